@@ -1,597 +1,776 @@
-/*
- * I2C source file
- */
- 
-/* 2021 Michael Nielson
- * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
- * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
- * Author: Michael Nielson
- * Email: nielsonm.projects@gmail.com
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful, but
- WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- General Public License for more details.
-
- See GNU General Public License at <http://www.gnu.org/licenses/>.
- 
- Copyright 2021 Michael Nielson
-*/
-
-
-#include <stdint.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "iostm8s005.h"
-#include "stm8s-005.h"
-#include "I2C.h"
-#include "main.h"
-#include "uip.h"
-#include "timer.h"
-#include "uart.h"
-#include "httpd.h"
-#include "uipopt.h"
-
-extern uint8_t OctetArray[11];
-
-uint8_t I2C_failcode;
-char * flash_ptr;
-char * ram_ptr;
-uint16_t copy_ram_index;
-uint8_t eeprom_num_write;
-uint8_t eeprom_num_read;
-uint16_t eeprom_base;
-
-
-
-#pragma section (flash_update)
-
-#if I2C_SUPPORT == 1
-
-//---------------------------------------------------------------------------//
-// This code uses:
-//   IO 14 as the I2C CLK signal (SCL)
-//   IO 15 as the I2C DATA signal (SDA)
-//
-// IO 14 is Port E bit 3 (of 0-7), thus mask is 0x08
-//   PE_DDR 1 is output, 0 is input
-//   PE_ODR
-//   PE_IDR
-// IO 15 is Port G bit 0 (of 0-7), thus mask is 0x01
-//   PG_DDR 1 is output, 0 is input
-//   PG_ODR
-//   PG_IDR
-//
-// If the I2C Feature is enabled in the Configuration page IO 14 and 15 are
-// kept "disabled" from the perspective of normal input/output operation.
-// This leaves the IO pin free to be manipulated by this code for I2C IO.
-//
-// In main.c, the write_output_pins() function will not write IO 14 and 15.
-// Instead in main.c, the check_runtime_changes() function will set IO 14 and
-// 15 to disabled if the Feature "I2C" is enabled. This removes the IO pins
-// from the IOControl page, and the IO pin will be kept disabled even if the
-// user attempts to enable them in the Configuration page.
-//
-// Hardware requirements:
-// a) You must add a 4.7Kohm pull up to 3V or to 5V on pins IO 14 and IO 15.
-// b) The I2C devices attached have a local 3V or 5V power supply.
-//---------------------------------------------------------------------------//
-
-// Typical use sequence:
-//  I2C_control(write ...)
-//  I2C_byte_address(...)
-//  I2C_write_byte(...) 1 byte or 64 bytes
-//  I2C_stop()
-// or
-//  I2C_control(write ...)
-//  I2C_byte_address(...)
-//  I2C_control(read...)
-//  I2C_read_byte(...) 1 byte or 64 bytes
-//  I2C_stop()
-
-void I2C_control(uint8_t control_byte)
-{
-  // The Control Byte addresses a device and provides the Read/Write bit to
-  // the device
-  
-  // Since the SDA and SCL pins are pulled high with a resistor to create a
-  // "1" on the bus, the Output Data Register for the SDA and SCL pins is
-  // written to 0, then a "1" on the pin is created by making the pin an input
-  // (effectively tri-stating the pin), and a "0" is created on the pin by
-  // making the pin an output. When read or write calls are made after
-  // addressing a device these ODR settings carry through to those functions.
-  
-  // Initialize pins. DDR is already 0 so these pins are floating.
-  PG_ODR &= (uint8_t)~0x01; // Write SDA ODR to 0
-  PE_ODR &= (uint8_t)~0x08; // Write SCL ODR to 0
-  
-  // Start condition:
-  SDA_high(); // Make sure SDA is high, then wait 5us
-  SCL_high(); // Make sure SCL is high, then wait 5us
-  SDA_low(); // Drive SDA low, then wait 5us
-  SCL_low(); // Drive SCL low, SCL_low() has no wait
-
-  // Output Device Control Byte. Bits 7 to 1 are address information, bit 0 is
-  // the Read/Write bit
-  I2C_transmit_byte(control_byte);
-  
-  // Read NACK/ACK from slave
-  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_CONTROL_BYTE;
-}
-
-
-void I2C_byte_address(uint16_t byte_address)
-{
-  // Send address to the Off-Board EEPROM where a byte read or write is to
-  // occur, or a sequential read/write stream is to occur.
-  
-  // Output Byte Address bit 15 to 8
-  I2C_transmit_byte((uint8_t)(byte_address >> 8));
-  
-  // Read NACK/ACK from slave
-  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_BYTE_ADDRESS1;
-  
-  // Output Byte Address bit 7 to 0
-  I2C_transmit_byte((uint8_t)(byte_address & 0x00ff));
-  
-  // Read NACK/ACK from slave
-  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_BYTE_ADDRESS2;
-}
-
-
-uint8_t I2C_read_byte(uint8_t I2C_last_flag)
-{
-  // In this application we only do sequential reads. NACK/ACK require
-  // special handling for this case. Each byte read is followed by an ACK
-  // except for the last byte, which is followed by NACK then a STOP
-  // condition.
-  uint8_t data_mask;
-  uint8_t I2C_data_field;
-  int nop_cnt;
-  
-  // Read Data bit 7 to 0
-  data_mask = 0x80;
-  I2C_data_field = 0;
-  while(1) {
-    // Input Data bit 7 to 0
-    SCL_high(); // Float SCL high, then wait 5us
-    if ((uint8_t)(PG_IDR & 0x01)) {
-      // Read data bit
-      I2C_data_field |= data_mask;
-    }
-    SCL_low();  // Drive SCL low, then no wait
-    for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
-    data_mask = (uint8_t)(data_mask >> 1);
-    if (data_mask == 0) break;
-  }
-  
-  //   Output NACK/ACK
-  if (I2C_last_flag == 0) {
-    SDA_low();  // Drive SDA low, then wait 5us. ACK for sequential reads.
-    SCL_pulse();
-    SDA_high(); // Float SDA high, then wait 5us.
-  }
-  else {
-    SDA_high(); // Float SDA high, then wait 5us. NACK for last byte.
-    SCL_pulse();
-    I2C_stop();
-  }
-  return I2C_data_field;
-}
-
-
-void SCL_pulse(void)
-{
-  SCL_high(); // Float SCL high, then wait 5us.
-  SCL_low();  // Drive SCL low, then no wait.
-}
-
-
-void SCL_high(void)
-{
-  int nop_cnt;
-  
-  PE_DDR &= (uint8_t)~0x08;; // write SCL DDR to 0 to float SCL high
-  for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
-}
-
-
-void SCL_low(void)
-{
-  PE_DDR |= (uint8_t)0x08; // write SCL DDR to 1 to pull SCL low
-  // No wait after SCL_low
-}
-
-
-void SDA_high(void)
-{
-  int nop_cnt;
-  
-  PG_DDR &= (uint8_t)~0x01; // write SDA DDR to 0 to float SDA high
-  for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
-}
-
-
-void SDA_low(void)
-{
-  int nop_cnt;
-  
-  PG_DDR |= (uint8_t)0x01; // write SDA DDR to 1 to pull SDA low
-  for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
-}
-
-
-void I2C_transmit_byte(uint8_t I2C_transmit_data)
-{
-  // This function will transmit up to 8 bits of data depending on the mask.
-  // For a normal data byte the mask starts with 0x80 and 8 bits are
-  // transmitted. For a device address byte the mask starts with 0x40 and
-  // 7 address bits are transmitted.
-  uint8_t data_mask;
-  data_mask = 0x80;
-  while(1) {
-    if ((I2C_transmit_data & data_mask) == data_mask) SDA_high(); // Float SDA high, wait 5us
-    else SDA_low();                        // or Drive SDA low, wait 5us
-    SCL_pulse();
-    data_mask = (uint8_t)(data_mask >> 1);
-    if (data_mask==0) break;
-  }
-  // NOTE: AT THE END OF THE LAST SCL_PULSE (WHEN SCL GOES LOW) THE SLAVE
-  // MAY START TRANSMITTING ITS NACK/ACK. BUT THE MASTER MIGHT STILL BE
-  // DRIVING THE SDA LINE ... SHOULD SDA BE RELEASED IN THIS ROUTINE
-  // IMMEDIATELY AT THE END OF SCL_PULSE? NOT SURE IT MATTERS, AS
-  // IMMEDIATELY AFTER I2C_TRANSMIT_BYTE WE CALL READ_SLAVE_NACKACK WHICH
-  // IMMEDIATELY RELEASES SDA. BUT TIMING COULD BE IMPROVED BY RELEASING
-  // SDA IN THIS ROUTINE WHEN DATA_MASK == 0.
-}
-  
-  
-uint8_t Read_Slave_NACKACK(void)
-{
-  uint8_t rtn;
-
-  rtn = 0;
-  
-  // Read NACK/ACK from slave
-  SDA_high(); // Float SDA high, wait 5us. This tristates the pin so slave
-              // can send NACK/ACK. ACK indicates slave received the address 
-              // properly.
-  SCL_high(); // Float SCL high, then wait 5us
-  
-  if (PG_IDR & 0x01) rtn = 1; // Read pin. 1 = NACK.
-  
-  SCL_low();  // Drive SCL low, then no wait
-  
-  return rtn;
-}
-
-  
-void I2C_stop(void)
-{
-  // Stop Condition
-  SDA_low();  // Drive SDA low, then wait 5us
-  SCL_high(); // Float SCL high, then wait 5us
-  SDA_high(); // Fload SDA high, then wait 5us
-}
-
-#endif // I2C_SUPPORT == 1
-
-
-
-#if OB_EEPROM_SUPPORT == 1
-void eeprom_copy_to_flash(void)
-{
-  uint16_t eeprom_index;
-  uint16_t blocks;
-
-  // This function will copy a Flash image from the Off-Board EEPROM to the
-  // STM8 Flash.
-  //
-  // The following variables must be global and must be set prior to calling
-  // this function:
-  //   *flash_ptr
-  //   eeprom_base
-  //
-  // In this application there are four image locations in the Off-Board
-  // EEPROM:
-  //   1) EEPROM Region 0 (EEPROM0) of the Off-Board EEPROM contains an image
-  //      of new Runtime code.
-  //   2) EEPROM Region 1 (EEPROM1) of the Off-Board EEPROM contans an image
-  //      of the Code Uploader. The Code Uploader provides a GUI to allow the
-  //      user to specify the file location of a new Runtime image.
-  //   3) EEPROM Region 2 (EEPROM2) of the Off-Board EEPROM contains an image
-  //      of the large strings used for html population of the GUI.
-  //   4) EEPROM Region 3 (EEPROM3) - not currently used.
-  //
-  // Copying data from the Off-Board EEPROM to Flash needs to be done using 128
-  // byte block programming.
-  //
-  // If we were to copy the entire Off-Board EEPROM to Flash the copy would be
-  // 32768 bytes. 128 at a time would be 256 cycles. Each cycle takes about
-  // 12ms for the I2C writes to the EEPROM plus a 6ms wait cycle for the
-  // EEPROM internal program cycle. The time to complete the entire copy is
-  // about 256 x (12ms + 6ms) = 4.6 sec.
-  //
-  // I have to assume that the Stack is still functional when this code runs,
-  // as it needs to call the I2C functions contained in this segment and the
-  // functions need to utilize locally declared variables. Initial testing
-  // shows this to be true.
-  //
-  // IMPORTANT IMPORTANT IMPORTANT IMPORTANT IMPORTANT IMPORTANT IMPORTANT
-  // Changes to the functions contained in the flash_update segment need to be
-  // made VERY carfully. The functions have been packed into as few bytes as
-  // possible, and must fit into Flash on 128 byte boundaries (start and end).
-  // In this application a maximum of 512 bytes can be used for the
-  // flash_update segment.
-  // Changes to the memcpy_update segment also need to be made very carefully
-  // as that segment gets copied to RAM - a resource that is always in short
-  // supply. The memcpy_update segment is currently about 40 bytes.
-  //
-  // In these functions the uip_buf is repurposed as the buffer to enable
-  // copies from Off-Board EEPROM to Flash. Because the I2C IO functions are
-  // needed to perform reads from Off-Board EEPROM the EEPROM content is first
-  // copied to RAM then copied to Flash. And because we can't overwrite the
-  // I2C functions in Flash until we are done using them, the final copy from
-  // Off-Board EEPROM to RAM to Flash must contain the entire flash_update
-  // segment and must fit safely in RAM. Since we must always copy 128 byte
-  // blocks the flash_update segment copy requires 4 blocks, or 512 bytes,
-  // which is larger than the size of the uip_buf. So, the data will over-run
-  // the end of the RAM space allocated to the uip_buf RAM space. This will
-  // still work because of the following:
-  // a) The .lkf file is set up to place the memcpy_update code at the start
-  //    of RAM. This is required for the next item to work. See the main.h
-  //    file for proper settings in the .lkf file.
-  // b) The Cosmic compiler/linker always places the largest RAM item at the
-  //    end of RAM ... and that turns out to be the uip_buf. This is why step
-  //    (a) is critical: the memcpy_update code must not be placed in RAM
-  //    after the uip_buf. Likewise, no other variables used in the copy
-  //    processes can appear in RAM after uip_buf as they will be over-written
-  //    when the copy processes run.
-  // So, with (a) and (b) established, writes to the uip_buf can over-run the
-  // end of RAM and can encroach on the Stack space without causing harm to
-  // operation of the copy routines. And since the copy routines are the last
-  // thing to run before a reboot occurs we don't have to worry about inter-
-  // ferring with operation of other runtime code.
-  //
-  // I thought about simply making the uip_buf 512 bytes long, but that wastes
-  // RAM in the non-upgradeable versions. So since it doesn't matter that we
-  // encroach on the Stack area this seems the best solution.
-  
-  ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
-  eeprom_index = eeprom_base;
-			      
-  // The Flash must be unlocked to allow any writes to it. The unlock occurs
-  // by the routine that calls this function. Note that when Flash is written
-  // the STM8 hardware will stall code execution until the write completes.
-  // This typically takes 6ms per write.
-  
-  // Memory map in 128 byte blocks:
-  //  Blocks 0 to 248 (249 blocks) are the main program memory.
-  //  Blocks 249 to 252 (4 blocks) are "pragma section (flash_update)".
-  //  Blocks 253-255 (3 blocks) are reserved for user data storage and are
-  //    only written when the user makes GUI input changes.
-  
-  blocks = 0;
-  while (blocks < 249 ) {
-    // In this application the main code area is always 249 blocks of 128
-    // bytes per block. Copy that first.
-    // Note: This routine is only run to replace the code in Flash.
-    
-    ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
-    // Enable sequential read from the Off-Board EEPROM.
-    // Read addressing sequence: Send Write Control byte, send Byte address,
-    // send Read Control Byte
-    I2C_control(eeprom_num_write);  // Write control byte to establish address
-    I2C_byte_address(eeprom_index); // Byte address of first byte
-    I2C_control(eeprom_num_read);   // Read control byte
-    
-    // Copy 128 bytes from Off-Board EEPROM to RAM
-    {
-      uint8_t i;
-      for (i=0; i<127; i++) {
-        *ram_ptr = I2C_read_byte(0);
-	ram_ptr++;
-      }
-    }
-    *ram_ptr = I2C_read_byte(1); // Final read with I2C_last_flag set
-
-    // Copy data from RAM to Flash
-    ram_ptr = &uip_buf[0]; // Reset the ram_ptr to the start of the uip_buf
-    copy_ram_to_flash(); // As part of the copy the flash_ptr will be
-                         // incremented to the start of the next 64 byte
-                         // block.
-    eeprom_index += 128; // Increment the eeprom_index to the start of the
-                         // next block.
-    blocks++;
-    
-    // Prevent the IWDG hardware watchdog from firing.
-    IWDG_KR = 0xaa;
-  }
-  
-  // We are copying contiguous 128 byte blocks. There are no gaps between the
-  // blocks. So, the eeprom_index should already be correct, the flash_ptr
-  // should already be correct, and eeprom_num_write and eeprom_num_read
-  // remain the same.  So we just need to copy 4 blocks to RAM then copy those
-  // to Flash. A note is that this will cause a small overwrite into the Stack
-  // area ... which shouldn't hurt anything since this is the last step before
-  // reboot.
-  
-  // Copy the flash_update segment to Flash.
-  // This copy is performed separately from the main code copy because the I2C
-  // functions are contained in the flash_update segment, and we need to stop
-  // using those functions at the time they are over-written in Flash. So, in
-  // this final step we use the I2C functions to copy the entire flash_update
-  // segment to RAM, then the memcpy_update function runs in RAM to write the
-  // segment from RAM to Flash. Then, we just wait for an IDWG to reboot the
-  // STM8.
-  ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
-  
-  // Enable sequential read from the Off-Board EEPROM.
-  // Read addressing sequence: Send Write Control byte, send Byte address,
-  // send Read Control Byte
-  I2C_control(eeprom_num_write);  // Write control byte to establish address
-  I2C_byte_address(eeprom_index); // Byte address of first byte
-  I2C_control(eeprom_num_read);   // Read control byte
-  
-  {
-    uint16_t j;
-    // In this application the flash_update segment is always 4 blocks (512
-    // bytes).
-    //
-    // First the segment is copied to RAM. This will occupy four 128 byte
-    // blocks. The blocks are copied to RAM, then copy_ram_to_flash() is
-    // called to copy the data from RAM to Flash. Note that the copy to RAM
-    // may exceed the size allocated to the uip_buf. This is OK as the uip_buf
-    // RAM area (and beyond) is no longer being used by regular runtime code
-    // ... and it is also OK if the RAM usage extends into the Stack area as
-    // very little Stack is being used when this code is running.
-      
-    for (j = 0; j < 511; j++) {
-      *ram_ptr = I2C_read_byte(0);
-      ram_ptr++;
-      eeprom_index++;
-    }
-    *ram_ptr = I2C_read_byte(1); // Final read with I2C_last_flag set
-  }
-
-
-  // Prevent the IWDG hardware watchdog from firing.
-  IWDG_KR = 0xaa;
-  
-  // Copy 512 bytes of data from RAM to Flash
-  ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
-  copy_ram_to_flash(); // Each call to copy_ram_to_flash updates the pointers
-  copy_ram_to_flash(); // so the next call writes the next contiguous 128 byte
-  copy_ram_to_flash(); // block.
-  copy_ram_to_flash(); //
-  
-  // Lock the Flash
-  FLASH_IAPSR &= (uint8_t)(~0x02);
-  
-  // Set the Window Watchdog to reboot the module
-  WWDG_WR = (uint8_t)0x7f;     // Window register reset
-  WWDG_CR = (uint8_t)0xff;     // Set watchdog to timeout in 49ms
-  WWDG_WR = (uint8_t)0x60;     // Window register value - doesn't matter
-                               // much as we plan to reset
-
-  // Wait here for WWDG to reset the module.
-  while(1);
-}
-#endif // OB_EEPROM_SUPPORT == 1
-
-#pragma section ()
-
-
-
-#pragma section (memcpy_update)
-
-#if OB_EEPROM_SUPPORT == 1
-void copy_ram_to_flash(void)
-{
-  // This function copies 128 byte blocks of data from RAM to Flash as part of
-  // the Flash update process.
-
-  uint8_t i;
-  
-  // Note: This function is only run to copy code to Flash in 128 byte blocks.
-  // The segment is relocatable and must be run from RAM as a requirement of
-  // the STM8 hardware. The _fctcpy function is used to copy this segment to
-  // RAM in a way that allows the function to be called from code running in
-  // Flash. So, when updating Flash the first thing that happens is this
-  // is copied to RAM, then Flash code updates start.
-    
-  // The following must be defined in global memory before calling the
-  // function:
-  //  char *flash_ptr
-  //  char *ram_ptr
-
-  // Enable Flash Block Programming
-  // The fastest (and least wear) method for writing Flash is to perform
-  // 128 byte block writes. To do this the PRG bit of the FLASH_CR2 register
-  // must be set before the 128 bytes are written. This requires a complement-
-  // ary write to the FLASH_NCR2 register. This will allow 128 bytes to be
-  // written in 6ms. Note that the STM8 hardware design will stall program
-  // execution while the Flash write completes, so there is no need for the
-  // code to have a wait function or to poll for completion of the write.
-  FLASH_CR2 |= FLASH_CR2_PRG;
-  FLASH_NCR2 &= (uint8_t)(~FLASH_NCR2_NPRG);
-
-  // Copy 128 bytes from RAM to Flash
-  for (i=0; i<128; i++) {
-    *flash_ptr = *ram_ptr;
-    flash_ptr++;
-    ram_ptr++;
-  }
-}
-#endif // OB_EEPROM_SUPPORT == 1
-
-#pragma section ()
-
-
-
-
-#if I2C_SUPPORT == 1
-void I2C_write_byte(uint8_t I2C_write_data)
-{
-  // Write a single data byte on the I2C bus.  This function is not included
-  // in the (flash_update) segment because it is never called again once the
-  // eeprom_copy_to_flash() function is called.
-  
-  // Write Data bit 7 to 0
-  I2C_transmit_byte(I2C_write_data);
-  
-  // Read NACK/ACK from slave
-  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_WRITE_BYTE;
-}
-
-
-void I2C_reset(void)
-{
-  // Reset the I2C bus to place it in a known state.
-  
-  // This function generates an I2C bus reset. This function is not included
-  // in the flash_update segment because it is never called again once the
-  // eeprom_copy_to_flash function is called.
-  
-  // The function:
-  // Floats SDA high
-  // Floats SCL high
-  // Generates 10 SCL clocks ending with SCL high
-  // Drive SDA low (a start condition)
-  // Drive SCL low
-  // Float SDA high
-  // Float SCL high
-  // Drive SCL low
-  // Drive SDA low
-  // Float SCL high
-  // FLoat SDA high (a stop condition)
-  // At this point the bus should be reset and operations can continue.
-  // The reset can be run at firmware start to make sure prior bus
-  // interruptions are cleared.
-  
-  int i;
-  int nop_cnt;
-
-  SDA_high(); // Make sure SDA is high (float)
-  SCL_high(); // Make sure SCL is high (float)
-  for (i=0; i<10; i++) {
-    SCL_low();
-    for (nop_cnt=0; nop_cnt<10; nop_cnt++) nop(); // Wait 5us
-    SCL_high();
-  }
-  SDA_low(); // Start condition
-  SCL_low();
-  SDA_high(); // Single 1 data bit clocked out
-  SCL_pulse();
-  SDA_low();  // "
-  SCL_high();
-  SDA_high(); // Stop condition
-}
-
-#endif // I2C_SUPPORT == 1
-
+/*
+ * I2C source file
+ */
+ 
+/* 2021 Michael Nielson
+ * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
+ * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
+ * Author: Michael Nielson
+ * Email: nielsonm.projects@gmail.com
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ See GNU General Public License at <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2021 Michael Nielson
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iostm8s005.h"
+#include "stm8s-005.h"
+#include "I2C.h"
+#include "main.h"
+#include "uip.h"
+#include "timer.h"
+#include "uart.h"
+#include "httpd.h"
+#include "uipopt.h"
+
+extern uint8_t OctetArray[11];
+
+uint8_t I2C_failcode;
+char * flash_ptr;
+char * ram_ptr;
+uint16_t copy_ram_index;
+uint8_t eeprom_num_write;
+uint16_t eeprom_base;
+uint8_t flash_verify_errors;     // Blocks that eeprom_copy_to_flash() could
+                                 // not make match the EEPROM image.
+uint8_t I2C_read_open;           // 1 if a sequential read was left open
+                                 // between calls. See I2C_read_close().
+
+
+
+#pragma section (flash_update)
+
+#if I2C_SUPPORT == 1
+
+//---------------------------------------------------------------------------//
+// Bit-bang timing
+// I2C_delay(n) is a countdown loop of about 4 CPU cycles (250ns at 16MHz)
+// per count. The counts below are the delays added after an SCL or SDA
+// change. The function call and return around each pin change add roughly
+// 10 more cycles, which the counts already account for.
+//   I2C_WAIT_HIGH - After SCL is released: rise time (300ns max with 4.7K
+//                   pull ups) plus tHIGH (0.6us in Fast Mode). Also covers
+//                   tSU;STA and tSU;STO.
+//   I2C_WAIT_LOW  - After SDA changes or SCL is driven low: tLOW (1.3us in
+//                   Fast Mode), tHD;STA and tBUF.
+// In Standard Mode the counts reproduce the original 5us delays.
+#if I2C_FAST_MODE == 1
+#define I2C_WAIT_HIGH	3
+#define I2C_WAIT_LOW	3
+#else // I2C_FAST_MODE == 0
+#define I2C_WAIT_HIGH	20
+#define I2C_WAIT_LOW	20
+#endif // I2C_FAST_MODE == 1
+
+#define I2C_delay(n) { uint8_t dly; for (dly = (n); dly; dly--) nop(); }
+
+//---------------------------------------------------------------------------//
+// This code uses:
+//   IO 14 as the I2C CLK signal (SCL)
+//   IO 15 as the I2C DATA signal (SDA)
+//
+// IO 14 is Port E bit 3 (of 0-7), thus mask is 0x08
+//   PE_DDR 1 is output, 0 is input
+//   PE_ODR
+//   PE_IDR
+// IO 15 is Port G bit 0 (of 0-7), thus mask is 0x01
+//   PG_DDR 1 is output, 0 is input
+//   PG_ODR
+//   PG_IDR
+//
+// If the I2C Feature is enabled in the Configuration page IO 14 and 15 are
+// kept "disabled" from the perspective of normal input/output operation.
+// This leaves the IO pin free to be manipulated by this code for I2C IO.
+//
+// In main.c, the write_output_pins() function will not write IO 14 and 15.
+// Instead in main.c, the check_runtime_changes() function will set IO 14 and
+// 15 to disabled if the Feature "I2C" is enabled. This removes the IO pins
+// from the IOControl page, and the IO pin will be kept disabled even if the
+// user attempts to enable them in the Configuration page.
+//
+// Hardware requirements:
+// a) You must add a 4.7Kohm pull up to 3V or to 5V on pins IO 14 and IO 15.
+// b) The I2C devices attached have a local 3V or 5V power supply.
+//---------------------------------------------------------------------------//
+
+// Typical use sequence:
+//  I2C_control(write ...)
+//  I2C_byte_address(...)
+//  I2C_write_byte(...) 1 byte or 64 bytes
+//  I2C_stop()
+// or
+//  I2C_control(write ...)
+//  I2C_byte_address(...)
+//  I2C_control(read...)
+//  I2C_read_byte(...) 1 byte or 64 bytes
+//  I2C_stop()
+// or, for reads, simply
+//  I2C_read_block(write control, byte address, destination, count)
+// I2C_read_block() is in the .text segment. eeprom_copy_to_flash() uses
+// I2C_read_sequential() instead, which is the part of I2C_read_block() that
+// has to stay in the flash_update segment.
+
+void I2C_control(uint8_t control_byte)
+{
+  // The Control Byte addresses a device and provides the Read/Write bit to
+  // the device
+  
+  // Since the SDA and SCL pins are pulled high with a resistor to create a
+  // "1" on the bus, the Output Data Register for the SDA and SCL pins is
+  // written to 0, then a "1" on the pin is created by making the pin an input
+  // (effectively tri-stating the pin), and a "0" is created on the pin by
+  // making the pin an output. When read or write calls are made after
+  // addressing a device these ODR settings carry through to those functions.
+  
+  // Initialize pins. DDR is already 0 so these pins are floating.
+  PG_ODR &= (uint8_t)~0x01; // Write SDA ODR to 0
+  PE_ODR &= (uint8_t)~0x08; // Write SCL ODR to 0
+  
+  // Start condition:
+  SDA_high(); // Make sure SDA is high, then wait
+  SCL_high(); // Make sure SCL is high, then wait
+  SDA_low(); // Drive SDA low, then wait
+  SCL_low(); // Drive SCL low, SCL_low() has no wait
+
+  // Output Device Control Byte. Bits 7 to 1 are address information, bit 0 is
+  // the Read/Write bit
+  I2C_transmit_byte(control_byte);
+  
+  // Read NACK/ACK from slave
+  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_CONTROL_BYTE;
+  
+  // Read_Slave_NACKACK() drives SCL low with no wait. After a Read Control
+  // Byte the next step is I2C_read_byte(), which releases SCL right away,
+  // so wait tLOW here.
+  if (control_byte & 0x01) I2C_delay(I2C_WAIT_LOW);
+}
+
+
+void I2C_byte_address(uint16_t byte_address)
+{
+  // Send address to the Off-Board EEPROM where a byte read or write is to
+  // occur, or a sequential read/write stream is to occur.
+  
+  // Output Byte Address bit 15 to 8
+  I2C_transmit_byte((uint8_t)(byte_address >> 8));
+  
+  // Read NACK/ACK from slave
+  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_BYTE_ADDRESS1;
+  
+  // Output Byte Address bit 7 to 0
+  I2C_transmit_byte((uint8_t)(byte_address & 0x00ff));
+  
+  // Read NACK/ACK from slave
+  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_BYTE_ADDRESS2;
+}
+
+
+uint8_t I2C_read_byte(uint8_t I2C_last_flag)
+{
+  // In this application we only do sequential reads. NACK/ACK require
+  // special handling for this case. Each byte read is followed by an ACK
+  // except for the last byte, which is followed by NACK then a STOP
+  // condition.
+  uint8_t i;
+  uint8_t I2C_data_field;
+  
+  // Read Data bit 7 to 0
+  // Each bit is shifted in from the bottom of I2C_data_field, so the loop
+  // needs only a down counter (no mask variable and no end test on the
+  // mask). After 8 bits the first bit read has reached bit 7.
+  I2C_data_field = 0;
+  for (i = 8; i; i--) {
+    SCL_high(); // Float SCL high, then wait
+    I2C_data_field = (uint8_t)(I2C_data_field << 1);
+    if ((uint8_t)(PG_IDR & 0x01)) I2C_data_field |= 0x01; // Read data bit
+    SCL_low();  // Drive SCL low, then no wait
+    I2C_delay(I2C_WAIT_LOW); // Wait tLOW
+  }
+  
+  //   Output NACK/ACK
+  if (I2C_last_flag == 0) {
+    SDA_low();  // Drive SDA low, then wait. ACK for sequential reads.
+    SCL_pulse();
+    SDA_high(); // Float SDA high, then wait.
+  }
+  else {
+    SDA_high(); // Float SDA high, then wait. NACK for last byte.
+    SCL_pulse();
+    I2C_stop();
+  }
+  return I2C_data_field;
+}
+
+
+void I2C_read_sequential(uint8_t control_byte, uint16_t byte_address, uint8_t *dest, uint16_t count)
+{
+  // Read count bytes from the Off-Board EEPROM into dest, starting at
+  // byte_address in the device selected by control_byte (the Write Control
+  // Byte). count must be at least 1, and the read must not run past the end
+  // of the 64KB block. Any read left open must already have been ended.
+  //
+  // This performs the read addressing sequence (Write Control byte, Byte
+  // address, Read Control byte) followed by a sequential read in which every
+  // byte is followed by an ACK except the last, which is followed by NACK
+  // and STOP.
+  //
+  // This is the smallest part of I2C_read_block() that eeprom_copy_to_flash()
+  // needs, so it is all that is kept in the flash_update segment.
+  I2C_control(control_byte);
+  I2C_byte_address(byte_address);
+  I2C_control((uint8_t)(control_byte | 0x01));
+  
+  // count-1 reads with ACK, then the final read with NACK and STOP
+  while (--count) *dest++ = I2C_read_byte(0);
+  *dest = I2C_read_byte(1);
+}
+
+
+void SCL_pulse(void)
+{
+  SCL_high(); // Float SCL high, then wait.
+  SCL_low();  // Drive SCL low, then no wait.
+}
+
+
+void SCL_high(void)
+{
+  PE_DDR &= (uint8_t)~0x08;; // write SCL DDR to 0 to float SCL high
+  I2C_delay(I2C_WAIT_HIGH); // Wait rise time plus tHIGH
+}
+
+
+void SCL_low(void)
+{
+  PE_DDR |= (uint8_t)0x08; // write SCL DDR to 1 to pull SCL low
+  // No wait after SCL_low
+}
+
+
+void SDA_high(void)
+{
+  PG_DDR &= (uint8_t)~0x01; // write SDA DDR to 0 to float SDA high
+  I2C_delay(I2C_WAIT_LOW); // Wait rise time plus data setup
+}
+
+
+void SDA_low(void)
+{
+  PG_DDR |= (uint8_t)0x01; // write SDA DDR to 1 to pull SDA low
+  I2C_delay(I2C_WAIT_LOW); // Wait data setup (or tHD;STA in a start)
+}
+
+
+void I2C_transmit_byte(uint8_t I2C_transmit_data)
+{
+  // This function will transmit up to 8 bits of data depending on the mask.
+  // For a normal data byte the mask starts with 0x80 and 8 bits are
+  // transmitted. For a device address byte the mask starts with 0x40 and
+  // 7 address bits are transmitted.
+  uint8_t data_mask;
+  data_mask = 0x80;
+  while(1) {
+    if ((I2C_transmit_data & data_mask) == data_mask) SDA_high(); // Float SDA high, then wait
+    else SDA_low();                        // or Drive SDA low, then wait
+    SCL_pulse();
+    data_mask = (uint8_t)(data_mask >> 1);
+    if (data_mask==0) break;
+  }
+  // NOTE: AT THE END OF THE LAST SCL_PULSE (WHEN SCL GOES LOW) THE SLAVE
+  // MAY START TRANSMITTING ITS NACK/ACK. BUT THE MASTER MIGHT STILL BE
+  // DRIVING THE SDA LINE ... SHOULD SDA BE RELEASED IN THIS ROUTINE
+  // IMMEDIATELY AT THE END OF SCL_PULSE? NOT SURE IT MATTERS, AS
+  // IMMEDIATELY AFTER I2C_TRANSMIT_BYTE WE CALL READ_SLAVE_NACKACK WHICH
+  // IMMEDIATELY RELEASES SDA. BUT TIMING COULD BE IMPROVED BY RELEASING
+  // SDA IN THIS ROUTINE WHEN DATA_MASK == 0.
+}
+  
+  
+uint8_t Read_Slave_NACKACK(void)
+{
+  uint8_t rtn;
+
+  rtn = 0;
+  
+  // Read NACK/ACK from slave
+  SDA_high(); // Float SDA high, then wait. This tristates the pin so slave
+              // can send NACK/ACK. ACK indicates slave received the address 
+              // properly.
+  SCL_high(); // Float SCL high, then wait
+  
+  if (PG_IDR & 0x01) rtn = 1; // Read pin. 1 = NACK.
+  
+  SCL_low();  // Drive SCL low, then no wait
+  
+  return rtn;
+}
+
+  
+void I2C_stop(void)
+{
+  // Stop Condition
+  SDA_low();  // Drive SDA low, then wait
+  SCL_high(); // Float SCL high, then wait
+  SDA_high(); // Fload SDA high, then wait
+}
+
+#endif // I2C_SUPPORT == 1
+
+
+
+#if OB_EEPROM_SUPPORT == 1
+uint8_t flash_block_differs(void)
+{
+  // Compare the 128 bytes at the start of the uip_buf with the 128 bytes at
+  // flash_ptr. Returns 1 if any byte differs. flash_ptr is not changed. This
+  // function is in the flash_update segment because it is used while the
+  // main Flash is being re-written.
+  uint8_t i;
+  for (i=0; i<128; i++) {
+    if (flash_ptr[i] != uip_buf[i]) return 1;
+  }
+  return 0;
+}
+
+
+void eeprom_copy_to_flash(void)
+{
+  uint16_t eeprom_index;
+  uint16_t blocks;
+  uint8_t retry;
+
+  // This function will copy a Flash image from the Off-Board EEPROM to the
+  // STM8 Flash.
+  //
+  // The following variables must be global and must be set prior to calling
+  // this function:
+  //   *flash_ptr
+  //   eeprom_base
+  //
+  // In this application there are four image locations in the Off-Board
+  // EEPROM:
+  //   1) EEPROM Region 0 (EEPROM0) of the Off-Board EEPROM contains an image
+  //      of new Runtime code.
+  //   2) EEPROM Region 1 (EEPROM1) of the Off-Board EEPROM contans an image
+  //      of the Code Uploader. The Code Uploader provides a GUI to allow the
+  //      user to specify the file location of a new Runtime image.
+  //   3) EEPROM Region 2 (EEPROM2) of the Off-Board EEPROM contains an image
+  //      of the large strings used for html population of the GUI.
+  //   4) EEPROM Region 3 (EEPROM3) - not currently used.
+  //
+  // Copying data from the Off-Board EEPROM to Flash needs to be done using 128
+  // byte block programming.
+  //
+  // If we were to copy the entire Off-Board EEPROM to Flash the copy would be
+  // 32768 bytes. 128 at a time would be 256 cycles. Each cycle takes about
+  // 12ms for the I2C writes to the EEPROM plus a 6ms wait cycle for the
+  // EEPROM internal program cycle. The time to complete the entire copy is
+  // about 256 x (12ms + 6ms) = 4.6 sec. With differential programming (see
+  // below) the 6ms Flash write is only spent on blocks that changed.
+  //
+  // I have to assume that the Stack is still functional when this code runs,
+  // as it needs to call the I2C functions contained in this segment and the
+  // functions need to utilize locally declared variables. Initial testing
+  // shows this to be true.
+  //
+  // IMPORTANT IMPORTANT IMPORTANT IMPORTANT IMPORTANT IMPORTANT IMPORTANT
+  // Changes to the functions contained in the flash_update segment need to be
+  // made VERY carfully. The functions have been packed into as few bytes as
+  // possible, and must fit into Flash on 128 byte boundaries (start and end).
+  // In this application a maximum of 512 bytes can be used for the
+  // flash_update segment. The -m 0x200 on the segment in the .lkf file makes
+  // the link fail if the segment grows past that, instead of letting it
+  // overlap the manifest and user data at 0xfe80.
+  // Changes to the memcpy_update segment also need to be made very carefully
+  // as that segment gets copied to RAM - a resource that is always in short
+  // supply. The memcpy_update segment is currently about 40 bytes.
+  //
+  // In these functions the uip_buf is repurposed as the buffer to enable
+  // copies from Off-Board EEPROM to Flash. Because the I2C IO functions are
+  // needed to perform reads from Off-Board EEPROM the EEPROM content is first
+  // copied to RAM then copied to Flash. And because we can't overwrite the
+  // I2C functions in Flash until we are done using them, the final copy from
+  // Off-Board EEPROM to RAM to Flash must contain the entire flash_update
+  // segment and must fit safely in RAM. Since we must always copy 128 byte
+  // blocks the flash_update segment copy requires 4 blocks, or 512 bytes,
+  // which is larger than the size of the uip_buf. So, the data will over-run
+  // the end of the RAM space allocated to the uip_buf RAM space. This will
+  // still work because of the following:
+  // a) The .lkf file is set up to place the memcpy_update code at the start
+  //    of RAM. This is required for the next item to work. See the main.h
+  //    file for proper settings in the .lkf file.
+  // b) The Cosmic compiler/linker always places the largest RAM item at the
+  //    end of RAM ... and that turns out to be the uip_buf. This is why step
+  //    (a) is critical: the memcpy_update code must not be placed in RAM
+  //    after the uip_buf. Likewise, no other variables used in the copy
+  //    processes can appear in RAM after uip_buf as they will be over-written
+  //    when the copy processes run.
+  // So, with (a) and (b) established, writes to the uip_buf can over-run the
+  // end of RAM and can encroach on the Stack space without causing harm to
+  // operation of the copy routines. And since the copy routines are the last
+  // thing to run before a reboot occurs we don't have to worry about inter-
+  // ferring with operation of other runtime code.
+  //
+  // I thought about simply making the uip_buf 512 bytes long, but that wastes
+  // RAM in the non-upgradeable versions. So since it doesn't matter that we
+  // encroach on the Stack area this seems the best solution.
+  
+  eeprom_index = eeprom_base;
+			      
+  // The Flash must be unlocked to allow any writes to it. The unlock occurs
+  // by the routine that calls this function. Note that when Flash is written
+  // the STM8 hardware will stall code execution until the write completes.
+  // This typically takes 6ms per write.
+  
+  // Memory map in 128 byte blocks:
+  //  Blocks 0 to 248 (249 blocks) are the main program memory.
+  //  Blocks 249 to 252 (4 blocks) are "pragma section (flash_update)".
+  //  Blocks 253-255 (3 blocks) are reserved for user data storage and are
+  //    only written when the user makes GUI input changes.
+  
+  // Differential programming:
+  // Between releases most 128 byte blocks are unchanged. Each block read
+  // from the Off-Board EEPROM is compared with the block already in Flash
+  // and is only programmed if it differs. The same compare then verifies
+  // the programmed block, and the block is programmed a second time if the
+  // verify fails. Blocks that still differ after that are counted in
+  // flash_verify_errors, which can be inspected with a debugger.
+  // Note that nothing in the .text segment can be called from here. The
+  // .text segment is being replaced block by block, and that includes the
+  // C library routines the compiler uses for 32 bit arithmetic.
+  flash_verify_errors = 0;
+  
+  blocks = 0;
+  while (blocks < 249 ) {
+    // In this application the main code area is always 249 blocks of 128
+    // bytes per block. Copy that first.
+    // Note: This routine is only run to replace the code in Flash.
+    
+    // Copy 128 bytes from Off-Board EEPROM to RAM
+    I2C_read_sequential(eeprom_num_write, eeprom_index, &uip_buf[0], 128);
+
+    // Copy data from RAM to Flash while the Flash block is different, at
+    // most twice
+    retry = 0;
+    while (flash_block_differs()) {
+      if (retry == 2) {
+        flash_verify_errors++;
+        break;
+      }
+      ram_ptr = &uip_buf[0]; // Set the ram_ptr to the start of the uip_buf
+      copy_ram_to_flash(); // As part of the copy the flash_ptr will be
+                           // incremented to the start of the next 128
+                           // byte block.
+      flash_ptr -= 128;    // Back to the block just written to verify it
+      retry++;
+    }
+    flash_ptr += 128;    // Increment the flash_ptr to the start of the next
+                         // block.
+    eeprom_index += 128; // Increment the eeprom_index to the start of the
+                         // next block.
+    blocks++;
+    
+    // Prevent the IWDG hardware watchdog from firing.
+    IWDG_KR = 0xaa;
+  }
+  
+  // We are copying contiguous 128 byte blocks. There are no gaps between the
+  // blocks. So, the eeprom_index should already be correct, the flash_ptr
+  // should already be correct, and eeprom_num_write remains the same.  So we just need to copy 4 blocks to RAM then copy those
+  // to Flash. A note is that this will cause a small overwrite into the Stack
+  // area ... which shouldn't hurt anything since this is the last step before
+  // reboot.
+  
+  // Copy the flash_update segment to Flash.
+  // This copy is performed separately from the main code copy because the I2C
+  // functions are contained in the flash_update segment, and we need to stop
+  // using those functions at the time they are over-written in Flash. So, in
+  // this final step we use the I2C functions to copy the entire flash_update
+  // segment to RAM, then the memcpy_update function runs in RAM to write the
+  // segment from RAM to Flash. Then, we just wait for an IDWG to reboot the
+  // STM8.
+  //
+  // In this application the flash_update segment is always 4 blocks (512
+  // bytes).
+  //
+  // First the segment is copied to RAM. This will occupy four 128 byte
+  // blocks. The blocks are copied to RAM, then copy_ram_to_flash() is
+  // called to copy the data from RAM to Flash. Note that the copy to RAM
+  // may exceed the size allocated to the uip_buf. This is OK as the uip_buf
+  // RAM area (and beyond) is no longer being used by regular runtime code
+  // ... and it is also OK if the RAM usage extends into the Stack area as
+  // very little Stack is being used when this code is running.
+  I2C_read_sequential(eeprom_num_write, eeprom_index, &uip_buf[0], 512);
+
+
+  // Prevent the IWDG hardware watchdog from firing.
+  IWDG_KR = 0xaa;
+  
+  // The flash_update segment is always re-written. Comparing it first would
+  // save one 6ms write per block, but the compare does not fit in the 512
+  // bytes of the segment.
+  // Copy 512 bytes of data from RAM to Flash
+  ram_ptr = &uip_buf[0]; // Set ram_ptr to the start of the uip_buf
+  copy_ram_to_flash(); // Each call to copy_ram_to_flash updates the pointers
+  copy_ram_to_flash(); // so the next call writes the next contiguous 128 byte
+  copy_ram_to_flash(); // block.
+  copy_ram_to_flash(); //
+  
+  // Lock the Flash
+  FLASH_IAPSR &= (uint8_t)(~0x02);
+  
+  // Set the Window Watchdog to reboot the module
+  WWDG_WR = (uint8_t)0x7f;     // Window register reset
+  WWDG_CR = (uint8_t)0xff;     // Set watchdog to timeout in 49ms
+  WWDG_WR = (uint8_t)0x60;     // Window register value - doesn't matter
+                               // much as we plan to reset
+
+  // Wait here for WWDG to reset the module.
+  while(1);
+}
+#endif // OB_EEPROM_SUPPORT == 1
+
+#pragma section ()
+
+
+
+#pragma section (memcpy_update)
+
+#if OB_EEPROM_SUPPORT == 1
+void copy_ram_to_flash(void)
+{
+  // This function copies 128 byte blocks of data from RAM to Flash as part of
+  // the Flash update process.
+
+  uint8_t i;
+  
+  // Note: This function is only run to copy code to Flash in 128 byte blocks.
+  // The segment is relocatable and must be run from RAM as a requirement of
+  // the STM8 hardware. The _fctcpy function is used to copy this segment to
+  // RAM in a way that allows the function to be called from code running in
+  // Flash. So, when updating Flash the first thing that happens is this
+  // is copied to RAM, then Flash code updates start.
+    
+  // The following must be defined in global memory before calling the
+  // function:
+  //  char *flash_ptr
+  //  char *ram_ptr
+
+  // Enable Flash Block Programming
+  // The fastest (and least wear) method for writing Flash is to perform
+  // 128 byte block writes. To do this the PRG bit of the FLASH_CR2 register
+  // must be set before the 128 bytes are written. This requires a complement-
+  // ary write to the FLASH_NCR2 register. This will allow 128 bytes to be
+  // written in 6ms. Note that the STM8 hardware design will stall program
+  // execution while the Flash write completes, so there is no need for the
+  // code to have a wait function or to poll for completion of the write.
+  FLASH_CR2 |= FLASH_CR2_PRG;
+  FLASH_NCR2 &= (uint8_t)(~FLASH_NCR2_NPRG);
+
+  // Copy 128 bytes from RAM to Flash
+  for (i=0; i<128; i++) {
+    *flash_ptr = *ram_ptr;
+    flash_ptr++;
+    ram_ptr++;
+  }
+}
+#endif // OB_EEPROM_SUPPORT == 1
+
+#pragma section ()
+
+
+
+
+#if I2C_SUPPORT == 1
+void I2C_write_byte(uint8_t I2C_write_data)
+{
+  // Write a single data byte on the I2C bus.  This function is not included
+  // in the (flash_update) segment because it is never called again once the
+  // eeprom_copy_to_flash() function is called.
+  
+  // Write Data bit 7 to 0
+  I2C_transmit_byte(I2C_write_data);
+  
+  // Read NACK/ACK from slave
+  if (Read_Slave_NACKACK()) I2C_failcode = I2C_FAIL_NACK_WRITE_BYTE;
+}
+
+
+uint8_t I2C_write_done(uint8_t control_byte)
+{
+  // Non-blocking check for completion of an EEPROM internal write cycle
+  // ("acknowledge polling" per the 24AA1025 / 24LC256 EEPROM specs).
+  //
+  // After the I2C_stop() that ends a page write the EEPROM stops responding
+  // to its address until the internal write cycle is complete. The write
+  // cycle is specified as 5ms max but is typically 1.5ms to 3ms. This
+  // function sends a start condition and the Write Control Byte and checks
+  // for the ACK, then sends a stop condition.
+  //
+  // Returns 1 if the EEPROM ACKed (write cycle complete, ready for the next
+  // operation), 0 if it is still busy. The function takes well under 100us,
+  // so the main loop can call it on each pass while continuing to service
+  // uIP.
+  //
+  // This does not use I2C_control() because a NACK here is the normal
+  // "busy" response and must not set I2C_failcode.
+  uint8_t rtn;
+  
+  PG_ODR &= (uint8_t)~0x01; // Write SDA ODR to 0
+  PE_ODR &= (uint8_t)~0x08; // Write SCL ODR to 0
+  
+  // Start condition
+  SDA_high();
+  SCL_high();
+  SDA_low();
+  SCL_low();
+  
+  I2C_transmit_byte(control_byte);
+  rtn = (uint8_t)(Read_Slave_NACKACK() ^ 1);
+  
+  I2C_stop();
+  
+  return rtn;
+}
+
+
+void I2C_write_wait(uint8_t control_byte)
+{
+  // Blocking wait for completion of an EEPROM internal write cycle. Returns
+  // as soon as the EEPROM ACKs its Write Control Byte rather than waiting
+  // the worst case 5ms. If the EEPROM still has not responded after about
+  // 10ms I2C_failcode is set and the function returns anyway.
+  uint8_t i;
+  
+  for (i=0; i<100; i++) {
+    if (I2C_write_done(control_byte)) return;
+    wait_timer(100); // Wait 100us between polls
+  }
+  I2C_failcode = I2C_FAIL_WRITE_TIMEOUT;
+}
+
+
+void I2C_read_close(void)
+{
+  // Terminate a sequential read that was left open between calls.
+  //
+  // Normally a sequential read is ended with a NACK and STOP on its last
+  // byte. The webpage template streamer (tpl_stream_fill() in httpd.c)
+  // instead leaves the Off-Board EEPROM in sequential read mode, with SCL
+  // held low after the ACK of the last byte, so that its next refill can
+  // continue reading without sending the Control Bytes and byte address
+  // again. The EEPROM has no bus timeout so it will wait indefinitely.
+  //
+  // Any other transaction must end the open read first. prep_read() calls
+  // this function, so all reads are covered. Writes in the runtime builds
+  // only occur during boot, before any template streaming.
+  //
+  // One more byte is read with a NACK to end the read. The byte is
+  // discarded.
+  if (I2C_read_open) {
+    I2C_read_byte(1);
+    I2C_read_open = 0;
+  }
+}
+
+
+void I2C_read_block(uint8_t control_byte, uint16_t byte_address, uint8_t *dest, uint16_t count)
+{
+  // Read count bytes from the Off-Board EEPROM into dest, starting at
+  // byte_address in the device selected by control_byte (the Write Control
+  // Byte, for example I2C_EEPROM0_WRITE). count must be at least 1.
+  //
+  // Callers do not need to call I2C_control(), I2C_byte_address() or
+  // I2C_read_byte() themselves. Any read left open by the template streamer
+  // is ended first.
+  //
+  // Page boundaries do not matter for reads, but the 24AA1025 sequential read
+  // wraps at the end of each 64KB block (it does not continue into the other
+  // block). If the read would run past address 0xffff it is split: the
+  // remainder is read from address 0x0000 of the other block, which is
+  // selected with the block select bit (0x08) of the Control byte. This is
+  // how the EEPROM0/1 device (0xa0) continues into the EEPROM2/3 device
+  // (0xa8).
+  uint16_t n;
+  
+  I2C_read_close();
+  
+  while (count) {
+    // Number of bytes before the end of the 64KB block. byte_address 0 means
+    // the whole block is available.
+    n = count;
+    if (byte_address != 0 && (uint16_t)(0 - byte_address) < n) {
+      n = (uint16_t)(0 - byte_address);
+    }
+    I2C_read_sequential(control_byte, byte_address, dest, n);
+    dest += n;
+    count -= n;
+    
+    // Continue at the start of the other 64KB block
+    byte_address = 0;
+    control_byte ^= 0x08;
+  }
+}
+
+
+void I2C_reset(void)
+{
+  // Reset the I2C bus to place it in a known state.
+  
+  // This function generates an I2C bus reset. This function is not included
+  // in the flash_update segment because it is never called again once the
+  // eeprom_copy_to_flash function is called.
+  
+  // The function:
+  // Floats SDA high
+  // Floats SCL high
+  // Generates 10 SCL clocks ending with SCL high
+  // Drive SDA low (a start condition)
+  // Drive SCL low
+  // Float SDA high
+  // Float SCL high
+  // Drive SCL low
+  // Drive SDA low
+  // Float SCL high
+  // FLoat SDA high (a stop condition)
+  // At this point the bus should be reset and operations can continue.
+  
+  // Any sequential read left open is abandoned by the reset.
+  I2C_read_open = 0;
+  // The reset can be run at firmware start to make sure prior bus
+  // interruptions are cleared.
+  
+  int i;
+
+  SDA_high(); // Make sure SDA is high (float)
+  SCL_high(); // Make sure SCL is high (float)
+  for (i=0; i<10; i++) {
+    SCL_low();
+    I2C_delay(I2C_WAIT_LOW); // Wait tLOW
+    SCL_high();
+  }
+  SDA_low(); // Start condition
+  SCL_low();
+  SDA_high(); // Single 1 data bit clocked out
+  SCL_pulse();
+  SDA_low();  // "
+  SCL_high();
+  SDA_high(); // Stop condition
+}
+
+#endif // I2C_SUPPORT == 1
+
@@ -1,6696 +1,7191 @@
-/*
- * Code file containing the HTTP Daemon module.
- * It supports GET (not completely implemented) and POST Request methods
- * 
- * Author: Simon Kueppers
- * Email: simon.kueppers@web.de
- * Homepage: http://klinkerstein.m-faq.de
- * 
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful,
- but WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- GNU General Public License for more details.
-
- You should have received a copy of the GNU General Public License
- along with this program.  If not, see <http://www.gnu.org/licenses/>.
- 
- Copyright 2008 Simon Kueppers
- *
- */
-  
-/* Modifications 2020 Michael Nielson
- * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
- * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
- * Author: Michael Nielson
- * Email: nielsonm.projects@gmail.com
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful, but
- WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- General Public License for more details.
-
- See GNU General Public License at <http://www.gnu.org/licenses/>.
- 
- Copyright 2020 Michael Nielson
-*/
-
-
-
-#include <stdlib.h>
-
-#include "httpd.h"
-#include "uip.h"
-#include "uip_arch.h"
-#include "gpio.h"
-#include "main.h"
-#include "timer.h"
-#include "mqtt_pal.h"
-#include "uipopt.h"
-#include "uart.h"
-#include "ds18b20.h"
-#include "i2c.h"
-#include "iostm8s005.h"
-#include "stm8s-005.h"
-
-#include "string.h"
-#include <ctype.h>
-
-
-#define STATE_CONNECTED		0	// Client has just connected
-#define STATE_GOTGET		1	// Client just sent a GET request
-#define STATE_GOTPOST		2	// Client just sent a POST request
-#define STATE_PARSEPOST		10	// We are currently parsing the
-                                        // client's POST-data
-#define STATE_PARSEFILE		11	// We are currently parsing the
-                                        // client's POSTed file data
-#define STATE_SENDHEADER200	12	// Next we send the HTTP 200 header
-#define STATE_SENDHEADER204	13	// Or we send the HTTP 204 header
-#define STATE_SENDDATA		14	// ... followed by data
-#define STATE_PARSEGET		15	// We are currently parsing the
-                                        // client's GET-request
-#define STATE_NULL		127     // Signals no fragment reassembly info
-                                        // present
-
-#define PARSE_CMD		0       // Parsing the command byte in a POST
-#define PARSE_NUM10		1       // Parsing the most sig digit of POST
-                                        // cmd
-#define PARSE_NUM1		2       // Parsing the least sig digit of a
-                                        // POST cmd
-#define PARSE_EQUAL		3       // Parsing the equal sign of a POST
-                                        // cmd
-#define PARSE_VAL		4       // Parsing the data value of a POST
-                                        // cmd
-#define PARSE_DELIM		5       // Parsing the delimiter of a POST cmd
-#define PARSE_SLASH1		6       // Parsing the slash of a GET cmd
-#define PARSE_FAIL		7       // Indicates parse failure - no action
-                                        // taken
-
-
-#define PARSE_FILE_SEEK_START	30	// Parse a new SREC record
-#define PARSE_FILE_SEEK_SX	31	// Parse a new SREC record
-#define PARSE_FILE_SEQUENTIAL	32	// Read data in the SREC record
-#define PARSE_FILE_NONSEQ	33	// Read non-sequential SREC record
-#define PARSE_FILE_COMPLETE	34	// Termination of good file read
-#define PARSE_FILE_FAIL		35	// Termination of failed file read
-#define PARSE_FILE_FAIL_EXIT	36	// Display of fail code
-
-
-#if DEBUG_SUPPORT != 0
-// Variables used to store debug information
-extern uint8_t debug[10];
-extern uint8_t stored_debug[10];
-#endif // DEBUG_SUPPORT
-
-extern uint16_t Port_Httpd;               // Port number in use
-
-extern uint8_t pin_control[16];           // Per pin configuration byte
-extern uint16_t ON_OFF_word;              // ON/OFF states of pins in single
-                                          // 16 bit word
-extern uint16_t Invert_word;              // Invert state of pins in single 16
-                                          // bit word
-
-extern uint8_t Pending_hostaddr[4];       // Temp storage for new IP address
-extern uint8_t Pending_draddr[4];         // Temp storage for new Gateway
-                                          // address
-extern uint8_t Pending_netmask[4];        // Temp storage for new Netmask
-
-extern uint16_t Pending_port;             // Temp storage for new Port number
-
-extern uint8_t Pending_devicename[20];    // Temp storage for new Device Name
-
-extern uint8_t Pending_config_settings;   // Temp storage for new Config
-                                          // settings
-					  
-extern uint8_t Pending_pin_control[16];   // Temp storage for new pin_control
-                                          // received from GUI
-
-extern uint8_t Pending_uip_ethaddr_oct[6]; // Temp storage for new MAC address
-
-extern uint8_t stored_hostaddr[4];	  // hostaddr stored in EEPROM
-extern uint8_t stored_draddr[4];	  // draddr stored in EEPROM
-extern uint8_t stored_netmask[4];	  // netmask stored in EEPROM
-
-extern uint16_t stored_port;		  // Port number stored in EEPROM
-
-extern uint8_t stored_devicename[20];     // Device name stored in EEPROM
-
-extern uint8_t stored_config_settings;    // Config settings stored in EEPROM
-
-extern char mac_string[13];		  // MAC Address in string format
-
-extern uint8_t parse_complete;            // Used to signal that all user
-                                          // inputs have POSTed and are ready
-					  // to be used
-
-extern uint8_t user_reboot_request;       // Communicates the need to reboot
-                                          // back to the main.c functions
-extern uint8_t restart_reboot_step;       // Indicates whether restart or
-                                          // reboot are underway.
-
-extern uint8_t stack_error;               // Flag indicating stack overflow
-                                          // error
-
-extern const char code_revision[];        // Code Revision
-       
-uint8_t OctetArray[11];		          // Used in emb_itoa conversions but
-                                          // also repurposed as a temporary
-					  // buffer for transferring data
-				          // between functions.
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-uint8_t find_content_info;    // Used to manage steps in determining whether
-                              // a file is "Content-Type: m" and in finding
-			      // a files "Content-Length".
-char byte_tail[3];            // Character pairs captured from the data
-                              // file. May also contain a single character
-			      // if a packet boundary is encountered while
-			      // reading the data file.
-uint16_t file_nBytes;         // Used in the data file functions to track the
-                              // number of bytes remaining in a packet.
-uint8_t byte_index;           // Used as an index to point to the bytes in an
-                              // incoming file data line.
-uint8_t parse_index;          // Used as an index for writing file data into
-                              // the parse_tail array
-uint16_t eeprom_address_index; // Address index into the Off-Board EEPROM for
-                              // use in writing uploaded files
-uint16_t new_address;         // New data address found while parsing SREC
-                              // file
-uint16_t temp_address;        // Temporary storage of a new data address found
-                              // while parsing SREC file
-uint16_t temp_address_low;    // Temporary storage of low byte of a new data
-                              // address found while parsing SREC file
-uint16_t address;             // Current address of data being parsed from an
-                              // SREC file
-uint8_t data_count;           // Data count found while parsing SREC file
-uint8_t data_value;           // Data byte read while parsing SREC file
-uint16_t line_count;          // Counts the number of data lines processed.
-uint8_t checksum;             // Used in validating file data
-uint8_t upgrade_failcode;     // Failure codes for Flash upgrade process.
-uint8_t file_type;            // Used to store the file type as Program data
-                              // or String data
-uint8_t non_sequential_detect; // Flag to inidcate an out of sequence SREC
-                              // address was detected.
-uint8_t SREC_start;           // Used to determine if a file upload is an SREC
-                              // file.
-uint8_t search_limit;         // Used to limit the time spent searching for
-                              // the start of the SREC data
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-#if OB_EEPROM_SUPPORT == 1
-// These defines locate the webpage content and webpage sizes stored in the
-// Srings region of the Off-Board EEPROM. In order to allow a String File to
-// be read using the same code used for reading Program Files the code expects
-// addresses starting at 0x8000, however in the EEPROM itself the base address
-// for Strings is 0x0000.
-#define MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION			0x0040
-#define MQTT_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION		0x0042
-#define BROWSER_ONLY_WEBPAGE_IOCONTROL_ADDRESS_LOCATION		0x0044
-#define BROWSER_ONLY_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION	0x0046
-#define MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION			0x0080
-#define MQTT_WEBPAGE_CONFIGURATION_SIZE_LOCATION		0x0082
-#define BROWSER_ONLY_WEBPAGE_IOCONTROL_SIZE_LOCATION		0x0084
-#define BROWSER_ONLY_WEBPAGE_CONFIGURATION_SIZE_LOCATION	0x0086
-
-
-uint8_t eeprom_copy_to_flash_request;
-                               // Flag to cause the main.c loop to call the
-                               // copy to flash function.
-uint16_t off_board_eeprom_index; // Used as an index into the Off-Board EEPROM
-                               // when reading webpage templates
-extern uint8_t eeprom_detect;  // Used in code update routines
-
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-#if I2C_SUPPORT == 1
-extern uint8_t I2C_failcode;         // Used in monitoring I2C transactions
-#endif // I2C_SUPPORT == 1
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-uint8_t parse_tail[40];       // Used to collect each component of a POST
-			      // sequence. If TCP fragmentation occurs
-                              // parse_tail will contain a part of the POST
-			      // component that was at the end of the packet.
-			      // The size of this array is determined by the
-			      // longest POST component. In normal POST
-			      // processing the longest component is the &h00
-			      // POST reply of 37 bytes.
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-#if  BUILD_SUPPORT == CODE_UPLOADER_BUILD
-uint8_t parse_tail[66];       // In the Code Uploader build the parse_tail is
-                              // used as described above, but it is also 
-			      // enlarged and repurposed for buffering data
-			      // received in a program update file. That data
-			      // is received one line of data at a time. The
-			      // maximum size required for this storage is 65
-			      // bytes.
-uint32_t file_length;         // Length of the body (the file data) in a
-                              // firmware update POST.
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-uint8_t z_diag;               // The last value in a POST (hidden), used for
-                              // diagnostics
-uint16_t HtmlPageIOControl_size;     // Size of the IOControl template
-uint16_t HtmlPageConfiguration_size; // Size of the Configuration template
-
-
-// These MQTT variables must always be compiled in the MQTT_BUILD and
-// BROWSER_ONLY_BUILD to maintain a common user interface between the MQTT
-// and Browser Only versions.
-extern uint8_t mqtt_enabled;              // Signals if MQTT has been enabled
-extern uint8_t stored_mqttserveraddr[4];  // mqttserveraddr stored in EEPROM
-extern uint16_t stored_mqttport;	  // MQTT Port number  stored in
-                                          // EEPROM
-extern char stored_mqtt_username[11];     // MQTT Username  stored in EEPROM
-extern char stored_mqtt_password[11];     // MQTT Password  stored in EEPROM
-
-extern uint8_t Pending_mqttserveraddr[4]; // Temp storage for new MQTT IP
-                                          // Address
-extern uint16_t Pending_mqttport;	  // Temp storage for new MQTT Port
-extern char Pending_mqtt_username[11];    // Temp storage for new MQTT
-                                          // Username
-extern char Pending_mqtt_password[11];    // Temp storage for new MQTT
-                                          // Password
-
-extern uint8_t mqtt_start_status;         // Contains error status from the
-                                          // MQTT start process
-extern uint8_t MQTT_error_status;         // For MQTT error status display in
-                                          // GUI
-
-
-
-extern uint8_t RXERIF_counter;            // Counts RXERIF errors
-extern uint8_t TXERIF_counter;            // Counts TXERIF errors
-extern uint32_t TRANSMIT_counter;         // Counts any transmit
-extern uint8_t MQTT_resp_tout_counter;    // Counts response timeout events
-extern uint8_t MQTT_not_OK_counter;       // Counts MQTT != OK events
-extern uint8_t MQTT_broker_dis_counter;   // Counts broker disconnect events
-extern uint32_t second_counter;           // Counts seconds since boot
-
-
-// DS18B20 variables
-extern uint8_t DS18B20_scratch[5][2];     // Stores the temperature measurement
-                                          // for the DS18B20s
-extern uint8_t FoundROM[5][8];            // Table of found ROM codes
-                                          // [x][0] = Family Code
-                                          // [x][1] = LSByte serial number
-                                          // [x][2] = byte 2 serial number
-                                          // [x][3] = byte 3 serial number
-                                          // [x][4] = byte 4 serial number
-                                          // [x][5] = byte 5 serial number
-                                          // [x][6] = MSByte serial number
-                                          // [x][7] = CRC
-extern int numROMs;                       // Count of DS18B20 devices found
-
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-// Variables stored in Flash
-// Define Flash addresses for IO Names and IO Timers
-extern uint16_t IO_TIMER[16] @FLASH_START_IO_TIMERS;
-extern char IO_NAME[16][16] @FLASH_START_IO_NAMES;
-extern uint16_t Pending_IO_TIMER[16];
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-
-
-
-
-//---------------------------------------------------------------------------//
-// Notes on web pages:
-// - Web pages are formed by placing the HTML for the pages in static
-//   constants in flash memory.
-//   OR
-//   Web pages are formed by placing the HTML for the pages in Off-Baord
-//   EEPROM (as controlled by #define OB_EEPROM_SUPPORT)
-//
-// - Since most of the web pages contain variable data (for instance things
-//   like the user changeable IP addresses, port numbers, device name, etc)
-//   the web page "constants" contain markers indicating where the application
-//   code should insert data as the web page constant is copied from flash
-//   memory into the output data buffer.
-//
-// - An example marker is %n01, wherein the CopyHttpData() function in the
-//   application code will replace the "%n01" characters with a single "0" or
-//   "1" character to signal the browser to paint a red or green box
-//   indicating mqtt status.
-//
-// - Additional markers are inserted to help with compression of the web page
-//   templates to reduce the amount of flash memory required. In these cases
-//   the markers tell the application code to insert strings that are repeated
-//   many times in the web page HTML text, rather than have them repeatedly
-//   appear in flash memory. For instance %y00 could be used to signal the
-//   application code to insert the string
-//   "this is a test string"
-//   While this makes the code harder to read, it makes the web page templates
-//   much smaller.
-//
-// - All of these insertion steps cause a complication: In the HttpDCall() the
-//   function "sizeof" is called to determine the size of the webpage to be
-//   copied to the uip_buf for transmission. The copy is performed in the
-//   CopyHttpData() function, and the size of the web page is provided in the
-//   pDataLeft variable. But this size is also used in the CopyHttpHeader()
-//   function to create the Content-Length: for the HTTP header. It is
-//   important that Content-Length be exactly the total amount of data that
-//   will be sent to the browser. The original code simply did a "sizeof" for
-//   the web page template. This is obviously wrong as the template gets a lot
-//   of 4 character placeholders swapped out with replacement text of varying
-//   lengths, not to mention the insertion of frequently repeated strings. So
-//   an "adjust_template_size" function was written to get the size of the
-//   template then adjust that size for all the replacement actions that will
-//   occur. The function needs to know which template it is working on because
-//   each has different amounts of replacement text. The size adjustment also
-//   needs to account for UIP_STATISTICS ifdef's as these will also cause
-//   variation in the length of the actual data transmitted.
-//
-// - IMPORTANT: Be sure to carefully update the adjust_template_size function
-//   if any changes are made to the %xxx text replacement markers and strings
-//   in the templates. Use CURL to verify that pages sizes are reported
-//   correctly.
-//
-// - The templates include the line
-//   "<link rel='icon' href='data:,'>".
-//   This is needed to prevent browsers from sending "favicon" requests. They
-//   seem to do this with annoying repetition greatly slowing down the
-//   transmit/receive process.
-//
-// - The templates include the line
-//   "<input type='hidden' name='z00' value='0'><br>"
-//   This inserts a hidden variable in the webpage to help the application
-//   determine that all POST data is received.
-//
-// - Each template that contains POST data includes an explanation of how the
-//   PARSE_BYTES value is calculated for that template. The PARSE_BYTES value
-//   tells the application exactly how much data will be returned in a POST
-//   form submittal arriving from the remote host. Note that a form submittal
-//   always returns the exact same amount of information even if no fields
-//   were changed on the form (with the exception of the devicename, username,
-//   and password fields which can be variable in length).
-//
-
-
-
-
-//-------------------------------------------------------------------------//
-// WEBPAGE_NULL define is needed to allow a default when webpage size
-// adjustments are needed in the adjust_template_size() function but the
-// IO_Control and Configuration pages are not included. This happens in
-// the case of a Code Uploader build.
-//-------------------------------------------------------------------------//
-#define WEBPAGE_NULL			0
-
-
-
-
-//-------------------------------------------------------------------------//
-// The next defines are included only in the case of a Code Uploader build
-// because the normal IO_Control and Configuration webpages are omitted in
-// that build.
-//-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-#define WEBPAGE_IOCONTROL		1
-#define WEBPAGE_CONFIGURATION		2
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-//---------------------------------------------------------------------------//
-#if BUILD_SUPPORT == MQTT_BUILD
-// IO Control Template
-//
-// PARSE_BYTES calculation:
-// The form contained in this webpage will generate several data update
-// replies. These replies need to be parsed to extract the data from them. We
-// need to stop parsing the reply POST data after all update bytes are parsed.
-// The formula for determining the stop value is as follows:
-//   For 1 of the replies (Pin Control):
-//   POST consists of a ParseCmd (a "h" in this case) in 1 byte
-//     Followed by the ParseNum in 2 bytes
-//     Followed by an equal sign in 1 byte
-//     Followed by a state value in 32 bytea
-//     Followed by a parse delimiter in 1 byte
-//   PLUS
-//   For 1 of the replies (hidden):
-//   POST consists of a ParseCmd (a "z" in this case) in 1 byte
-//     Followed by the ParseNum in 2 bytes
-//     Followed by an equal sign in 1 byte
-//     Followed by a state value in 1 byte
-//     Followed by a parse delimiter in 1 byte
-// THUS
-// For 1 of the replies there are 37 bytes in the reply
-// For 1 of the replies there are 6 bytes per reply
-// The formula in this case is
-//     PARSEBYTES = (1 x 37)
-//                + (1 x 6) - 1
-//     PARSEBYTES = 37
-//                + 6 - 1 = 42
-//
-#define WEBPAGE_IOCONTROL		1
-#define PARSEBYTES_IOCONTROL		42
-// Next line is a dummy define used only by the strings pre-processor.
-#define MQTT_WEBPAGE_IOCONTROL_BEGIN    90
-#if OB_EEPROM_SUPPORT == 0
-static const char g_HtmlPageIOControl[] =
-"%y04%y05"
-      "<title>%a00: IO Control</title>"
-   "</head>"
-   "<body>"
-      "<h1>IO Control</h1>"
-      "<form onsubmit='return m.s(event);return false'>"
-         "<table>"
-            "<tr>"
-               "<th>Name:</th>"
-               "<td colspan=2 style='text-align: left'>%a00</td>"
-            "</tr>"
-            "<script>"
-"const m=(t=>{const e=document,n=e.querySelector.bind(e)('form'),r=(Object.entries,parseI"
-"nt),o=t=>e.write(t),s=t=>t.map(t=>((t,e)=>r(t).toString(16).padStart(e,'0'))(t,2)).join("
-"''),a=t=>t.match(/.{2}/g).map(t=>r(t,16)),c=t=>encodeURIComponent(t),d=[],h=[],p=(t,e,n)"
-"=>{return`<label><input type=radio name=o${e} value=${t} ${n==t?'checked':''}/>${(t?'on'"
-":'off').toUpperCase()}</label>`},l=()=>location.href='/60';return a(t.h00).forEach((t,e)"
-"=>{3==(3&t)?h.push(`<tr><td>Output #${e+1}</td><td class='s${t>>7} t3'></td><td class=c>"
-"${p(1,e,t>>7)}${p(0,e,t>>7)}</td></tr>`):1==(3&t)&&d.push(`<tr><td>Input #${e+1}</td><td"
-" class='s${t>>7} t3'></td><td/></tr>`)}),o(d.join('')),o(`<tr><th></th><th></th>${h.leng"
-"th>0?'<th class=c>SET</th>':''}</tr>`),o(h.join('')),{s:e=>{e.preventDefault();const r=n"
-"ew XMLHttpRequest,o=Array.from((()=>{const e=new FormData(n);return e.set('h00',s(a(t.h0"
-"0).map((t,n)=>{const r='o'+n,o=e.get(r)<<7;return e.delete(r),o}))),e})().entries(),([t,"
-"e])=>`${c(t)}=${c(e)}`).join('&');r.open('POST','/',!1),r.send(o+'&z00=0'),l()},l:l}})({"
-"h00:'%h00'});"
-            "%y01"
-      "<p/>"
-      "%y02`/60`'>Refresh</button> "
-      "%y02`/61`'>Configuration</button>"
-      "<pre>%t00%t01%t02%t03%t04</pre>"
-   "</body>"
-"</html>";
-#endif // OB_EEPROM_SUPPORT == 0
-
-#if OB_EEPROM_SUPPORT == 1
-// Declared short static const here so that common code can be used for Flash
-// and Off-Board webpage sources.
-static const char g_HtmlPageIOControl[] = " ";
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-
-/*
-// Credit to Jevgeni Kiski for the javascript work and html improvements.
-// Below is the raw script used above before minify.
-// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
-// 2) Copy the resulting minified script to an editor and replace all double quotes with
-//    single quotes. THIS STEP IS VERY IMPORTANT.
-// 3) Copy the result to the above between the <script> and </script> lines.
-// 4) Add double quotes at the start and end of the minfied script to make it part of the
-//    constant string.
-// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
-//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
-//    removed from the minified script.
-
-const m = (data => {
-    const doc = document,
-        selector = doc.querySelector.bind(doc),
-        form = selector('form'),
-        get_entries = Object.entries,
-        parse_int = parseInt,
-        document_write = text => doc.write(text),
-        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
-        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
-        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
-        encode = v => encodeURIComponent(v),
-        inputs = [],
-        outputs = [],
-        make_radio_input = (type, id, checked_type) => {
-            var type_str = type ? 'on' : 'off';
-            return `<label><input type=radio name=o${id} value=${type} ${checked_type == type ? 'checked' : ''}/>${type_str.toUpperCase()}</label>`;
-        },
-        get_form_data = () => {
-            const form_data = new FormData(form);
-            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
-                const name = 'o' + i,
-                    result = form_data.get(name) << 7;
-                form_data.delete(name);
-                return result;
-            })));
-            return form_data;
-        },
-        reload_page = () => location.href = '/60',
-        submit_form = (event) => {
-        	event.preventDefault();
-
-          const request = new XMLHttpRequest(),
-              string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
-          request.open('POST', '/', false);
-          request.send(string_data + '&z00=0');
-          reload_page();
-        };
-        
-
-    convert_from_hex(data.h00).forEach((cfg, i) => {
-        if ((cfg & 3) == 3) { //output
-            outputs.push(`<tr><td>Output #${i + 1}</td><td class='s${cfg >> 7} t3'></td><td class=c>${make_radio_input(1, i, cfg >> 7)}${make_radio_input(0, i, cfg >> 7)}</td></tr>`);
-        } else if ((cfg & 3) == 1) { // input
-            inputs.push(`<tr><td>Input #${i + 1}</td><td class='s${cfg >> 7} t3'></td><td/></tr>`);
-        }
-    });
-
-    document_write(inputs.join(''));
-    document_write(`<tr><th></th><th></th>${outputs.length > 0 ? '<th class=c>SET</th>' : ''}</tr>`);
-    document_write(outputs.join(''));
-    
-    return {s: submit_form, l:reload_page}
-})({ h00: '%h00' });
-
-
-*/
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-
-
-#if BUILD_SUPPORT == MQTT_BUILD
-// Configuration webpage Template
-//
-// PARSE_BYTES calculation:
-// The form contained in this webpage will generate several data update
-// replies. These replies need to be parsed to extract the data from them. We
-// need to stop parsing the reply POST data after all update bytes are parsed.
-// The formula for determining the stop value is as follows:
-//     For 1 of the replies (device name):
-//     example: a00=xxxxxxxxxxxxxxxxxxx&
-//     where xxxxxxxxxxxxxxxxxxx is 1 to 19 bytes
-//   PLUS
-//     For 4 of the replies (HTML IP, MQTT IP, Gateway, and Netmask fields):
-//     example: b00=xxxxxxxx&
-//     where xxxxxxxx is 8 bytes
-//   PLUS
-//     For 2 of the replies (HTML and MQTT Port numbers):
-//     example: c00=xxxx&
-//     where xxxx is 4 bytes
-//   PLUS
-//     For 1 of the replies (MAC):
-//     example: d00=xxxxxxxxxxxx&
-//     where xxxxxxxxxxxx is 12 bytes
-//   PLUS
-//   For 1 of the replies (Config):
-//     example: g00=xxxxxx&
-//     where xxxxxx is 6 bytes
-//   PLUS
-//   For 2 of the replies (MQTT Username and Password):
-//     example: m00=xxxxxxxxxx&
-//     where xxxxxxxxxx is 1 to 10 bytes
-//   PLUS
-//   For 1 of the replies (Pin Control):
-//     example: h00=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx&
-//     where xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx is 32 bytes
-//   PLUS
-//   For 1 of the replies (hidden):
-//   POST consists of a ParseCmd (a "z" in this case) in 1 byte
-//     example: z00=x&
-//     where x is 1 byte
-// The formula in this case is
-//     PARSEBYTES = (1 x 24)
-//                + (4 x 13)
-//                + (2 x 9)
-//                + (1 x 17) 
-//                + (1 x 11) 
-//                + (2 x 15)
-//                + (1 x 37)
-//                + (1 x 6) - 1
-//     PARSEBYTES = 24
-//                + 52
-//                + 18
-//                + 17
-//                + 11
-//                + 30
-//                + 37
-//                + 6 - 1 = 194
-//
-#define WEBPAGE_CONFIGURATION		2
-#define PARSEBYTES_CONFIGURATION	194
-// Next line is dummy define used only by the strings pre-processor.
-#define MQTT_WEBPAGE_CONFIGURATION_BEGIN	91
-#if OB_EEPROM_SUPPORT == 0
-static const char g_HtmlPageConfiguration[] =
-"%y04%y05"
-      "<title>%a00: Configuration</title>"
-   "</head>"
-   "<body>"
-      "<h1>Configuration</h1>"
-      "<form onsubmit='return m.s(event);return false'>"
-         "<table>"
-            "<tr>"
-               "<td>Name</td>"
-               "<td><input name='a00' value='%a00' pattern='[0-9a-zA-Z-_*.]{1,19}' required title='1 to 19 letters, numbers, and -_*. no spaces' maxlength='19'/></td>"
-            "</tr>"
-            "<tr class='hs'/>"
-            "<tr>"
-               "<td>IP Address</td>"
-               "<td>"
-                 "<input name='b00' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Gateway</td>"
-               "<td>"
-                 "<input name='b04' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Netmask</td>"
-               "<td>"
-                 "<input name='b08' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Port</td>"
-               "<td><input name='c00' class='t8 port'></td>"
-            "</tr>"
-            "<tr>"
-               "<td>MAC Address</td>"
-               "<td>"
-                 "<input name='d00' required pattern='([0-9a-fA-F]{2}[:-]?){5}([0-9a-fA-F]{2})' title='aa:bb:cc:dd:ee:ff format' maxlength=17/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Features</td>"
-               "<td class='f'></td>"
-            "</tr>"
-            "<tr class='hs'/>"
-            "<tr>"
-               "<td>MQTT Server</td>"
-               "<td>"
-                 "<input name='b12' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>MQTT Port</td>"
-               "<td><input name='c01' class='t8 port'></td>"
-            "</tr>"
-            "<tr>"
-               "<td>MQTT Username</td>"
-               "<td class='up'><input name='l00' value='%l00'></td>"
-            "</tr>"
-            "<tr>"
-               "<td>MQTT Password</td>"
-               "<td class='up'><input name='m00' value='%m00'></td>"
-            "</tr>"
-            "<tr class='hs'/>"
-            "<tr>"
-               "<td>MQTT Status</td>"
-               "<td class='s'>"
-                 "<div class='s%n00'></div> <div class='s%n01'></div> <div class='s%n02'></div> <div class='s%n03'></div> <div class='s%n04'></div>"
-               "</td>"
-            "</tr>"
-            "<tr class='hs'/>"
-         "</table>"
-         "<table>"
-            "<tr>"
-              "<th>IO</th>"
-              "<th>Type</th>"
-              "<th>Invert</th>"
-              "<th>Boot state</th>"
-            "</tr>"
-         "<script>"
-"const m=(e=>{const t=['b00','b04','b08','b12'],n=['c00','c01'],o={disabled:0,input:1,out"
-"put:3},r={retain:8,on:16,off:0},a=document,c=location,s=a.querySelector.bind(a),p=s('for"
-"m'),d=Object.entries,i=parseInt,l=(e,t)=>i(e).toString(16).padStart(t,'0'),u=e=>e.map(e="
-">l(e,2)).join(''),m=e=>e.match(/.{2}/g).map(e=>i(e,16)),$=e=>encodeURIComponent(e),b=(e,"
-"t)=>(e=>s(`input[name=${e}]`))(e).value=t,f=(e,t)=>{for(const n of a.querySelectorAll(e)"
-")t(n)},h=(e,t)=>{for(const[n,o]of d(t))e.setAttribute(n,o)},g=(e,t)=>d(e).map(e=>`<optio"
-"n value=${e[1]} ${e[1]==t?'selected':''}>${e[0]}</option>`).join(''),x=(e,t,n,o='')=>`<i"
-"nput type='checkbox' name='${e}' value=${t} ${(n&t)==t?'checked':''}>${o}`,y=(e,t,n)=>{c"
-"onst o=new XMLHttpRequest;o.open(e,t,!1),o.send(n)},A=()=>c.href='/61',T=()=>{a.body.inn"
-"erText='Wait 5s...',setTimeout(A,5e3)},j=m(e.g00)[0],E={required:!0};return f('.ip',e=>{"
-"h(e,{...E,title:'x.x.x.x format',pattern:'((25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$"
-")|$)){4}'})}),f('.port',e=>{h(e,{...E,type:'number',min:10,max:65535})}),f('.up input',e"
-"=>{h(e,{title:'0 to 10 letters, numbers, and -_*. no spaces. Blank for no entry.',maxlen"
-"gth:10,pattern:'[0-9a-zA-Z-_*.]{0,10}$'})}),t.forEach(t=>b(t,m(e[t]).join('.'))),n.forEa"
-"ch(t=>b(t,i(e[t],16))),b('d00',e.d00.replace(/[0-9a-z]{2}(?!$)/g,'$&:')),m(e.h00).forEac"
-"h((e,t)=>{const n=1&e?x('p'+t,4,e):'',s=3==(3&e)?`<select name='p${t}'>${g(r,24&e)}</sel"
-"ect>`:'',p='#d'==c.hash?`<td>${e}</td>`:'';(e=>a.write(e))(`<tr><td>#${t+1}</td><td><sel"
-"ect name='p${t}'>${g(o,3&e)}</select></td><td>${n}</td><td>${s}</td>${p}</tr>`)}),s('.f'"
-").innerHTML=Array.from(d({'Full Duplex':1,'HA Auto':6,MQTT:4,DS18B20:8}),([e,t])=>x('g00"
-"',t,j,e)).join('</br>'),{r:()=>{y('GET','/91'),T()},s:o=>{o.preventDefault();const r=Arr"
-"ay.from((()=>{const o=new FormData(p),r=e=>o.getAll(e).map(e=>i(e)).reduce((e,t)=>e|t,0)"
-";return t.forEach(e=>o.set(e,u(o.get(e).split('.')))),n.forEach(e=>o.set(e,l(o.get(e),4)"
-")),o.set('d00',o.get('d00').toLowerCase().replace(/[:-]/g,'')),o.set('h00',u(m(e.h00).ma"
-"p((e,t)=>{const n='p'+t,a=r(n);return o.delete(n),a}))),o.set('g00',u([r('g00')])),o})()"
-".entries(),([e,t])=>`${$(e)}=${$(t)}`).join('&');y('POST','/',r+'&z00=0'),T()},l:A}})({b"
-"00:'%b00',b04:'%b04',b08:'%b08',c00:'%c00',d00:'%d00',b12:'%b12',c01:'%c01',h00:'%h00',g"
-"00:'%g00'});"
-            "%y01"
-      "<p>Code Revision %w00<br/>"
-        "<a href='https://github.com/nielsonm236/NetMod-ServerApp/wiki'>Help Wiki</a>"
-      "</p>"
-      "<button title='Save first!' onclick='m.r()'>Reboot</button>"
-      "<br><br>"
-      "%y02`/61`'>Refresh</button> "
-      "%y02`/60`'>IO Control</button>"
-   "</body>"
-"</html>";
-#endif // OB_EEPROM_SUPPORT == 0
-
-#if OB_EEPROM_SUPPORT == 1
-// Declared short static const here so that common code can be used for Flash
-// and Off-Board webpage sources.
-static const char g_HtmlPageConfiguration[] = " ";
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-/*
-// Credit to Jevgeni Kiski for the javascript work and html improvements.
-// Below is the raw script used above before minify.
-// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
-// 2) Copy the resulting minified script to an editor and replace all double quotes with
-//    single quotes. THIS STEP IS VERY IMPORTANT.
-// 3) Copy the result to the above between the <script> and </script> lines.
-// 4) Add double quotes at the start and end of the minfied script to make it part of the
-//    constant string.
-// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
-//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
-//    removed from the minified script.
-
-const m = (data => {
-    const ip_input_names = ['b00', 'b04', 'b08', 'b12'],
-        port_input_names = ['c00', 'c01'],
-        features = { 'Full Duplex': 1, 'HA Auto': 6, 'MQTT': 4, 'DS18B20': 8 },
-        pin_types = { 'disabled': 0, 'input': 1, 'output': 3 },
-        boot_state = { 'retain': 8, 'on': 16, 'off': 0 },
-        doc=document,
-        loc=location,
-        selector=doc.querySelector.bind(doc),
-        form=selector('form'),
-        get_entries=Object.entries,
-        parse_int = parseInt,
-        document_write = text => doc.write(text),
-        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
-        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
-        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
-        encode = v => encodeURIComponent(v),
-        query_input_by_name = n => selector(`input[name=${n}]`),
-        set_input_value = (n, v) => query_input_by_name(n).value = v,
-        selector_apply_fn = (query, fn) => { for (const e of doc.querySelectorAll(query)) { fn(e) } },
-        set_attributes = (e, d) => { for (const [k, v] of get_entries(d)) { e.setAttribute(k, v); } },
-        make_options = (o, v) => get_entries(o).map((o) => `<option value=${o[1]} ${o[1] == v ? 'selected' : ''}>${o[0]}</option>`).join(''),
-        make_checkbox = (name, bit, value, title='') => `<input type='checkbox' name='${name}' value=${bit} ${(value & bit) == bit ? 'checked' : ''}>${title}`,
-        get_form_data = () => {
-            const form_data = new FormData(form),
-            	collect_bits = (name) => form_data.getAll(name).map(v => parse_int(v)).reduce((a, b) => a | b, 0);
-              
-            ip_input_names.forEach((n) => form_data.set(n, convert_to_hex(form_data.get(n).split('.'))));
-            port_input_names.forEach((n) => form_data.set(n, pad_hex(form_data.get(n), 4)));
-            
-            form_data.set('d00', form_data.get('d00').toLowerCase().replace(/[:-]/g, ''));
-            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
-                const name = 'p' + i,
-                    result = collect_bits(name);
-                form_data.delete(name);
-                return result;
-            })));
-            
-            form_data.set('g00', convert_to_hex([collect_bits('g00')]));
-            
-            return form_data;
-        },
-        send_request = (method, url, data) => {
-        	const request = new XMLHttpRequest();
-          request.open(method, url, false);
-          request.send(data);
-        },
-        reload_page = () => loc.href = '/61',
-        wait_reboot = () => {
-          doc.body.innerText = 'Wait 5s...';
-          setTimeout(reload_page, 5000);
-        },
-        reboot = () => {
-          send_request('GET', '/91');
-          wait_reboot();
-        },
-        submitForm = (event) => {
-        	event.preventDefault();
-          const string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
-          send_request('POST', '/', string_data + '&z00=0');
-          wait_reboot();
-        },
-        features_data = convert_from_hex(data.g00)[0],
-        common_attributes = {required: true};
-
-    selector_apply_fn('.ip', (e) => { set_attributes(e, {...common_attributes, title: 'x.x.x.x format', pattern: '((25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$)|$)){4}' }); });
-    selector_apply_fn('.port', (e) => { set_attributes(e, {...common_attributes, type: 'number', min: 10, max: 65535 }); });
-    selector_apply_fn('.up input', (e) => { set_attributes(e, {title: '0 to 10 letters, numbers, and -_*. no spaces. Blank for no entry.', maxlength: 10, pattern: '[0-9a-zA-Z-_*.]{0,10}$' }); });
-
-    ip_input_names.forEach((n) => set_input_value(n, convert_from_hex(data[n]).join('.')));
-    port_input_names.forEach((n) => set_input_value(n, parse_int(data[n], 16)));
-    set_input_value('d00', data.d00.replace(/[0-9a-z]{2}(?!$)/g, '$&:'));
-
-    convert_from_hex(data.h00).forEach((n, i) => {
-        const checkbox = n & 1 ? make_checkbox('p'+i, 4, n) : '',
-            make_select = (n & 3) == 3 ? `<select name='p${i}'>${make_options(boot_state, n & 24)}</select>` : '',
-            debug_column = (loc.hash == '#d'?`<td>${n}</td>`:'');
-        document_write(`<tr><td>#${i + 1}</td><td><select name='p${i}'>${make_options(pin_types, n & 3)}</select></td><td>${checkbox}</td><td>${make_select}</td>${debug_column}</tr>`);
-    });
-    
-    selector('.f').innerHTML = Array.from(
-    	get_entries(features),
-      ([name, bit]) => make_checkbox('g00', bit, features_data, name)).join('</br>'
-    );
-    
-    
-    return {r:reboot, s: submitForm, l:reload_page};
-})({
-    b00: '%b00',
-    b04: '%b04',
-    b08: '%b08',
-    c00: '%c00',
-    d00: '%d00',
-    b12: '%b12',
-    c01: '%c01',
-    h00: '%h00',
-    g00: '%g00'
-});
-
-*/
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-
-
-
-//---------------------------------------------------------------------------//
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-// IO Control Template
-//
-// PARSE_BYTES calculation:
-// The form contained in this webpage will generate several data update
-// replies. These replies need to be parsed to extract the data from them. We
-// need to stop parsing the reply POST data after all update bytes are parsed.
-// The formula for determining the stop value is as follows:
-//   Each POST has a "wrapper" consisting of
-//     1 byte ParseCmd
-//     2 byte ParseNum
-//     1 byte egual sign
-//     1 byte Delimiter
-//     So, add 5 bytes to each POST as defined here:
-//
-//     For 1 of the replies (Pin Control):
-//     POST consists of 32 bytes data plus 5 byte wrapper (37 bytes)
-//   PLUS
-//     For 1 of the replies (hidden):
-//     example: z00=x where x is 1 byte (note no &)
-//     POST consists of a 1 byte data plus 4 byte wrapper (5 bytes)
-// THUS
-// The formula in this case is
-//     PARSEBYTES = (1 x 37)
-//                + (1 x 5)
-//     PARSEBYTES = 37
-//                + 5 = 42
-//
-#define WEBPAGE_IOCONTROL		1
-#define PARSEBYTES_IOCONTROL		42
-// Next line is dummy define used only by the strings pre-processor.
-#define BROWSER_ONLY_WEBPAGE_IOCONTROL_BEGIN	92
-#if OB_EEPROM_SUPPORT == 0
-static const char g_HtmlPageIOControl[] =
-"%y04%y05"
-      "<title>%a00: IO Control</title>"
-   "</head>"
-   "<body>"
-      "<h1>IO Control</h1>"
-      "<form onsubmit='return m.s(event);return false'>"
-         "<table>"
-            "<tr>"
-               "<th>Name:</th>"
-               "<td colspan=2 style='text-align: left'>%a00</td>"
-            "</tr>"
-            "<script>"
-"const m=(t=>{const e=document,j=e.querySelector.bind(e)('form'),r=(Object.entries,parseInt)"
-",n=t=>e.write(t),o=t=>t.map(t=>((t,e)=>r(t).toString(16).padStart(e,'0'))(t,2)).join(''),a="
-"t=>t.match(/.{2}/g).map(t=>r(t,16)),s=t=>encodeURIComponent(t),c=[],d=[],h=(t,e,j)=>{return"
-"`<label><input type=radio name=o${e} value=${t} ${j==t?'checked':''}/>${(t?'on':'off').toUp"
-"perCase()}</label>`},p=()=>location.href='/60';return a(t.h00).forEach((e,j)=>{var r=t['j'+"
-"(j+'').padStart(2,'0')];3==(3&e)?d.push(`<tr><td>${r}</td><td class='s${e>>7} t3'></td><td "
-"class=c>${h(1,j,e>>7)}${h(0,j,e>>7)}</td></tr>`):1==(3&e)&&c.push(`<tr><td>${r}</td><td cla"
-"ss='s${e>>7} t3'></td><td/></tr>`)}),n(c.join('')),n(`<tr><th></th><th></th>${d.length>0?'<"
-"th class=c>SET</th>':''}</tr>`),n(d.join('')),{s:e=>{e.preventDefault();const r=new XMLHttp"
-"Request,n=Array.from((()=>{const e=new FormData(j);return e.set('h00',o(a(t.h00).map((t,j)="
-">{const r='o'+j,n=e.get(r)<<7;return e.delete(r),n}))),e})().entries(),([t,e])=>`${s(t)}=${"
-"s(e)}`).join('&');r.open('POST','/',!1),r.send(n+'&z00=0'),p()},l:p}})({h00:'%h00',j00:'%j0"
-"0',j01:'%j01',j02:'%j02',j03:'%j03',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%j07',j08:'%j08',"
-"j09:'%j09',j10:'%j10',j11:'%j11',j12:'%j12',j13:'%j13',j14:'%j14',j15:'%j15'});"
-            "%y01"
-      "<p/>"
-      "%y02`/60`'>Refresh</button> "
-      "%y02`/61`'>Configuration</button>"
-      "<pre>%t00%t01%t02%t03%t04</pre>"
-   "</body>"
-"</html>";
-#endif // OB_EEPROM_SUPPORT == 0
-
-#if OB_EEPROM_SUPPORT == 1
-// Declared short static const here so that common code can be used for Flash
-// and Off-Board webpage sources.
-static const char g_HtmlPageIOControl[] = " ";
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-
-/*
-// Credit to Jevgeni Kiski for the javascript work and html improvements.
-// Below is the raw script used above before minify.
-// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
-// 2) Copy the resulting minified script to an editor and replace all double quotes with
-//    single quotes. THIS STEP IS VERY IMPORTANT.
-// 3) Copy the result to the above between the <script> and </script> lines.
-// 4) Add double quotes at the start and end of the minfied script to make it part of the
-//    constant string.
-// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
-//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
-//    removed from the minified script.
-
-const m = (data => {
-    const doc = document,
-        selector = doc.querySelector.bind(doc),
-        form = selector('form'),
-        get_entries = Object.entries,
-        parse_int = parseInt,
-        document_write = text => doc.write(text),
-        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
-        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
-        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
-        encode = v => encodeURIComponent(v),
-        inputs = [],
-        outputs = [],
-        make_radio_input = (type, id, checked_type) => {
-            var type_str = type ? 'on' : 'off';
-            return `<label><input type=radio name=o${id} value=${type} ${checked_type == type ? 'checked' : ''}/>${type_str.toUpperCase()}</label>`;
-        },
-        get_form_data = () => {
-            const form_data = new FormData(form);
-            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
-                const name = 'o' + i,
-                    result = form_data.get(name) << 7;
-                form_data.delete(name);
-                return result;
-            })));
-            return form_data;
-        },
-        reload_page = () => location.href = '/60',
-        submit_form = (event) => {
-        	event.preventDefault();
-
-          const request = new XMLHttpRequest(),
-              string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
-          request.open('POST', '/', false);
-          request.send(string_data + '&z00=0');
-          reload_page();
-        };
-        
-
-    convert_from_hex(data.h00).forEach((cfg, i) => {
-    		var name = data['j'+(i+'').padStart(2, '0')];
-        if ((cfg & 3) == 3) { //output
-            outputs.push(`<tr><td>${name}</td><td class='s${cfg >> 7} t3'></td><td class=c>${make_radio_input(1, i, cfg >> 7)}${make_radio_input(0, i, cfg >> 7)}</td></tr>`);
-        } else if ((cfg & 3) == 1) { // input
-            inputs.push(`<tr><td>${name}</td><td class='s${cfg >> 7} t3'></td><td/></tr>`);
-        }
-    });
-
-    document_write(inputs.join(''));
-    document_write(`<tr><th></th><th></th>${outputs.length > 0 ? '<th class=c>SET</th>' : ''}</tr>`);
-    document_write(outputs.join(''));
-    
-    return {s: submit_form, l:reload_page}
-})({
-  h00: '%h00',
-  j00: '%j00',
-  j01: '%j01',
-  j02: '%j02',
-  j03: '%j03',
-  j04: '%j04',
-  j05: '%j05',
-  j06: '%j06',
-  j07: '%j07',
-  j08: '%j08',
-  j09: '%j09',
-  j10: '%j10',
-  j11: '%j11',
-  j12: '%j12',
-  j13: '%j13',
-  j14: '%j14',
-  j15: '%j15',
-});
-
-*/
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-// Configuration webpage Template
-//
-// PARSE_BYTES calculation:
-// The form contained in this webpage will generate several data update
-// replies. These replies need to be parsed to extract the data from them. We
-// need to stop parsing the reply POST data after all update bytes are parsed.
-// The formula for determining the stop value is as follows:
-//   Each POST has a "wrapper" consisting of
-//     1 byte ParseCmd
-//     2 byte ParseNum
-//     1 byte egual sign
-//     1 byte Delimiter
-//     So, add 5 bytes to each POST as defined here:
-//
-//     For 1 of the replies (device name):
-//     example: a00=xxxxxxxxxxxxxxxxxxx& where xxxxxxxxxxxxxxxxxxx is 1 to 19 bytes
-//     POST consists of 19 bytes data plus 5 byte wrapper (24 bytes)
-//   PLUS
-//     For 3 of the replies (HTML IP, Gateway, and Netmask fields):
-//     example: b00=xxxxxxxx& where xxxxxxxx is 8 bytes
-//     POST consists of 8 bytes data plus 5 byte wrapper (13 bytes)
-//   PLUS
-//     For 1 of the replies (HTML Port number):
-//     example: c00=xxxx& where xxxx is 4 bytes
-//     POST consists of 4 bytes data plus 5 byte wrapper (9 bytes)
-//   PLUS
-//     For 1 of the replies (MAC):
-//     example: d00=xxxxxxxxxxxx& where xxxxxxxxxxxx is 12 bytes
-//     POST consists of 12 bytes data plus 5 byte wrapper (17 bytes)
-//   PLUS
-//     For 1 of the replies (Config):
-//     example: g00=xx& where xx is 2 bytes
-//     POST consists of 2 bytes data plus 5 byte wrapper (7 bytes)
-//   PLUS
-//     For 1 of the replies (Pin Control):
-//     example: h00=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx&
-//     where xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx is 32 bytes
-//     POST consists of 32 bytes data plus 5 byte wrapper (37 bytes)
-//   PLUS
-//     For 16 of the replies (IO Name):
-//     example: j00=xxxxxxxxxxxxxxx& where xxxxxxxxxxxxxxx is 15 bytes
-//     POST consists of 15 bytes data plus 5 byte wrapper (20 bytes)
-//   PLUS
-//     For 16 of the replies (IO Timer):
-//     example: i00=xxxx& where xxxx is 4 bytes
-//     POST consists of 4 bytes data plus 5 byte wrapper (9 bytes)
-//   PLUS
-//     For 1 of the replies (hidden):
-//     example: z00=x where x is 1 byte (note no &)
-//     POST consists of 1 byte data plus 4 byte wrapper (5 bytes)
-// The formula in this case is
-//     PARSEBYTES = (1 x 24)
-//                + (3 x 13)
-//                + (1 x 9)
-//                + (1 x 17)
-//                + (1 x 7)
-//                + (1 x 37)
-//                + (16 x 20)
-//                + (16 x 9)
-//                + (1 x 5)
-//     PARSEBYTES = 24
-//                + 39
-//                + 9
-//                + 17
-//                + 7
-//                + 37
-//                + 320
-//                + 144
-//                + 5 = 602
-//
-#define WEBPAGE_CONFIGURATION		2
-#define PARSEBYTES_CONFIGURATION	602
-// Next line is dummy define used only by the strings pre-processor.
-#define BROWSER_ONLY_WEBPAGE_CONFIGURATION_BEGIN	93
-#if OB_EEPROM_SUPPORT == 0
-static const char g_HtmlPageConfiguration[] =
-"%y04%y05"
-      "<title>%a00: Configuration</title>"
-   "</head>"
-   "<body>"
-      "<h1>Configuration</h1>"
-      "<form onsubmit='return m.s(event);return false'>"
-         "<table>"
-            "<tr>"
-               "<td>Name</td>"
-               "<td><input name='a00' value='%a00' pattern='[0-9a-zA-Z-_*.]{1,19}' required title='1 to 19 letters, numbers, and -_*. no spaces' maxlength='19'/></td>"
-            "</tr>"
-            "<tr class='hs'/>"
-            "<tr>"
-               "<td>IP Address</td>"
-               "<td>"
-                 "<input name='b00' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Gateway</td>"
-               "<td>"
-                 "<input name='b04' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Netmask</td>"
-               "<td>"
-                 "<input name='b08' class='ip'/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Port</td>"
-               "<td><input name='c00' class='t8 port'></td>"
-            "</tr>"
-            "<tr>"
-               "<td>MAC Address</td>"
-               "<td>"
-                 "<input name='d00' required pattern='([0-9a-fA-F]{2}[:-]?){5}([0-9a-fA-F]{2})' title='aa:bb:cc:dd:ee:ff format' maxlength=17/>"
-               "</td>"
-            "</tr>"
-            "<tr>"
-               "<td>Features</td>"
-               "<td class='f'></td>"
-            "</tr>"
-            "<tr class='hs'/>"
-         "</table>"
-         "<table>"
-            "<tr>"
-              "<th>IO</th>"
-              "<th>Type</th>"
-              "<th>Name</th>"
-              "<th>Invert</th>"
-              "<th>Boot state</th>"
-              "<th>Timer</th>"
-            "</tr>"
-         "<script>"
-"const m=(e=>{const t=['b00','b04','b08'],i=['c00'],n={disabled:0,input:1,output:3},r={r"
-"etain:8,on:16,off:0},a={'0.1s':0,'1s':16384,'1m':32768,'1h':49152},o=document,s=locatio"
-"n,c=o.querySelector.bind(o),j=c('form'),d=Object.entries,p=parseInt,l=(e,t)=>p(e).toStr"
-"ing(16).padStart(t,'0'),m=e=>e.map(e=>l(e,2)).join(''),u=e=>e.match(/.{2}/g).map(e=>p(e"
-",16)),$=e=>encodeURIComponent(e),b=(e,t)=>(e=>c(`input[name=${e}]`))(e).value=t,f=(e,t)"
-"=>{for(const i of o.querySelectorAll(e))t(i)},h=(e,t)=>{for(const[i,n]of d(t))e.setAttr"
-"ibute(i,n)},g=(e,t)=>d(e).map(e=>`<option value=${e[1]} ${e[1]==t?'selected':''}>${e[0]"
-"}</option>`).join(''),x=(e,t,i,n='')=>`<input type='checkbox' name='${e}' value=${t} ${"
-"(i&t)==t?'checked':''}>${n}`,y=(e,t,i)=>{const n=new XMLHttpRequest;n.open(e,t,!1),n.se"
-"nd(i)},S=()=>s.href='/61',v=()=>{o.body.innerText='Wait 5s...',setTimeout(S,5e3)},A=u(e"
-".g00)[0],E={required:!0};return f('.ip',e=>{h(e,{...E,title:'x.x.x.x format',pattern:'("
-"(25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$)|$)){4}'})}),f('.port',e=>{h(e,{...E,type"
-":'number',min:10,max:65535})}),t.forEach(t=>b(t,u(e[t]).join('.'))),i.forEach(t=>b(t,p("
-"e[t],16))),b('d00',e.d00.replace(/[0-9a-z]{2}(?!$)/g,'$&:')),u(e.h00).forEach((t,i)=>{c"
-"onst c=1&t?x('p'+i,4,t):'',j=(e,i)=>3==(3&t)?e:i,d=(''+i).padStart(2,'0'),p=j(u(e['i'+d"
-"]).reduce((e,t)=>(e<<8)+t),0),l=j(`<select name='p${i}'>${g(r,24&t)}</select>`,''),m='#"
-"d'==s.hash?`<td>${t}</td>`:'',$=j(`<input type=number class=t8 name='i${d}' value='${16"
-"383&p}' min=0 max=16383><select name='i${d}'>${g(a,49152&p)}</select>`,'');(e=>o.write("
-"e))(`<tr><td>#${i+1}</td><td><select name='p${i}'>${g(n,3&t)}</select></td><td><input n"
-"ame='j${d}' value='${e['j'+d]}' pattern='[0-9a-zA-Z_*.-]{1,15}' required title='1 to 15"
-" letters, numbers, and -*_. no spaces' maxlength=15/></td><td>${c}</td><td>${l}</td><td"
-">${$}</td>${m}</tr>`)}),c('.f').innerHTML=Array.from(d({'Full Duplex':1,DS18B20:8}),([e"
-",t])=>x('g00',t,A,e)).join('</br>'),{r:()=>{y('GET','/91'),v()},s:n=>{n.preventDefault("
-");const r=Array.from((()=>{const n=new FormData(j),r=e=>n.getAll(e).map(e=>p(e)).reduce"
-"((e,t)=>e|t,0);t.forEach(e=>n.set(e,m(n.get(e).split('.')))),i.forEach(e=>n.set(e,l(n.g"
-"et(e),4))),n.set('d00',n.get('d00').toLowerCase().replace(/[:-]/g,'')),n.set('h00',m(u("
-"e.h00).map((e,t)=>{const i='p'+t,a=r(i);return n.delete(i),a})));for(let e=0;e<16;e++){"
-"let t=(''+e).padStart(2,'0');n.set('i'+t,l(65535&r('i'+t),4))}return n.set('g00',m([r('"
-"g00')])),n})().entries(),([e,t])=>`${$(e)}=${$(t)}`).join('&');y('POST','/',r+'&z00=0')"
-",v()},l:S}})({b00:'%b00',b04:'%b04',b08:'%b08',c00:'%c00',d00:'%d00',h00:'%h00',g00:'%g"
-"00',j00:'%j00',j01:'%j01',j02:'%j02',j03:'%j03',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%"
-"j07',j08:'%j08',j09:'%j09',j10:'%j10',j11:'%j11',j12:'%j12',j13:'%j13',j14:'%j14',j15:'"
-"%j15',i00:'%i00',i01:'%i01',i02:'%i02',i03:'%i03',i04:'%i04',i05:'%i05',i06:'%i06',i07:"
-"'%i07',i08:'%i08',i09:'%i09',i10:'%i10',i11:'%i11',i12:'%i12',i13:'%i13',i14:'%i14',i15"
-":'%i15'});"
-            "%y01"
-      "<p>Code Revision %w00<br/>"
-        "<a href='https://github.com/nielsonm236/NetMod-ServerApp/wiki'>Help Wiki</a>"
-      "</p>"
-      "<button title='Save first!' onclick='m.r()'>Reboot</button>"
-      "<br><br>"
-      "%y02`/61`'>Refresh</button> "
-      "%y02`/60`'>IO Control</button>"
-   "</body>"
-"</html>";
-#endif // OB_EEPROM_SUPPORT == 0
-
-#if OB_EEPROM_SUPPORT == 1
-// Declared short static const here so that common code can be used for Flash
-// and Off-Board webpage sources.
-static const char g_HtmlPageConfiguration[] = " ";
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-/*
-// Credit to Jevgeni Kiski for the javascript work and html improvements.
-// Below is the raw script used above before minify.
-// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
-// 2) Copy the resulting minified script to an editor and replace all double quotes with
-//    single quotes. THIS STEP IS VERY IMPORTANT.
-// 3) Copy the result to the above between the <script> and </script> lines.
-// 4) Add double quotes at the start and end of the minfied script to make it part of the
-//    constant string.
-// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
-//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
-//    removed from the minified script.
-
-const m = (data => {
-    const ip_input_names = ['b00', 'b04', 'b08'],
-        port_input_names = ['c00'],
-        features = { 'Full Duplex': 1, 'DS18B20': 8 },
-        pin_types = { 'disabled': 0, 'input': 1, 'output': 3 },
-        boot_state = { 'retain': 8, 'on': 16, 'off': 0 },
-        timer_unit = { '0.1s': 0, '1s': 0x4000, '1m': 0x8000, '1h': 0xc000 },
-        doc=document,
-        loc=location,
-        selector=doc.querySelector.bind(doc),
-        form=selector('form'),
-        get_entries=Object.entries,
-        parse_int = parseInt,
-        document_write = text => doc.write(text),
-        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
-        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
-        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
-        encode = v => encodeURIComponent(v),
-        query_input_by_name = n => selector(`input[name=${n}]`),
-        set_input_value = (n, v) => query_input_by_name(n).value = v,
-        selector_apply_fn = (query, fn) => { for (const e of doc.querySelectorAll(query)) { fn(e) } },
-        set_attributes = (e, d) => { for (const [k, v] of get_entries(d)) { e.setAttribute(k, v); } },
-        make_options = (o, v) => get_entries(o).map((o) => `<option value=${o[1]} ${o[1] == v ? 'selected' : ''}>${o[0]}</option>`).join(''),
-        make_checkbox = (name, bit, value, title='') => `<input type='checkbox' name='${name}' value=${bit} ${(value & bit) == bit ? 'checked' : ''}>${title}`,
-        get_form_data = () => {
-            const form_data = new FormData(form),
-            	collect_bits = (name) => form_data.getAll(name).map(v => parse_int(v)).reduce((a, b) => a | b, 0);
-              
-            ip_input_names.forEach((n) => form_data.set(n, convert_to_hex(form_data.get(n).split('.'))));
-            port_input_names.forEach((n) => form_data.set(n, pad_hex(form_data.get(n), 4)));
-            
-            form_data.set('d00', form_data.get('d00').toLowerCase().replace(/[:-]/g, ''));
-            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
-                const name = 'p' + i,
-                    result = collect_bits(name);
-                form_data.delete(name);
-                return result;
-            })));
-            for (let i=0;i<16;i++) {
-              let input_nr = (''+i).padStart(2, '0');
-            	form_data.set('i'+input_nr, pad_hex(collect_bits('i'+input_nr) & 0xffff, 4));
-            }
-            
-            form_data.set('g00', convert_to_hex([collect_bits('g00')]));
-            
-            return form_data;
-        },
-        send_request = (method, url, data) => {
-        	const request = new XMLHttpRequest();
-          request.open(method, url, false);
-          request.send(data);
-        },
-        reload_page = () => loc.href='/61',
-        wait_reboot = () => {
-          doc.body.innerText = 'Wait 5s...';
-          setTimeout(reload_page, 5000);
-        },
-        reboot = () => {
-          send_request('GET', '/91');
-          wait_reboot();
-        },
-        submitForm = (event) => {
-        	event.preventDefault();
-          const string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
-          send_request('POST', '/', string_data + '&z00=0');
-          wait_reboot();
-        },
-        features_data = convert_from_hex(data.g00)[0],
-        common_attributes = {required: true};
-
-    selector_apply_fn('.ip', (e) => { set_attributes(e, {...common_attributes, title: 'x.x.x.x format', pattern: '((25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$)|$)){4}' }); });
-    selector_apply_fn('.port', (e) => { set_attributes(e, {...common_attributes, type: 'number', min: 10, max: 65535 }); });
-
-    ip_input_names.forEach((n) => set_input_value(n, convert_from_hex(data[n]).join('.')));
-    port_input_names.forEach((n) => set_input_value(n, parse_int(data[n], 16)));
-    set_input_value('d00', data.d00.replace(/[0-9a-z]{2}(?!$)/g, '$&:'));
-
-    convert_from_hex(data.h00).forEach((n, i) => {
-        const invert_checkbox = n & 1 ? make_checkbox('p'+i, 4, n) : '',
-            if_output = (a,b) => (n & 3) == 3 ? a: b,
-        		input_nr = (''+i).padStart(2, '0'),
-            timer_int_value = if_output(convert_from_hex(data['i'+input_nr]).reduce((prev, cur)=>(prev<<8)+cur), 0),
-            boot_state_select = if_output(`<select name='p${i}'>${make_options(boot_state, n & 24)}</select>`,''),
-            debug_column = (loc.hash == '#d'?`<td>${n}</td>`:''),
-            timer_column = if_output(`<input type=number class=t8 name='i${input_nr}' value='${timer_int_value & 0x3fff}' min=0 max=16383><select name='i${input_nr}'>${make_options(timer_unit, timer_int_value & 0xc000)}</select>`,'');
-        document_write(`<tr><td>#${i + 1}</td><td><select name='p${i}'>${make_options(pin_types, n & 3)}</select></td><td><input name='j${input_nr}' value='${data['j'+input_nr]}' pattern='[0-9a-zA-Z_*.-]{1,15}' required title='1 to 15 letters, numbers, and -*_. no spaces' maxlength=15/></td><td>${invert_checkbox}</td><td>${boot_state_select}</td><td>${timer_column}</td>${debug_column}</tr>`);
-    });
-    
-    selector('.f').innerHTML = Array.from(
-    	get_entries(features),
-      ([name, bit]) => make_checkbox('g00', bit, features_data, name)).join('</br>'
-    );
-    
-    
-    return {r:reboot, s: submitForm, l:reload_page};
-})({
-    b00: '%b00',
-    b04: '%b04',
-    b08: '%b08',
-    c00: '%c00',
-    d00: '%d00',
-    h00: '%h00',
-    g00: '%g00',
-    j00: '%j00',
-    j01: '%j01',
-    j02: '%j02',
-    j03: '%j03',
-    j04: '%j04',
-    j05: '%j05',
-    j06: '%j06',
-    j07: '%j07',
-    j08: '%j08',
-    j09: '%j09',
-    j10: '%j10',
-    j11: '%j11',
-    j12: '%j12',
-    j13: '%j13',
-    j14: '%j14',
-    j15: '%j15',
-    i00: '%i00',
-    i01: '%i01',
-    i02: '%i02',
-    i03: '%i03',
-    i04: '%i04',
-    i05: '%i05',
-    i06: '%i06',
-    i07: '%i07',
-    i08: '%i08',
-    i09: '%i09',
-    i10: '%i10',
-    i11: '%i11',
-    i12: '%i12',
-    i13: '%i13',
-    i14: '%i14',
-    i15: '%i15',
-});
-
-*/
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-// Statistics page Template
-#define WEBPAGE_STATS1		6
-static const char g_HtmlPageStats1[] =
-"%y04%y05"
-  "<title>%a00: Network Statistics</title>"
-  "</head>"
-  "<body>"
-  "<h1>Network Statistics</h1>"
-  "<p>Values shown are since last power on or reset</p>"
-  "<table>"
-  "<tr><td class='t1'>%e00</td><td class='t2'>Dropped packets at the IP layer</td></tr>"
-  "<tr><td class='t1'>%e01</td><td class='t2'>Received packets at the IP layer</td></tr>"
-  "<tr><td class='t1'>%e02</td><td class='t2'>Sent packets at the IP layer</td></tr>"
-  "<tr><td class='t1'>%e03</td><td class='t2'>Packets dropped due to wrong IP version or header length</td></tr>"
-  "<tr><td class='t1'>%e04</td><td class='t2'>Packets dropped due to wrong IP length, high byte</td></tr>"
-  "<tr><td class='t1'>%e05</td><td class='t2'>Packets dropped due to wrong IP length, low byte</td></tr>"
-  "<tr><td class='t1'>%e06</td><td class='t2'>Packets dropped since they were IP fragments</td></tr>"
-  "<tr><td class='t1'>%e07</td><td class='t2'>Packets dropped due to IP checksum errors</td></tr>"
-  "<tr><td class='t1'>%e08</td><td class='t2'>Packets dropped since they were not ICMP or TCP</td></tr>"
-  "<tr><td class='t1'>%e09</td><td class='t2'>Dropped ICMP packets</td></tr>"
-  "<tr><td class='t1'>%e10</td><td class='t2'>Received ICMP packets</td></tr>"
-  "<tr><td class='t1'>%e11</td><td class='t2'>Sent ICMP packets</td></tr>"
-  "<tr><td class='t1'>%e12</td><td class='t2'>ICMP packets with a wrong type</td></tr>"
-  "<tr><td class='t1'>%e13</td><td class='t2'>Dropped TCP segments</td></tr>"
-  "<tr><td class='t1'>%e14</td><td class='t2'>Received TCP segments</td></tr>"
-  "<tr><td class='t1'>%e15</td><td class='t2'>Sent TCP segments</td></tr>"
-  "<tr><td class='t1'>%e16</td><td class='t2'>TCP segments with a bad checksum</td></tr>"
-  "<tr><td class='t1'>%e17</td><td class='t2'>TCP segments with a bad ACK number</td></tr>"
-  "<tr><td class='t1'>%e18</td><td class='t2'>Received TCP RST (reset) segments</td></tr>"
-  "<tr><td class='t1'>%e19</td><td class='t2'>Retransmitted TCP segments</td></tr>"
-  "<tr><td class='t1'>%e20</td><td class='t2'>Dropped SYNs due to too few connections avaliable</td></tr>"
-  "<tr><td class='t1'>%e21</td><td class='t2'>SYNs for closed ports, triggering a RST</td></tr>"
-  "</table>"
-  "<br>"
-  "<button onclick='location=`/61`'>Configuration</button>"
-  "<button onclick='location=`/68`'>Refresh</button>"
-  "<button onclick='location=`/69`'>Clear</button>"
-  "</body>"
-  "</html>";
-#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-
-#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
-// Link Error Statistics page Template
-#define WEBPAGE_STATS2		7
-static const char g_HtmlPageStats2[] =
-  "%y04%y05"
-  "<title>%a00: Link Error Statistics</title>"
-  "</head>"
-  "<body>"
-  "<h1>Link Error Statistics</h1>"
-  "<table>"
-  "<tr><td>31 %e31</td></tr>"
-  "<tr><td>32 %e32</td></tr>"
-  "<tr><td>33 %e33</td></tr>"
-  "<tr><td>35 %e35</td></tr>"
-  "</table>"
-  "<br>"
-  "<button onclick='location=`/61`'>Configuration</button>"
-  "<button onclick='location=`/66`'>Refresh</button>"
-  "<button onclick='location=`/67`'>Clear</button>"
-  "</body>"
-  "</html>";
-#endif // DEBUG_SUPPORT
-
-
-
-#if DEBUG_SENSOR_SERIAL == 1
-// Temperature Sensor Serial Number page Template
-#define WEBPAGE_SENSOR_SERIAL	8
-static const char g_HtmlPageTmpSerialNum[] =
-  "%y04%y05"
-  "<title>%a00: Temperature Sensor Serial Numbers</title>"
-  "</head>"
-  "<body>"
-  "<h1>Temperature Sensor Serial Numbers</h1>"
-  "<table>"
-  "<tr><td>%e40</td></tr>"
-  "<tr><td>%e41</td></tr>"
-  "<tr><td>%e42</td></tr>"
-  "<tr><td>%e43</td></tr>"
-  "<tr><td>%e44</td></tr>"
-  "</table>"
-  "<br>"
-  "<button onclick='location=`/61`'>Configuration</button>"
-  "</body>"
-  "</html>";
-#endif // DEBUG_SENSOR_SERIAL
-
-
-
-// Very Short IO state page Template
-// Only responds with a TCP payload that contains the 16 alphanumeric
-// characters representing the IO pins states. The response is not
-// browser compatible.
-// 4 bytes; size of reports 5
-#define WEBPAGE_SSTATE		9
-static const char g_HtmlPageSstate[] =
-  "%f00";
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-// Code Uploader Support page Template
-// This is the main web page shown by the Code Uploader.
-#define WEBPAGE_UPLOADER		10
-static const char g_HtmlPageUploader[] =
-  "%y04%y05"
-  "<title>Code Uploader</title>"
-  "</head>"
-  "<body>"
-  "<h1>Code Uploader</h1>"
-  "<form action='' method='post' enctype='multipart/form-data'>"
-  
-  "<script>"
-    "function startTimer(){"
-      "var timeleft = 20;"
-      "var downloadTimer = setInterval(function(){"
-        "if(timeleft <= 0){"
-          "clearInterval(downloadTimer);"
-        "}"
-        "document.getElementById('progressBar').value = 20 - timeleft;"
-        "timeleft -= 1;"
-      "}, 1000);"
-    "}"
-    "function start(){"
-      "document.getElementById('progressBar');"
-      "startTimer();"
-    "};"
-  "</script>"
-
-  "<p>"
-  "Use CHOOSE FILE to select a .sx file then click SUBMIT. The 30 second<br>"
-  "Upload and Flash programming process will start.<br>"
-  "</p>"
-  
-  "<p><input input type='file' name='file1' accept='.sx' required /></p>"
-  "<p><button type='submit' onclick='start()'>Submit</button></p>"
-
-  "<p>"
-  "Once you click Submit do not access via your browser until Flash programming<br>"
-  "completes.<br>"
-  "</p>"
-  
-  "<p>"
-  "<progress id='progressBar' value='0' max='20'></progress>"
-  "<br><br><br>"
-
-  "</form>"
-  
-  "<p>"
-  "RESTORE: If you arrived here unintentionally DO NOT CLICK SUBMIT. Instead<br>"
-  "use the Restore button to reinstall your previous firmware version.<br>"
-  "</p>"
-  "<button onclick='location=`/73`'>Restore</button>"
-  "<p>"
-  "<br>"
-  "</p>"
-  "</body>"
-  "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-// Load Uploader page Template
-// This web page is shown when the user requests the Code Uploader with the
-// /72 command.
-#define WEBPAGE_LOADUPLOADER		12
-static const char g_HtmlPageLoadUploader[] =
-  "%y04%y05"
-  "<title>Loading Code Uploader</title>"
-  "</head>"
-  "<body>"
-  "<h1>Loading Code Uploader</h1>"
-  "<p>"
-  "DO NOT ACCESS BROWSER FOR 15 SECONDS.<br><br>"
-  "Wait until the progress bar completes, then click Continue.<br><br>"
-  
-  "<progress value='0' max='15' id='progressBar'></progress>"
-  "<script>"
-  "var timeleft = 15;"
-  "var downloadTimer = setInterval(function(){"
-    "if(timeleft <= 0){"
-      "clearInterval(downloadTimer);"
-    "}"
-    "document.getElementById('progressBar').value = 15 - timeleft;"
-    "timeleft -= 1;"
-  "}, 1000);"
-  "</script>"
-  
-  "<br>"
-  "<br>"
-  
-  "</p>"
-  "<button onclick='location=`/`'>Continue</button>"
-  "</body>"
-  "</html>";
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-// Existing Image page Template
-// This web page is shown when the user requests that the existing firmware
-// image be reinstalled
-#define WEBPAGE_EXISTING_IMAGE	13
-static const char g_HtmlPageExistingImage[] =
-  "%y04%y05"
-  "<title>Restoring Existing Image</title>"
-  "</head>"
-  "<body>"
-  "<h1>Restoring Existing Image</h1>"
-  "<p>"
-  "It takes about 15 SECONDS to restore the existing firmware image.<br><br>"
-  "DO NOT ATTEMPT BROWSER ACCESS DURING THIS 15 SECOND PERIOD.<br><br>"
-  "Wait until the progress bar completes, then click Continue.<br><br>"
-  
-  "<progress value='0' max='15' id='progressBar'></progress>"
-  "<script>"
-  "var timeleft = 15;"
-  "var downloadTimer = setInterval(function(){"
-    "if(timeleft <= 0){"
-      "clearInterval(downloadTimer);"
-    "}"
-    "document.getElementById('progressBar').value = 15 - timeleft;"
-    "timeleft -= 1;"
-  "}, 1000);"
-  "</script>"
-  "<br>"
-  "<br>"
-  
-  "</p>"
-  "<button onclick='location=`/`'>Continue</button>"
-  "</body>"
-  "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-// Timer page Template
-// This web page is shown when uploaded code is being written to the Flash.
-// The page displays a wait timer to help prevent the user from taking
-// actions while the Flash is finishing.
-#define WEBPAGE_TIMER	14
-static const char g_HtmlPageTimer[] =
-  "%y04%y05"
-  "<title>Writing Flash</title>"
-  "</head>"
-  "<body>"
-  "<h1>Writing and Verifying Flash</h1>"
-  "<p>"
-  "Wait until the progress bar completes, then click Continue.<br><br>"
-  
-  "<progress value='0' max='15' id='progressBar'></progress>"
-  "<script>"
-  "var timeleft = 15;"
-  "var downloadTimer = setInterval(function(){"
-    "if(timeleft <= 0){"
-      "clearInterval(downloadTimer);"
-    "}"
-    "document.getElementById('progressBar').value = 15 - timeleft;"
-    "timeleft -= 1;"
-  "}, 1000);"
-  "</script>"
-  "<br>"
-  "<br>"
-  
-  "</p>"
-  "<button onclick='location=`/`'>Continue</button>"
-  "</body>"
-  "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-// Upload Complete page Template
-// This web page is shown when the uploaded strings file completes success-
-// fully.
-#define WEBPAGE_UPLOAD_COMPLETE	15
-static const char g_HtmlPageUploadComplete[] =
-  "%y04%y05"
-  "<title>Upload Complete</title>"
-  "</head>"
-  "<body>"
-  "<h1>Upload Complete</h1>"
-  "<p>"
-  "Click Continue.<br><br>"
-  "</p>"
-  "<button onclick='location=`/`'>Continue</button>"
-  "</body>"
-  "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-// Parse Fail page Template
-// This web page is shown when uploaded code had a parsing failure.
-#define WEBPAGE_PARSEFAIL	16
-static const char g_HtmlPageParseFail[] =
-  "%y04%y05"
-  "<title>Upload Parse Fail</title>"
-  "</head>"
-  "<body>"
-  "<h1>Upload Parse Fail</h1>"
-  "<p>"
-  "Parsing of the uploaded file failed.<br>"
-  "Retry the upload. Make sure you selected the correct file.<br>"
-  "Fault reason code:<br>"
-  "%s02"
-  "</p>"
-  "<button onclick='location=`/`'>Continue</button>"
-  "</body>"
-  "</html>";
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-// EEPROM Missing webpage
-// This web page is shown when the EEPROM has gone missing unexpectedly.
-// This should never happen, but may occur is there is a faulty connection.
-#define WEBPAGE_EEPROM_MISSING	17
-static const char g_HtmlPageEEPROMMissing[] =
-  "%y04%y05"
-  "<title>EEPROM Missing</title>"
-  "</head>"
-  "<body>"
-  "<h1>EEPROM Missing</h1>"
-  "<p>"
-  "EEPROM device may be defective or wiring may be loose.<br>"
-  "</p>"
-  "<button onclick='location=`/`'>Continue</button>"
-  "</body>"
-  "</html>";
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-
-
-//---------------------------------------------------------------------------//
-// The following creates an array of strings that are commonly used strings
-// in the HTML pages. To reduce the size of the HTML pages these common
-// strings are replaced with placeholders of the form "%yxx", then when the
-// HTML page is copied to the trasnmit buffer the placeholders are replaced
-// with one of the strings in this array. The length of each string is
-// manually counted and put in the associated _len value. When the _len value 
-// is needed it often has 4 subtracted (as the strings are replacing the 4
-// character placeholder), so that subtraction is done once here.
-
-// The following creates an array of 6 strings of variable length
-
-// String for %y00 replacement in web page templates
-#define s0 "" \
-  "placeholder"
-
-// String for %y01 replacement in web page templates
-#define s1 "" \
-  "</script>" \
-  "</table>" \
-  "<p/>" \
-  "<button type=submit>Save</button> <button type=reset onclick='m.l()'>Undo All</button>" \
-  "</form>"
-
-// String for %y02 replacement in web page templates
-#define s2 "" \
-  "<button title='Save first!' onclick='location="
-
-// String for %y03 replacement in web page templates
-#define s3 "" \
-"placeholder"
-
-// String for %y04 replacement in web page templates
-#define s4  "" \
-  "<html>"\
-  "<head>" \
-  "<link rel='icon' href='data:,'>" \
-  "<meta name='viewport' content='width=device-width'>" \
-  "<style>" \
-  ".s0{background:red;}" \
-  ".s1{background:green;}"
-
-// String for %y05 replacement in web page templates
-#define s5 "" \
-  "table{border-spacing:8px2px}" \
-  ".t1{width:100px;}" \
-  ".t2{width:450px;}" \
-  ".t3{width:30px;}" \
-  ".t8{width:60px;}" \
-  ".c{text-align:center;}" \
-  ".ip input{width:27px;}" \
-  ".mac input{width:14px;}" \
-  ".s div{width:13px;height:13px;display:inline-block;}" \
-  ".hs{height:9px;}" \
-  "</style>"
-
-// The following creates an array of string lengths corresponding to
-// the strings in the #define statements above
-// AND
-// Creates an array of string lengths (less 4) corresponding to the
-// strings above
-struct page_string {
-    const char * str;
-    uint8_t size;
-    uint8_t size_less4;
-};
-
-const struct page_string ps[6] = {
-    { s0, sizeof(s0)-1, sizeof(s0)-5 },
-    { s1, sizeof(s1)-1, sizeof(s1)-5 },
-    { s2, sizeof(s2)-1, sizeof(s2)-5 },
-    { s3, sizeof(s3)-1, sizeof(s3)-5 },
-    { s4, sizeof(s4)-1, sizeof(s4)-5 },
-    { s5, sizeof(s5)-1, sizeof(s5)-5 }
-};
-
-// Access the above strings, string length, and (string length - 4) as
-// follows:
-// ps[i].str
-// ps[i].size
-// ps[i].size_less4
-
-
-//---------------------------------------------------------------------------//
-// The following compile time pre-processor statements test the string
-// lengths to make sure they are within valid limits. All string lengths
-// must be less than 256.
-#if (sizeof(s0) > 255)
-  #error "string s0 is too big"
-#endif
-
-#if (sizeof(s1) > 255)
-  #error "string s1 is too big"
-#endif
-
-#if (sizeof(s2) > 255)
-  #error "string s2 is too big"
-#endif
-
-#if (sizeof(s3) > 255)
-  #error "string s3 is too big"
-#endif
-
-#if (sizeof(s4) > 255)
-  #error "string s4 is too big"
-#endif
-
-#if (sizeof(s5) > 255)
-  #error "string s5 is too big"
-#endif
-
-
-void HttpDStringInit() {
-  // Initialize HttpD string sizes
-  
-#if OB_EEPROM_SUPPORT == 0
-  HtmlPageIOControl_size = (uint16_t)(sizeof(g_HtmlPageIOControl) - 1);
-  HtmlPageConfiguration_size = (uint16_t)(sizeof(g_HtmlPageConfiguration) - 1);
-#endif // OB_EEPROM_SUPPORT == 0
-
-#if OB_EEPROM_SUPPORT == 1
-#if BUILD_SUPPORT == MQTT_BUILD
-  // Prepare to read 2 bytes from Off-Board EEPROM and convert to uint16_t.
-  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION);
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-  // Prepare to read 2 bytes from Off-Board EEPROM and convert to uint16_t.
-  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, BROWSER_ONLY_WEBPAGE_IOCONTROL_SIZE_LOCATION);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-  // Read 2 bytes from Off-Board EEPROM and convert to uint16_t.
-  {
-    uint16_t temp;
-    OctetArray[0] = I2C_read_byte(0);
-    OctetArray[1] = I2C_read_byte(1);
-    temp = (uint16_t)(OctetArray[0] << 8);
-    temp |= OctetArray[1];
-    HtmlPageIOControl_size = temp;
-  }
-  
-#if BUILD_SUPPORT == MQTT_BUILD
-  // Prepare to read 2 bytes from Off-Board EEPROM and convert to uint16_t.
-  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, MQTT_WEBPAGE_CONFIGURATION_SIZE_LOCATION);
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-  // Prepare to read 2 bytes from Off-Board EEPROM and convert to uint16_t.
-  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, BROWSER_ONLY_WEBPAGE_CONFIGURATION_SIZE_LOCATION);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-  // Read 2 bytes from Off-Board EEPROM and convert to uint16_t.
-  {
-    uint16_t temp;
-    OctetArray[0] = I2C_read_byte(0);
-    OctetArray[1] = I2C_read_byte(1);
-    temp = (uint16_t)(OctetArray[0] << 8);
-    temp |= OctetArray[1];
-    HtmlPageConfiguration_size = temp;
-  }
-#endif // OB_EEPROM_SUPPORT == 1
-}
-
-
-void init_off_board_string_pointers(struct tHttpD* pSocket) {
-  // Initialize the index into the Off-Board EEPROM Strings region.
-  //
-  // In order to allow a String File to be read using the same code used for
-  // reading Program Files the code expects the Strings file to have SREC
-  // addresses starting at 0x8000, however in the EEPROM itself the base
-  // address for Strings is 0x0000. This initialization will compensate for
-  // that disparity.
-
-#if OB_EEPROM_SUPPORT == 1
-
-  if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
-
-#if BUILD_SUPPORT == MQTT_BUILD
-    // Prepare to read the two byte string address from Off-Board EEPROM and
-    // convert to uint16_t.
-    prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION);
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Prepare to read the two byte string address from Off-Board EEPROM and
-    // convert to uint16_t.
-    prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, BROWSER_ONLY_WEBPAGE_IOCONTROL_ADDRESS_LOCATION);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-    // Read 2 bytes
-    {
-      uint16_t temp;
-      OctetArray[0] = I2C_read_byte(0);
-      OctetArray[1] = I2C_read_byte(1);
-      temp = (uint16_t)(OctetArray[0] << 8);
-      temp |= OctetArray[1];
-      off_board_eeprom_index = temp - 0x8000;
-    }
-  }
-      
-  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-
-#if BUILD_SUPPORT == MQTT_BUILD
-    // Prepare to read the two byte string address from Off-Board EEPROM and
-    // convert to uint16_t.
-    prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, MQTT_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION);
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Prepare to read the two byte string address from Off-Board EEPROM and
-    // convert to uint16_t.
-    prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, BROWSER_ONLY_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-    // Read 2 bytes
-    {
-      uint16_t temp;
-      OctetArray[0] = I2C_read_byte(0);
-      OctetArray[1] = I2C_read_byte(1);
-      temp = (uint16_t)(OctetArray[0] << 8);
-      temp |= OctetArray[1];
-      off_board_eeprom_index = temp - 0x8000;
-    }
-
-  }
-#endif // OB_EEPROM_SUPPORT == 1
-}
-
-
-void httpd_diagnostic(void) {
-#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
-#if OB_EEPROM_SUPPORT == 1
-  // Read and display the 8 bytes with address info for the web pages
-  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION);
-  {
-    int i;
-    uint8_t temp[8];
-    UARTPrintf("Webpage Address Bytes: ");
-    temp[0] = I2C_read_byte(0);
-    temp[1] = I2C_read_byte(0);
-    temp[2] = I2C_read_byte(0);
-    temp[3] = I2C_read_byte(0);
-    temp[4] = I2C_read_byte(0);
-    temp[5] = I2C_read_byte(0);
-    temp[6] = I2C_read_byte(0);
-    temp[7] = I2C_read_byte(1);
-    for (i = 0; i < 8; i++) {
-      emb_itoa(temp[i], OctetArray, 16, 2);
-      UARTPrintf(OctetArray);
-      UARTPrintf(" ");
-    }
-  UARTPrintf("\r\n");
-  }
-  
-  // Read and display the 8 bytes with size info for the web pages
-  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION);
-  {
-    int i;
-    uint8_t temp[8];
-    UARTPrintf("Webpage Size Bytes: ");
-    temp[0] = I2C_read_byte(0);
-    temp[1] = I2C_read_byte(0);
-    temp[2] = I2C_read_byte(0);
-    temp[3] = I2C_read_byte(0);
-    temp[4] = I2C_read_byte(0);
-    temp[5] = I2C_read_byte(0);
-    temp[6] = I2C_read_byte(0);
-    temp[7] = I2C_read_byte(1);
-    for (i = 0; i < 8; i++) {
-      emb_itoa(temp[i], OctetArray, 16, 2);
-      UARTPrintf(OctetArray);
-      UARTPrintf(" ");
-    }
-  UARTPrintf("\r\n");
-  }
-
-  UARTPrintf("IOControl Page Size: ");
-  emb_itoa(HtmlPageIOControl_size, OctetArray, 16, 4);
-  UARTPrintf(OctetArray);
-  UARTPrintf("\r\n");
-
-
-  UARTPrintf("Configuration Page Size: ");
-  emb_itoa(HtmlPageConfiguration_size, OctetArray, 16, 4);
-  UARTPrintf(OctetArray);
-  UARTPrintf("\r\n");
-#endif // OB_EEPROM_SUPPORT == 1
-#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
-}
-
-
-uint16_t adjust_template_size(struct tHttpD* pSocket)
-{
-  uint16_t size;
-  // declare and pre-calculate repeatedly used values
-  int strlen_devicename_adjusted = (strlen(stored_devicename) - 4);
-  
-  // This function calculates the size of the HTML page that will be
-  // transmitted based on the size of the web page template plus adjustments
-  // needed to account for text strings that replace markers in the web page
-  // template.
-  // 
-  // Note to self: This code is crap from the perspective of readability and
-  // being error prone. Walking through the web page templates to verify that
-  // this code properly adjusts the reported web page size is tedious,
-  // particularly when it comes to the #if inclusions/exclusions. Need to
-  // work on a better methodology.
-  //
-  // Most of the size calculations end up being constants, so a lot of this
-  // function is comments explaining where the constants come from, then
-  // simply adding the result to the template size.
-  
-  size = 0;
-
-
-  //-------------------------------------------------------------------------//
-  // A no-function check for current_webpage that allows the various options
-  // to compile as "else if" statements.
-  //-------------------------------------------------------------------------//
-  if (pSocket->current_webpage == WEBPAGE_NULL) { }
-
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_IOCONTROL template
-  //-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
-    size = HtmlPageIOControl_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title> and in body
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-    size = size + (2 * strlen_devicename_adjusted);
-
-    // Account for pin control field %h00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (32 - 4));
-    // size = size + (1 x 28);
-    size = size + 28;
- 
-    // Account for Temperature Sensor insertion %t00 to %t04
-    // Each of these insertions can have a different length due to the
-    // text around them. If DS18B20 is NOT enabled we only need to
-    // subtract the size of the 5 placeholders.
-    //
-    if (stored_config_settings & 0x08) {
-      //  %t00 "<p>Temperature Sensors<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    40 bytes of text plus 27 bytes of data = 59
-      //    size = size + 67 - 4
-      size = size + 63;
-      //
-      //  %t01 "<br> xxxxxxxxxxxx " 
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    18 bytes of text plus 27 bytes of data = 37
-      //    size = size + 45 - 4
-      size = size + 41;
-      //
-      //  %t02 "<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    18 bytes of text plus 27 bytes of data = 37
-      //    size = size + 45 - 4
-      size = size + 41;
-      //
-      //  %t03 "<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //    18 bytes of text plus 27 bytes of data = 37
-      //    size = size + 45 - 4
-      size = size + 41;
-      //
-      //  %t04 "<br> xxxxxxxxxxxx "
-      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
-      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
-      //      plus "<br></p>"
-      //    18 bytes of text plus 27 bytes of data = 45
-      //    plus 8 bytes of text = 53
-      //    size = size + 53 - 4
-      size = size + 49;
-    }
-    else {
-      // Subtract the size of the placeholders as they won't be used
-      // size = size - (5 x 4)
-      size = size - 20;
-    }
-    
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-    // String for %y01 in web page template
-    // There 1 instance (Save and Undo All buttons)
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[1].size_less4;
-
-    // String for %y02 in web page template
-    // There 2 instances (Refresh and Configuration buttons)
-    // size = size + (#instances) x (ps[2].size - marker_field_size);
-    // size = size + (2 x ps[2].size_less4);
-    size = size + (2 * ps[2].size_less4);
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Name fields %j00 to %j15
-    // Each can be variable in size during run time so we have to calculate
-    // them  each time we display the web page.
-    {
-      int i;
-      for (i=0; i<15; i++) {
-        size = size + (strlen(IO_NAME[i]) - 4);
-      }
-    }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_CONFIGURATION template
-  //-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-    size = HtmlPageConfiguration_size;
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title> and in body
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the /web page.
-    size = size + (2 * strlen_devicename_adjusted);
-
-    // Account for HTML IP Address, Gateway Address, and
-    // Netmask fields %b00, %b04, %b08
-    // There are 3 instances of these fields
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (3 x (8 - 4));
-    // size = size + (3 x (4));
-    size = size + 12;
-
-    // Account for HTML Port field %c00
-    // There is 1 instance
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (5 - 4));
-    // size = size + (1 x (1));
-    // size = size + 1;
-    size = size + 1;
-
-    // Account for MAC field %d00
-    // There is 1 instance of this field
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (12 - 4));
-    // size = size + (1 x (8));
-    size = size + 8;
-
-    // Account for Config string %g00
-    // There is 1 instance
-    // value_size is 2 (2 characters)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (2 - 4));
-    // size = size + (1 x (-2));
-    size = size - 2;
-
-    // Account for Code Revision + Code Type insertion %w00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (26 - 4));
-    // size = size + (1 x 22);
-    size = size + 22;
-
-    // Account for pin control field %h00
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (32 - 4));
-    // size = size + (1 x 28);
-    size = size + 28;
-
-    // Account for Text Replacement insertion
-    // Some strings appear frequently in the templates - things like the
-    // button titles which appear when hovering over a button. These strings
-    // are inserted on the fly when the web page is sent to the browser, so
-    // they have to be accounted for in the size of the web page.
-    
-    // String for %y01 in web page template
-    // There 1 instance (Save and Undo All buttons)
-    // size = size + (#instances) x (ps[1].size - marker_field_size);
-    // size = size + ps[1].size_less4;
-    size = size + ps[1].size_less4;
-
-    // String for %y02 in web page templates
-    // There are 2 instances (Refresh and IO Control buttons)
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances) x (ps[2].size - 4);
-    // size = size + (2) x ps[2].size_less4;
-    size = size + (2 * ps[2].size_less4);
-    
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    // Account for IO Name fields %j00 to %j15
-    // Each can be variable in size during run time so we have to calculate
-    // them  each time we display the web page.
-    {
-      int i;
-      for (i=0; i<15; i++) {
-        size = size + (strlen(IO_NAME[i]) - 4);
-      }
-    }
-
-    // Account for IO Timer field %i00 to %i15
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (4 - 4));
-    // size = size + (16 x 0);
-    // size = size + 0;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
- 
-#if BUILD_SUPPORT == MQTT_BUILD
-    // Account for MQTT IP Address field %b12
-    // There is 1 instance
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (8 - 4));
-    // size = size + (1 x (4));
-    size = size + 4;
-    
-    // Account for MQTT Port field %c01
-    // There is 1 instance
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (1 x (5 - 4));
-    // size = size + (1 x (1));
-    // size = size + 1;
-    size = size + 1;
-
-    // Account for Username field %l00
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-    size = size + (strlen(stored_mqtt_username) - 4);
-
-    // Account for Password field %m00
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-    size = size + (strlen(stored_mqtt_password) - 4);
-    
-    // Account for red/green State Progress boxes %n00, %n01, %n02, %n03, %n04 
-    // There are always 5 boxes, one for each State progress indicator
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (#instances x (1 - 4));
-    // size = size + (5 x (-3));
-    size = size - 15;
-#endif // BUILD_SUPPORT == MQTT_BUILD
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_STATS1 template
-  //-------------------------------------------------------------------------//
-#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_STATS1) {
-    size = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title>
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-    size = size + strlen_devicename_adjusted;
-    
-    // Account for Statistics fields %e00 to %e21
-    // There are 22 instances of these fields
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (22 x (10 - 4));
-    // size = size + (22 x (6));
-    size = size + 132;
-  }
-#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_STATS2 template
-  //-------------------------------------------------------------------------//
-#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
-  else if (pSocket->current_webpage == WEBPAGE_STATS2) {
-    size = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title>
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-    size = size + strlen_devicename_adjusted;
-
-    // Account for Statistics fields %e31, %e32, %e33, %e35
-    // There are 4 instances of these fields
-    // size = size + (#instances x (value_size - marker_field_size));
-    // size = size + (4 x (10 - 4));
-    // size = size + (4 x (6));
-    size = size + 24;
-  }
-#endif // DEBUG_SUPPORT
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the DEBUG_SENSOR_SERIAL template
-  //-------------------------------------------------------------------------//
-#if DEBUG_SENSOR_SERIAL == 1
-  else if (pSocket->current_webpage == WEBPAGE_SENSOR_SERIAL) {
-    size = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title>
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-    size = size + strlen_devicename_adjusted;
-  }
-#endif // DEBUG_SENSOR_SERIAL
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_SSTATE template
-  //-------------------------------------------------------------------------//
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  else if (pSocket->current_webpage == WEBPAGE_SSTATE) {
-    size = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-//    size = size + ps[4].size_less4
-//                + ps[5].size_less4;
-
-    // Account for Device Name field %a00 in <title>
-    // This can be variable in size during run time so we have to calculate it
-    // each time we display the web page.
-//    size = size + strlen_devicename_adjusted;
-
-    // Account for Short Form IO Settings field (%f00)
-    // size = size + (value size - marker_field_size)
-    // size = size + (16 - 4);
-    size = size + 12;
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_LOADUPLOADER template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_LOADUPLOADER) {
-    size = (uint16_t)(sizeof(g_HtmlPageLoadUploader) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_UPLOADER template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_UPLOADER) {
-    size = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
-
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_EXISTING_IMAGE template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_EXISTING_IMAGE) {
-    size = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_TIMER template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_TIMER) {
-    size = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_UPLOAD_COMPLETE template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_UPLOAD_COMPLETE) {
-    size = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-  }
-
-
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_PARSEFAIL template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_PARSEFAIL) {
-    size = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;
-    
-    // Account for EEPROM status string %s02
-    // size = size + (value size - marker_field_size)
-    // size = size + (40 - 4);
-    size = size + 36;
-  }
-
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-  //-------------------------------------------------------------------------//
-  // Adjust the size reported by the WEBPAGE_EEPROM_MISSING template
-  //-------------------------------------------------------------------------//
-  else if (pSocket->current_webpage == WEBPAGE_EEPROM_MISSING) {
-    size = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
-    
-    // Account for header replacement strings %y04 %y05
-    size = size + ps[4].size_less4
-                + ps[5].size_less4;    
-  }
-#endif // OB_EEPROM_SUPPORT == 1
-  return size;
-}
-
-
-void emb_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad)
-{
-  // Implementation of itoa() specific to this application
-  // num  - The value to be converted
-  // str  - Pointer to the storage location for the converted value
-  // base - The base to be used in the output string
-  // pad  - size of the string result, pre-pad with zeroes if needed
-  //
-  // The resulting string in str will be NULL terminated on completion.
-  // No checking is done so make sure str has enough room for the
-  // converted value and the terminator.
-  //
-  // Positive numbers ONLY,
-  //   Up to 10 digits (32 bits),
-  //   Includes leading 0 pad,
-  //   Converts base 2 (binary), 8 (nibbles), 10 (decimal), 16 (hex)
-  //     base 2 example
-  //       emb_itoa(number, OctetArray, 2, 8);
-  //       where number is a uint8_t containing the value 0xac
-  //       output string in OctetArray is 10101100
-  //     base 8 example
-  //       emb_itoa(number, OctetArray, 2, 4);
-  //       where number is a uint8_t containing the value 0xac
-  //       output string in OctetArray is 0254
-  //     base 10 example
-  //       emb_itoa(number, OctetArray, 2, 5);
-  //       where number is a uint8_t containing the value 0xac
-  //       output string in OctetArray is 00172
-  //     base 16 example
-  //       emb_itoa(number, OctetArray, 2, 8);
-  //       where number is a uint32_t containing the value 0xc0a80004
-  //       output string in OctetArray is c0a80004
-
-  int i;
-  uint8_t rem;
-
-  // Fill the string with zeroes. This handles the case where the num provided
-  // to the function is zero, and it handles padding as the function will fill
-  // in anything up to the pad length. The value "pad" is effectively the
-  // length of the desired output. If number = 0 no further processing needed.
-  for (i=0; i < pad; i++) str[i] = '0';
-  str[pad] = '\0';
-  if (num == 0) return;
-  
-  // Process individual digits
-  i = 0;
-  while (num != 0) {
-    rem = (uint8_t)(num % base);
-    if (rem > 9) str[i++] = (uint8_t)(rem - 10 + 'a');
-    else str[i++] = (uint8_t)(rem + '0');
-    num = num/base;
-  }
-
-  // Reverse the string
-  {
-    uint8_t start;
-    uint8_t end;
-    uint8_t temp;
-    
-    start = 0;
-    end = (uint8_t)(pad - 1);
-    
-    while (start < end) {
-      temp = str[start];
-      str[start] = str[end];
-      str[end] = temp;
-      start++;
-      end--;
-    }
-  }
-}
-
-
-int hex2int(char ch)
-{
-  // Convert a single hex character to an integer (a nibble)
-  // If the character is not hex -1 is returned
-  if (ch >= '0' && ch <= '9') return ch - '0';
-  if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
-  if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
-  return -1;
-}
-
-
-uint8_t two_hex2int(char chmsb, char chlsb)
-{
-  uint8_t temp;
-  // Convert two hex characters to an integer (an unsigned byte)
-  temp = (uint8_t)hex2int(chmsb);
-  temp = (uint8_t)(temp<<4);
-  temp = (uint8_t)(temp | hex2int(chlsb));
-  return temp;
-}
-
-
-void int2hex(uint8_t i)
-{
-  uint8_t j;
-  // Convert a single integer into two hex characters (two nibbles).
-  // Put the result in global variable OctetArray.
-  j = (uint8_t)(i>>4);
-  OctetArray[0] = int2nibble(j);
-  
-  j = (uint8_t)(i & 0x0f);
-  OctetArray[1] = int2nibble(j);
-  
-  OctetArray[2] = '\0';
-}
-
-
-uint8_t int2nibble(uint8_t j)
-{
-  // Convert a 4 bit integer to a character (a single nibble).
-  if(j<=9) return (uint8_t)(j + '0');
-  else return (uint8_t)(j - 10 + 'a');
-}
-
-
-static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen)
-{
-  uint16_t nBytes;
-  int i;
-  
-  static const char http_string1[] = 
-    "HTTP/1.1 200 OK\r\n"
-    "Content-Length:";
-  static const char http_string2[] = 
-    "\r\n"
-    "Cache-Control: no-cache, no-store\r\n"
-    "Content-Type: text/html; charset=utf-8\r\n"
-    "Connection:close\r\n\r\n";
-
-  nBytes = 0;
-
-  pBuffer = stpcpy(pBuffer, http_string1);
-  nBytes += strlen(http_string1);
-
-  // This creates the "xxxxx" part of a 5 character "Content-Length:xxxxx" field in the pBuffer.
-  emb_itoa(nDataLen, OctetArray, 10, 5);
-  pBuffer = stpcpy(pBuffer, OctetArray);
-  nBytes += 5;
-
-  pBuffer = stpcpy(pBuffer, http_string2);
-  nBytes += strlen(http_string2);
-  
-  return nBytes;
-}
-
-
-static uint16_t CopyHttpData(uint8_t* pBuffer,
-                             const char** ppData,
-			     uint16_t* pDataLeft,
-			     uint16_t nMaxBytes,
-			     struct tHttpD* pSocket)
-{
-  // This function copies the selected webpage from flash storage to the
-  // output buffer.
-  // pBuffer - the output buffer
-  // ppData - the Flash storage for the Webpage template
-  // pDataLeft - remaining size of the template to be processed
-  // nMaxBytes - size of the output buffer
-  // While performing the copy the stream of characters in the webpage
-  // template is searched for special markers that indicate where template
-  // text should be replaced with variable length text.
-    
-  uint8_t nByte;
-  uint8_t nParsedNum;
-  uint8_t nParsedMode;
-  uint8_t temp;
-  int i;
-  int no_err;
-  unsigned char temp_octet[3];
-  uint8_t* pBuffer_start;
-  
-  // For use only in upgradeable builds:
-  #define PRE_BUF_SIZE	230
-  char pre_buf[PRE_BUF_SIZE];
-  uint16_t pre_buf_ptr = 0;
-
-  
-  nParsedNum = 0;
-  nParsedMode = 0;
-  pBuffer_start =  pBuffer;
-
-  // The input value "nMaxBytes" provided by the calling routine is based on
-  // the MSS (Maximum Segment Size) defined in UIP_TCP_MSS.
-  //
-  // In this "transmit" routine MSS indicates the maximum number of TCP
-  // datagram bytes that the remote host will accept in a TCP segment (the
-  // TCP datagram part of an IP frame). The MSS value is defined in the
-  // uipopt.h file. Later the MSS should be updated with a value obtained from
-  // the browser that is accessing the web server during setup of a connection.
-  // However, I don't think this actually happens, and for simplification I
-  // think UIP is using a single MSS value for transmit and receive. Receive
-  // is the critical direction because we have limited memory to store
-  // incoming packets ... and it is OK if we transmit less than the MSS that a
-  // remote host tells us it can receive. The problem that this causes is that
-  // as we reduce the value of MSS for receive, it also reduces the size of
-  // MSS for transmit, and that causes our web page transmission to take a
-  // very long time (I'm seeing 2 seconds for a simple web page). May have to
-  // work on this some more.
-  //
-  // In the original UIP code there was a "uip_split" function that would
-  // reduce the size of transmitted packets. I think that code was interacting
-  // with the code below creating instability, perhaps because a lot of
-  // short packets were generated. Making the nMaxBytes limit smaller than the
-  // uip_split threshold effectively prevented the uip_split from operating,
-  // and the overall code became stable. I subsequently decided to remove
-  // uip_split from this application.
-  //
-  //-------------------------------------------------------------------------//
-  // See the uipopt.h file: UIP_TCP_MSS must be smaller than the UIP_BUF
-  // (which is the same size as MAXFRAME) by the size of the headers (54
-  // bytes). So, if MAXFRAME is 500 bytes UIP_TCP_MSS can be up to 446 bytes.
-  // In this application UIP_TCP_MSS is set to 440.
-  // 
-  // We really only need to make sure that the loop below stays within the
-  // MSS boundary and within the UIP_BUF buffer size, whichever is smaller.
-  //-------------------------------------------------------------------------//
-  //
-  // #define ENC28J60_MAXFRAME	900 (in enc28j60.h)
-  //   Note: When using MQTT, ENC28J60_MAXFRAME could only be a max of 500
-  //   bytes to allow room for the MQTT variables and buffer.
-  //
-  // nMaxbytes must be 32 bytes smaller than UIP_TCP_MSS due to the need to
-  // allow for the largest string insertion that is NOT a %yxx replacement.
-  //
-  // nMaxBytes should not cause a TCP datagram formation larger than 536
-  // bytes.
-  //
-  // Note: Complete transmission of the typical webpage in this application is
-  // about 4000 bytes.
-
-  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-  // This over-rides the nMaxBytes value passed to the function to account
-  // for extra bytes that might be sent in a single pass of the loop below.
-  nMaxBytes = UIP_TCP_MSS - 40;
-  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-
-
-
-  //-------------------------------------------------------------------------//
-#if OB_EEPROM_SUPPORT == 1
-  if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-    // This code is applicable only when the Off-Board EERPOM is used to store
-    // the IOControl and Configuration webpage templates.
-    // Reading templates from the Off-Board EEPROM is very slow relative to
-    // reading the templates from STM8 Flash. So the "pre_buf[]" array is used
-    // to bulk read template data from the Off-Board EEPROM to improve code
-    // speed. pre_buf is then used to provide data to the webpage transmission
-    // code.
-    // Optimization:
-    //  - Packet transmissio size will never about 440 bytes
-    //  - There isn't enough RAM to have a 440 byte buffer so later in the
-    //    process the pre_buf gets re-loaded
-    //  - Thus the pre_buf only needs to be about 230 bytes (to minimize the
-    //    amount of data read from the EEPROM per packet, thus minimizing
-    //    time spent reading the data).
-    //  - I say "about 230 bytes" because there is some variability in how
-    //    much needs to be read due to the need to compensate for aliasing of
-    //    the read-from-EEPROM vs the collection of "%-nParsedMode-nParsedNum"
-    //    values. To account for this aliasing the buffer will get refilled
-    //    a few bytes before it is completely empty (see the refill code
-    //    further below).
-    
-    {
-      uint16_t i;
-      
-      prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, off_board_eeprom_index);
-      for (i = 0; i < (PRE_BUF_SIZE - 1); i++) {
-        pre_buf[i] = I2C_read_byte(0);
-      }
-      pre_buf[PRE_BUF_SIZE - 1] = I2C_read_byte(1);
-      pre_buf_ptr = 0;
-    }
-  }
-#endif // OB_EEPROM_SUPPORT == 1
-  //-------------------------------------------------------------------------//
-
-
-  while ((uint16_t)(pBuffer - pBuffer_start) < nMaxBytes) {
-    // This is the main loop for processing the page templates stored in
-    // flash and inserting variable data as the webpage is copied to the
-    // transmission buffer.
-    //
-    // The variable *pDataLeft counts down the amount of data not yet
-    // "consumed" from the source web page template.
-    //
-    // There are a large number of "markers" in the template (example: %a01)
-    // that get replaced by other text when the template is read and copied
-    // to the transmit buffer. Thus, the amount of data actually sent for a
-    // given page can greatly exceed the original size of the template.
-    //
-    // There are two ways this loop terminates:
-    // 1) If (pBuffer - pBuffer_start) exceeds nMaxBytes.
-    // 2) If *pDataLeft reaches a count of zero.
-    // If the loop terminates and there is still data left to transmit (as
-    // indicated by pDataLeft > 0) the calling routine will call the function
-    // again.
-    
-    if (*pDataLeft > 0) {
-      // If pDataLeft > 0 then we are (or are still) processing a page
-      // template.
-    
-      if (pSocket->insertion_index != 0) {
-        // If we previously interrupted an insertion string transfer to the
-	// transmit buffer then we don't want to read a character from the
-	// template, and instead we want to continue with the insertion string
-	// process. In this case use the retained nParsedMode and nParsedNum
-	// values so that we return to the %yxx part of the function. Note
-	// that if we are in the process of copying an insertion string to the
-	// transmit buffer the insertion_index will be non-zero.
-        // insertion_index = %yxx insertion byte index (1 byte)
-        // nParsedMode ('y' in this case)
-        // nParsedNum  (0, 1, 2, etc)
-	// Note: Since pSocket->ParseCmd and pSocket->ParseNum are not being
-	// used while this code is running I repurposed them as temporary
-	// storage for the nParsedMode and nParsedNum values until the next
-	// packet generation is started.
-        nParsedMode = pSocket->ParseCmd;
-        nParsedNum = pSocket->ParseNum;
-	nByte = '0'; // Need to set nByte to something other than '%' so we
-	             // can use the regular processing routine.
-      }
-      else {
-        // Else we're not continuing a string insertion and instead we should
-	// process the next character in the page template.
-	//
-        // Collect a byte from the source webpage. It will either be written
-	// to the transmission buffer as-is, or it (and perhaps characters
-	// that follow it) will be processed for replacement in the
-	// transmission buffer. pDataLeft is decremented once for each
-	// character read from the web page template.
-        
-#if OB_EEPROM_SUPPORT == 0
-	nByte = **ppData;
-#endif // OB_EEPROM_SUPPORT == 0
-
-#if OB_EEPROM_SUPPORT == 1
-        if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-          {
-            uint16_t i;
-            // This code is applicable only when the Off-Board EERPOM is used
-	    // to store the IOControl and Configuration webpage templates.
-            //
-            // If we arrive here and find that the pre_buf is almost empty then
-	    // refill it starting with the current location in the
-	    // off_board_eeprom_index. Since the pre_buf_ptr can get incre-
-	    // mented up to 4 times before we check it again we need to reload
-	    // the buffer brefore we reach the end of the buffer. Since we are
-	    // reloading from the current point in the EEPROM no data is lost.
-            if (pre_buf_ptr > (PRE_BUF_SIZE - 6)) {
-              prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, off_board_eeprom_index);
-              for (i = 0; i < (PRE_BUF_SIZE - 1); i++) {
-                pre_buf[i] = I2C_read_byte(0);
-              }
-              pre_buf[PRE_BUF_SIZE - 1] = I2C_read_byte(1);
-              pre_buf_ptr = 0;
-            }
-          }
-	  
-          // Read 1 byte from the pre_buf
-	  nByte = pre_buf[pre_buf_ptr];
-	}
-	else nByte = **ppData;
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-        // Search for '%' symbol in the data stream. The symbol indicates the
-	// start of one of these special fields:
-        // %a - A user entered text field with a device name. Used for GUI
-	//      display so the user can easily tell what device they are
-	//      connected to. Also used as part of the MQTT Topic name. Also
-	//      displayed in the tab "title" field of a browser. Input and
-	//      output. Max 19 chars.
-        // %b - Address values - in the GUI the user will change these values
-	//      if they want to change the IP Address, Gateway Address,
-	//      Netmask or MQTT Server IP Address. Input and output.
-        // %c - HTTP Port Number or MQTT Server Port Number - in the GUI the
-	//      user will change this value if they want to change the Port
-	//      number. Input and output.
-        // %d - MAC values - in the GUI the user will change these values if
-	//      they want to change the MAC address. Input and output.
-        // %e - Statistics display information. Output only.
-        // %f - IO states displayed in simplified form. Output only.
-        // %g - "Config" string to control MQTT Enable, Full/Half Duplex, and
-	//      Home Assistant Auto Discovery functions. Input and Output.
-	// %h - Pin Control string - The pin control string is defined as 32
-	//      characters representing 16 hex bytes of information in text
-	//      format. Each byte is the pin_control character for each IO
-	//      pin. Input and Output.
-	// %i - IO Timer values
-	// %j - IO Names
-        // %l - MQTT Username - This is a user entered text field with a
-	//      Username. Used in MQTT communication. Input and output.
-        // %m - MQTT Password - This is a user entered text field with a
-	//      Password. Used in MQTT communication. Input and output.
-        // %n - MQTT Status - Displays red or green boxes to indicate startup
-	//      status for MQTT (Connection Available, ARP OK, TCP OK, Connect
-	//      OK, MQTT_OK). Output only.
-	// %s - EEPROM presence status. Output only.
-	// %t - Temperature Sensor data. Output only.
-	// %w - Code Revision. Output only.
-        // %y - Indicates the need to insert one of several commonly occuring
-	//      HTML strings. This is to aid in compressing the web page
-	//      templates stored in flash memory.
-        // %z - A bogus variable inserted at the end of the form data to make
-	//      sure that all real data is followed by an & character. This
-	//      helps to find the end of variable length values in the POST
-	//      form. The z value itself is never used.
-      
-        if (nByte == '%') {
-          (*ppData)++;
-          (*pDataLeft)--;
-#if OB_EEPROM_SUPPORT == 1
-          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-	    off_board_eeprom_index++;
-            pre_buf_ptr++;
-	  }
-#endif // OB_EEPROM_SUPPORT == 1
-          
-          // Collect the "nParsedMode" value (the i, o, a, b, c, etc part of
-	  // the field). This, along with the "nParsedNum" digits that follow,
-	  // will determine what data is put in the output stream.
-#if OB_EEPROM_SUPPORT == 0
-	  nParsedMode = **ppData;
-#endif // OB_EEPROM_SUPPORT == 0
-#if OB_EEPROM_SUPPORT == 1
-          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-	    // Read 1 byte from pre_buf
-	    nParsedMode = pre_buf[pre_buf_ptr];
-	    off_board_eeprom_index++;
-            pre_buf_ptr++;
-	  }
-	  else nParsedMode = **ppData;
-#endif // OB_EEPROM_SUPPORT == 1
-          (*ppData)++;
-          (*pDataLeft)--;
-          
-          // Collect the first digit of the "nParsedNum" which follows the
-	  // "nParsedMode". This is the "tens" digit of the two character
-	  // nParsedNum.
-#if OB_EEPROM_SUPPORT == 0
-	  temp = **ppData;
-#endif // OB_EEPROM_SUPPORT == 0
-#if OB_EEPROM_SUPPORT == 1
-          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-	    // Read 1 byte from pre_buf
-	    temp = pre_buf[pre_buf_ptr];
-	    off_board_eeprom_index++;
-            pre_buf_ptr++;
-	  }
-  	  else temp = **ppData;
-#endif // OB_EEPROM_SUPPORT == 1
-          nParsedNum = (uint8_t)((temp - '0') * 10);
-          (*ppData)++;
-          (*pDataLeft)--;
-
-          // Collect the second digit of the "nParsedNum". This is the "ones"
-	  // digit. Add it to the "tens" digit to complete the number in
-	  // integer form.
-#if OB_EEPROM_SUPPORT == 0
-	  temp = **ppData;
-#endif // OB_EEPROM_SUPPORT == 0
-#if OB_EEPROM_SUPPORT == 1
-          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-	    // Read 1 byte from pre_buf
-	    temp = pre_buf[pre_buf_ptr];
-	    off_board_eeprom_index++;
-	    pre_buf_ptr++;
-	  }
-	  else temp = **ppData;
-#endif // OB_EEPROM_SUPPORT == 1
-          nParsedNum = (uint8_t)(nParsedNum + temp - '0');
-          (*ppData)++;
-          (*pDataLeft)--;
-	}
-      }
-
-      if ((nByte == '%') || (pSocket->insertion_index != 0)) {
-        // NOW insert information in the transmit stream based on the nParsedMode
-	// and nParsedNum just collected. Anything inserted in the transmit stream
-	// is in ascii / UTF-8 form.
-
-        if (nParsedMode == 'a') {
-	  // This displays the device name (up to 19 characters)
-          pBuffer = stpcpy(pBuffer, stored_devicename);
-	}
-
-	
-        else if (nParsedMode == 'b') {
-	  // This displays the IP Address, Gateway Address, and Netmask information.
-	  // We need to get the 32 bit values for IP Address, Gateway Address, and
-	  // Netmask and send them as text strings of hex characters (8 characters
-	  // for a 32 bit number, for example "c0a80004").
-	  {
-	    uint32_t temp32;
-	    uip_ipaddr_t * uip_ptr = NULL;
-	    
-            switch (nParsedNum)
-	    {
-	      // Depending on nParsedNum, point the correspondent variable
-	      case 0:
-	        uip_ptr = &uip_hostaddr;
-	        break;
-	      case 4:
-	        uip_ptr = &uip_draddr;
-	        break;
-	      case 8:
-	        uip_ptr = &uip_netmask;
-	        break;
-	      case 12:
-	        uip_ptr = &uip_mqttserveraddr;
-	        break;
-	      default: break;
-            }
-	  
-	    // Convert the value to an 8 digit hex string
-	    if (uip_ptr != NULL) {
-	        temp32 = (*uip_ptr)[0];
-		temp32 <<= 16;
-		temp32 |= (*uip_ptr)[1];
-	        emb_itoa(temp32, OctetArray, 16, 8);
-	    }
-	  
- 	    // Copy OctetArray characters to output. Advance pointers.
-            pBuffer = stpcpy(pBuffer, OctetArray);
-	  }
-	}
-	
-        else if (nParsedMode == 'c') {
-	  // If nParsedNum == 0 this is the HTML Port number (5 characters)
-	  // If nParsedNum == 1 this is the MQTT Port number (5 characters)
-	  // In both cases we need to get a single 16 bit integer from storage
-	  // but put it in the transmission buffer as 5 alpha characters in
-	  // hex format.
-
-	  // Write the 5 digit Port value in hex
-	  if (nParsedNum == 0) emb_itoa(stored_port, OctetArray, 16, 5);
-	  else emb_itoa(stored_mqttport, OctetArray, 16, 5);
-	    
-	  // Copy OctetArray characters to output. Advance pointers.
-          pBuffer = stpcpy(pBuffer, OctetArray);
-        }
-	
-        else if (nParsedMode == 'd') {
-	  // This displays the MAC adddress information (2 characters per
-	  // octet). We send the 12 characters in the mac_string (rather
-	  // than from the uip_ethaddr bytes) as the mac_string is already
-	  // in alphanumeric format.
-          pBuffer = stpcpy(pBuffer, mac_string);
-	}
-	
-
-#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-        else if ((nParsedMode == 'e') && (nParsedNum < 22)) {
-	  // This displays the statistics information (10 characters per
-	  // data item). We need to get a single uint32_t from storage but
-	  // put it in the output stream as a character representation of
-	  // the data.
-	  // uip_stat.ip.drop       Number of dropped packets at the IP layer.
-	  // uip_stat.ip.recv       Number of received packets at the IP layer.
-	  // uip_stat.ip.sent       Number of sent packets at the IP layer.
-	  // uip_stat.ip.vhlerr     Number of packets dropped due to wrong IP version or header length.
-	  // uip_stat.ip.hblenerr   Number of packets dropped due to wrong IP length, high byte.
-	  // uip_stat.ip.lblenerr   Number of packets dropped due to wrong IP length, low byte.
-	  // uip_stat.ip.fragerr    Number of packets dropped since they were IP fragments.
-	  // uip_stat.ip.chkerr     Number of packets dropped due to IP checksum errors.
-	  // uip_stat.ip.protoerr   Number of packets dropped since they were neither ICMP, UDP nor TCP.
-	  // uip_stat.icmp.drop     Number of dropped ICMP packets.
-	  // uip_stat.icmp.recv     Number of received ICMP packets.
-	  // uip_stat.icmp.sent     Number of sent ICMP packets.
-	  // uip_stat.icmp.typeerr  Number of ICMP packets with a wrong type.
-	  // uip_stat.tcp.drop      Number of dropped TCP segments.
-	  // uip_stat.tcp.recv      Number of received TCP segments.
-	  // uip_stat.tcp.sent      Number of sent TCP segments.
-	  // uip_stat.tcp.chkerr    Number of TCP segments with a bad checksum.
-	  // uip_stat.tcp.ackerr    Number of TCP segments with a bad ACK number.
-	  // uip_stat.tcp.rst       Number of received TCP RST (reset) segments.
-	  // uip_stat.tcp.rexmit    Number of retransmitted TCP segments.
-	  // uip_stat.tcp.syndrop   Number of dropped SYNs due to too few connections avaliable.
-	  // uip_stat.tcp.synrst    Number of SYNs for closed ports, triggering a RST.
-	  
-          switch (nParsedNum)
-	  {
-	    // Output the statistics. First convert to 10 digit Decimal.
-	    case 0:  emb_itoa(uip_stat.ip.drop,      OctetArray, 10, 10); break;
-	    case 1:  emb_itoa(uip_stat.ip.recv,      OctetArray, 10, 10); break;
-	    case 2:  emb_itoa(uip_stat.ip.sent,      OctetArray, 10, 10); break;
-	    case 3:  emb_itoa(uip_stat.ip.vhlerr,    OctetArray, 10, 10); break;
-	    case 4:  emb_itoa(uip_stat.ip.hblenerr,  OctetArray, 10, 10); break;
-	    case 5:  emb_itoa(uip_stat.ip.lblenerr,  OctetArray, 10, 10); break;
-	    case 6:  emb_itoa(uip_stat.ip.fragerr,   OctetArray, 10, 10); break;
-	    case 7:  emb_itoa(uip_stat.ip.chkerr,    OctetArray, 10, 10); break;
-	    case 8:  emb_itoa(uip_stat.ip.protoerr,  OctetArray, 10, 10); break;
-	    case 9:  emb_itoa(uip_stat.icmp.drop,    OctetArray, 10, 10); break;
-	    case 10: emb_itoa(uip_stat.icmp.recv,    OctetArray, 10, 10); break;
-	    case 11: emb_itoa(uip_stat.icmp.sent,    OctetArray, 10, 10); break;
-	    case 12: emb_itoa(uip_stat.icmp.typeerr, OctetArray, 10, 10); break;
-	    case 13: emb_itoa(uip_stat.tcp.drop,     OctetArray, 10, 10); break;
-	    case 14: emb_itoa(uip_stat.tcp.recv,     OctetArray, 10, 10); break;
-	    case 15: emb_itoa(uip_stat.tcp.sent,     OctetArray, 10, 10); break;
-	    case 16: emb_itoa(uip_stat.tcp.chkerr,   OctetArray, 10, 10); break;
-	    case 17: emb_itoa(uip_stat.tcp.ackerr,   OctetArray, 10, 10); break;
-	    case 18: emb_itoa(uip_stat.tcp.rst,      OctetArray, 10, 10); break;
-	    case 19: emb_itoa(uip_stat.tcp.rexmit,   OctetArray, 10, 10); break;
-	    case 20: emb_itoa(uip_stat.tcp.syndrop,  OctetArray, 10, 10); break;
-	    case 21: emb_itoa(uip_stat.tcp.synrst,   OctetArray, 10, 10); break;
-	  }
-        pBuffer = stpcpy(pBuffer, OctetArray);
-	}
-#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
-        else if ((nParsedMode == 'e') && (nParsedNum >= 30) && (nParsedNum < 40)) {
-          if (nParsedNum == 31) {
-	    emb_itoa(second_counter, OctetArray, 10, 10);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-	  }
-          else if (nParsedNum == 32) {
-	    emb_itoa(TRANSMIT_counter, OctetArray, 10, 10);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-	  }
-          else if (nParsedNum == 33) {
-	    for (i=0; i<5; i++) {
-              int2hex(stored_debug[i]);
-              pBuffer = stpcpy(pBuffer, OctetArray);
-	    }
-	  }
-          else if (nParsedNum == 35) {
-            *pBuffer++ = '0';
-            *pBuffer++ = '0';
-            *pBuffer++ = '0';
-            *pBuffer++ = '0';
-            int2hex(MQTT_resp_tout_counter);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-            int2hex(MQTT_not_OK_counter);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-            int2hex(MQTT_broker_dis_counter);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-	  }
-	}
-#endif // DEBUG_SUPPORT
-
-
-#if DEBUG_SENSOR_SERIAL == 1
-        else if ((nParsedMode == 'e') && (nParsedNum >= 40)) {
-	  // This is for diagnostic use only and is NOT normally enabled
-	  // in the compile options. This displays the Temperature Sensor
-	  // Serial Numbers and was made necessary due to some suppliers
-	  // providing DS18B20 devices with identical serial numbers.
-          if ((nParsedNum - 40) <= numROMs) {
-	    {
-              int n;
-              for (n=6; n>0; n--) {
-                int2hex(FoundROM[nParsedNum - 40][n]);
-	        pBuffer = stpcpy(pBuffer, OctetArray);
-              }
-	    }
-          }
-	  // If the sensor does not exist ...
-	  else {
-	    pBuffer = stpcpy(pBuffer, "------------");
-	  }
-	}
-#endif // DEBUG_SENSOR_SERIAL
-
-
-        else if (nParsedMode == 'f') {
-	  // Display the pin state information in the format used by the "98" and
-	  // "99" command. "99" is the command used in the original Network Module.
-	  // For output pins display the state in the pin_control byte.
-	  // For input pins if the Invert bit is set the ON_OFF state needs to be
-	  // inverted before displaying.
-	  // Bits are output for Pin 16 first and Pin 1 last
-	  i = 15;
-	  while( 1 ) {
-	    if (pin_control[i] & 0x02) {
-	      // This is an output
-	      if (pin_control[i] & 0x80) {
-	        // Output is ON
-		*pBuffer++ = '1';
-	      }
-	      else {
-		// Output is OFF
-		*pBuffer++ = '0';
-	      }
-            }
-            else {
-	      // This is an input
-	      if (pin_control[i] & 0x80) {
-	        // Input is ON, invert if needed
-	        if (pin_control[i] & 0x04) *pBuffer = '0';
-	        else *pBuffer = '1';
-                pBuffer++;
-	      }
-	      else {
-		// Input is OFF, invert if needed
-		if (pin_control[i] & 0x04) *pBuffer = '1';
-		else *pBuffer = '0';
-                pBuffer++;
-	      }
-	    }
-	    if (i == 0) break;
-	    i--;
-          }
-	}
-	
-
-        else if (nParsedMode == 'g') {
-	  // This displays the Config string, currently defined as follows:
-	  // Communicated to and from the web pages as 2 characters making
-	  // a hex encoded byte. Stored in memory as a single byte.
-	  // Bit 8: Undefined, 0 only
-	  // Bit 7: Undefined, 0 only
-	  // Bit 6: Undefined, 0 only
-	  // Bit 5: Undefined, 0 only
-	  // Bit 4: DS18B20 1 = Enable, 0 = Disable
-	  // Bit 3: MQTT 1 = Enable, 0 = Disable
-	  // Bit 2: Home Assistant Auto Discovery 1 = Enable, 0 = Disable
-	  // Bit 1: Duplex 1 = Full, 0 = Half
-	  // There is only 1 'g' ID so we don't need to check the nParsedNum.
-	  
-	  // Convert Config settngs byte into two hex characters
-          int2hex(stored_config_settings);
-	  pBuffer = stpcpy(pBuffer, OctetArray);
-	}
-	
-	
-        else if (nParsedMode == 'h') {
-	  // This sends the Pin Control String, defined as follows:
-	  // 32 characters
-	  // The 32 characters represent 16 hex bytes of information in text
-	  // format. Each byte is the pin_control character for each IO pin
-	  // starting with pin 01 on the left.
-	  // Note: Input pins needed to have the ON/OFF bit inverted if the
-	  //   Invert bit is set.
-	  	  
-	  // Insert pin_control bytes
-	  {
-	    int i;
-	    uint8_t j;
-	    for (i = 0; i <16; i++) {
-	      j = pin_control[i];
-	      if ((j & 0x02) == 0x00) {
-	        // This is an input pin - check the invert bit
-	        if (j & 0x04) { // Invert is set - flip the ON/OFF bit
-		  if (j & 0x80) j &= 0x7f;
-		  else j |= 0x80;
-		}
-	      }
-	      int2hex(j);
-	      pBuffer = stpcpy(pBuffer, OctetArray);
-            }
-	  }
-	}
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-        else if (nParsedMode == 'i') {
-	  // This sends the IO Timer units and IO Timer values to the Browser
-	  // defined as follows:
-	  // 2 bytes represented as hex encoded strings (4 nibbles)
-	  // Upper 2 bits are units
-	  // Lower 14 bits are value
-	  {
-	    uint8_t j;
-	    j = (uint8_t)((IO_TIMER[nParsedNum] & 0xff00) >> 8);
-	    int2hex(j);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-	    j = (uint8_t)(IO_TIMER[nParsedNum] & 0x00ff);
-	    int2hex(j);
-            pBuffer = stpcpy(pBuffer, OctetArray);
-          }
-	}
-	
-	
-        else if (nParsedMode == 'j') {
-	  // This displays IO Names in user friendly format (1 to 15 characters)
-          pBuffer = stpcpy(pBuffer, IO_NAME[nParsedNum]);
-	}
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-        else if (nParsedMode == 'l') {
-	  // This displays MQTT Username information (0 to 10 characters)
-          pBuffer = stpcpy(pBuffer, stored_mqtt_username);
-	}
-
-
-        else if (nParsedMode == 'm') {
-	  // This displays MQTT Password information (0 to 10 characters)
-          pBuffer = stpcpy(pBuffer, stored_mqtt_password);
-	}
-
-
-        else if (nParsedMode == 'n') {
-	  // This displays the MQTT Start Status information as five
-	  // red/green boxes showing Connections available, ARP status,
-	  // TCP status, MQTT Connect status, and MQTT Error status.
-	  no_err = 0;
-
-          switch (nParsedNum)
-	  {
-	    case 0:
-              // Connection request status
-	      if (mqtt_start_status & MQTT_START_CONNECTIONS_GOOD) no_err = 1;
-	      break;
-	    case 1:
-	      // ARP request status
-	      if (mqtt_start_status & MQTT_START_ARP_REQUEST_GOOD) no_err = 1;
-	      break;
-	    case 2:
-	      // TCP connection status
-	      if (mqtt_start_status & MQTT_START_TCP_CONNECT_GOOD) no_err = 1;
-	      break;
-	    case 3:
-	      // MQTT Connection status 1
-	      if (mqtt_start_status & MQTT_START_MQTT_CONNECT_GOOD) no_err = 1;
-              break;
-	    case 4:
-	      // MQTT start complete with no errors
-	      if ((MQTT_error_status == 1) && ((mqtt_start_status & 0xf0) == 0xf0) ) no_err = 1;
-              break;
-	    default:
-	      break;
-	  }
-	  
-	  if (no_err == 1) *pBuffer++ = '1'; // Paint a green square
-	  else *pBuffer++ = '0'; // Paint a red square
-	}
-
-
-#if OB_EEPROM_SUPPORT == 1
-        else if (nParsedMode == 's') {
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-	  if (nParsedNum == 2) {
-	    // This sends the Parse Fail reason code. %s02
-	    // Note: String copied to the pBuffer must be 40 characters
-	    if (upgrade_failcode == UPGRADE_FAIL_FILE_READ_CHECKSUM)
-	      pBuffer = stpcpy(pBuffer, "Checksum error receiving file...........");
-	    else if (upgrade_failcode == UPGRADE_FAIL_EEPROM_MISCOMPARE)
-	      pBuffer = stpcpy(pBuffer, "EEPROM content miscompare...............");
-	    else if (upgrade_failcode == STRING_EEPROM_MISCOMPARE)
-	      pBuffer = stpcpy(pBuffer, "EEPROM content miscompare...............");
-	    else if (upgrade_failcode == UPGRADE_FAIL_NOT_SREC)
-	      pBuffer = stpcpy(pBuffer, "SREC file format incorrect..............");
-	    else
-	      pBuffer = stpcpy(pBuffer, "Unknown Error...........................");
-	  }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-	}
-#endif // OB_EEPROM_SUPPORT == 1
-
-
-        else if ((nParsedMode == 't') && (stored_config_settings & 0x08)) {
-	  // This displays temperature sensor data for 5 sensors and the
-	  // text fields around that data IF DS18B20 mode is enabled.
-	  
-	  if (nParsedNum == 0) {
-	    #define TEMPTEXT "<p>Temperature Sensors<br>"
-	    pBuffer = stpcpy(pBuffer, TEMPTEXT);
-	    #undef TEMPTEXT
-	  }
-	  
-	  // Output the sensor ID numbers
-	  // For display we output the MSByte first followed by remaining
-	  // bytes. A total of 6 bytes are displayed in hex encoded format.
-	  if (nParsedNum <= numROMs) {
-	    *pBuffer++ = ' ';
-	    {
-	      int i;
-	      for (i=6; i>0; i--) {
-	        int2hex(FoundROM[nParsedNum][i]);
-	        pBuffer = stpcpy(pBuffer, OctetArray);
-	      }
-              pBuffer = stpcpy(pBuffer, " ");
-	    }
-	  }
-	  // If the sensor does not exist ...
-	  else {
-	    pBuffer = stpcpy(pBuffer, " ------------ ");
-	  }
-	  
-	  // Output temperature data
-          pBuffer = show_temperature_string(pBuffer, nParsedNum);
-	  if (nParsedNum == 4) {
-	    #define TEMPTEXT "</p>"
-	    pBuffer = stpcpy(pBuffer, TEMPTEXT);
-	    #undef TEMPTEXT
-	  }
-	}
-
-
-        else if (nParsedMode == 'w') {
-	  // This displays Code Revision information (13 characters) plus Code
-	  // Type (13 characters, '.' characters are added to make sure the
-	  // length is always 13)
-          pBuffer = stpcpy(pBuffer, code_revision);
-	  
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD	&& I2C_SUPPORT == 0 && OB_EEPROM_SUPPORT == 0
-          pBuffer = stpcpy(pBuffer, " Browser Only");
-#endif
-
-#if BUILD_SUPPORT == MQTT_BUILD	&& I2C_SUPPORT == 0 && OB_EEPROM_SUPPORT == 0
-          pBuffer = stpcpy(pBuffer, " MQTT .......");
-#endif
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD	&& I2C_SUPPORT == 1 && OB_EEPROM_SUPPORT == 1
-          pBuffer = stpcpy(pBuffer, " Browser UPG ");
-#endif
-
-#if BUILD_SUPPORT == MQTT_BUILD	&& I2C_SUPPORT == 1 && OB_EEPROM_SUPPORT == 1
-          pBuffer = stpcpy(pBuffer, " MQTT UPG ...");
-#endif
-	}
-
-
-        else if (nParsedMode == 'y') {
-          // Indicates the need to insert one of several commonly occuring HTML
-          // strings. These strings were created to aid in compressing the web
-	  // page templates stored in flash memory by storing the strings once,
-	  // then inserting them in the web page template as that template is
-	  // sent to the browser for display.
-	  //
-	  // Processing of a long string insertion is a special case and may
-	  // bridge over more than one call to the CopyHttpData() function. This
-	  // is to better utilize the transmit buffer. Without the "bridging" the
-	  // function would have to always make sure there is enough buffer space
-	  // to hold the longest string, whether a string is being sent or not.
-	  // This would waste buffer space and require many more packets to send
-	  // an HTML page.
-	  //
-	  // Bridging of calls to the CopyHttpData() function is acomplished as
-	  // follows:
-	  // a) If a %yxx placeholder is detected in the template as much of the
-	  //    replacement string is inserted in the send buffer as possible.
-	  // b) An "insertion_index" is filled to contain the index into the
-	  //    string being inserted into the transmit buffer. If this index
-	  //    is non-zero we know we are in the process of inserting a %yxx
-	  //    string. If the index is zero we are NOT in the process of
-	  //    inserting a %yxx string.
-	  // c) If the CopyHttpData() function hits the maximum character
-	  //    insertion limit for the packet it does a normal return to the
-	  //    calling function, and the insertion_index is retained in the
-	  //    socket struct. nParsedMode and nParsedNum are also retained
-	  //    in the socket struct in the pSocket->ParseCmd and
-	  //    pSocket->ParseNum variables. This stores the information
-	  //    needed to continue the string insertion on the next call to
-	  //    CopyHttpData().
-	  // d) If the entire string is inserted successfully the
-	  //    insertion_index is cleared to 0.
-	  // d) When CopyHttpData() is called again it will check the
-	  //    insertion_index to determine if a string insertion was prev-
-	  //    iously underway. If so the function will jump to this point
-	  //    in the routine and will continue the string insertion.
-          
-	  // insertion_index will be 0 if we are just starting insertion of a
-	  //   string.
-	  // insertion_index will be non-0 if a string insertion was started
-	  //   and is not yet complete. In this case insertion_index is an
-	  //   index to the next character in the source string that is to be
-	  //   inserted into the transmit buffer.
-
-          // pSocket->ParseCmd and pSocket->ParseNum are used to temporarily
-          // store the nParsedMode and nParsedNum values until the start of
-	  // the next transmit packet generation. These struct are repurposed
-	  // for this storage because they are not being used while this code
-	  // is running.
-
-	  i = pSocket->insertion_index;
-	  pSocket->ParseCmd = nParsedMode;
-	  pSocket->ParseNum = nParsedNum;
-	  
-	  // The insertion strings are stored as an array of strings. nParsedNum
-	  // is used as an index to select the needed string, and i is used as
-	  // an index to single characters in each string. Also, the string
-	  // length for each string in the "array of strngs" is stored in an
-	  // "array of string lengths" with nParsedNum again used as an index
-	  // to select the correct value.
-          // Access the strings and string lengths as follows:
-          // ps[i].str
-          // ps[i].size
-          *pBuffer = (uint8_t)ps[nParsedNum].str[i];
-	  pSocket->insertion_index++;
-	  if (pSocket->insertion_index == ps[nParsedNum].size) pSocket->insertion_index = 0;
-          pBuffer++;
-	}
-      }
-
-
-      else {
-        // If the above code did not process a "%" nParsedMode code and we were
-	// not continuing a string insertion then whatever character we read from
-	// the page template is copied as-is to the uip_buf for transmission.
-        *pBuffer = nByte;
-        *ppData = *ppData + 1;
-        *pDataLeft = *pDataLeft - 1;
-        pBuffer++;
-#if OB_EEPROM_SUPPORT == 1
-        if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-          off_board_eeprom_index++;
-	  pre_buf_ptr++;
-	}
-#endif // OB_EEPROM_SUPPORT == 1
-      }
-    }
-    else break;
-  }
-  return (pBuffer - pBuffer_start);
-}
-
-
-char *show_temperature_string(char *pBuffer, uint8_t nParsedNum)
-{
-  // Display temperature strings in degrees C and degrees F
-  // Note: &#8451; inserts a degree symbol followed by C.
-  // Note: &#8457; inserts a degree symbol followed by F.
-  convert_temperature(nParsedNum, 0);      // Convert to degrees C in OctetArray
-  pBuffer = stpcpy(pBuffer, OctetArray);     // Display sensor value
-  #define TEMPTEXT "&#8451; "              // Display degress C symbol
-  pBuffer = stpcpy(pBuffer, TEMPTEXT);
-  #undef TEMPTEXT
-  
-  convert_temperature(nParsedNum, 1);      // Convert to degrees F in OctetArray
-  pBuffer = stpcpy(pBuffer, OctetArray);     // Display sensor value
-  #define TEMPTEXT "&#8457;<br>"           // Display degress F symbol
-  pBuffer = stpcpy(pBuffer, TEMPTEXT);
-  #undef TEMPTEXT
-  
-  return pBuffer;
-}
-
-
-void HttpDInit(void)
-{
-  // Initialize the structures that manage each connection in the form of a
-  // protosocket
-  int i;
-  register struct uip_conn *uip_connr = uip_conn;
-  
-  // Initialize the struct tHttpD values
-  for (i = 0; i < UIP_CONNS; i++) {
-    uip_connr = &uip_conns[i];
-//    init_tHttpD_struct(&uip_connr->appstate.HttpDSocket);
-    init_tHttpD_struct(&uip_connr->appstate.HttpDSocket, i);
-  }
-
-  // Start listening on our port
-  uip_listen(htons(Port_Httpd));
-}
-
-
-// void init_tHttpD_struct(struct tHttpD* pSocket) {
-void init_tHttpD_struct(struct tHttpD* pSocket, int i) {
-  // Initialize the contents of the struct tHttpD
-  // This function is called UIP_CONNS times by the HttpDinit function. It is
-  // called once for each possible connection. The function sets the initial
-  // values within the pSocket structure to give a new connection a "starting
-  // place", such as which page to initially display when a connection is made.
-  
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  pSocket->current_webpage = WEBPAGE_IOCONTROL;
-  pSocket->structID = i; // TEMPORARY DEBUG MARKER
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-  
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-  pSocket->current_webpage = WEBPAGE_UPLOADER;
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-// UARTPrintf("init_tHttpd_struct\r\n");
-
-  pSocket->insertion_index = 0;
-  init_off_board_string_pointers(pSocket);
-}
-
-
-void HttpDCall(uint8_t* pBuffer, uint16_t nBytes, struct tHttpD* pSocket)
-{
-  uint16_t nBufSize;
-  int i;
-  uint8_t j;
-  char compare_buf[32];
-  uint8_t GET_response_type = 200;
-
-  // HttpDCall() is used to:
-  // a) Receive a request or data from the Browser:
-  //    In the form of a GET if the Browser is requesting a web page or other
-  //    other action.
-  //    In the form of a POST if the Broswer is sending data to the
-  //    application.
-  //    "if (uip_newdata()" part of the code below.
-  // b) Send a requsted web page to the Browser:
-  //    This uses the "if (uip_connected())" part of the code below to start a
-  //    new page transmission and the "if (uip_acked())" part of the code
-  //    below if continuing a page transmission.
-
-  i = 0;
-  j = 0;
-
-// UARTPrintf("HttpDCall: current_webpage = ");
-// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("   structID = ");
-// emb_itoa(pSocket->structID, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-  if (uip_connected()) {
-    //Initialize this connection
-    
-// UARTPrintf("HttpDCall: uip_connected  current_webpage = ");
-// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("   structID = ");
-// emb_itoa(pSocket->structID, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-    if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
-      pSocket->pData = g_HtmlPageIOControl;
-      pSocket->nDataLeft = HtmlPageIOControl_size;
-      // nDataLeft above is used when we get around to calling CopyHttpData
-      // in state STATE_SENDDATA
-    }
-    
-    if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-      pSocket->pData = g_HtmlPageConfiguration;
-      pSocket->nDataLeft = HtmlPageConfiguration_size;
-    }
-    
-    if (pSocket->current_webpage == WEBPAGE_SSTATE) {
-      pSocket->pData = g_HtmlPageSstate;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
-    }
-
-#if OB_EEPROM_SUPPORT == 1
-    if (pSocket->current_webpage == WEBPAGE_LOADUPLOADER) {
-      pSocket->pData = g_HtmlPageLoadUploader;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageLoadUploader) - 1);
-    }
-#endif // OB_EEPROM_SUPPORT == 1
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-    if (pSocket->current_webpage == WEBPAGE_STATS1) {
-      pSocket->pData = g_HtmlPageStats1;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
-    }
-#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
-    if (pSocket->current_webpage == WEBPAGE_STATS2) {
-      pSocket->pData = g_HtmlPageStats2;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
-    }
-#endif // DEBUG_SUPPORT
-
-#if DEBUG_SENSOR_SERIAL == 1
-    if (pSocket->current_webpage == WEBPAGE_SENSOR_SERIAL) {
-      pSocket->pData = g_HtmlPageTmpSerialNum;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
-    }
-#endif // DEBUG_SENSOR_SERIAL
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-    if (pSocket->current_webpage == WEBPAGE_UPLOADER) {
-      pSocket->pData = g_HtmlPageUploader;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
-    }
-
-    if (pSocket->current_webpage == WEBPAGE_EXISTING_IMAGE) {
-      pSocket->pData = g_HtmlPageExistingImage;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
-    }
-
-    if (pSocket->current_webpage == WEBPAGE_TIMER) {
-      pSocket->pData = g_HtmlPageTimer;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
-    }
-
-    if (pSocket->current_webpage == WEBPAGE_UPLOAD_COMPLETE) {
-      pSocket->pData = g_HtmlPageUploadComplete;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
-    }
-
-    if (pSocket->current_webpage == WEBPAGE_PARSEFAIL) {
-      pSocket->pData = g_HtmlPageParseFail;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
-    }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-#if OB_EEPROM_SUPPORT == 1
-    if (pSocket->current_webpage == WEBPAGE_EEPROM_MISSING) {
-      pSocket->pData = g_HtmlPageEEPROMMissing;
-      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
-    }
-#endif // OB_EEPROM_SUPPORT == 1
-
-    pSocket->nState = STATE_CONNECTED;
-    pSocket->nPrevBytes = 0xFFFF;
-
-    // Note on TCP Fragment reassembly: The uip_connected() steps ABOVE are
-    // run for every TCP packet and fragment. That being the case we need to
-    // be sure that TCP Fragment reassembly values are not changed in these
-    // steps.
-  }
-
-  else if (uip_acked()) {
-
-// UARTPrintf("HttpDCall: uip_acked  current_webpage = ");
-// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("   structID = ");
-// emb_itoa(pSocket->structID, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-    // if uip_acked() is true we will be in the STATE_SENDDATA state and
-    // only need to run the "senddata" part of this routine. This typically
-    // happens when there are multiple packets to send to the Broswer in
-    // response to a POST or GET, so we may repeat this loop in
-    // STATE_SENDDATA several times.
-    goto senddata;
-  }
-  
-  else if (uip_newdata()) {
-
-// UARTPrintf("HttpDCall: uip_newdata  current_webpage = ");
-// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("   structID = ");
-// emb_itoa(pSocket->structID, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-    // This is the start of a new Browser session, or it is additional packets
-    // sent to complete a transmission from the Browser.
-    //
-    // In this limited application the only "new data" packets a browser can
-    // send to the web server are "POST" or "GET" packets, as the browser can
-    // only reply to the pages the web server sent to it. We're going to parse
-    // the data portion of the packet.
-    //
-    // This code will re-assemble POST/GET datagrams that arrive in
-    // "fragmented" packets. Note that we are not really receiving "fragments"
-    // in the traditional sense of an original packet being broken up by
-    // router points in the network. In that case we could have used the MF
-    // flag ("More Fragments") in the IP Header as each packet arrived to
-    // determine if the final packet was received. But in this case we have
-    // given the remote host a packet size limitation (via MSS settings), and
-    // the remote host has broken up the TCP datagram into small packets. There
-    // is nothing in the IP or TCP headers that shows a clear connection
-    // between the packets except for the sequence and ack numbers. That being
-    // the case this code relies on the nParseLeft value to determine when a
-    // sequence of packets with the TCP datagram in it completes.
-    //
-    // While possibly a misnomer, I will call these "TCP Fragments" in the
-    // comments in this code.
-    //
-    // The TCP Fragments are tracked and reassembled by saving the parse state
-    // and values at each step in the parsing so that incomplete parse steps
-    // can be continued when the next packet in a TCP Fragment series arrives.
-    // Note that it is possible for one of the following to happen:
-    //   1) POST/GET data can arrive complete in the first packet (no TCP
-    //      Fragments).
-    //   2) TCP Fragment packets can be anywhere from 2 to "many" packets, and
-    //      the fragment break can be at any character in datagram - it can
-    //      even occur at the last character of the POST/GET data where there
-    //      is nothing useful left to parse, but there might still be a tiny
-    //      fragment coming in to complete the TCP Fragment series. Note this
-    //      should never happen if we parse the end of POST data.
-    //   3) The first POST/GET packet will always start with "POST" or "GET "
-    //      as the first four characters in the datagram. This comes right
-    //      after the LLH, IP, and TCP Headers, so it will start at byte 55 of
-    //      the uip_buf. We won't count on that exact byte number, but it is
-    //      reasonable to assume that the buffer is always 400 bytes or more,
-    //      and that the "POST" or "GET " phrase will be completely contained
-    //      within the first packet, thus the phrase itself will never be
-    //      fragmented.
-    //   3a) Once the "POST" phrase is found it can be followed in the
-    //      datagram by a very long HTML preamble (the overhead stuff sent by
-    //      browsers that precedes the POST data content ... hundreds of
-    //      bytes). So it is very likely that TCP Fragments will occur within
-    //      this preamble area before we find the actual POST data, or that
-    //      the preamble will cause the POST data to get pushed onto a
-    //      fragmentation boundary.
-    //   3b) Likewise the GET request can be followed by a very long HTML
-    //      preamble (I guess I should call it a post-amble in this case). The
-    //      post-amble can also be hundreds of bytes. It is less problematic
-    //      in the GET case because everything we want to parse from the GET
-    //      message will occur prior to the post-amble and has zero chance of
-    //      being fragmented. So the code is not written to handle any
-    //      fragmentation of GET requests.
-    //   3c) With the addition of Off-Board EEPROMs and the ability to upload
-    //      replacement code via Ethernet the POST pre-amble is parsed for the
-    //      "Content-Type" phrase. The phrase is used to determine if the POST
-    //      data contains a new firmware file, or if the POST data contains
-    //      user entered responses to GUI fields.
-    //   3d) Otherwise this code by-passes all the preamble/post-amble stuff
-    //      but saves the parsing state so it knows we are either looking for
-    //      data or disposing of extraneous fragments.
-    //
-      
-    // In the code below we are parsing for the "POST" or "GET " phrase. We do
-    // not need to worry about TCP fragmentation because the phrase will appear
-    // very early in the first packet (easily within the first 100 bytes).
-    // However, once we receive "POST" we go into a loop looking for the
-    // "\r\n\r\n" sequence, and we need to be able to handle TCP fragmentation
-    // during that search.
-    //
-    // If we are parsing a TCP fragment then pSocket->nState may have been
-    // restored to STATE_PARSEPOST or STATE_PARSEGET. If so the parse code
-    // will run but won't do anything.
-    
-    // If we are in STATE_CONNECTED (meaning we are reading the first and
-    // perhaps only packet in a series) check the first five characters of the
-    // uip_buf to see if this is a POST or GET request.
-    if (pSocket->nState == STATE_CONNECTED) {
-      if (memcmp("POST", &pBuffer[0], 4) == 0) pSocket->nState = STATE_GOTPOST;
-      if (memcmp("GET", &pBuffer[0], 3) == 0)  pSocket->nState = STATE_GOTGET;
-      pBuffer += 4;
-      nBytes -= 4;
-      // We are collecting the first packet. Clear parse_tail so it will be
-      // ready if there is a TCP Fragment.
-      parse_tail[0] = '\0';
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-      // Initialize the find_content_info state. It is used to manage the
-      // search for the Content-Type and Content-Length phrases.
-      find_content_info = SEEK_CONTENT_INFO;
-
-// UARTPrintf("\r\n");
-// UARTPrintf("find_content_info = SEEK_CONTENT_INFO initialize");
-// UARTPrintf("\r\n");
-
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-    }
-    
-
-    if (pSocket->nState == STATE_GOTPOST) {
-      // If this is a BROWSER_ONLY_BUILD or a MQTT_BUILD then the only kind of
-      // POST we can receive is a "normal" POST consisting of values the user
-      // entered in the GUI. If that is the case the data we want follows the
-      // first \r\n\r\n sequence in the html body.
-      // If this is a CODE_UPLOADER_BUILD then the only kind of POST we can
-      // receive is a "file" POST wherein the POST consists of a new firmware
-      // file. If that is the case the data we want follows the second
-      // \r\n\r\n sequence in the html body. Note that we need to search the
-      // html pre-amble for the "Content-Length" when running a Code Uploader
-      // build.
-
-// UARTPrintf("\r\n");
-// UARTPrintf("pSocket->nState == STATE_GOTPOST Search for rnrn");
-// UARTPrintf("\r\n");
-
-      if (nBytes == 0) {
-        // If we enter the search at end of fragment we exit and will come
-	// back to this point with the next fragment.
-        return;
-      }
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-      while (nBytes != 0) {
-	// The following searches for the \r\n\r\n sequence
-	if (pSocket->nNewlines == 2) {
-	  // This handles the case where a TCP Fragmentation occured in the
-	  // previous packet just as we collected the second \n. In that case
-	  // the search does not continue.
-	}
-	else {
-          // We're processing packets but haven't found the \r\n\r\n sequence
-          // yet. The sequence detector really just looks for two \n in a row,
-          // ignoring the first \r. If any character other than \r appears
-	  // between the \n and \n the Newlines counter is zero'd.
-          if (*pBuffer == '\n') pSocket->nNewlines++;
-          else if (*pBuffer == '\r') { }
-          else pSocket->nNewlines = 0;
-          pBuffer++;
-          nBytes--;
-          if (nBytes == 0) {
-            // If we hit end of fragment we exit and will come back to the loop
-            // with the next fragment.
-            return;
-          }
-        }
-
-        if (pSocket->nNewlines == 2) {
-          // Beginning of non-file POST found.
-	  
-	  // Clear nNewlines for future POSTs
-	  pSocket->nNewlines = 0;
-	  
-          // Set current_webpage to NULL. This will be used later to aid in
-	  // determining if the POST is coming from an IOControl POST or from
-	  // a Configuration POST.
-	  pSocket->current_webpage = WEBPAGE_NULL;
-	  
-	  // Initialize parse_tail for first pass of parsing
-	  parse_tail[0] = '\0';
-	  
-          // Start parsing
-          pSocket->nState = STATE_PARSEPOST;
-	  if (nBytes == 0) {
-	    // If we are at end of fragment here we exit and will return in
-	    // STATE_PARSEPOST
-	    return;
-	  }
-          break;
-        }
-      }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-	
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-      while (nBytes != 0) {
-	// Search for the "Content-Length: " phrase. We're processing the first
-	// packet but haven't found the phrase yet.
-        if ((*pBuffer == 'C') && (find_content_info == SEEK_CONTENT_INFO)) {
-          // Might have first character of the phrase. Copy 16 characters from
-	  // pBuffer into a temporary buffer and check for a match to the
-	  // phrase.
-          {
-            int i;
-            
-	    for (i=0; i<16; i++) {
-              compare_buf[i] = *pBuffer;
-              pBuffer++;
-              nBytes--;
-            }
-            // At this point we have captured enough characters to check for
-            // the "Content-Length: " phrase.
-            if (strncmp(compare_buf, "Content-Length: ", 16) == 0) {
-              // Found "Content-Length: "
-	      i = 0;
-	      while (1) {
-                // Extract the content length value. The value starts with the
-	        // first character following the phrase, and continues until a
-	        // ';' or '\r' or '\n' is found.
-	        if (*pBuffer == ';' || *pBuffer == '\r' || *pBuffer == '\n') {
-		  OctetArray[i] = '\0';
-		  break;
-		}
-		else {
-		  OctetArray[i++] = *pBuffer;
-		  pBuffer++;
-                  nBytes--;
-		}
-	      }
-	      // Convert OctetArray to an integer. This needs to be a 32 bit
-	      // integer as the file content could exceed 65536 characters but
-	      // will not exceed 99999
-	      //
-	      // See this URL for an explanation of the use of (uint16_t) and
-	      // "U" in the equations below:
-	      // https://www.microchip.com/forums/m1126560.aspx
-	      // Note: Simple addition and subtraction doesn't see to have this
-	      // problem ... appears to be division and multiplication only.
-	      // Note: Can't use atoi() ... it seems to have the same problem.
-
-	      file_length =  ((uint16_t)(OctetArray[0] - '0') * 10000U);
-	      file_length += ((uint16_t)(OctetArray[1] - '0') * 1000U);
-	      file_length += ((uint16_t)(OctetArray[2] - '0') * 100U);
-	      file_length += ((uint16_t)(OctetArray[3] - '0') * 10U);
-	      file_length += ((uint16_t)(OctetArray[4] - '0') * 1U);
-              find_content_info = SEEK_FIRST_RNRN;
-
-// UARTPrintf("\r\n");
-// UARTPrintf("Found Content-Length: ");
-// UARTPrintf(OctetArray);
-// UARTPrintf("  file_length: ");
-// emb_itoa(file_length, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-	    }
-	  }
-        }	
-
-	// The following searches for the \r\n\r\n sequence
-	if (pSocket->nNewlines == 2) {
-	  // This handles the case where a TCP Fragmentation occured in the
-	  // previous packet just as we collected the second \n. In that case
-	  // the search does not continue.
-	}
-	else {
-          // We're processing packets but haven't found the \r\n\r\n sequence
-          // yet. The sequence detector really just looks for two \n in a row,
-          // ignoring the first \r. If any character other than \r appears
-	  // between the \n and \n the Newlines counter is zero'd.
-          if (*pBuffer == '\n') pSocket->nNewlines++;
-          else if (*pBuffer == '\r') { }
-          else pSocket->nNewlines = 0;
-          pBuffer++;
-          nBytes--;
-          if (nBytes == 0) {
-            // If we hit end of fragment we exit and will come back to the loop
-            // with the next fragment.
-            return;
-          }
-        }
-
-        if ((pSocket->nNewlines == 2) && (find_content_info == SEEK_FIRST_RNRN)) {
-	  // Need to search for next \r\n\r\n
-          pSocket->nNewlines = 0;
-	  find_content_info = SEEK_SECOND_RNRN;
-
-// UARTPrintf("\r\n");
-// UARTPrintf("find_content_info = SEEK_SECOND_RNRN");
-// UARTPrintf("\r\n");
-
-	}
-        else if ((pSocket->nNewlines == 2) && (find_content_info == SEEK_SECOND_RNRN)) {
-	  // Found second set of \r\n\r\n
-	  // Clear nNewlines for future searches
-	  pSocket->nNewlines = 0;
-	  
-	  // We are parsing a data file
-	  // The next character in the POST should be the first character of
-	  // the payload (in this case, the new program file).
-          find_content_info = FOUND_CONTENT_INFO;
-
-// UARTPrintf("\r\n");
-// UARTPrintf("find_content_info = FOUND_CONTENT_TYPE FINAL");
-// UARTPrintf("\r\n");
-
-	  // Beginning of a data file found.
-	  // Initialize parsing variables.
-          byte_index = 0;
-          parse_index = 0;
-          eeprom_address_index = I2C_EEPROM0_BASE;
-          parse_tail[0] = '\0';
-          byte_tail[0] = '\0';
-          byte_tail[1] = '\0';
-          line_count = 0;
-          checksum = 0;
-          upgrade_failcode = UPGRADE_OK;
-	  non_sequential_detect = 0;
-	  SREC_start = 1;
-          search_limit = 0;
-	  for (i=0; i<30; i++) {
-	    // Initialize the search compare buffer
-	    compare_buf[i] = 'z';
-	  }
-          // Start parsing
-          pSocket->nState = STATE_PARSEFILE;
-	  pSocket->ParseState = PARSE_FILE_SEEK_START;
-          
-          // nParseLeft is normally set to the size of the POST data when
-	  // parsing user entered values from a Browser GUI. In this case the
-	  // data file is much larger than the nParseLeft variable can contain
-	  // so nParseLeft is just set to 1 and used as a flag to indicate
-	  // receipt of all file data (at which time it is set to 0). This
-	  // allows the normal POST processing termination processes to
-	  // complete as they do with user POST entries.
-	  pSocket->nParseLeft = 1;
-
-// UARTPrintf("\r\n");
-// UARTPrintf("Starting STATE_PARSEFILE");
-// UARTPrintf("\r\n");
-
-	  if (nBytes == 0) {
-	    // If we are at end of fragment here we exit and will return in
-	    // STATE_PARSEFILE
-	    return;
-	  }
-          break;
-	}
-      }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-    }
-
-
-    if (pSocket->nState == STATE_GOTGET) {
-
-// UARTPrintf("\r\n");
-// UARTPrintf("pSocket->nState == STATE_GOTGET Going to PARSEGET");
-// UARTPrintf("\r\n");
-
-      // Don't search for \r\n\r\n ... instead parse what we've got
-      // Initialize Parsing variables
-      // nParseLeft is used as a flag in GET parsing. nParseLeft == 1 will
-      // cause parsing to continue. nParseLeft == 0 will cause parsing to
-      // end.
-      pSocket->nParseLeft = 1;
-      pSocket->ParseState = PARSE_SLASH1;
-      // Start parsing
-      pSocket->nState = STATE_PARSEGET;
-    }
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-    if (pSocket->nState == STATE_PARSEPOST) {
-      // This code parses data the user entered in the GUI.
-      parsepost(pSocket, pBuffer, nBytes);
-    }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-    
-
-    if (pSocket->nState == STATE_PARSEGET) {
-
-// UARTPrintf("\r\n");
-// UARTPrintf("pSocket->nState == STATE_PARSEGET Parsing");
-// UARTPrintf("\r\n");
-
-      // This section will parse a GET request sent by the user. Normally in a
-      // general purpose web server a GET request would be used to obtain
-      // files or other items from the server. In that general case the data
-      // that follows "GET " is a "/path/filename" (path optional). In this
-      // application we'll use "filename" to command the web server to perform
-      // internal operations. For instance, performing a GET for filename "42"
-      // (with a "/42") might turn an output on, or might command transmission
-      // of a specific web page, rather than retrieve a file.
-      //
-      // At this point the "GET " (GET plus space) part of the request has
-      // been parsed. The "GET " should be followed by "/filename". So we look
-      // for the "/" and collect the next two characters as the fake
-      // "filename".
-      //
-      // Fragmentation note: We don't need to collect any state information in
-      // this parse process as anything we are collecting will easily fit in
-      // the first 100 bytes of the first packet ... so no fragmentation will
-      // occur.
-      //
-      // Browser note: Looks like some browsers get creative and do things
-      // like requesting "favicon.ico" from the server. This causes the code
-      // below to execute - and in the original code it caused confusion as I
-      // would send the IOControl web page if I didn't understand the inquiry.
-      // Now I will just throw the request away if it doesn't exactly match an
-      // expected request. The only exception will be if I get a "/" or "/ "
-      // then I will send the default web page.
-
-      while (nBytes != 0) {
-        if (pSocket->ParseState == PARSE_SLASH1) {
-	  // When we entered the loop *pBuffer should already be pointing at
-	  // the "/". If there isn't one we should display the IOControl page.
-          pSocket->ParseCmd = *pBuffer;
-          pBuffer++;
-	  if (pSocket->ParseCmd == (uint8_t)0x2f) { // Compare to '/'
-	    pSocket->ParseState = PARSE_NUM10;
-	  }
-          else {
-            // Didn't find '/' - send default page
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-// UARTPrintf("Get slash search1\r\n");
-
-	    pSocket->current_webpage = WEBPAGE_IOCONTROL;
-            pSocket->pData = g_HtmlPageIOControl;
-            pSocket->nDataLeft = HtmlPageIOControl_size;
-            init_off_board_string_pointers(pSocket);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-	    pSocket->current_webpage = WEBPAGE_UPLOADER;
-            pSocket->pData = g_HtmlPageUploader;
-            pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
-	                             // SENDHEADER
-	  }
-        }
-
-        else if (pSocket->ParseState == PARSE_NUM10) {
-	  // It's possible we got here because the user did not request a
-	  // filename (ie, the user entered "192.168.1.4:8080/". In this case
-	  // there will be a space here instead of a digit, and we should just
-	  // exit the while() loop and send the default page.
-	  if (*pBuffer == ' ') {
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-// UARTPrintf("Get slash search2\r\n");
-
-	    pSocket->current_webpage = WEBPAGE_IOCONTROL;
-            pSocket->pData = g_HtmlPageIOControl;
-            pSocket->nDataLeft = HtmlPageIOControl_size;
-            init_off_board_string_pointers(pSocket);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-	    pSocket->current_webpage = WEBPAGE_UPLOADER;
-            pSocket->pData = g_HtmlPageUploader;
-            pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
-	                             // SENDHEADER
-	  }
-	  // Parse first ParseNum digit. Looks like the user did input a
-	  // filename digit, so collect it here.
-	  else if (isdigit(*pBuffer)) { // Check for user entry error
-            // Still good - parse number
-            pSocket->ParseNum = (uint8_t)((*pBuffer - '0') * 10);
-	    pSocket->ParseState = PARSE_NUM1;
-            pSocket->nParseLeft = 1; // Set to 1 so PARSE_NUM1 will be called
-            pBuffer++;
-	  }
-	  else {
-	    // Something out of sync or invalid filename - exit while() loop
-	    // but do not change the current_webpage
-            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
-	                             // SENDHEADER
-            pSocket->ParseState = PARSE_FAIL;
-	  }
-        }
-	
-	// Parse second ParseNum digit
-        else if (pSocket->ParseState == PARSE_NUM1) {
-	  if (isdigit(*pBuffer)) { // Check for user entry error
-            // Still good - parse number
-            pSocket->ParseNum += (uint8_t)(*pBuffer - '0');
-            pSocket->ParseState = PARSE_VAL;
-            pSocket->nParseLeft = 1; // Set to 1 so PARSE_VAL will be called
-            pBuffer++;
-	  }
-	  else {
-	    // Something out of sync or invalid filename - exit while() loop
-	    // but do not change the current_webpage
-            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
-	                             // SENDHEADER
-            pSocket->ParseState = PARSE_FAIL;
-	  }
-	}
-	
-        else if (pSocket->ParseState == PARSE_VAL) {
-	  // ParseNum should now contain a two digit "filename". The filename
-	  // is used to command specific action by the webserver. Following
-	  // are the commands for the Network Module.
-	  //
-	  // From a fragment perspective we already received all the useful
-	  // information, so we can clear the saved states and process what
-	  // we've got. If another fragment still follows it won't have
-	  // anything useful in it and processing of the fragment won't cause
-	  // anything to happen.
-	  //
-	  // Note: Only those Output ON/OFF commands that correspond to a pin
-	  // configured as an Output will work.
-	  //
-	  // For 00-31, 55, and 56 you wont see any screen refresh.
-	  // http://IP/00  Output-01OFF
-	  // http://IP/01  Output-01ON
-	  // http://IP/02  Output-02OFF
-	  // http://IP/03  Output-02ON
-	  // http://IP/04  Output-03OFF
-	  // http://IP/05  Output-03ON
-	  // http://IP/06  Output-04OFF
-	  // http://IP/07  Output-04ON
-	  // http://IP/08  Output-05OFF
-	  // http://IP/09  Output-05ON
-	  // http://IP/10  Output-06OFF
-	  // http://IP/11  Output-06ON
-	  // http://IP/12  Output-07OFF
-	  // http://IP/13  Output-07ON
-	  // http://IP/14  Output-08OFF
-	  // http://IP/15  Output-08ON
-	  // http://IP/16  Output-09OFF
-	  // http://IP/17  Output-09ON
-	  // http://IP/18  Output-10OFF
-	  // http://IP/19  Output-10ON
-	  // http://IP/20  Output-11OFF
-	  // http://IP/21  Output-11ON
-	  // http://IP/22  Output-12OFF
-	  // http://IP/23  Output-12ON
-	  // http://IP/24  Output-13OFF
-	  // http://IP/25  Output-13ON
-	  // http://IP/26  Output-14OFF
-	  // http://IP/27  Output-14ON
-	  // http://IP/28  Output-15OFF
-	  // http://IP/29  Output-15ON
-	  // http://IP/30  Output-16OFF
-	  // http://IP/31  Output-16ON
-	  // http://IP/55  All Outputs ON
-	  // http://IP/56  All Outputs OFF
-	  //
-	  // http://IP/60  Show IO Control page
-	  // http://IP/61  Show Configuration page
-	  // http://IP/63  Show Help page (deprecated)
-	  // http://IP/64  Show Help2 page (deprecated)
-	  // http://IP/65  Flash LED 3 times (no screen refresh)
-	  // http://IP/66  Show Link Error Statistics page
-	  // http://IP/67  Clear Link Error Statistics and refresh page
-	  // http://IP/68  Show Network Statistics page
-	  // http://IP/69  Clear Network Statistics and refresh page
-          // http://IP/70  Clear the "Reset Status Register" counters
-          // http://IP/71  Display the Temperature Sensor Serial Numbers
-          // http://IP/72  Load the Code Uploader (works only in runtime
-	  //               builds)
-          // http://IP/73  Restore (works only in the Code Uploader build)
-          // http://IP/74  Erase EEPROM (works only in the Code Uploader
-	  //               build)
-          // http://IP/75  Show Code Uploader Timer (works only in the Code
-	  //               Uploader build)
-	  // http://IP/91  Reboot
-	  // http://IP/98  Show Very Short Form IO States page
-	  // http://IP/99  Show Short Form IO States page
-	  //
-          GET_response_type = 200; // Default response type
-          switch(pSocket->ParseNum)
-	  {
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-	    case 55:
-	      // Turn all outputs ON. Verify that each pin is an output
-	      // and that it is enabled.
-	      for (i=0; i<16; i++) {
- 		Pending_pin_control[i] = pin_control[i];
-                if ((pin_control[i] & 0x03) == 0x03) {
-                  // The above: If an Enabled Output, then turn on the pin
-                  Pending_pin_control[i] |= 0x80;
-	        }
-              }
-	      parse_complete = 1;
-	      GET_response_type = 204; // No return webpage
-	      break;
-	      
-	    case 56:
-	      // Turn all outputs OFF. Verify that each pin is an output
-	      // and that it is enabled.
-	      for (i=0; i<16; i++) {
-		Pending_pin_control[i] = pin_control[i];
-                if ((pin_control[i] & 0x03) == 0x03) {
-                  // The above: If an Enabled Output, then turn off the pin
-                  Pending_pin_control[i] &= 0x7f;
-	        }
-              }
-	      parse_complete = 1; 
-	      GET_response_type = 204; // No return webpage
-	      break;
-
-	    case 60: // Show IO Control page
-
-// UARTPrintf("case 60\r\n");
-
-	      pSocket->current_webpage = WEBPAGE_IOCONTROL;
-              pSocket->pData = g_HtmlPageIOControl;
-              pSocket->nDataLeft = HtmlPageIOControl_size;
-              init_off_board_string_pointers(pSocket);
-	      break;
-	      
-	    case 61: // Show Configuration page
-
-// UARTPrintf("case 61\r\n");
-
-	      pSocket->current_webpage = WEBPAGE_CONFIGURATION;
-              pSocket->pData = g_HtmlPageConfiguration;
-              pSocket->nDataLeft = HtmlPageConfiguration_size;
-              init_off_board_string_pointers(pSocket);
-	      break;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-	    case 65: // Flash LED for diagnostics
-	      debugflash();
-	      debugflash();
-	      debugflash();
-	      GET_response_type = 204; // No return webpage
-	      break;
-
-#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
-            case 66: // Show Link Error Statistics page
-	      pSocket->current_webpage = WEBPAGE_STATS2;
-              pSocket->pData = g_HtmlPageStats2;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
-	      break;
-	      
-            case 67: // Clear Link Error Statistics
-	      // Clear the the Link Error Statistics bytes.
-	      // Important: 
-	      // The debug[] byte indexes used may change if the
-	      // number of debug bytes changes.
-	      debug[3] = 0; // Clear TXERIF counter
-	      debug[4] = 0; // Clear RXERIF counter
-	      update_debug_storage1();
-	      TRANSMIT_counter = 0;
-	      MQTT_resp_tout_counter = 0;
-	      MQTT_not_OK_counter = 0;
-	      MQTT_broker_dis_counter = 0;
-	      
-	      pSocket->current_webpage = WEBPAGE_STATS2;
-              pSocket->pData = g_HtmlPageStats2;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
-	      break;
-#endif // DEBUG_SUPPORT
-
-#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-            case 68: // Show Network Statistics page
-	      pSocket->current_webpage = WEBPAGE_STATS1;
-              pSocket->pData = g_HtmlPageStats1;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
-	      break;
-	      
-            case 69: // Clear Network Statistics and refresh page
-	      uip_init_stats();
-	      pSocket->current_webpage = WEBPAGE_STATS1;
-              pSocket->pData = g_HtmlPageStats1;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
-	      break;
-#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-            case 70: // Clear the "Reset Status Register" counters
-	      // Clear the counts for EMCF, SWIMF, ILLOPF, IWDGF, WWDGF
-	      // These only display via the UART
-	      for (i = 5; i < 10; i++) debug[i] = 0;
-	      update_debug_storage1();
-	      break;
-
-#if DEBUG_SENSOR_SERIAL == 1
-            case 71: // Display the Temperature Sensor Serial Numbers
-	      pSocket->current_webpage = WEBPAGE_SENSOR_SERIAL;
-              pSocket->pData = g_HtmlPageTmpSerialNum;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
-	      break;
-#endif // DEBUG_SENSOR_SERIAL
-
-#if OB_EEPROM_SUPPORT == 1
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-            case 72: // Load Code Uploader
-	      // Re-Check that the EEPROM exists, and if it does then load the
-	      // Code Uploader from Off-Board EEPROM1, display the Loading
-	      // Code Uploader webpage, then reboot.
-	      // If the EEPROM does not exist dieplay an error webpage.
-	      // Verify that Off-Board EEPROM(s) exist.
-              eeprom_detect = off_board_EEPROM_detect();
-	      if (eeprom_detect == 0) {
-	        pSocket->current_webpage = WEBPAGE_EEPROM_MISSING;
-                pSocket->pData = g_HtmlPageEEPROMMissing;
-                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
-	      }
-	      else {
-	        pSocket->current_webpage = WEBPAGE_LOADUPLOADER;
-                pSocket->pData = g_HtmlPageLoadUploader;
-                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageLoadUploader) - 1);
-                eeprom_copy_to_flash_request = I2C_COPY_EEPROM1_REQUEST;
-	      }
-	      break;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-	      
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-            case 73: // Reload firmware existing image
-	      // Load the existing firmware image from Off-Board EEPROM0,
-	      // display the Loading Existing Image webpage, then reboot.
-	      pSocket->current_webpage = WEBPAGE_EXISTING_IMAGE;
-              pSocket->pData = g_HtmlPageExistingImage;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
-              eeprom_copy_to_flash_request = I2C_COPY_EEPROM0_REQUEST;
-	      upgrade_failcode = UPGRADE_OK;
-	      break;
-	      
-            case 74: // Erase entire Off-Board EEPROM
-              // Erase EEPROM regions 0, 1, 2, and 3 to provide a clean slate.
-	      // Useful mostly during development for code debug.
-	      {
-	        uint16_t i;
-	        uint8_t j;
-	        int k;
-	        uint16_t temp_eeprom_address_index;
-	        for (k=0; k<4; k++) {
-	          for (i=0; i<256; i++) {
-	            // Write 256 blocks of 128 bytes each with zero
-		    if (k == 0) I2C_control(I2C_EEPROM0_WRITE);
-		    if (k == 1) I2C_control(I2C_EEPROM1_WRITE);
-		    if (k == 2) I2C_control(I2C_EEPROM2_WRITE);
-		    if (k == 3) I2C_control(I2C_EEPROM3_WRITE);
-	            temp_eeprom_address_index = i * 128;
-                    I2C_byte_address(temp_eeprom_address_index);
-	            for (j=0; j<128; j++) {
-	              // Write a zero byte
-	              I2C_write_byte(0);
-	            }
-                    I2C_stop(); // Start the EEPROM internal write cycle
-                    IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-                    wait_timer(5000); // Wait 5ms
-	          }
-                }
-	      }
-              break;
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-#endif // OB_EEPROM_SUPPORT == 1
-
-	    case 91: // Reboot
-	      user_reboot_request = 1;
-	      break;
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-            case 98: // Show Very Short Form IO state page
-            case 99: // Show Short Form IO state page
-	      // Normally when a page is transmitted the "current_webpage" is
-	      // updated to reflect the page just transmitted. This is not
-	      // done for this case as the page is very short (only requires
-	      // one packet to send) and not changing the current_webpage
-	      // pointer prevents "page interference" between normal browser
-	      // activity and the automated functions that normally use this
-	      // page.
-	      pSocket->current_webpage = WEBPAGE_SSTATE;
-              pSocket->pData = g_HtmlPageSstate;
-              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
-	      break;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-	    default:
-	      if (pSocket->ParseNum < 32) {
-                // Output-01..16 OFF/ON
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-                update_ON_OFF((uint8_t)(pSocket->ParseNum/2), (uint8_t)(pSocket->ParseNum%2));
-//                // Show Short Form IO state page
-//	        pSocket->current_webpage = WEBPAGE_SSTATE;
-//                pSocket->pData = g_HtmlPageSstate;
-//                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
-	        GET_response_type = 204; // No return webpage
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-              }
-              else {
-	        // Show default page
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-// UARTPrintf("Default GET case\r\n");
-
-	        pSocket->current_webpage = WEBPAGE_IOCONTROL;
-                pSocket->pData = g_HtmlPageIOControl;
-                pSocket->nDataLeft = HtmlPageIOControl_size;
-                init_off_board_string_pointers(pSocket);
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-	        pSocket->current_webpage = WEBPAGE_UPLOADER;
-                pSocket->pData = g_HtmlPageUploader;
-                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-              }
-              break;
-
-	  } // end switch
-          pSocket->nParseLeft = 0;
-        }
-
-        if (pSocket->ParseState == PARSE_FAIL) {
-          // Parsing failed above. By going to STATE_SENDHEADER200 
-	  // javascript should repaint the page already sent. While
-	  // inefficient this will satisfy the browser's need for a
-	  // reply when it requests favicon.ico or whatever else it
-	  // requests that we don't have.
-          pSocket->nPrevBytes = 0xFFFF;
-          pSocket->nState = STATE_SENDHEADER200;
-	  break;
-	}
-
-        if (pSocket->nParseLeft == 0) {
-          // Finished parsing ... even if nBytes is not zero
-	  // Send the response
-          pSocket->nPrevBytes = 0xFFFF;
-          if (GET_response_type == 200) {
-	    // Update GUI with appropriate webpage
-            pSocket->nState = STATE_SENDHEADER200;
-	  }
-          if (GET_response_type == 204) {
-	    // No return webpage - send header with Content-Length: 0
-            pSocket->nState = STATE_SENDHEADER204;
-	  }
-          break;
-        }
-      } // end of while loop
-    }
-
-
-
-    
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-    if (pSocket->nState == STATE_PARSEFILE) {
-
-// UARTPrintf("\r\n");
-// UARTPrintf("pSocket->nState == STATE_PARSEFILE Parsing");
-// UARTPrintf("\r\n");
-
-      // This step is entered if a POST containing a firmware file was
-      // detected. The file contents will be copied to the Off-Board EEPROM,
-      // then the Off-B0ard EEPROM will be copied to the internal Flash, then
-      // the device will reboot.
-      //
-      // Some notes:
-      // - This application normally parses POST files providing user data
-      //   entries in a Browser session. As such, the size of the data is
-      //   easily less than 65536 characters, thus the nParseLeft variable
-      //   used in normal parsing is a uint16_t type.
-      // - When a SREC file is attached to a POST the datagram can be 1024
-      //   lines x 78 bytes = 79872 characters PLUS some other overhead like
-      //   S0 and S7 records, and some miscellaneous records (partial data,
-      //   0x4000 addresses, etc).
-      //   So nParseLeft cannot be used in receiving the SREC
-      //   file other than as a flag to indicate that parsing is complete.
-      //   Instead the SREC file parser searches for a SREC S7 record to find
-      //   the end of the data then sets nParseLeft to signal that the end of
-      //   data was reached.
-      // - If an invalid file is supplied (ie, not an SREC file) it is detect-
-      //   ed by not finding an "S0" as the first two characters of the file.
-      //   In that case a loop is entered to allow the entire file to be sent
-      //   by the browser, but an upgrade_failcode is set to notify the user
-      //   of the error.
-      // - If an invalid SREC file is provided ... well, can't help the user
-      //   with every possible fart. The invalid SREC file will likely be
-      //   loaded into Flash and reprogramming via the SWIM interface may be
-      //   necessary.
-
-// UARTPrintf("\r\n");
-// UARTPrintf("Parsing data file\r\n");
-
-// UARTPrintf(" byte_index = ");
-// emb_itoa(byte_index, OctetArray, 10, 3);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-// UARTPrintf(" parse_index = ");
-// emb_itoa(parse_index, OctetArray, 10, 3);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-// UARTPrintf(" eeprom_address_index = ");
-// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-// UARTPrintf(" ParseState = ");
-// emb_itoa(pSocket->ParseState, OctetArray, 10, 3);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-// UARTPrintf("***NEWPACKET***");
-
-
-      // nBytes is tracked in this function using the global file_nBytes to
-      // enable shared use of the nBytes value in this function and the
-      // read_two_characters function.
-      file_nBytes = nBytes;
-
-      // This function uses a step by step state machine to read the data file
-
-      // When first starting the data file read keep in mind that even though
-      // the data part of the packet is just starting, a packet boundary can
-      // occur anywhere. However, we know that there will be at least one byte
-      // left in the current packet when we start.
-
-
-      if (pSocket->ParseState == PARSE_FILE_SEEK_START) {
-
-        // The first thing we need to do is find the start of the actual SREC
-        // file. In order to do this we need to find the end of the "multi-
-	// part boundary".
-        // Since only one SREC file is included in an update file the multi-
-	// part boundary immediately follows the second \r\n\r\n sequence.
-	// This is an example of the boundary text that will precede the first
-	// characters of the SREC data:
-        //
-        // -----------------------------168888385127375703662499690451
-        // Content-Disposition: form-data; name="file1"; filename="NetworkModule.sx"
-        // Content-Type: application/octet-stream
-        //
-        // So, we need to find the start of the SREC data by finding the end
-	// of the phrase "Type: application/octet-stream".
-        // Since a user might provide an invalid file we should also determine
-        // a reasonable point to give up looking for the phrase. Counting up
-	// the above and adding a little buffer for file name differences, we
-	// should find the end of the phrase within 200 characters of starting
-	// the search. If we don't it can be assumed this is not an SREC file.
-
-        while (1) {
-	  // Search for the "Type: application/octet-stream" phrase.
-	  // Since we can hit a packet boundary at any time we must check for
-	  // file_nBytes == 0 and break away to allow the next packet to be
-	  // read.
-	  // This search works by reading one character at a time from the
-	  // pBuffer and placing it in a left shift register. The register
-	  // shifts left one character each time a new character would exceed
-	  // the length of the register. The register is then compared with
-	  // the search phrase.
-	  
-	  for (i=0; i<29; i++) {
-	    // Shift the register contents left
-	    compare_buf[i] = compare_buf[i+1];
-	  }
-// UARTPrintf("compare_buf: ");
-// UARTPrintf(compare_buf);
-// UARTPrintf("\r\n");
-	  // Add a new character to the end of the register
-	  compare_buf[29] = *pBuffer;
-	  pBuffer++;
-	  file_nBytes--;
-	  file_length--;
-	  search_limit++;
-	  
-          if (strncmp(compare_buf, "Type: application/octet-stream", 30) == 0) {
-            // Found "Type: application/octet-stream"
-	    // The next character starts the SREC content
-            pSocket->ParseState = PARSE_FILE_SEEK_SX;
-// UARTPrintf("Found octet-stream\r\n");
-
-
-// Diagnostic - Print the characters that follow "octet-stream"
-// UARTPrintf("Characters following octet-stream: ");
-// for (i=0; i<30; i++) {
-// compare_buf[0] = *pBuffer;
-// pBuffer++;
-// compare_buf[1] = '\0';
-// UARTPrintf(compare_buf);
-// }
-// UARTPrintf("\r\n");
-
-
-	    break; // Break out of the local while loop
-	  }
-	      
-          if (search_limit >= 200) {
-            // Should have found the phrase by now. Assume this is not a valid
-	    // SREC file. Break out of the loop and go to PARSE_FILE_FAIL
-	    // The next character starts the SREC content
-// UARTPrintf("Exceeded search limit\r\n");
-            pSocket->ParseState = PARSE_FILE_FAIL;
-	    break; // Break out of the local while loop
-	  }
-	  
-          if (file_nBytes == 0) {
-            // We just read the last character in this packet. Break out
-            // of the local while loop so the next packet will be read.
-            break; // Break out of the local while loop
-          }
-        } // End of local while loop
-      }
-
-      if (pSocket->ParseState != PARSE_FILE_SEEK_START) {
-        while (1) {
-          // This while() loop is a state machine with three main
-	  // "pSocket->ParseState" states:
-	  // PARSE_FILE_SEEK_SX
-	  //   Parses the leading characters of each SREC looking for the SREC
-	  //   type.
-	  //     If the SREC type is S0 we are starting receipt of an SREC file
-	  //     so the 32K EEPROM0 space is erased to make it available to
-	  //     store the parsed SREC content. This SREC must be read to deter-
-	  //     mine the "file_type", ie, is it a PROGRAM file or a STRING
-	  //     file.
-	  //     If the SREC type is S3 we are starting receipt of an SREC data
-	  //     line. The "address" contained within the data line is parsed
-	  //     then the state machine goes to state PARSE_FILE_SEQUENTIAL or
-	  //     state PARSE_FILE_NONSEQ as needed.
-	  //     If the SREC type is S7 we are at the last record in the SREC
-	  //     file.
-	  // PARSE_FILE_SEQUENTIAL
-	  //   Parses "sequential" SREC date, ie, the first data record and any
-	  //   subsequent data record that has an address that is sequential
-	  //   with the previous data record.
-	  // PARSE_FILE_NONSEQ
-	  //   Parses "non-sequential" SREC data, ie, any data record that has
-	  //   an address that is not seqeuntial relative to the previous data
-	  //   record.
-	  // Exit at end of packet (file_nBytes == 0). This can occur at any
-	  // point while reading data. The exit allows the uip functions to
-	  // receive the next ethernet packet, then the STATE_PARSEFILE code
-	  // will be re-entered to continue this state machine where we left
-	  // off. Re-entry is made possible because "pSocket->nState" and
-	  // "pSocket->ParseState" are both saved so that we know where we
-	  // were when a packet ended (a TCP Fragmentation).
-          
-          if (pSocket->ParseState == PARSE_FILE_SEEK_SX) {
-
-// UARTPrintf(" ParseState = PARSE_FILE_SEEK_SX\r\n");
-
-	    // This parse looks for the start of record and will parse the
-	    // address value for the record.
-	    while (1) {
-              // Try to read two characters from the SREC
-              pBuffer = read_two_characters(pBuffer);
-              if (byte_tail[0] == '\0') {
-	        // No characters were found. This can occur when an end of
-	        // packet occurs during a CRLF sequence. The read attempt will
-	        // have set file_nBytes to zero. Break out of the local while
-	        // loop so that the next packet will be read.
-	        break;
-	      }
-              if (byte_tail[1] == '\0') {
-                // We only found 1 character so we just read the last character
-	        // in this packet. The read_two_characters() function will have
-	        // set file_nBytes to zero. Break out of the local while loop so
-	        // the next packet will be read.
-                break;
-              }
-
-// {
-// uint8_t temp[3];
-// temp[0] = byte_tail[0];
-// temp[1] = byte_tail[1];
-// temp[2] = '\0';
-// UARTPrintf(temp);
-// }
-            
-	      // If we didn't break out then we successfully read two charac-
-	      // ters.
-	      
-	      // If this is the start of the SREC parsing the file MUST begin
-	      // with "S0" ... otherwise we must assume this is not an SREC file
-	      // and we will abort the parsing.
-	      if (SREC_start == 1) {
-	        if (strncmp(byte_tail, "S0", 2) != 0) {
-	          // This does not appear to be an SREC file. Abort.
-                  upgrade_failcode = UPGRADE_FAIL_NOT_SREC;
-	      
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_NOT_SREC\r\n");
-
-                  pSocket->ParseState = PARSE_FILE_FAIL;
-		  break;
-	        }
-	        else SREC_start = 0;
-	      }
-	      
-	      // "byte_index" is used to track progress in dissecting the
-	      // incoming SREC.
-	      
-	      if (byte_index == 0) {
-	        if (strncmp(byte_tail, "S0", 2) == 0) {
-                  // Check if the two characters are "S0", indicating the start
-		  // of a SREC file.
-
-// UARTPrintf("Found S0\r\n");
-
-                  // Erase EEPROM0 to provide a clean space to store the incom-
-		  // ing SREC data.
-		  
-		  {
-		    uint16_t i;
-		    uint8_t j;
-		    uint16_t temp_eeprom_address_index;
-// UARTPrintf("\r\nEEPROM0 erase at temp_eeprom_address_index ");
-		    for (i=0; i<256; i++) {
-		      // Write 256 blocks of 128 bytes each with zero
-                      I2C_control(I2C_EEPROM0_WRITE); // Send Write Control Byte
-		      temp_eeprom_address_index = i * 128;
-                      I2C_byte_address(temp_eeprom_address_index);
-		      for (j=0; j<128; j++) {
-		        // Write a zero byte
-		        I2C_write_byte(0);
-		      }
-                      I2C_stop(); // Start the EEPROM internal write cycle
-                      IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-// emb_itoa(temp_eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf(" ");
-                      // Wait for completion of write.
-		      // For simplicity I'm waiting 5ms (the max time required).
-		      // This loop could be sped up by using "acknowledge
-		      // polling" (see the 24AA1025 EEPROM spec).
-                      wait_timer(5000); // Wait 5ms
-                    }
-// UARTPrintf("\r\n");
-		  }
-		  // Now go on to determining what kind of file was sent
-		  file_type = FILETYPE_SEARCH;
-	          byte_index = 2;
-                  // Clear byte_tail for subsequent reads
-                  byte_tail[0] = '\0';
-                  byte_tail[1] = '\0';
-	          // Continue to read the address value in this SREC
-	          continue;
-	        }
-	        else if (strncmp(byte_tail, "S3", 2) == 0) {
-                  // Check if the two characters are "S3", indicating the start
-		  // of a new SREC data line.
-
-// UARTPrintf("Found S3\r\n");
-
-	          byte_index = 2;
-                  // Clear byte_tail for subsequent reads
-                  byte_tail[0] = '\0';
-                  byte_tail[1] = '\0';
-	          // Continue to read the address value in this SREC
-	          continue;
-	        }
-	        else if (strncmp(byte_tail, "S7", 2) == 0) {
-// UARTPrintf("Found S7\r\n");
-                  // Check if the two characters are "S7", indicating the end of
-		  // data.
-		 
-		  if (parse_index != 0) {
-		    // If any data remains in parse_tail write it to the EEPROM.
-                    {
-                      int i;
-                      uint8_t I2C_last_flag;
-                      uint8_t temp_byte;
-                      
-		      // Send Write Control Byte
-	              if (file_type == FILETYPE_PROGRAM) {
-                        I2C_control(I2C_EEPROM0_WRITE);
-		      }
-	              if (file_type == FILETYPE_STRING) {
-                        I2C_control(I2C_EEPROM2_WRITE);
-// UARTPrintf("\r\nEEPROM2 write at eeprom_address_index ");
-		      }
-                      I2C_byte_address(eeprom_address_index);
-// UARTPrintf("\r\nEEPROM write at eeprom_address_index ");
-// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf(": \r\n");
-                      for (i=0; i<64; i++) {
-		        I2C_write_byte(parse_tail[i]);
-// emb_itoa(parse_tail[i], OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-		      }
-                      I2C_stop();
-                      wait_timer(5000); // Wait 5ms
-                      IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-                      // Validate data in Off-Board EEPROM
-	              if (file_type == FILETYPE_PROGRAM) {
-                        prep_read(I2C_EEPROM0_WRITE, I2C_EEPROM0_READ, eeprom_address_index);
-                      }
-	              if (file_type == FILETYPE_STRING) {
-                        prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, eeprom_address_index);
-                      }
-	              I2C_last_flag = 0;
-                      for (i=0; i<64; i++) {
-                        if (i == 63) I2C_last_flag = 1;
-                        temp_byte = I2C_read_byte(I2C_last_flag);
-                        if (temp_byte != parse_tail[i]) {
-                          upgrade_failcode = UPGRADE_FAIL_EEPROM_MISCOMPARE;
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_EEPROM_MISCOMPARE\r\n");
-                          pSocket->ParseState = PARSE_FILE_FAIL;
-                        }
-                      }
-                    }
-		  }
-		  
-		  // At this point all data is processed. Go on to the
-		  // PARSE_FILE_COMPLETE code.
- 
-	          pSocket->ParseState = PARSE_FILE_COMPLETE;
-		  
-		  continue; // Continue reading characters until end of file
-	        }
-	        else {
-	          // Throw away characters and continue search
-                  // Clear byte_tail for subsequent reads
-                  byte_tail[0] = '\0';
-                  byte_tail[1] = '\0';
-		  continue;
-                } 
-	      }
-	    
-	      if (byte_index == 2) {
-	        // Read the data count value
-
-// UARTPrintf("byte_index == 2  ");
-
-                data_count = two_hex2int(byte_tail[0], byte_tail[1]);
-	        // Start checksum
-	        checksum = data_count;
-	        byte_index = 4;
-                // Clear byte_tail for subsequent reads
-                byte_tail[0] = '\0';
-                byte_tail[1] = '\0';
-	        continue;
-	      }
-	    
-	      if (byte_index == 4) {
-	        // Ignore first byte of address value
-
-// UARTPrintf("byte_index == 4  ");
-
-	        data_count--;
-	        // Add to checksum. Value is always 00
-	        checksum += 0;
-	        byte_index = 6;
-                // Clear byte_tail for subsequent reads
-                byte_tail[0] = '\0';
-                byte_tail[1] = '\0';
-	        continue;
-	      }
-	    
-	      if (byte_index == 6) {
-	        // Ignore the second byte of address value
-
-// UARTPrintf("byte_index == 6  ");
-
-	        data_count--;
-	        // Add to checksum. Value is always 00
-	        checksum += 0;
-	        byte_index = 8;
-                // Clear byte_tail for subsequent reads
-                byte_tail[0] = '\0';
-                byte_tail[1] = '\0';
-	        continue;
-	      }
-	    
-	      if (byte_index == 8 && file_type != FILETYPE_SEARCH) {
-	        // Capture the high order byte of the address value
-
-// UARTPrintf("byte_index == 8  ");
-
-                temp_address = two_hex2int(byte_tail[0], byte_tail[1]);
-	        data_count--;
-	        checksum += (uint8_t)temp_address;
-	        temp_address = temp_address << 8;
-	        byte_index = 10;
-                // Clear byte_tail for subsequent reads
-                byte_tail[0] = '\0';
-                byte_tail[1] = '\0';
-	        continue;
-	      }
-	    
-	      if (byte_index == 8 && file_type == FILETYPE_SEARCH) {
-	        // Determine file_type
-
-// UARTPrintf("byte_index == 8\r\n");
-
-	        data_count--;
-	        // Capture the first byte of the file type
-	        // 'N' (0x4E) is a NetworkModule program file
-	        // 'S' (0x53) is a String File
-                if (two_hex2int(byte_tail[0], byte_tail[1]) == 0x4E) {
-	          file_type = FILETYPE_PROGRAM;
-
-// UARTPrintf("file_type = FILETYPE_PROGRAM\r\n");
-	      
-	        }
-	        else {
-	          file_type = FILETYPE_STRING;
-
-// UARTPrintf("file_type = FILETYPE_STRING\r\n");
-	      
-                }
-	        // Reset byte_index and byte_tail
-	        byte_index = 0;
-                byte_tail[0] = '\0';
-                byte_tail[1] = '\0';
-	        // Break out of while loop so that next SREC will be read
-                break;
-	      }
-	    
-	      if (byte_index == 10) {
-	        // Capture the low order byte of the address value
-
-// UARTPrintf("byte_index == 10\r\n");
-
-                temp_address_low = two_hex2int(byte_tail[0], byte_tail[1]);
-	        data_count--;
-	        checksum += (uint8_t)temp_address_low;
-	        temp_address |= temp_address_low;
-	      
-	        if ((temp_address < 0x8000) || (temp_address > (FLASH_START_USER_RESERVE - 1))) {
-// UARTPrintf("\r\nDiscard ");
-// UARTPrintf("temp_address = ");
-// emb_itoa(temp_address, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-	          // If the address is not in the range 0x8000 to
-	          // FLASH_START_USER_DATA_RESERVE we ignore the SREC and
-		  // stay in ParseState PARSE_FILE_SEEK_SX to search for the
- 		  // next SREC.
-	          byte_index = 0;
-                  // Clear byte_tail for subsequent reads
-                  byte_tail[0] = '\0';
-                  byte_tail[1] = '\0';
-	          break;
-	        }
-	        else {
-	          // Else we start processing the SREC
-                  new_address = temp_address;
-// UARTPrintf("\r\nnew_address = ");
-// emb_itoa(new_address, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-	        }
-	      
-	        if (new_address == 0x8000) {
-	          // If this is the start of the firmware image set address and
-	          // parse the first SREC in the image
-	          address = 0x8000;
-                  pSocket->ParseState = PARSE_FILE_SEQUENTIAL;
-                  // Clear byte_tail for subsequent reads
-                  byte_tail[0] = '\0';
-                  byte_tail[1] = '\0';
-                  break;
-	        }
-	      
-	        if (new_address > 0x8000) {
-	          // Handle valid addresses beyond the starting address
-	          if (new_address == address) {
-	            // While reading the SREC "address" should have incremented
-		    // up to equal the "new_address". If so then continue read-
-		    // ing data
-                    pSocket->ParseState = PARSE_FILE_SEQUENTIAL;
-                    // Clear byte_tail for subsequent reads
-                    byte_tail[0] = '\0';
-                    byte_tail[1] = '\0';
-	            break;
-	          }
-		  
-		  else {
-		    // This is a case where the "new_address" is not sequential
-		    // with the prevous data read.
-		    // In this case we need to finish writing data we were col-
-		    // lecting, then we need to use the PARSE_FILE_NONSEQ code
-		    // to begin collection of data at the new_address.
-		    //   If the new_address is in space already written to the
-		    //   EEPROM an over-write of the EEPROM content will occur.
-		    //   If the new_address is in space futher out in the EEPROM
-		    //   the EEPROM writes will begin at that new_address.
-		    // 
-
-
-// UARTPrintf("\r\nFound data line with non-sequential address: parse_index = ");
-// emb_itoa(parse_index, OctetArray, 16, 2);
-// UARTPrintf(OctetArray);
-
-		    if (parse_index != 0) {
-		      // If we were in the middle of writing a 64 byte block to
-		      // EEPROM we need to finish that. Write the 64 bytes of
-		      // data that are in the parse_tail array into the Off-
-		      // Board EEPROM.
-                      {
-                        int i;
-                        uint8_t I2C_last_flag;
-                        uint8_t temp_byte;
-			
-                        // Send Write Control Byte
-	                if (file_type == FILETYPE_PROGRAM) {
-                          I2C_control(I2C_EEPROM0_WRITE);
-			}
-	                if (file_type == FILETYPE_STRING) {
-                          I2C_control(I2C_EEPROM2_WRITE);
-// UARTPrintf("\r\nEEPROM2 write at eeprom_address_index ");
-			}
-			
-		        // At this point the eeprom_address_index will be point-
-		        // ing at the start of the 64 byte EEPROM block that was
-		        // being processed when the out-of-sequence address was
-		        // encountereed.
-                        I2C_byte_address(eeprom_address_index);
-// UARTPrintf("\r\nEEPROM write at eeprom_address_index ");
-// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf(": \r\n");
-                        for (i=0; i<64; i++) {
-		          I2C_write_byte(parse_tail[i]);
-// emb_itoa(parse_tail[i], OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-		        }
-                        I2C_stop();
-                        wait_timer(5000); // Wait 5ms
-                        IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-			
-                        // Validate data in Off-Board EEPROM
-	                if (file_type == FILETYPE_PROGRAM) {
-                          prep_read(I2C_EEPROM0_WRITE, I2C_EEPROM0_READ, eeprom_address_index);
-			}
-	                if (file_type == FILETYPE_STRING) {
-                          prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, eeprom_address_index);
-			}
-			
-	                I2C_last_flag = 0;
-                        for (i=0; i<64; i++) {
-                          if (i == 63) I2C_last_flag = 1;
-                          temp_byte = I2C_read_byte(I2C_last_flag);
-                           if (temp_byte != parse_tail[i]) {
-                             upgrade_failcode = UPGRADE_FAIL_EEPROM_MISCOMPARE;
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_EEPROM_MISCOMPARE\r\n");
-                             pSocket->ParseState = PARSE_FILE_FAIL;
-                          }
-                        }
-                      }
-		    }
-		  
-		    // Go to the non-sequential data processing
-                    pSocket->ParseState = PARSE_FILE_NONSEQ;
-                    // Clear byte_tail for subsequent reads
-                    byte_tail[0] = '\0';
-                    byte_tail[1] = '\0';
-		    
-		    // Set "address" to be equal to "new_address"
-		    address = new_address;
-		    
-		    // Indicate initial detection of the non-sequential data.
-		    // This is used to allow the processing to be re-entrant
-		    // should TCP Fragmentation occur.
-		    non_sequential_detect = 1;
-		    
-	            break;
-		  }
-	        }
-	      }
-	    
-              if (file_nBytes == 0) {
-                // We just read the last character in this packet. Break out
-                // of the local while loop so the next packet will be read.
-                break;
-              }
-	    } // End of local while() loop
-	  }
-
-
-          if (pSocket->ParseState == PARSE_FILE_SEQUENTIAL) {
-// UARTPrintf(" ParseState = PARSE_FILE_SEQUENTIAL\r\n");
-	    // This parse is entered knowing that the next two characters are a
-	    // data byte.
-	    while (1) {
-              // Read two characters from the SREC
-              pBuffer = read_two_characters(pBuffer);
-              if (byte_tail[0] == '\0') {
-	        // No characters were found. This can occur when an end of
-	        // packet occurs during a CRLF sequence. The read attempt will
-	        // have set file_nBytes to zero. Break out of the local while
-	        // loop so that the next packet will be read.
-	        break;
-	      }
-              if (byte_tail[1] == '\0') {
-                // We only found 1 character so we just read the last character
-	        // in this packet. The read_two_characters() function will have
-	        // set file_nBytes to zero. Break out of the local while loop so
-	        // the next packet will be read.
-                break;
-              }
-
-// {
-// uint8_t temp[3];
-// temp[0] = byte_tail[0];
-// temp[1] = byte_tail[1];
-// temp[2] = '\0';
-// UARTPrintf(temp);
-// }
-	    
-	      // If we didn't break out then we successfully read two characters
-              data_value = two_hex2int(byte_tail[0], byte_tail[1]);
-              checksum += data_value;
-              data_count--;
-              // Clear byte_tail for subsequent reads
-              byte_tail[0] = '\0';
-              byte_tail[1] = '\0';
-	      
-	      if (data_count > 0) {
-	        // Copy data to parse_tail
-	        parse_tail[parse_index++] = data_value;
-	        address++; // Increment the incoming address counter
-	      }
-	      
-	      if (data_count == 0) {
-// UARTPrintf("data_count 0\r\n");
-	        // We just read the last byte in this SREC. The byte just read
-	        // was the checksum. Check for validity.
-	        if (checksum != 0xff) {
-	          // Handle Checksum Error
-                  upgrade_failcode = UPGRADE_FAIL_FILE_READ_CHECKSUM;
-
-// UARTPrintf("checksum = ");
-// emb_itoa(checksum, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-	      
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_FILE_READ_CHECKSUM\r\n");
-                  pSocket->ParseState = PARSE_FILE_FAIL;
-		  break;
-	        }
-	      }
-	    
-	      if (parse_index == 64 && file_type == FILETYPE_PROGRAM) {
-// UARTPrintf("parse_index 64\r\n");
-	        // Copy parse_tail to Off-Board EEPROM0
-	        
-                // Write the 64 bytes of data that are in the parse_tail array
-                // into the Off-Board EEPROM.
-                {
-                  int i;
-                  uint8_t I2C_last_flag;
-                  uint8_t temp_byte;
-                  
-                  I2C_control(I2C_EEPROM0_WRITE); // Send Write Control Byte
-                  I2C_byte_address(eeprom_address_index);
-// UARTPrintf("\r\nEEPROM0 write at eeprom_address_index ");
-// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf(": \r\n");
-                  for (i=0; i<64; i++) {
-                    I2C_write_byte(parse_tail[i]);
-// emb_itoa(parse_tail[i], OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-                  }
-                  I2C_stop();
-                  wait_timer(5000); // Wait 5ms
-                  IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-                  // Validate data in Off-Board EEPROM
-                  prep_read(I2C_EEPROM0_WRITE, I2C_EEPROM0_READ, eeprom_address_index);
-	          I2C_last_flag = 0;
-// UARTPrintf("\r\nEEPROM contents: \r\n");
-                  for (i=0; i<64; i++) {
-                    if (i == 63) I2C_last_flag = 1;
-                    temp_byte = I2C_read_byte(I2C_last_flag);
-// emb_itoa(temp_byte, OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-                    if (temp_byte != parse_tail[i]) {
-                      upgrade_failcode = UPGRADE_FAIL_EEPROM_MISCOMPARE;
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_EEPROM_MISCOMPARE\r\n");
-                      pSocket->ParseState = PARSE_FILE_FAIL;
-                    }
-                  }
-                  eeprom_address_index += 64;
-                }
-              }
-	    
-	      if (parse_index == 64 && file_type == FILETYPE_STRING) {
-	        // Copy parse_tail to Off-Board EEPROM2
-	        
-                // Write the 64 bytes of data that are in the parse_tail array
-                // into the Off-Board EEPROM.
-                {
-                  int i;
-                  uint8_t I2C_last_flag;
-                  uint8_t temp_byte;
-                  
-                  I2C_control(I2C_EEPROM2_WRITE); // Send Write Control Byte
-                  I2C_byte_address(eeprom_address_index);
-// UARTPrintf("\r\nEEPROM2 write at eeprom_address_index ");
-// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf(": \r\n");
-                  for (i=0; i<64; i++) {
-                    I2C_write_byte(parse_tail[i]);
-// emb_itoa(parse_tail[i], OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-                  }
-                  I2C_stop();
-                  wait_timer(5000); // Wait 5ms
-                  IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-                  // Validate data in Off-Board EEPROM
-                  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, eeprom_address_index);
-	          I2C_last_flag = 0;
-// UARTPrintf("\r\nEEPROM contents: \r\n");
-                  for (i=0; i<64; i++) {
-                    if (i == 63) I2C_last_flag = 1;
-                    temp_byte = I2C_read_byte(I2C_last_flag);
-// emb_itoa(temp_byte, OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-                    if (temp_byte != parse_tail[i]) {
-                      upgrade_failcode = STRING_EEPROM_MISCOMPARE;
-// UARTPrintf("UPGRADE_FAILCODE = STRING_EEPROM_MISCOMPARE\r\n");
-                      pSocket->ParseState = PARSE_FILE_FAIL;
-                    }
-                  }
-                  eeprom_address_index += 64;
-                }
-	      }
-
-	      if (parse_index == 64) {
-// UARTPrintf("parse_index64 clear for next data\r\n");
-	        // This is just a cleanup routine to make debug easier. This
-	        // will zero out the parse_tail array so that subsequent writes
-	        // to parse tail that end before filling it will be followed by
-	        // zeroes.
-	        for (i=0; i<64; i++) parse_tail[i] = 0;
-	        parse_index = 0; // Clear for next data
-	      }
-	      
-	      if (data_count == 0) {
-                // Go on to read next SREC
-                byte_index = 0;
-                pSocket->ParseState = PARSE_FILE_SEEK_SX;
-                break;
-	      }
-	    
-              if (file_nBytes == 0) {
-                // We just read the last character in this packet. Break out
-                // of the local while loop so the next packet will be read.
-                break;
-              }
-	    } // End of local while() loop
-	  }
-
-
-          if (pSocket->ParseState == PARSE_FILE_NONSEQ) {
-// UARTPrintf(" ParseState = PARSE_FILE_NONSEQ\r\n");
-            // This is a case where the new_address is not sequential with the
-	    // previous adddress.
-	    //
-	    // If this occurs then only the data in the SREC is copied to the
-	    // EEPROM, but it requires reading the existing data from the EEPROM
-	    // then inserting the new SREC data into the existing EEPROM data.
-	    //
-            // The "address" and "eeprom_address_index" values will be updated
-	    // according to the addressing values needed by this special case,
-	    // causing all new SREC addresses to be treated as non-sequential
-	    // until they start becoming sequential again.
-	    //
-	    // WHAT IF THE NON-SEQUENTIAL DATA OCCUPIES MORE THAN ONE SREC?
-	    // If the additional SRECs are sequential relative to the first non-
-	    // sequential address encountered they will be handled by the seq-
-	    // uential data processing routine. If the next SREC is non-sequen-
-	    // tial this routine will run again.
-	    //
-	    // WHAT IF THE NON-SEQUENTIAL SREC STARTS AT A POINT OTHER THAN 0
-	    // RELATIVE TO THE 64 BYTE WRITES TO EEPROM?
-	    // This is actually the typical case, so the code needs to read the
-	    // existing data from the EEPROM to preserve previously written
-	    // data, then an offset is calculated to determine the point that
-	    // new SREC data needs to start within the existing EEPROM data.
-	    // a) The data to read from the EEPROM is the 64 bytes starting at
-	    //    ((new_address - 0x8000) & 0xFFC0).
-	    // b) The offset into this data for writing the new data is
-	    //    (new_address & 0x003F).
-	    // NOTE: (a) and (b) are performed only once at the initial detect-
-	    // ion of a non-sequential SREC case. The "non_sequential_detect"
-	    // flag is used to manage this. This is necessary as TCP Fragmenta-
-	    // tion may cause the process to be re-entered.
-	    // c) Read the incoming SREC and write the contents to parse_tail.
-	    //    If the end of parse_tail is reached or the end of the SREC is
-	    //    reached write the parse_tail to the EEPROM.
-	    // d) If the end of the parse_tail is reached but there is still
-	    //    data in the incoming SREC then read the next 64 bytes from the
-	    //    EEPROM into parse_tail, and continue writing the incoming SREC
-	    //    data into the parse_tail starting at byte [0].
-	    //    When the end of the SREC is reached write the parse_tail to
-	    //    the EEPROM.
-	    // e) Exit comments: "address" and "eeprom_address_index" never get
-	    //    changed in this process so when this parsing completes we will
-	    //    go on to reading the next SREC. If that next SREC has a
-	    //    new_address lower than the current address the non-sequential
-	    //    process repeats. Otherwise the regular read SREC process runs.
-	    
-            // Why not use the above technique for every SREC?
-	    // Because it would result in twice as many writes to the EEPROM
-	    // taking a lot longer to do the programming. Twice as many writes
-	    // will occur because it is typical for the incoming data to be
-	    // skewed relative to the 64 byte writes to the EEPROM, and the
-	    // incoming SREC data is in 32 byte blocks as opposed to the 64 byte
-	    // blocks being written to the EEPROM.
-	  
-	    if (non_sequential_detect == 1) {
-// UARTPrintf("\r\nnon_sequential_detect == 1 ");
-	      // Calculate the starting index of the EEPROM block
-	      eeprom_address_index = (new_address - 0x8000) & 0xFFC0;
-	      
-	      // Read the existing EEPROM data into parse_tail
-	      if (file_type == FILETYPE_PROGRAM) {
-                prep_read(I2C_EEPROM0_WRITE, I2C_EEPROM0_READ, eeprom_address_index);
-              }
-	      if (file_type == FILETYPE_STRING) {
-                prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, eeprom_address_index);
-              }
-	      
-	      for (i=0; i<63; i++) {
-                parse_tail[i] = I2C_read_byte(0);
-              }
-              parse_tail[63] = I2C_read_byte(1);
-	      
-	      // Set the offset into parse_tail for the new data.
-              parse_index = (uint8_t)(new_address & 0x003F);
-	      
-	      // Clear initial detect flag so this "if" section will be bypassed
-	      // if the code is re-entered due to handle TCP Fragmentation.
-	      non_sequential_detect = 0;
-// UARTPrintf("\r\nnon_sequential_detect EEPROM read completed");
-	    }
-	    
-	    // This parse is entered knowing that the next two characters are a
-	    // data byte, and that all the data of interest is contained in a
-	    // single incoming SREC.
-	    
-	    while (1) {
-              // Read two characters from the data line
-              pBuffer = read_two_characters(pBuffer);
-              if (byte_tail[0] == '\0') {
-	        // No characters were found. This can occur when an end of
-	        // packet occurs during a CRLF sequence. The read attempt will
-	        // have set file_nBytes to zero. Break out of the local while
-	        // loop so that the next packet will be read.
-	        break;
-	      }
-              if (byte_tail[1] == '\0') {
-                // We only found 1 character so we just read the last character
-	        // in this packet. The read_two_characters() function will have
-	        // set file_nBytes to zero. Break out of the local while loop so
-	        // the next packet will be read.
-                break;
-              }
-
-// {
-// uint8_t temp[3];
-// temp[0] = byte_tail[0];
-// temp[1] = byte_tail[1];
-// temp[2] = '\0';
-// UARTPrintf(temp);
-// }
-	    
-	      // If we didn't break out then we successfully read two characters
-              data_value = two_hex2int(byte_tail[0], byte_tail[1]);
-              checksum += data_value;
-	      data_count--;
-              // Clear byte_tail for subsequent reads
-              byte_tail[0] = '\0';
-              byte_tail[1] = '\0';
-	      
-	      if (data_count > 0) {
-	        // Copy data to parse_tail
-	        parse_tail[parse_index++] = data_value;
-	        address++; // Increment the incoming address counter
-	      }
-	      
-	      if (data_count == 0) {
-	        // We just read the last byte in this SREC. The byte just read
-	        // was the checksum. Check for validity.
-	        if (checksum != 0xff) {
-	          // Handle Checksum Error
-                  upgrade_failcode = UPGRADE_FAIL_FILE_READ_CHECKSUM;
-
-// UARTPrintf("checksum = ");
-// emb_itoa(checksum, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-	      
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_FILE_READ_CHECKSUM\r\n");
-                  pSocket->ParseState = PARSE_FILE_FAIL;
-		  break;
-	        }
-	        else {
-// UARTPrintf("\r\nnon_sequential_detect checksum completed");
-	        }
-	      }
-	      
-	      if (data_count == 0 || parse_index == 64) {
-                // Copy parse_tail to Off-Board EEPROM0
-	        
-                // Write the data in the parse_tail array into the Off-Board
-	        // EEPROM.
-                {
-                  int i;
-                  uint8_t I2C_last_flag;
-                  uint8_t temp_byte;
-		  
-	          if (file_type == FILETYPE_PROGRAM) {
-                    I2C_control(I2C_EEPROM0_WRITE); // Send Write Control Byte
-		  }
-	          if (file_type == FILETYPE_STRING) {
-                    I2C_control(I2C_EEPROM2_WRITE); // Send Write Control Byte
-// UARTPrintf("\r\nEEPROM2 write at eeprom_address_index ");
-		  }
-		  
-                  I2C_byte_address(eeprom_address_index);
-// UARTPrintf("\r\nEEPROM0 write at eeprom_address_index ");
-// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf(": \r\n");
-                  for (i=0; i<64; i++) {
-                    I2C_write_byte(parse_tail[i]);
-// emb_itoa(parse_tail[i], OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-                  }
-                  I2C_stop();
-                  wait_timer(5000); // Wait 5ms
-                  IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-		  
-                  // Validate data in Off-Board EEPROM
-	          if (file_type == FILETYPE_PROGRAM) {
-                    prep_read(I2C_EEPROM0_WRITE, I2C_EEPROM0_READ, eeprom_address_index);
-		  }
-	          if (file_type == FILETYPE_STRING) {
-                    prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, eeprom_address_index);
-		  }
-		  
-	          I2C_last_flag = 0;
-// UARTPrintf("\r\nEEPROM contents: \r\n");
-                  for (i=0; i<64; i++) {
-                    if (i == 63) I2C_last_flag = 1;
-                    temp_byte = I2C_read_byte(I2C_last_flag);
-// emb_itoa(temp_byte, OctetArray, 16, 2);
-// UARTPrintf(" ");
-// UARTPrintf(OctetArray);
-                    if (temp_byte != parse_tail[i]) {
-                      upgrade_failcode = UPGRADE_FAIL_EEPROM_MISCOMPARE;
-// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_EEPROM_MISCOMPARE\r\n");
-                      pSocket->ParseState = PARSE_FILE_FAIL;
-                    }
-                  }
-                }
-	      }
-	      
-	      if (parse_index == 64 && data_count != 0) {
-	        // Hit end of parse_tail but still have data to read from this
-	        // SREC. Read the next 64 bytes from the EEPROM into parse_tail,
-	        // and continue writing the incoming SREC data into the
-	        // parse_tail starting at byte [0]. When the end of the SREC
-	        // data is reached write the parse_tail to the EEPROM.
-	        
-	        // Point to next block in EEPROM
-	        eeprom_address_index += 64;
-		
-                // Read the next existing EEPROM data into parse_tail
-	        if (file_type == FILETYPE_PROGRAM) {
-                  prep_read(I2C_EEPROM0_WRITE, I2C_EEPROM0_READ, eeprom_address_index);
-		}
-	        if (file_type == FILETYPE_STRING) {
-                  prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, eeprom_address_index);
-		}
-		
-	        for (i=0; i<63; i++) {
-	          parse_tail[i] = I2C_read_byte(0);
-	        }
-	        parse_tail[63] = I2C_read_byte(1);
-	    
-	        // The local while loop continues to finish reading the incoming
-	        // SREC.
-	      }
-	      
-	      if (parse_index == 64) {
-	        parse_index = 0; // Clear for next data
-	      }
-	      
-	      if (data_count == 0) {
-                // Go on to read next SREC
-                byte_index = 0;
-                pSocket->ParseState = PARSE_FILE_SEEK_SX;
-                break;
-	      }
-	      
-              if (file_nBytes == 0) {
-// UARTPrintf("\r\nnon_sequential_detect file_nBytes == 0");
-                // We just read the last character in this packet. Break out
-                // of the local while loop so the next packet will be read.
-                break;
-              }
-	    } // End of local while loop
-	  }
-	
-
-          if (pSocket->ParseState == PARSE_FILE_FAIL) {
-            // Abort parsing.
-	    // Enter a loop that will allow the Browser to finish sending
-	    // whatever it was sending.
-	    while (file_length > 0) {
-	      // Use the read_two_characters() function to deplete the incoming
-	      // packets. Once file_length reaches zero we've received all
-	      // packets.
-	      // Note that if we "break" it allows the program to fetch another
-	      // packet and then we return to this routine to read and deplete
-	      // that packet.
-	      // Also note that when file_length reaches zero file_nBytes should
-	      // also be zero if all is working correctly.
-	      
-              // Read two characters from the data line
-              pBuffer = read_two_characters(pBuffer);
-              IWDG_KR = 0xaa; // Prevent the IWDG from firing.
-	      if (file_length == 0) {
-	        // All packets read. Go on to the PARSE_FILE_FAIL_EXIT routine.
-	        pSocket->ParseState = PARSE_FILE_FAIL_EXIT;
-// UARTPrintf("\r\nSet ParseState to PARSE_FILE_FAIL_EXIT, break local loop\r\n");
-		break;
-              }
-              if (file_nBytes == 0) {
-                // The read_two_characters() function will set file_nBytes to
-	        // zero if an end of packet occurred. If so break out of the
-	        // local while loop so the next packet will be read.
-	        break;
-	      }
-	    } // End of local while loop
-	  }
-
-	  if (file_length == 0) {
-	    // All packets read.
-// UARTPrintf("\r\nAll packets read, break main loop\r\n");
-	    break; // Break out of mail while loop
-          }
-	  
-          if (file_nBytes == 0) {
-            // We just read the last character in this packet. Break out
-            // of the main while loop so the next packet will be read.
-
-// Diagnostic only
-// UARTPrintf("\r\nfile_length: ");
-// emb_itoa(file_length, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("  file_nBytes: ");
-// emb_itoa(file_nBytes, OctetArray, 10, 3);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-// UARTPrintf("XXXXXX-EOP-XXXXXX");
-            break; // Break out of main while loop
-          }
-        } // End of main while loop
-      }
-
-// UARTPrintf("\r\nExcuting code after main loop\r\n");
-// if (pSocket->ParseState == PARSE_FILE_FAIL_EXIT) {
-// UARTPrintf("\r\nParseState == PARSE_FILE_FAIL_EXIT\r\n");
-// }
-    
-      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_PROGRAM) {
-
-// UARTPrintf("\r\n");
-// UARTPrintf("File Upload Complete - entering 500ms pause");
-// UARTPrintf("\r\n");
-
-        // All data is now in Off-Board EEPROM0. Signal the main.c loop to
-	// copy the data to Flash and display a Timer window to have the
-	// user wait until Flash programming completes and the module reboots.
-	eeprom_copy_to_flash_request = I2C_COPY_EEPROM0_REQUEST;
-        pSocket->nParseLeft = 0;
-	
-	pSocket->current_webpage = WEBPAGE_TIMER;
-        pSocket->pData = g_HtmlPageTimer;
-        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
-	
-	// Send the response
-        pSocket->nPrevBytes = 0xFFFF;
-        pSocket->nState = STATE_SENDHEADER200;
-      }
-
-
-      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_STRING) {
-
-// UARTPrintf("\r\n");
-// UARTPrintf("File Upload Complete - entering 500ms pause");
-// UARTPrintf("\r\n");
-
-        // All data is now in Off-Board EEPROM2.
-	// Display the Upload Complete GUI.
-        pSocket->nDataLeft = 0;
-        pSocket->nParseLeft = 0;
-	
-	pSocket->current_webpage = WEBPAGE_UPLOAD_COMPLETE;
-        pSocket->pData = g_HtmlPageUploadComplete;
-        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
-	
-        // Send the response
-        pSocket->nPrevBytes = 0xFFFF;
-        pSocket->nState = STATE_SENDHEADER200;
-      }
-
-
-      if (pSocket->ParseState == PARSE_FILE_FAIL_EXIT) {
-        // Parsing aborted. Display a GUI with the fail reason code.
-
-// UARTPrintf("\r\n");
-// UARTPrintf("Parse FAIL XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
-// UARTPrintf("\r\n");
-
-	// Display the fail reason and tell the user to try again.
-        pSocket->nParseLeft = 0;
-	pSocket->current_webpage = WEBPAGE_PARSEFAIL;
-        pSocket->pData = g_HtmlPageParseFail;
-        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
-	// Send the response
-        pSocket->nPrevBytes = 0xFFFF;
-        pSocket->nState = STATE_SENDHEADER200;
-      }
-    }
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-    if (pSocket->nState == STATE_SENDHEADER200) {
-
-// UARTPrintf("HttpDCall: SENDHEADER200\r\n");
-
-      // This step is usually entered after GET processing is complete in
-      // order to send an appropriate web page in response to the GET request.
-      // In the uip_send() call we provide the CopyHttpHeader function with
-      // the length of the web page.
-      // Some GET requests do not send a webpage response (just a header with
-      // 0 data). In those cases STATE_SENDHEADER204 will have been entered
-      // from GET processing.
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, adjust_template_size(pSocket)));
-      pSocket->nState = STATE_SENDDATA;
-      return;
-    }
-      
-    if (pSocket->nState == STATE_SENDHEADER204) {
-
-// UARTPrintf("HttpDCall: SENDHEADER204\r\n");
-
-      // This step is entered after POST is complete.
-      // This step is also entered after GET processing is complete if no
-      // webpage reply is required.
-      // In both of these cases we only send a header with Content Length: 0
-      // and no data is sent.
-      // Note: After POST of an IOControl or Configuration page no webpage is
-      // automatically sent. The javascript in those pages will generate a GET
-      // request to update the Browser after the POST is sent.
-      // Note: It is not clear if some browsers require a "204 No Content"
-      // header. This appears to work just returning a "200 OK" with Content
-      // Length: 0.
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, 0));
-      // Clear nDataLeft and go to STATE_SENDDATA, but only to close
-      // connection.
-      pSocket->nDataLeft = 0;
-      pSocket->nState = STATE_SENDDATA;
-      return;
-    }
-
-    senddata:
-    if (pSocket->nState == STATE_SENDDATA) {
-      // We have sent the HTML Header or HTML Data previously. Now we send
-      // data using the CopyHttpData() function as a pre-processor, and the
-      // uip_send() function to actually copy data from the internal buffer
-      // to the ENC28J60 hardware.
-      // Data is always sent at the end of a "uip_newdata()" as a response to
-      // a Browser request.
-      // When transmitting data to the Browser there may be more data than
-      // will fit in one packet. For instance transmitting one of the Webpage
-      // templates can easily take 10 or more transmit packets. So, additional
-      // data (if any) will be sent on return to this function in response to
-      // "uip_acked()". Whether or not there is additional data to send in a
-      // series of packets is tracked in the nDataLeft variable.
-      // If there is no data to send, or if all data has been sent, we close
-      // the connection.
-
-// UARTPrintf("Send Data, off_board_eeprom_index: ");
-// emb_itoa(off_board_eeprom_index, OctetArray, 16, 4);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-      if (pSocket->nDataLeft == 0) {
-        // There is no data to send. Close connection
-        nBufSize = 0;
-      }
-      else {
-        // Copy data to buffer
-        pSocket->nPrevBytes = pSocket->nDataLeft;
-        nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
-        pSocket->nPrevBytes -= pSocket->nDataLeft;
-      }
-
-      if (nBufSize == 0) {
-        //No Data has been copied (or there was none to send). Close connection
-        uip_close();
-      }
-      else {
-        //Else send copied data
-        uip_send(uip_appdata, nBufSize);
-      }
-      
-      return;
-    }
-  }
-  
-  else if (uip_rexmit()) {
-
-// UARTPrintf("HttpDCall: uip_rexmit\r\n");
-
-    if (pSocket->nPrevBytes == 0xFFFF) {
-      // Send header again
-      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, adjust_template_size(pSocket)));
-    }
-    else {
-
-// UARTPrintf("XXXX RETRANSMIT XXXX\r\n");
-
-      // The pData pointer needs to be moved back by the number of bytes
-      // consumed from the webpage template.
-      pSocket->pData -= pSocket->nPrevBytes;
-      
-#if OB_EEPROM_SUPPORT == 1
-      // A similar adjustment is required for off_board_eeprom_index when
-      // the webpage is sourced from Off-Board EEPROM.
-      off_board_eeprom_index -= pSocket->nPrevBytes;
-#endif // OB_EEPROM_SUPPORT == 1
-      
-      pSocket->nDataLeft += pSocket->nPrevBytes;
-      pSocket->nPrevBytes = pSocket->nDataLeft;
-      nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
-      pSocket->nPrevBytes -= pSocket->nDataLeft;
-      
-      if (nBufSize == 0) {
-        //No Data has been copied. Close connection
-        uip_close();
-      }
-      else {
-        //Else send copied data
-        uip_send(uip_appdata, nBufSize);
-      }
-    }
-    return;
-  }
-}
-
-
-
-#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
-char *read_two_characters(char *pBuffer)
-{
-  // This function attempts to read two bytes from the SREC file.
-  // - Normal function is that two bytes are read.
-  // - The function must also handle the case where we only need to read one
-  //   byte because a byte was already read at the tail of a previous packet.
-  // - The function must also handle the case where we can only read one byte
-  //   because it is the last remaining byte in a packet.
-  // - The function discards any CR or LF character
-  //
-  // The function updates and returns the pBuffer pointer as bytes are consum-
-  // ed from the incoming data buffer.
-  //
-  // The function updates the byte_tail string with the bytes read from the
-  // incoming data buffer.
-  //
-  // The function updates the nParseLeft and file_nBytes counters.
-
-  if ((byte_tail[0] != '\0') && (byte_tail[1] == '\0')) {
-    // This is a check for TCP Fragmentation during a prior packet. byte_tail
-    // will have length 0 if no prior fragmentation occurred. If TCP Fragment-
-    // ation DID occur then byte_tail[0] will contain the last byte read from the
-    // SREC file and byte_tail[1] will contain NULL.
-    // Note that the SREC file is read one byte at a time, but a two byte pair
-    // is needed for any processing to occur. So, if only one byte of the two
-    // byte pair is captured when a packet boundary is encountered that byte
-    // must be saved in byte_tail so that the two bye pair can be completed
-    // and processed when the next packet is received.
-    // We have to account for the case where the single byte read in the
-    // previous packet is followed by CR or LF. In that case we discard the
-    // CR and LF and go on to read the next valid character.
-    
-    while (1) {
-      if (*pBuffer != '\r' && *pBuffer != '\n') {
-        byte_tail[1] = *pBuffer;
-        pBuffer++;
-        file_nBytes--;
-	file_length--; // Decrement the file_length for every character read
-	break;
-      }
-      else {
-        // Ignore the CR or LF
-        pBuffer++;
-        file_nBytes--;
-	file_length--; // Decrement the file_length for every character read
-	if (file_nBytes == 0) break;
-      }
-    }
-    byte_tail[2] = '\0';
-    return pBuffer;
-  }
-
-  else {
-    // We are starting with an empty byte_tail. Fill with any remaining bytes
-    // in the packet, but ignore CR and LF.
-    if (file_nBytes != 0) {
-      while (1) {
-        if (*pBuffer != '\r' && *pBuffer != '\n') {
-          byte_tail[0] = *pBuffer;
-          pBuffer++;
-          file_nBytes--;
-          file_length--; // Decrement the file_length for every character read
-          break;
-        }
-        else {
-          // Ignore the CR or LF
-          pBuffer++;
-          file_nBytes--;
-          file_length--; // Decrement the file_length for every character read
-  	  if (file_nBytes == 0) break;
-        }
-      }
-    }
-    
-    if (file_nBytes != 0) {
-      while (1) {
-        if (*pBuffer != '\r' && *pBuffer != '\n') {
-          byte_tail[1] = *pBuffer;
-          pBuffer++;
-          file_nBytes--;
-          file_length--; // Decrement the file_length for every character read
-          break;
-        }
-        else {
-          // Ignore the CR or LF
-          pBuffer++;
-          file_nBytes--;
-          file_length--; // Decrement the file_length for every character read
-  	  if (file_nBytes == 0) break;
-        }
-      }
-    }
-    byte_tail[2] = '\0';
-    return pBuffer;
-  }
-}
-#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
-
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-uint16_t parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes) {
-  // This function parses data the user entered in the GUI.
-  
-  // Parse pre-process
-  // A "local_buf" is created on the stack to hold the incoming POST data for
-  // parsing.
-  // The POST data is copied from the uip_buf to the local_buf until one of
-  // two things happen:
-  // a) The local_buf is full
-  // b) The end of the uip_buf is reached (end of the packet)
-  //
-  // Each POST component is copied to the parse_tail as they are found. As
-  // each POST component is found it will replace the prior POST component.
-  // The objective is to let the parse_tail contain any partial POST that
-  // appears at the tail of the current packet (ie, when a TCP Fragment
-  // occurs). The parse_tail is global so that it will retain the partial
-  // POST data when leaving the function to collect additional packets.
-  //
-  // Note: local_buf is used only within this function. It is important that
-  // the stack used by the local_buf is freed up so that the CopyHttpData()
-  // called later can use the stack memory for a different buffer.
-
-  uint16_t i;
-  uint16_t j;
-  char local_buf[300];
-  uint16_t local_buf_index_max;
-
-// UARTPrintf("parse_post: current_webpage = ");
-// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-  local_buf_index_max = 290;
-
-// UARTPrintf("\r\n");
-// UARTPrintf("pSocket->nState == STATE_PARSEPOST Parsing");
-// UARTPrintf("\r\n");
-// UARTPrintf("Parsing normal POST");
-// UARTPrintf("\r\n");
-
-  // If we are continuing data collection due to a TCP Fragment parse_tail
-  // will have any fragment of the previous POST in it. Otherwise
-  // parse_tail is NULL. We need to restore the parse_tail to the start of
-  // the local_buf so that additional data will be added to it.
-  strcpy(local_buf, parse_tail);
-  i = strlen(parse_tail);
-  j = 0;
-  
-  while (1) {
-    local_buf[i] = *pBuffer;
-    local_buf[i+1] = '\0';
-    parse_tail[j] = *pBuffer;
-    parse_tail[j+1] = '\0';
-    pBuffer++;
-    nBytes--;
-    i++;
-    j++;
-    
-    if (nBytes == 0) {
-      // Hit end of packet
-      if (strcmp(parse_tail, "&z00=0") == 0) {
-        // If this is also the end of the POST (as indicated by parse_tail
-        // equal to "&z00=0") then send the entire local_buf to parsing.
-        // Parse the local_buf
-
-// UARTPrintf("parse_tail: \r\n");
-// UARTPrintf(parse_tail);
-// UARTPrintf("\r\n");
-// UARTPrintf("End of POST: \r\n");
-// UARTPrintf(local_buf);
-// UARTPrintf("\r\n");
-
-        parse_local_buf(pSocket, local_buf, strlen(local_buf));
-        break;
-      }
-      
-      else {
-        // We don't have all the POST data - it will be arriving in
-        // subsequent packets
-        //
-        // There can be two cases at this point:
-        //   1) We received a part of the first POST component, in which
-        //      case the partial POST component in the parse_tail will not
-        //      start with a & symbol, and there is no useful data in the
-        //      local_buf
-        //   2) We received a part of a POST component after the first
-        //      POST component, in which case the partial POST component
-        //      in the parse_tail will start with a & symbol, and there is
-        //      data in the local_buf that must be parsed
-        
-        // Handle the case where parse_tail does not start with &
-        if (parse_tail[0] != '&') break;
-        
-        // Handle the case where parse tail DOES start with &
-        else {
-          // Back up the NULL terminator in the local_buf to the point where
-          // the last POST component ended. Note that this will eliminate
-          // one delimiter search in POST parsing so we need to decrement
-          // the nParseLeft value by one for this case.
-          i = i - strlen(parse_tail);
-          local_buf[i] = '\0';
-          pSocket->nParseLeft--;
-          
-          // Parse the local_buf
-
-// UARTPrintf("parse_tail: \r\n");
-// UARTPrintf(parse_tail);
-// UARTPrintf("\r\n");
-// UARTPrintf("local_buf: \r\n");
-// UARTPrintf(local_buf);
-// UARTPrintf("\r\n");
-
-          parse_local_buf(pSocket, local_buf, strlen(local_buf));
-          
-          // Shift the content of parse_tail to eliminate the '&'
-          strcpy(parse_tail, &parse_tail[1]);
-          break;
-        }
-      }
-    }
-	
-    if (i == local_buf_index_max) {
-      // Hit end of local_buf
-      // We don't yet have all the data from this packet but need to
-      // parse what we have so far.
-      // The local_buf only contains POST data, and we can't hit the
-      // end of the local_buf unless multiple posts have been collected,
-      // so, no need to handle special cases like receiving a partial
-      // first POST component.
-      //
-      // Back up the NULL terminator in the local_buf to the point where
-      // the last POST component ended. Note that this will eliminate
-      // one delimiter search in POST parsing so we need to decrement
-      // the nParseLeft value by one for this case.
-      i = i - strlen(parse_tail);
-      local_buf[i] = '\0';
-      pSocket->nParseLeft--;
-      
-      // Parse the local_buf
-
-// UARTPrintf("parse_tail: \r\n");
-// UARTPrintf(parse_tail);
-// UARTPrintf("\r\n");
-// UARTPrintf("local_buf: \r\n");
-// UARTPrintf(local_buf);
-// UARTPrintf("\r\n");
-
-      parse_local_buf(pSocket, local_buf, strlen(local_buf));
-      
-      // Shift the content of parse_tail to eliminate the '&'
-      strcpy(parse_tail, &parse_tail[1]);
-      
-      // There is still more POST data in the uip_buf. Restore the
-      // partial POST component to the local_buf and reset the index
-      // values so the while() loop can continue data collection.
-      strcpy(local_buf, parse_tail);
-      i = strlen(parse_tail); // Note: parse_tail might be empty
-      // Note: the "j" index into parse_tail is not reset in this
-      // case as the packet might end before the parse_tail is
-      // completely collected.
-      continue;
-    }
-    
-    if (*pBuffer == '&') {
-      // Starting a new POST component collection.
-      // Reset j so the parse_tail will fill with the new POST component.
-      j = 0;
-      parse_tail[0] = '\0';
-      continue;
-    }
-  }
-  return nBytes;
-}
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-void parse_local_buf(struct tHttpD* pSocket, char* local_buf, uint16_t lbi_max)
-{
-  uint16_t lbi; // Local buffer index
-  
-// UARTPrintf("parse_local_buf: current_webpage = ");
-// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
-// UARTPrintf(OctetArray);
-// UARTPrintf("\r\n");
-
-  // This function will parse a POST sent by the user (usually when they
-  // click on the "submit" button on a webpage). POST data will consist
-  // of:
-  //  One digit with a ParseCmd
-  //  Two digits with a ParseNum indicating the item to be changed
-  //  One digit with an equal sign
-  //  A variable number of characters with a ParseState indicating the
-  //    new value of the item
-  //  One digit with a Parse Delimiter (an '&')
-  //
-  // The parse pre-process has placed as much of the POST as possible
-  // in the local_buf. This routine will parse that data and will seek
-  // the end of the data as indicated by finding the &z00=0 POST
-  // component.
-
-  // When we parse the local_buf we always start in state PARSE_CMD
-  pSocket->ParseState = PARSE_CMD;
-
-  lbi = 0; // local buf index
-  while (1) {
-    // When appropriate conditions are met a break will occur to leave
-    // the while loop.
-    if (pSocket->ParseState == PARSE_CMD) {
-      pSocket->ParseCmd = (uint8_t)(local_buf[lbi]);
-      pSocket->ParseState = PARSE_NUM10;
-      pSocket->nParseLeft--;
-      lbi++;
-    }
-    
-    else if (pSocket->ParseState == PARSE_NUM10) {
-      pSocket->ParseNum = (uint8_t)((local_buf[lbi] - '0') * 10);
-      pSocket->ParseState = PARSE_NUM1;
-      pSocket->nParseLeft--;
-      lbi++;
-    }
-    
-    else if (pSocket->ParseState == PARSE_NUM1) {
-      pSocket->ParseNum += (uint8_t)(local_buf[lbi] - '0');
-      pSocket->ParseState = PARSE_EQUAL;
-      pSocket->nParseLeft--;
-      lbi++;
-    }
-    
-    else if (pSocket->ParseState == PARSE_EQUAL) {
-      pSocket->ParseState = PARSE_VAL;
-      pSocket->nParseLeft--;
-      lbi++;
-    }
-    
-    else if (pSocket->ParseState == PARSE_VAL) {
-      // 'a' is POST data for the Device Name
-      // 'b' is POST data for the IP/Gateway/Netmask
-      // 'c' is POST data for the Port number
-      // 'd' is POST data for the MAC
-      // 'g' is POST data for the Config settings string
-      // 'h' is POST data for the Pin Control String
-      // 'i' is POST data for the IO Timers
-      // 'j' is POST data for the IO Names
-      // 'l' is POST data for the MQTT Username
-      // 'm' is POST data for the MQTT Password
-      // 'z' is POST data for a hidden input used as an end-of-POST
-      //     indicator
-      
-      // Parse 'a' 'l' 'm' 'j' ----------------------------------------------//
-      if (pSocket->ParseCmd == 'a'
-       || pSocket->ParseCmd == 'l'
-       || pSocket->ParseCmd == 'm'
-       || pSocket->ParseCmd == 'j' ) {
-        // a = Update the Device Name field
-        // l = Update the MQTT Username field
-        // m = Update the MQTT Password field
-        // j = Update the IO Name field
-        
-	// Notes on the "current_webpage" logic.
-	// When parsing a POST we need to know if the POST came from a
-	// IOControl page or from a Configuation page. The IOControl page
-	// starts with a 'h' value, while the Configuration page starts
-	// with a 'a' value. If we have not encountered a 'a' value yet
-	// the current_webpage will be NULL. Now that we see a 'a' value
-	// we now know we are receiving a POST from a Configuration page.
-	// Setting current_webpage here is important to subsequent POST
-	// processing decisions.
-        pSocket->current_webpage = WEBPAGE_CONFIGURATION;
-        pSocket->nParseLeft = PARSEBYTES_CONFIGURATION;
-
-        {
-          int i;
-          uint8_t amp_found;
-          char tmp_Pending[20];
-          int num_chars;
-	  
-	  num_chars = 0;
-          
-          switch (pSocket->ParseCmd) {
-            case 'a': num_chars = 19; break;
-            case 'l':
-            case 'm': num_chars = 10; break;
-            case 'j': num_chars = 15; break;
-          }
-          
-          // This function processes POST data for one of several string fields:
-          //   Device Name field
-          //   MQTT Username field
-          //   MQTT Password field
-          //   IO Name field
-          //
-          // POST data for strings are a special case case in that the resulting
-          // string can consist of anything from 0 to X number of characters. So, we
-          // have to parse until the POST delimiter '&' is found.
-          //
-          amp_found = 0;
-          memset(tmp_Pending, '\0', 20);
-
-          for (i = 0; i < num_chars; i++) {
-            // Collect characters until num_chars are collected or '&' is found.
-            if (amp_found == 0) {
-              // Collect a byte of the devicename from the local_buf until the '&' is
-              // found.
-              if (local_buf[lbi] == '&') amp_found = 1;
-              else {
-                tmp_Pending[i] = local_buf[lbi];
-                pSocket->nParseLeft--;
-                lbi++;
-              }
-            }
-            if (amp_found) {
-              // We must reduce nParseLeft here because it is based on the PARESEBYTES_
-              // value which assumes num_chars bytes for the string field. If the
-              // POSTed string field is less than num_chars bytes then nParseLeft is
-              // too big by the number of characters omitted and must be corrected
-              // here. When we exit the loop the buffer index is left pointing at the
-              // '&' which starts the next field.
-              pSocket->nParseLeft--;
-            }
-          }
-  
-          switch (pSocket->ParseCmd)
-	  {
-	    case 'a':
-	      memcpy(Pending_devicename, tmp_Pending, num_chars);
-	      break;
-	    case 'l':
-	      memcpy(Pending_mqtt_username, tmp_Pending, num_chars);
-	      break;
-	    case 'm':
-	      memcpy(Pending_mqtt_password, tmp_Pending, num_chars);
-	      break;
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-	    case 'j':
-	      unlock_flash();
-	      if (strcmp(IO_NAME[pSocket->ParseNum], tmp_Pending) != 0) {
-	        // The write to Flash will occur 4 bytes at a time to
-		// reduce Flash wear. All 16 bytes reserved in the Flash
-		// for a given IO Name will be written at one time in a
-		// sequence of 4 byte "word" writes.
-	        i = 0;
-	        while(i<16) {
-	          FLASH_CR2 = 0x40;
-	          FLASH_NCR2 = 0xBF;
-	          memcpy(&IO_NAME[pSocket->ParseNum][i], &tmp_Pending[i], 4);
-	          i += 4;
-	        }
-              }
-	      lock_flash();
-	      break;
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-	  }
-        }
-      }
-
-
-      // Parse 'b' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'b') {
-        // This code updates the "pending" IP address, Gateway address,
-        // Netmask, and MQTT Host IP address which will then cause the
-        // main.c functions to restart the software.
-        // The value following the 'bxx=' ParseCmd and ParseNum consists
-        // of eight alpha nibbles representing the value in hex. The
-        // function call collects the alpha nibbles and converts them to
-	// the numeric value used by the other firmware functions.
-        {
-          int i;
-          int j;
-          uint8_t temp;
-          
-          // The following updates the IP address, Gateway address, NetMask, and MQTT
-          // IP Address based on GUI input.
-          // The code converts eight alpha fields with hex alphas ('0' to 'f') into
-          // 4 octets representing the new setting.
-            
-          // Convert characters of the hex string to numbers two characters
-          // at a time and store the result.
-          temp = 0;
-          i = 0;
-          j = 0;
-          while (i < 8) {
-            // Create a number from two hex characters
-            temp = two_hex2int(local_buf[lbi], local_buf[lbi+1]);
-	    lbi +=2;
-            pSocket->nParseLeft -= 2;
-	    i += 2;
-	    
-            j = (8 - i) / 2;
-          	  
-            switch(pSocket->ParseNum)
-            {
-              case 0:  Pending_hostaddr[j]       = (uint8_t)temp; break;
-              case 4:  Pending_draddr[j]         = (uint8_t)temp; break;
-              case 8:  Pending_netmask[j]        = (uint8_t)temp; break;
-              case 12: Pending_mqttserveraddr[j] = (uint8_t)temp; break;
-              default: break;
-            }
-          }
-        }
-      }
-
-
-      // Parse 'c' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'c') {
-        // This code updates the "pending" HTTP Port number or MQTT Port
-        // number which will then cause the main.c functions to restart
-        // the software.
-        // ParseNum == 0 indicates the HTTP Port number.
-        // ParseNum == 1 indicates the MQTT Port number.
-        // The value following the 'cxx=' ParseCmd & ParseNum consists
-        // of four alpha nibbles with the port number in hex form. The
-        // function call collects the nibbles, validates them, and updates
-        // the pending port number.
-        {
-          int i;
-          uint16_t temp;
-            
-          // Code to update the Port number based on GUI input.
-          // The code converts four alpha fields with hex alphas ('0' to 'f')
-          // into a 16 bit number, and validates that the number is within the
-          // valid range.
-            
-          // Convert string to 16 bit integer
-          temp = 0;
-          for (i=0; i<4; i++) {
-            temp |= hex2int((uint8_t)local_buf[lbi]) << (12 - i*4);
-	    lbi++;
-            pSocket->nParseLeft--;
-          }
-
-          if (temp > 9) { // Make change only if valid entry
-            if (pSocket->ParseNum == 0) Pending_port = (uint16_t)temp;
-            else Pending_mqttport = (uint16_t)temp;
-          }
-        }
-      }
-
-
-      // Parse 'd' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'd') {
-        // This code updates the "pending" MAC address which will then
-        // cause the main.c functions to restart the software.
-        // The value following the 'dxx=' ParseCmd and ParseNum consists
-        // of twelve alpha nibbles in hex form ('0' to '9' and 'a' to 'f').
-        // The function call collects the nibbles, validates them, and
-        // updates the pending MAC number.
-        {
-          int i;
-          uint16_t temp;
-            
-          // Code to update the MAC number based on GUI input.
-          // The code converts twelve alpha fields with hex alphas ('0' to 'f')
-          // into 6 octets representing the new setting.
-	  
-          // Convert characters of the hex string to numbers two
-          // at a time and store the result.
-          i = 0;
-          while (i < 12) {
-            temp = 0;
-            // Create a number from two hex characters
-            temp = two_hex2int(local_buf[lbi], local_buf[lbi+1]);
-	    lbi +=2;
-            pSocket->nParseLeft -= 2;
-	    i += 2;
-            // Store result in Pending_uip_ethaddr_oct. Note that order is
-            // reversed in this variable.
-            Pending_uip_ethaddr_oct[ (12-i)/2 ] = (uint8_t)temp;
-          }
-        }
-      }
-
-
-      // Parse 'g' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'g') {
-        {
-          // This code sets the Config Settings bytes which define the
-          // DS18B20, MQTT, Full/Half Duplex, and Home Assistant Auto
-          // Discovery functionality.
-          //
-          // There are always 2 characters in the string which represent a
-          // hex encoded byte. Each is collected and saved for later
-          // processing.
-	  //
-          // Convert hex nibbles to a byte and store in Config settings
-	  Pending_config_settings = two_hex2int(local_buf[lbi], local_buf[lbi+1]);
-	  lbi +=2;
-          pSocket->nParseLeft -= 2;
-        }
-      }
-
-
-      // Parse 'h' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'h') {
-        // This code sets the Pending_pin_control bytes based on the
-        // information in the 32 character string sent in the h00 field.
-        //
-        // There are always 32 characters in the string in 16 pairs of
-        // hex encoded nibbles, each pair representing a hex encoded pin
-        // control byte. The character pairs are extracted one set at a
-        // time, converted to a numeric byte, and stored in their
-        // corresponding Pending_pin_control byte.
-        {
-          int i;
-          int j;
-          uint8_t k;
-
-          // Sort the alpha characters into the pin control bytes
-          i = 0;
-          j = 0;
-          while( i<32 ) {
-            // The Configuration page updates all bits except the
-            // ON/OFF bit
-            // The IOControl page only updates the ON/OFF bit
-            Pending_pin_control[j] = pin_control[j];
-            // Convert the pin control string into numeric bytes
-            // two characters at a time. "k" will contain the byte
-            // after conversion.
-            k = two_hex2int(local_buf[lbi], local_buf[lbi+1]);
-	    lbi +=2;
-            pSocket->nParseLeft -= 2;
-	    i += 2;
-	    
-	    // Notes on the "current_webpage" logic.
-	    // When parsing a POST we need to know if the POST came from a
-	    // IOControl page or from a Configuation page. The IOControl page
-	    // starts with a 'h' value, while the Configuration page starts
-	    // with a 'a' value. If we have not encountered a 'a' value yet
-	    // the current_webpage will be NULL, so we now know we are
-	    // receiving a POST from an IOControl page.
-	    if (pSocket->current_webpage == WEBPAGE_NULL) {
-              pSocket->current_webpage = WEBPAGE_IOCONTROL;
-	      pSocket->nParseLeft = PARSEBYTES_IOCONTROL;
-	    }
-	    
-            if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
-// UARTPrintf("Received Config Data\r\n");
-              // Keep the ON/OFF bit as-is
-              Pending_pin_control[j] = (uint8_t)(Pending_pin_control[j] & 0x80);
-              // Mask out the ON/OFF bit in the temp variable
-              k = (uint8_t)(k & 0x7f);
-            }
-            else {
-// UARTPrintf("Received IOControl Data\r\n");
-              // current_webpage is WEBPAGE_IOCONTROL
-              // Keep the configuration bits as-is
-              Pending_pin_control[j] = (uint8_t)(Pending_pin_control[j] & 0x7f);
-              // Mask out the configuration bits in the temp variable
-              k = (uint8_t)(k & 0x80);
-            }
-            // "OR" in the changed bits
-            Pending_pin_control[j] = (uint8_t)(Pending_pin_control[j] | k);
-            j++;
-          }
-        }
-      }
-
-
-#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
-      // Parse 'i' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'i') {
-        // This code updates the IO Timer units and values in Pending
-	// variables so that the mainc.c functions will write them to
-	// Flash.
-        // The value following the 'ixx=' ParseCmd & ParseNum consists of
-	// 2 bytes represented as hex encoded strings (4 nibbles).
-	// Upper 2 bits are units
-	// Lower 14 bits are value
-	// The bytes are converted from the hex encoded string to a 16
-	// bit integer for storage in Flash.
-        {
-          uint16_t temp;
-
-          // Sort the alpha characters into the Pending IO Timer bytes
-	  
-          // Collect upper byte
-          // Convert two bytes of the string buffer into numeric bytes
-          // two characters at a time.
-          temp = (uint8_t)(two_hex2int(local_buf[lbi], local_buf[lbi+1]));
-	  temp = (temp << 8);
-	  lbi += 2;
-          pSocket->nParseLeft -= 2;
-          // Collect lower byte
-          temp |= (uint8_t)(two_hex2int(local_buf[lbi], local_buf[lbi+1]));
-	  lbi += 2;
-          pSocket->nParseLeft -= 2;
-	  // Store in Pending_IO_TIMER array
-	  Pending_IO_TIMER[pSocket->ParseNum] = temp;
-        }
-      }
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
-
-
-      // Parse 'z' ------------------------------------------------------//
-      else if (pSocket->ParseCmd == 'z') {
-        // This code signals that the "hidden" post was received. This
-        // is an indicaor that the entire POST was received.
-        //
-        // There is no '&' delimiter after this POST value.
-        //
-        pSocket->nParseLeft = 0;
-        break; // Break out of the while loop. We're done with POST.
-      }
-	  
-      // If we got to this point one of the "if/else if" above should have
-      // executed leaving the pointers pointing at the "&" delimiter in
-      // the POST data as the next character to be processed. So we set
-      // the ParseState to PARSE_DELM and let the while() do its next pass.
-      //
-      pSocket->ParseState = PARSE_DELIM;
-    }
-	
-    else if (pSocket->ParseState == PARSE_DELIM) {
-      if ((pSocket->nParseLeft > 0) && (lbi < lbi_max)) {
-        // Parse the next character, which must be a '&' delimiter. From
-        // here we go parse the next command byte.
-        pSocket->ParseState = PARSE_CMD;
-        pSocket->nParseLeft--;
-        lbi++;
-      }
-      else if ((pSocket->nParseLeft > 0) && (lbi >= lbi_max)) {
-        // We hit the end of the data in the local_buf but there is still
-	// more POST data. Break out of the while(1) loop so we'll return
-	// to collect more data from the uip_buf.
-	break; // Exit parsing
-      }
-      else {
-        // If we came to PARSE_DELIM and there was nothing left to parse
-        // in this or any subsequent packet (the normal exit state for
-        // POST data) then we just make sure nParseLeft is zero (not
-        // negative) and go on to exit.
-        pSocket->nParseLeft = 0; // End the parsing
-        break; // Exit parsing
-      }
-    }
-  }  // end of "while(1)" loop
-      
-  // If nParseLeft == 0 we should enter STATE_SENDHEADER204, but we
-  // clean up the fragment tracking pointers first.
-  //
-  // If nParseLeft is > 0 we haven't received the whole POST yet. In that
-  // case we should not enter STATE_SENDHEADER204 until we finish
-  // receiving and parsing the whole POST.
-  //
-  // We also do not want the main.c loop to do any processing of the
-  // Pending values collected so far until we've completed collecting ALL
-  // POST data. We can tell we still have processing to do because:
-  //   pSocket->nParseLeft != 0.
-  // I will use a global "parse_complete" variable to pass the state to
-  // the main.c functions.
-  //
-
-  if (pSocket->nParseLeft == 0) {
-    // Finished parsing
-	
-    // Signal the main.c processes that parsing is complete
-    parse_complete = 1;
-    // Set nState to close the connection
-    pSocket->nState = STATE_SENDHEADER204;
-  }
-
-  else {
-    // Else nParseLeft > 0 so we are still waiting on the remote host to
-    // send more POST data. This should arrive in subsequent packets. The
-    // remote host is not expecting a CLOSE connection until we are done
-    // receiving all POST data. The CLOSE will happen as part of the
-    // STATE_SENDHEADER204 process.
-    //
-    // Note on TCP Fragment reassembly: When the MSS is smaller than the
-    // size of the packets that the remote host wants to send it will
-    // simply send multiple packets of size MSS or smaller. We are
-    // entirely dependent on nParseLeft to determine when to go to
-    // STATE_SEND_HEADER, and we must assume that any additional fragments
-    // that are sent after we get all the POST data are disposed of by the
-    // UIP code. FYI, there shouldn't be any TCP Fragments after
-    // nParseLeft = 0.
-    //
-    uip_len = 0;
-  }
-}
-#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
-
-
-void update_ON_OFF(uint8_t i, uint8_t j)
-{
-  // Verify that pin is an output and it is enabled. If so
-  // update the ON/OFF state. Otherwise the command is ignored.
-  if ((pin_control[i] & 0x01) && (pin_control[i] & 0x02)) {
-    Pending_pin_control[i] = pin_control[i];
-    if (j==0) Pending_pin_control[i] &= (uint8_t)(~0x80);
-    else Pending_pin_control[i] |= (uint8_t)0x80;
-    parse_complete = 1;
-  }
-}
-
-
-void encode_16bit_registers()
-{
-  // Function to sort the pin control bytes into the 16 bit registers.
-  int i;
-  uint16_t j;
-  i = 0;
-  j = 0x0001;
-  while( i<16 ) {
-    if (pin_control[i] & 0x04) Invert_word = Invert_word |  j;
-    else                       Invert_word = Invert_word & ~j;
-    if (pin_control[i] & 0x80) ON_OFF_word = ON_OFF_word |  j;
-    else                       ON_OFF_word = ON_OFF_word & ~j;
-    i++;
-    j = j << 1;
-  }
-}
+/*
+ * Code file containing the HTTP Daemon module.
+ * It supports GET (not completely implemented) and POST Request methods
+ * 
+ * Author: Simon Kueppers
+ * Email: simon.kueppers@web.de
+ * Homepage: http://klinkerstein.m-faq.de
+ * 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2008 Simon Kueppers
+ *
+ */
+  
+/* Modifications 2020 Michael Nielson
+ * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
+ * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
+ * Author: Michael Nielson
+ * Email: nielsonm.projects@gmail.com
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ See GNU General Public License at <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2020 Michael Nielson
+*/
+
+
+
+#include <stdlib.h>
+
+#include "httpd.h"
+#include "uip.h"
+#include "uip_arch.h"
+#include "gpio.h"
+#include "main.h"
+#include "timer.h"
+#include "mqtt_pal.h"
+#include "uipopt.h"
+#include "uart.h"
+#include "ds18b20.h"
+#include "i2c.h"
+#include "iostm8s005.h"
+#include "stm8s-005.h"
+
+#include "string.h"
+#include <ctype.h>
+
+
+#if DEBUG_SUPPORT != 0
+// Variables used to store debug information
+extern uint8_t debug[10];
+extern uint8_t stored_debug[10];
+#endif // DEBUG_SUPPORT
+
+extern uint16_t Port_Httpd;               // Port number in use
+
+extern uint8_t pin_control[16];           // Per pin configuration byte
+extern uint16_t ON_OFF_word;              // ON/OFF states of pins in single
+                                          // 16 bit word
+extern uint16_t Invert_word;              // Invert state of pins in single 16
+                                          // bit word
+
+extern uint8_t Pending_hostaddr[4];       // Temp storage for new IP address
+extern uint8_t Pending_draddr[4];         // Temp storage for new Gateway
+                                          // address
+extern uint8_t Pending_netmask[4];        // Temp storage for new Netmask
+
+extern uint16_t Pending_port;             // Temp storage for new Port number
+
+extern uint8_t Pending_devicename[20];    // Temp storage for new Device Name
+
+extern uint8_t Pending_config_settings;   // Temp storage for new Config
+                                          // settings
+					  
+extern uint8_t Pending_pin_control[16];   // Temp storage for new pin_control
+                                          // received from GUI
+
+extern uint8_t Pending_uip_ethaddr_oct[6]; // Temp storage for new MAC address
+
+extern uint8_t stored_hostaddr[4];	  // hostaddr stored in EEPROM
+extern uint8_t stored_draddr[4];	  // draddr stored in EEPROM
+extern uint8_t stored_netmask[4];	  // netmask stored in EEPROM
+
+extern uint16_t stored_port;		  // Port number stored in EEPROM
+
+extern uint8_t stored_devicename[20];     // Device name stored in EEPROM
+
+extern uint8_t stored_config_settings;    // Config settings stored in EEPROM
+
+extern char mac_string[13];		  // MAC Address in string format
+
+extern uint8_t parse_complete;            // Used to signal that all user
+                                          // inputs have POSTed and are ready
+					  // to be used
+
+extern uint8_t user_reboot_request;       // Communicates the need to reboot
+                                          // back to the main.c functions
+extern uint8_t restart_reboot_step;       // Indicates whether restart or
+                                          // reboot are underway.
+
+extern uint8_t stack_error;               // Flag indicating stack overflow
+                                          // error
+
+extern const char code_revision[];        // Code Revision
+       
+uint8_t OctetArray[11];		          // Used in emb_itoa conversions but
+                                          // also repurposed as a temporary
+					  // buffer for transferring data
+				          // between functions.
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+uint8_t find_content_info;    // Used to manage steps in determining whether
+                              // a file is "Content-Type: m" and in finding
+			      // a files "Content-Length".
+char byte_tail[3];            // Character pairs captured from the data
+                              // file. May also contain a single character
+			      // if a packet boundary is encountered while
+			      // reading the data file.
+uint16_t file_nBytes;         // Used in the data file functions to track the
+                              // number of bytes remaining in a packet.
+uint8_t byte_index;           // Used as an index to point to the bytes in an
+                              // incoming file data line.
+uint8_t parse_index;          // Used as an index for writing file data into
+                              // the parse_tail array
+uint16_t eeprom_address_index; // Address index into the Off-Board EEPROM for
+                              // use in writing uploaded files
+uint16_t new_address;         // New data address found while parsing SREC
+                              // file
+uint16_t temp_address;        // Temporary storage of a new data address found
+                              // while parsing SREC file
+uint16_t temp_address_low;    // Temporary storage of low byte of a new data
+                              // address found while parsing SREC file
+uint16_t address;             // Current address of data being parsed from an
+                              // SREC file
+uint8_t data_count;           // Data count found while parsing SREC file
+uint8_t data_value;           // Data byte read while parsing SREC file
+uint16_t line_count;          // Counts the number of data lines processed.
+uint8_t checksum;             // Used in validating file data
+uint8_t upgrade_failcode;     // Failure codes for Flash upgrade process.
+uint8_t file_type;            // Used to store the file type as Program data
+                              // or String data
+uint8_t non_sequential_detect; // Flag to inidcate an out of sequence SREC
+                              // address was detected.
+uint8_t SREC_start;           // Used to determine if a file upload is an SREC
+                              // file.
+uint8_t search_limit;         // Used to limit the time spent searching for
+                              // the start of the SREC data
+uint16_t bin_remaining;       // Data bytes remaining in a binary image
+uint32_t bin_crc;             // CRC32 calculated over binary image data
+uint32_t bin_header_crc;      // CRC32 from the binary image header
+uint32_t image_crc;           // CRC32 from the binary Program image header
+uint16_t image_length;        // Data length from the binary Program image
+                              // header. 0 if the Program file was an SREC
+                              // file.
+#if UPLOAD_PIPELINE_SUPPORT == 1
+struct upload_page_t upload_ring[UPLOAD_RING_PAGES];
+                              // Decoded 64 byte pages waiting to be written
+			      // to the Off-Board EEPROM
+uint8_t upload_ring_head;     // Index of the next upload_ring entry to fill
+uint8_t upload_ring_tail;     // Index of the upload_ring entry being written
+uint8_t upload_ring_count;    // Number of upload_ring entries in use
+uint8_t upload_ring_state;    // State of the upload_ring writer
+uint16_t upload_ring_polls;   // Counts write completion polls of the EEPROM
+uint8_t upload_ring_fail;     // Set if a page in the upload_ring failed to
+                              // verify
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+
+uint8_t eeprom_erase_state;   // State of the /74 Off-Board EEPROM erase
+uint16_t eeprom_erase_block;  // Next 128 byte block to erase (0 to 1023)
+uint16_t eeprom_erase_polls;  // Counts write completion polls of the EEPROM
+
+static void upload_erase_eeprom0(void);
+static void upload_write_page(struct tHttpD* pSocket, uint8_t failcode);
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+#if OB_EEPROM_SUPPORT == 1
+// These defines locate the webpage content and webpage sizes stored in the
+// Srings region of the Off-Board EEPROM. In order to allow a String File to
+// be read using the same code used for reading Program Files the code expects
+// addresses starting at 0x8000, however in the EEPROM itself the base address
+// for Strings is 0x0000.
+#define MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION			0x0040
+#define MQTT_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION		0x0042
+#define BROWSER_ONLY_WEBPAGE_IOCONTROL_ADDRESS_LOCATION		0x0044
+#define BROWSER_ONLY_WEBPAGE_CONFIGURATION_ADDRESS_LOCATION	0x0046
+#define MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION			0x0080
+#define MQTT_WEBPAGE_CONFIGURATION_SIZE_LOCATION		0x0082
+#define BROWSER_ONLY_WEBPAGE_IOCONTROL_SIZE_LOCATION		0x0084
+#define BROWSER_ONLY_WEBPAGE_CONFIGURATION_SIZE_LOCATION	0x0086
+
+
+uint8_t eeprom_copy_to_flash_request;
+                               // Flag to cause the main.c loop to call the
+                               // copy to flash function.
+uint16_t off_board_eeprom_index; // Used as an index into the Off-Board EEPROM
+                               // when reading webpage templates
+uint16_t HtmlPageIOControl_index; // Off-Board EEPROM address of the
+                               // IOControl template
+uint16_t HtmlPageConfiguration_index; // Off-Board EEPROM address of the
+                               // Configuration template
+uint8_t tpl_buf[TPL_BUF_SIZE]; // Template streamer read ahead ring
+uint8_t tpl_head;              // Index in tpl_buf of the next template byte
+uint8_t tpl_count;             // Number of bytes in tpl_buf
+uint16_t tpl_addr;             // Off-Board EEPROM address of tpl_buf[tpl_head]
+uint8_t tpl_active;            // 1 while a template is being sent
+extern uint8_t I2C_read_open;  // 1 if a sequential read is left open
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+uint16_t tpl_stat_inline;      // Template bytes read while the connection
+                               // waited (in CopyHttpData())
+uint16_t tpl_stat_prefetch;    // Template bytes read ahead in idle time
+uint16_t tpl_stat_inline_ms;   // Time spent on inline reads
+uint8_t tpl_stat_address;      // Number of read addressing sequences
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+extern uint8_t eeprom_detect;  // Used in code update routines
+
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+#if I2C_SUPPORT == 1
+extern uint8_t I2C_failcode;         // Used in monitoring I2C transactions
+#endif // I2C_SUPPORT == 1
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+uint8_t parse_tail[40];       // Used to collect each component of a POST
+			      // sequence. If TCP fragmentation occurs
+                              // parse_tail will contain a part of the POST
+			      // component that was at the end of the packet.
+			      // The size of this array is determined by the
+			      // longest POST component. In normal POST
+			      // processing the longest component is the &h00
+			      // POST reply of 37 bytes.
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+
+#if  BUILD_SUPPORT == CODE_UPLOADER_BUILD
+uint8_t parse_tail[66];       // In the Code Uploader build the parse_tail is
+                              // used as described above, but it is also 
+			      // enlarged and repurposed for buffering data
+			      // received in a program update file. That data
+			      // is received one line of data at a time. The
+			      // maximum size required for this storage is 65
+			      // bytes.
+uint32_t file_length;         // Length of the body (the file data) in a
+                              // firmware update POST.
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+uint8_t z_diag;               // The last value in a POST (hidden), used for
+                              // diagnostics
+uint16_t HtmlPageIOControl_size;     // Size of the IOControl template
+uint16_t HtmlPageConfiguration_size; // Size of the Configuration template
+
+
+// These MQTT variables must always be compiled in the MQTT_BUILD and
+// BROWSER_ONLY_BUILD to maintain a common user interface between the MQTT
+// and Browser Only versions.
+extern uint8_t mqtt_enabled;              // Signals if MQTT has been enabled
+extern uint8_t stored_mqttserveraddr[4];  // mqttserveraddr stored in EEPROM
+extern uint16_t stored_mqttport;	  // MQTT Port number  stored in
+                                          // EEPROM
+extern char stored_mqtt_username[11];     // MQTT Username  stored in EEPROM
+extern char stored_mqtt_password[11];     // MQTT Password  stored in EEPROM
+
+extern uint8_t Pending_mqttserveraddr[4]; // Temp storage for new MQTT IP
+                                          // Address
+extern uint16_t Pending_mqttport;	  // Temp storage for new MQTT Port
+extern char Pending_mqtt_username[11];    // Temp storage for new MQTT
+                                          // Username
+extern char Pending_mqtt_password[11];    // Temp storage for new MQTT
+                                          // Password
+
+extern uint8_t mqtt_start_status;         // Contains error status from the
+                                          // MQTT start process
+extern uint8_t MQTT_error_status;         // For MQTT error status display in
+                                          // GUI
+
+
+
+extern uint8_t RXERIF_counter;            // Counts RXERIF errors
+extern uint8_t TXERIF_counter;            // Counts TXERIF errors
+#if FAIR_SCHEDULER_SUPPORT == 1
+extern struct hub_stats_t hub_stats[UIP_CONNS]; // Per connection scheduler
+                                          // diagnostics
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+extern uint32_t TRANSMIT_counter;         // Counts any transmit
+extern uint8_t MQTT_resp_tout_counter;    // Counts response timeout events
+extern uint8_t MQTT_not_OK_counter;       // Counts MQTT != OK events
+extern uint8_t MQTT_broker_dis_counter;   // Counts broker disconnect events
+extern uint32_t second_counter;           // Counts seconds since boot
+
+
+// DS18B20 variables
+extern uint8_t DS18B20_scratch[5][2];     // Stores the temperature measurement
+                                          // for the DS18B20s
+extern uint8_t FoundROM[5][8];            // Table of found ROM codes
+                                          // [x][0] = Family Code
+                                          // [x][1] = LSByte serial number
+                                          // [x][2] = byte 2 serial number
+                                          // [x][3] = byte 3 serial number
+                                          // [x][4] = byte 4 serial number
+                                          // [x][5] = byte 5 serial number
+                                          // [x][6] = MSByte serial number
+                                          // [x][7] = CRC
+extern int numROMs;                       // Count of DS18B20 devices found
+
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+extern uint8_t event_temperature_seq;     // Incremented each time new
+                                          // temperature readings are
+					  // available
+extern uint32_t t100ms_ctr1;              // 100ms counter
+uint8_t event_temps[UIP_CONNS][10];       // Raw DS18B20 readings reported
+                                          // in the last Event Stream data
+					  // record on each connection
+					  // (indexed by structID) so that a
+					  // retransmit can re-create it
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+extern uint16_t render_cache_version;     // Incremented on any change that
+                                          // alters the IOControl page
+uint8_t render_cache_valid;               // 1 = the render cache holds a
+                                          // complete IOControl page
+uint16_t render_cache_tag;                // render_cache_version of the
+                                          // cached page
+uint16_t render_cache_size;               // Size of the cached page
+uint8_t render_cache_epoch;               // Incremented each time the cache
+                                          // is refilled. Connections reading
+					  // from the cache keep a copy in
+					  // ParseNum so they can detect that
+					  // the cache changed under them.
+struct tHttpD* render_cache_filler;       // Connection that is rendering the
+                                          // page into the cache (NULL if
+					  // none)
+uint16_t render_cache_fill_ofs;           // Bytes written to the cache by
+                                          // the filling connection
+uint16_t render_cache_fill_tag;           // render_cache_version when the
+                                          // fill started
+#define RENDER_CACHE_MAX (ENC28J60_CACHEEND - ENC28J60_CACHESTART + 1)
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+// Variables stored in Flash
+// Define Flash addresses for IO Names and IO Timers
+extern uint16_t IO_TIMER[16] @FLASH_START_IO_TIMERS;
+extern char IO_NAME[16][16] @FLASH_START_IO_NAMES;
+extern uint16_t Pending_IO_TIMER[16];
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+
+
+
+
+//---------------------------------------------------------------------------//
+// Notes on web pages:
+// - Web pages are formed by placing the HTML for the pages in static
+//   constants in flash memory.
+//   OR
+//   Web pages are formed by placing the HTML for the pages in Off-Baord
+//   EEPROM (as controlled by #define OB_EEPROM_SUPPORT)
+//
+// - Since most of the web pages contain variable data (for instance things
+//   like the user changeable IP addresses, port numbers, device name, etc)
+//   the web page "constants" contain markers indicating where the application
+//   code should insert data as the web page constant is copied from flash
+//   memory into the output data buffer.
+//
+// - An example marker is %n01, wherein the CopyHttpData() function in the
+//   application code will replace the "%n01" characters with a single "0" or
+//   "1" character to signal the browser to paint a red or green box
+//   indicating mqtt status.
+//
+// - Additional markers are inserted to help with compression of the web page
+//   templates to reduce the amount of flash memory required. In these cases
+//   the markers tell the application code to insert strings that are repeated
+//   many times in the web page HTML text, rather than have them repeatedly
+//   appear in flash memory. For instance %y00 could be used to signal the
+//   application code to insert the string
+//   "this is a test string"
+//   While this makes the code harder to read, it makes the web page templates
+//   much smaller.
+//
+// - All of these insertion steps cause a complication: In the HttpDCall() the
+//   function "sizeof" is called to determine the size of the webpage to be
+//   copied to the uip_buf for transmission. The copy is performed in the
+//   CopyHttpData() function, and the size of the web page is provided in the
+//   pDataLeft variable. But this size is also used in the CopyHttpHeader()
+//   function to create the Content-Length: for the HTTP header. It is
+//   important that Content-Length be exactly the total amount of data that
+//   will be sent to the browser. The original code simply did a "sizeof" for
+//   the web page template. This is obviously wrong as the template gets a lot
+//   of 4 character placeholders swapped out with replacement text of varying
+//   lengths, not to mention the insertion of frequently repeated strings. So
+//   an "adjust_template_size" function was written to get the size of the
+//   template then adjust that size for all the replacement actions that will
+//   occur. The function needs to know which template it is working on because
+//   each has different amounts of replacement text. The size adjustment also
+//   needs to account for UIP_STATISTICS ifdef's as these will also cause
+//   variation in the length of the actual data transmitted.
+//
+// - IMPORTANT: Be sure to carefully update the adjust_template_size function
+//   if any changes are made to the %xxx text replacement markers and strings
+//   in the templates. Use CURL to verify that pages sizes are reported
+//   correctly.
+//
+// - The templates include the line
+//   "<link rel='icon' href='data:,'>".
+//   This is needed to prevent browsers from sending "favicon" requests. They
+//   seem to do this with annoying repetition greatly slowing down the
+//   transmit/receive process.
+//
+// - The templates include the line
+//   "<input type='hidden' name='z00' value='0'><br>"
+//   This inserts a hidden variable in the webpage to help the application
+//   determine that all POST data is received.
+//
+// - Each template that contains POST data includes an explanation of how the
+//   PARSE_BYTES value is calculated for that template. The PARSE_BYTES value
+//   tells the application exactly how much data will be returned in a POST
+//   form submittal arriving from the remote host. Note that a form submittal
+//   always returns the exact same amount of information even if no fields
+//   were changed on the form (with the exception of the devicename, username,
+//   and password fields which can be variable in length).
+//
+// The WEBPAGE_ numbers that identify each template are in httpd.h.
+
+
+
+//---------------------------------------------------------------------------//
+#if BUILD_SUPPORT == MQTT_BUILD
+// IO Control Template
+//
+// PARSE_BYTES calculation:
+// The form contained in this webpage will generate several data update
+// replies. These replies need to be parsed to extract the data from them. We
+// need to stop parsing the reply POST data after all update bytes are parsed.
+// The formula for determining the stop value is as follows:
+//   For 1 of the replies (Pin Control):
+//   POST consists of a ParseCmd (a "h" in this case) in 1 byte
+//     Followed by the ParseNum in 2 bytes
+//     Followed by an equal sign in 1 byte
+//     Followed by a state value in 32 bytea
+//     Followed by a parse delimiter in 1 byte
+//   PLUS
+//   For 1 of the replies (hidden):
+//   POST consists of a ParseCmd (a "z" in this case) in 1 byte
+//     Followed by the ParseNum in 2 bytes
+//     Followed by an equal sign in 1 byte
+//     Followed by a state value in 1 byte
+//     Followed by a parse delimiter in 1 byte
+// THUS
+// For 1 of the replies there are 37 bytes in the reply
+// For 1 of the replies there are 6 bytes per reply
+// The formula in this case is
+//     PARSEBYTES = (1 x 37)
+//                + (1 x 6) - 1
+//     PARSEBYTES = 37
+//                + 6 - 1 = 42
+//
+#define PARSEBYTES_IOCONTROL		42
+// Next line is a dummy define used only by the strings pre-processor.
+#define MQTT_WEBPAGE_IOCONTROL_BEGIN    90
+#if OB_EEPROM_SUPPORT == 0
+static const char g_HtmlPageIOControl[] =
+"%y04%y05"
+      "<title>%a00: IO Control</title>"
+   "</head>"
+   "<body>"
+      "<h1>IO Control</h1>"
+      "<form onsubmit='return m.s(event);return false'>"
+         "<table>"
+            "<tr>"
+               "<th>Name:</th>"
+               "<td colspan=2 style='text-align: left'>%a00</td>"
+            "</tr>"
+            "<script>"
+"const m=(t=>{const e=document,n=e.querySelector.bind(e)('form'),r=(Object.entries,parseI"
+"nt),o=t=>e.write(t),s=t=>t.map(t=>((t,e)=>r(t).toString(16).padStart(e,'0'))(t,2)).join("
+"''),a=t=>t.match(/.{2}/g).map(t=>r(t,16)),c=t=>encodeURIComponent(t),d=[],h=[],p=(t,e,n)"
+"=>{return`<label><input type=radio name=o${e} value=${t} ${n==t?'checked':''}/>${(t?'on'"
+":'off').toUpperCase()}</label>`},l=()=>location.href='/60';return a(t.h00).forEach((t,e)"
+"=>{3==(3&t)?h.push(`<tr><td>Output #${e+1}</td><td class='s${t>>7} t3'></td><td class=c>"
+"${p(1,e,t>>7)}${p(0,e,t>>7)}</td></tr>`):1==(3&t)&&d.push(`<tr><td>Input #${e+1}</td><td"
+" class='s${t>>7} t3'></td><td/></tr>`)}),o(d.join('')),o(`<tr><th></th><th></th>${h.leng"
+"th>0?'<th class=c>SET</th>':''}</tr>`),o(h.join('')),{s:e=>{e.preventDefault();const r=n"
+"ew XMLHttpRequest,o=Array.from((()=>{const e=new FormData(n);return e.set('h00',s(a(t.h0"
+"0).map((t,n)=>{const r='o'+n,o=e.get(r)<<7;return e.delete(r),o}))),e})().entries(),([t,"
+"e])=>`${c(t)}=${c(e)}`).join('&');r.open('POST','/',!1),r.send(o+'&z00=0'),l()},l:l}})({"
+"h00:'%h00'});"
+            "%y01"
+      "<p/>"
+      "%y02`/60`'>Refresh</button> "
+      "%y02`/61`'>Configuration</button>"
+      "<pre>%t00%t01%t02%t03%t04</pre>"
+   "</body>"
+"</html>";
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if OB_EEPROM_SUPPORT == 1
+// Declared short static const here so that common code can be used for Flash
+// and Off-Board webpage sources.
+static const char g_HtmlPageIOControl[] = " ";
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+
+/*
+// Credit to Jevgeni Kiski for the javascript work and html improvements.
+// Below is the raw script used above before minify.
+// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
+// 2) Copy the resulting minified script to an editor and replace all double quotes with
+//    single quotes. THIS STEP IS VERY IMPORTANT.
+// 3) Copy the result to the above between the <script> and </script> lines.
+// 4) Add double quotes at the start and end of the minfied script to make it part of the
+//    constant string.
+// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
+//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
+//    removed from the minified script.
+
+const m = (data => {
+    const doc = document,
+        selector = doc.querySelector.bind(doc),
+        form = selector('form'),
+        get_entries = Object.entries,
+        parse_int = parseInt,
+        document_write = text => doc.write(text),
+        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
+        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
+        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
+        encode = v => encodeURIComponent(v),
+        inputs = [],
+        outputs = [],
+        make_radio_input = (type, id, checked_type) => {
+            var type_str = type ? 'on' : 'off';
+            return `<label><input type=radio name=o${id} value=${type} ${checked_type == type ? 'checked' : ''}/>${type_str.toUpperCase()}</label>`;
+        },
+        get_form_data = () => {
+            const form_data = new FormData(form);
+            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
+                const name = 'o' + i,
+                    result = form_data.get(name) << 7;
+                form_data.delete(name);
+                return result;
+            })));
+            return form_data;
+        },
+        reload_page = () => location.href = '/60',
+        submit_form = (event) => {
+        	event.preventDefault();
+
+          const request = new XMLHttpRequest(),
+              string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
+          request.open('POST', '/', false);
+          request.send(string_data + '&z00=0');
+          reload_page();
+        };
+        
+
+    convert_from_hex(data.h00).forEach((cfg, i) => {
+        if ((cfg & 3) == 3) { //output
+            outputs.push(`<tr><td>Output #${i + 1}</td><td class='s${cfg >> 7} t3'></td><td class=c>${make_radio_input(1, i, cfg >> 7)}${make_radio_input(0, i, cfg >> 7)}</td></tr>`);
+        } else if ((cfg & 3) == 1) { // input
+            inputs.push(`<tr><td>Input #${i + 1}</td><td class='s${cfg >> 7} t3'></td><td/></tr>`);
+        }
+    });
+
+    document_write(inputs.join(''));
+    document_write(`<tr><th></th><th></th>${outputs.length > 0 ? '<th class=c>SET</th>' : ''}</tr>`);
+    document_write(outputs.join(''));
+    
+    return {s: submit_form, l:reload_page}
+})({ h00: '%h00' });
+
+
+*/
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+
+
+#if BUILD_SUPPORT == MQTT_BUILD
+// Configuration webpage Template
+//
+// PARSE_BYTES calculation:
+// The form contained in this webpage will generate several data update
+// replies. These replies need to be parsed to extract the data from them. We
+// need to stop parsing the reply POST data after all update bytes are parsed.
+// The formula for determining the stop value is as follows:
+//     For 1 of the replies (device name):
+//     example: a00=xxxxxxxxxxxxxxxxxxx&
+//     where xxxxxxxxxxxxxxxxxxx is 1 to 19 bytes
+//   PLUS
+//     For 4 of the replies (HTML IP, MQTT IP, Gateway, and Netmask fields):
+//     example: b00=xxxxxxxx&
+//     where xxxxxxxx is 8 bytes
+//   PLUS
+//     For 2 of the replies (HTML and MQTT Port numbers):
+//     example: c00=xxxx&
+//     where xxxx is 4 bytes
+//   PLUS
+//     For 1 of the replies (MAC):
+//     example: d00=xxxxxxxxxxxx&
+//     where xxxxxxxxxxxx is 12 bytes
+//   PLUS
+//   For 1 of the replies (Config):
+//     example: g00=xxxxxx&
+//     where xxxxxx is 6 bytes
+//   PLUS
+//   For 2 of the replies (MQTT Username and Password):
+//     example: m00=xxxxxxxxxx&
+//     where xxxxxxxxxx is 1 to 10 bytes
+//   PLUS
+//   For 1 of the replies (Pin Control):
+//     example: h00=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx&
+//     where xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx is 32 bytes
+//   PLUS
+//   For 1 of the replies (hidden):
+//   POST consists of a ParseCmd (a "z" in this case) in 1 byte
+//     example: z00=x&
+//     where x is 1 byte
+// The formula in this case is
+//     PARSEBYTES = (1 x 24)
+//                + (4 x 13)
+//                + (2 x 9)
+//                + (1 x 17) 
+//                + (1 x 11) 
+//                + (2 x 15)
+//                + (1 x 37)
+//                + (1 x 6) - 1
+//     PARSEBYTES = 24
+//                + 52
+//                + 18
+//                + 17
+//                + 11
+//                + 30
+//                + 37
+//                + 6 - 1 = 194
+//
+#define PARSEBYTES_CONFIGURATION	194
+// Next line is dummy define used only by the strings pre-processor.
+#define MQTT_WEBPAGE_CONFIGURATION_BEGIN	91
+#if OB_EEPROM_SUPPORT == 0
+static const char g_HtmlPageConfiguration[] =
+"%y04%y05"
+      "<title>%a00: Configuration</title>"
+   "</head>"
+   "<body>"
+      "<h1>Configuration</h1>"
+      "<form onsubmit='return m.s(event);return false'>"
+         "<table>"
+            "<tr>"
+               "<td>Name</td>"
+               "<td><input name='a00' value='%a00' pattern='[0-9a-zA-Z-_*.]{1,19}' required title='1 to 19 letters, numbers, and -_*. no spaces' maxlength='19'/></td>"
+            "</tr>"
+            "<tr class='hs'/>"
+            "<tr>"
+               "<td>IP Address</td>"
+               "<td>"
+                 "<input name='b00' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Gateway</td>"
+               "<td>"
+                 "<input name='b04' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Netmask</td>"
+               "<td>"
+                 "<input name='b08' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Port</td>"
+               "<td><input name='c00' class='t8 port'></td>"
+            "</tr>"
+            "<tr>"
+               "<td>MAC Address</td>"
+               "<td>"
+                 "<input name='d00' required pattern='([0-9a-fA-F]{2}[:-]?){5}([0-9a-fA-F]{2})' title='aa:bb:cc:dd:ee:ff format' maxlength=17/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Features</td>"
+               "<td class='f'></td>"
+            "</tr>"
+            "<tr class='hs'/>"
+            "<tr>"
+               "<td>MQTT Server</td>"
+               "<td>"
+                 "<input name='b12' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>MQTT Port</td>"
+               "<td><input name='c01' class='t8 port'></td>"
+            "</tr>"
+            "<tr>"
+               "<td>MQTT Username</td>"
+               "<td class='up'><input name='l00' value='%l00'></td>"
+            "</tr>"
+            "<tr>"
+               "<td>MQTT Password</td>"
+               "<td class='up'><input name='m00' value='%m00'></td>"
+            "</tr>"
+            "<tr class='hs'/>"
+            "<tr>"
+               "<td>MQTT Status</td>"
+               "<td class='s'>"
+                 "<div class='s%n00'></div> <div class='s%n01'></div> <div class='s%n02'></div> <div class='s%n03'></div> <div class='s%n04'></div>"
+               "</td>"
+            "</tr>"
+            "<tr class='hs'/>"
+         "</table>"
+         "<table>"
+            "<tr>"
+              "<th>IO</th>"
+              "<th>Type</th>"
+              "<th>Invert</th>"
+              "<th>Boot state</th>"
+            "</tr>"
+         "<script>"
+"const m=(e=>{const t=['b00','b04','b08','b12'],n=['c00','c01'],o={disabled:0,input:1,out"
+"put:3},r={retain:8,on:16,off:0},a=document,c=location,s=a.querySelector.bind(a),p=s('for"
+"m'),d=Object.entries,i=parseInt,l=(e,t)=>i(e).toString(16).padStart(t,'0'),u=e=>e.map(e="
+">l(e,2)).join(''),m=e=>e.match(/.{2}/g).map(e=>i(e,16)),$=e=>encodeURIComponent(e),b=(e,"
+"t)=>(e=>s(`input[name=${e}]`))(e).value=t,f=(e,t)=>{for(const n of a.querySelectorAll(e)"
+")t(n)},h=(e,t)=>{for(const[n,o]of d(t))e.setAttribute(n,o)},g=(e,t)=>d(e).map(e=>`<optio"
+"n value=${e[1]} ${e[1]==t?'selected':''}>${e[0]}</option>`).join(''),x=(e,t,n,o='')=>`<i"
+"nput type='checkbox' name='${e}' value=${t} ${(n&t)==t?'checked':''}>${o}`,y=(e,t,n)=>{c"
+"onst o=new XMLHttpRequest;o.open(e,t,!1),o.send(n)},A=()=>c.href='/61',T=()=>{a.body.inn"
+"erText='Wait 5s...',setTimeout(A,5e3)},j=m(e.g00)[0],E={required:!0};return f('.ip',e=>{"
+"h(e,{...E,title:'x.x.x.x format',pattern:'((25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$"
+")|$)){4}'})}),f('.port',e=>{h(e,{...E,type:'number',min:10,max:65535})}),f('.up input',e"
+"=>{h(e,{title:'0 to 10 letters, numbers, and -_*. no spaces. Blank for no entry.',maxlen"
+"gth:10,pattern:'[0-9a-zA-Z-_*.]{0,10}$'})}),t.forEach(t=>b(t,m(e[t]).join('.'))),n.forEa"
+"ch(t=>b(t,i(e[t],16))),b('d00',e.d00.replace(/[0-9a-z]{2}(?!$)/g,'$&:')),m(e.h00).forEac"
+"h((e,t)=>{const n=1&e?x('p'+t,4,e):'',s=3==(3&e)?`<select name='p${t}'>${g(r,24&e)}</sel"
+"ect>`:'',p='#d'==c.hash?`<td>${e}</td>`:'';(e=>a.write(e))(`<tr><td>#${t+1}</td><td><sel"
+"ect name='p${t}'>${g(o,3&e)}</select></td><td>${n}</td><td>${s}</td>${p}</tr>`)}),s('.f'"
+").innerHTML=Array.from(d({'Full Duplex':1,'HA Auto':6,MQTT:4,DS18B20:8}),([e,t])=>x('g00"
+"',t,j,e)).join('</br>'),{r:()=>{y('GET','/91'),T()},s:o=>{o.preventDefault();const r=Arr"
+"ay.from((()=>{const o=new FormData(p),r=e=>o.getAll(e).map(e=>i(e)).reduce((e,t)=>e|t,0)"
+";return t.forEach(e=>o.set(e,u(o.get(e).split('.')))),n.forEach(e=>o.set(e,l(o.get(e),4)"
+")),o.set('d00',o.get('d00').toLowerCase().replace(/[:-]/g,'')),o.set('h00',u(m(e.h00).ma"
+"p((e,t)=>{const n='p'+t,a=r(n);return o.delete(n),a}))),o.set('g00',u([r('g00')])),o})()"
+".entries(),([e,t])=>`${$(e)}=${$(t)}`).join('&');y('POST','/',r+'&z00=0'),T()},l:A}})({b"
+"00:'%b00',b04:'%b04',b08:'%b08',c00:'%c00',d00:'%d00',b12:'%b12',c01:'%c01',h00:'%h00',g"
+"00:'%g00'});"
+            "%y01"
+      "<p>Code Revision %w00<br/>"
+        "<a href='https://github.com/nielsonm236/NetMod-ServerApp/wiki'>Help Wiki</a>"
+      "</p>"
+      "<button title='Save first!' onclick='m.r()'>Reboot</button>"
+      "<br><br>"
+      "%y02`/61`'>Refresh</button> "
+      "%y02`/60`'>IO Control</button>"
+   "</body>"
+"</html>";
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if OB_EEPROM_SUPPORT == 1
+// Declared short static const here so that common code can be used for Flash
+// and Off-Board webpage sources.
+static const char g_HtmlPageConfiguration[] = " ";
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+/*
+// Credit to Jevgeni Kiski for the javascript work and html improvements.
+// Below is the raw script used above before minify.
+// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
+// 2) Copy the resulting minified script to an editor and replace all double quotes with
+//    single quotes. THIS STEP IS VERY IMPORTANT.
+// 3) Copy the result to the above between the <script> and </script> lines.
+// 4) Add double quotes at the start and end of the minfied script to make it part of the
+//    constant string.
+// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
+//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
+//    removed from the minified script.
+
+const m = (data => {
+    const ip_input_names = ['b00', 'b04', 'b08', 'b12'],
+        port_input_names = ['c00', 'c01'],
+        features = { 'Full Duplex': 1, 'HA Auto': 6, 'MQTT': 4, 'DS18B20': 8 },
+        pin_types = { 'disabled': 0, 'input': 1, 'output': 3 },
+        boot_state = { 'retain': 8, 'on': 16, 'off': 0 },
+        doc=document,
+        loc=location,
+        selector=doc.querySelector.bind(doc),
+        form=selector('form'),
+        get_entries=Object.entries,
+        parse_int = parseInt,
+        document_write = text => doc.write(text),
+        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
+        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
+        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
+        encode = v => encodeURIComponent(v),
+        query_input_by_name = n => selector(`input[name=${n}]`),
+        set_input_value = (n, v) => query_input_by_name(n).value = v,
+        selector_apply_fn = (query, fn) => { for (const e of doc.querySelectorAll(query)) { fn(e) } },
+        set_attributes = (e, d) => { for (const [k, v] of get_entries(d)) { e.setAttribute(k, v); } },
+        make_options = (o, v) => get_entries(o).map((o) => `<option value=${o[1]} ${o[1] == v ? 'selected' : ''}>${o[0]}</option>`).join(''),
+        make_checkbox = (name, bit, value, title='') => `<input type='checkbox' name='${name}' value=${bit} ${(value & bit) == bit ? 'checked' : ''}>${title}`,
+        get_form_data = () => {
+            const form_data = new FormData(form),
+            	collect_bits = (name) => form_data.getAll(name).map(v => parse_int(v)).reduce((a, b) => a | b, 0);
+              
+            ip_input_names.forEach((n) => form_data.set(n, convert_to_hex(form_data.get(n).split('.'))));
+            port_input_names.forEach((n) => form_data.set(n, pad_hex(form_data.get(n), 4)));
+            
+            form_data.set('d00', form_data.get('d00').toLowerCase().replace(/[:-]/g, ''));
+            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
+                const name = 'p' + i,
+                    result = collect_bits(name);
+                form_data.delete(name);
+                return result;
+            })));
+            
+            form_data.set('g00', convert_to_hex([collect_bits('g00')]));
+            
+            return form_data;
+        },
+        send_request = (method, url, data) => {
+        	const request = new XMLHttpRequest();
+          request.open(method, url, false);
+          request.send(data);
+        },
+        reload_page = () => loc.href = '/61',
+        wait_reboot = () => {
+          doc.body.innerText = 'Wait 5s...';
+          setTimeout(reload_page, 5000);
+        },
+        reboot = () => {
+          send_request('GET', '/91');
+          wait_reboot();
+        },
+        submitForm = (event) => {
+        	event.preventDefault();
+          const string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
+          send_request('POST', '/', string_data + '&z00=0');
+          wait_reboot();
+        },
+        features_data = convert_from_hex(data.g00)[0],
+        common_attributes = {required: true};
+
+    selector_apply_fn('.ip', (e) => { set_attributes(e, {...common_attributes, title: 'x.x.x.x format', pattern: '((25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$)|$)){4}' }); });
+    selector_apply_fn('.port', (e) => { set_attributes(e, {...common_attributes, type: 'number', min: 10, max: 65535 }); });
+    selector_apply_fn('.up input', (e) => { set_attributes(e, {title: '0 to 10 letters, numbers, and -_*. no spaces. Blank for no entry.', maxlength: 10, pattern: '[0-9a-zA-Z-_*.]{0,10}$' }); });
+
+    ip_input_names.forEach((n) => set_input_value(n, convert_from_hex(data[n]).join('.')));
+    port_input_names.forEach((n) => set_input_value(n, parse_int(data[n], 16)));
+    set_input_value('d00', data.d00.replace(/[0-9a-z]{2}(?!$)/g, '$&:'));
+
+    convert_from_hex(data.h00).forEach((n, i) => {
+        const checkbox = n & 1 ? make_checkbox('p'+i, 4, n) : '',
+            make_select = (n & 3) == 3 ? `<select name='p${i}'>${make_options(boot_state, n & 24)}</select>` : '',
+            debug_column = (loc.hash == '#d'?`<td>${n}</td>`:'');
+        document_write(`<tr><td>#${i + 1}</td><td><select name='p${i}'>${make_options(pin_types, n & 3)}</select></td><td>${checkbox}</td><td>${make_select}</td>${debug_column}</tr>`);
+    });
+    
+    selector('.f').innerHTML = Array.from(
+    	get_entries(features),
+      ([name, bit]) => make_checkbox('g00', bit, features_data, name)).join('</br>'
+    );
+    
+    
+    return {r:reboot, s: submitForm, l:reload_page};
+})({
+    b00: '%b00',
+    b04: '%b04',
+    b08: '%b08',
+    c00: '%c00',
+    d00: '%d00',
+    b12: '%b12',
+    c01: '%c01',
+    h00: '%h00',
+    g00: '%g00'
+});
+
+*/
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+
+
+
+//---------------------------------------------------------------------------//
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+// IO Control Template
+//
+// PARSE_BYTES calculation:
+// The form contained in this webpage will generate several data update
+// replies. These replies need to be parsed to extract the data from them. We
+// need to stop parsing the reply POST data after all update bytes are parsed.
+// The formula for determining the stop value is as follows:
+//   Each POST has a "wrapper" consisting of
+//     1 byte ParseCmd
+//     2 byte ParseNum
+//     1 byte egual sign
+//     1 byte Delimiter
+//     So, add 5 bytes to each POST as defined here:
+//
+//     For 1 of the replies (Pin Control):
+//     POST consists of 32 bytes data plus 5 byte wrapper (37 bytes)
+//   PLUS
+//     For 1 of the replies (hidden):
+//     example: z00=x where x is 1 byte (note no &)
+//     POST consists of a 1 byte data plus 4 byte wrapper (5 bytes)
+// THUS
+// The formula in this case is
+//     PARSEBYTES = (1 x 37)
+//                + (1 x 5)
+//     PARSEBYTES = 37
+//                + 5 = 42
+//
+#define PARSEBYTES_IOCONTROL		42
+// Next line is dummy define used only by the strings pre-processor.
+#define BROWSER_ONLY_WEBPAGE_IOCONTROL_BEGIN	92
+#if OB_EEPROM_SUPPORT == 0
+static const char g_HtmlPageIOControl[] =
+"%y04%y05"
+      "<title>%a00: IO Control</title>"
+   "</head>"
+   "<body>"
+      "<h1>IO Control</h1>"
+      "<form onsubmit='return m.s(event);return false'>"
+         "<table>"
+            "<tr>"
+               "<th>Name:</th>"
+               "<td colspan=2 style='text-align: left'>%a00</td>"
+            "</tr>"
+            "<script>"
+"const m=(t=>{const e=document,j=e.querySelector.bind(e)('form'),r=(Object.entries,parseInt)"
+",n=t=>e.write(t),o=t=>t.map(t=>((t,e)=>r(t).toString(16).padStart(e,'0'))(t,2)).join(''),a="
+"t=>t.match(/.{2}/g).map(t=>r(t,16)),s=t=>encodeURIComponent(t),c=[],d=[],h=(t,e,j)=>{return"
+"`<label><input type=radio name=o${e} value=${t} ${j==t?'checked':''}/>${(t?'on':'off').toUp"
+"perCase()}</label>`},p=()=>location.href='/60';return a(t.h00).forEach((e,j)=>{var r=t['j'+"
+"(j+'').padStart(2,'0')];3==(3&e)?d.push(`<tr><td>${r}</td><td class='s${e>>7} t3'></td><td "
+"class=c>${h(1,j,e>>7)}${h(0,j,e>>7)}</td></tr>`):1==(3&e)&&c.push(`<tr><td>${r}</td><td cla"
+"ss='s${e>>7} t3'></td><td/></tr>`)}),n(c.join('')),n(`<tr><th></th><th></th>${d.length>0?'<"
+"th class=c>SET</th>':''}</tr>`),n(d.join('')),{s:e=>{e.preventDefault();const r=new XMLHttp"
+"Request,n=Array.from((()=>{const e=new FormData(j);return e.set('h00',o(a(t.h00).map((t,j)="
+">{const r='o'+j,n=e.get(r)<<7;return e.delete(r),n}))),e})().entries(),([t,e])=>`${s(t)}=${"
+"s(e)}`).join('&');r.open('POST','/',!1),r.send(n+'&z00=0'),p()},l:p}})({h00:'%h00',j00:'%j0"
+"0',j01:'%j01',j02:'%j02',j03:'%j03',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%j07',j08:'%j08',"
+"j09:'%j09',j10:'%j10',j11:'%j11',j12:'%j12',j13:'%j13',j14:'%j14',j15:'%j15'});"
+            "%y01"
+      "<p/>"
+      "%y02`/60`'>Refresh</button> "
+      "%y02`/61`'>Configuration</button>"
+      "<pre>%t00%t01%t02%t03%t04</pre>"
+   "</body>"
+"</html>";
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if OB_EEPROM_SUPPORT == 1
+// Declared short static const here so that common code can be used for Flash
+// and Off-Board webpage sources.
+static const char g_HtmlPageIOControl[] = " ";
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+
+/*
+// Credit to Jevgeni Kiski for the javascript work and html improvements.
+// Below is the raw script used above before minify.
+// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
+// 2) Copy the resulting minified script to an editor and replace all double quotes with
+//    single quotes. THIS STEP IS VERY IMPORTANT.
+// 3) Copy the result to the above between the <script> and </script> lines.
+// 4) Add double quotes at the start and end of the minfied script to make it part of the
+//    constant string.
+// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
+//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
+//    removed from the minified script.
+
+const m = (data => {
+    const doc = document,
+        selector = doc.querySelector.bind(doc),
+        form = selector('form'),
+        get_entries = Object.entries,
+        parse_int = parseInt,
+        document_write = text => doc.write(text),
+        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
+        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
+        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
+        encode = v => encodeURIComponent(v),
+        inputs = [],
+        outputs = [],
+        make_radio_input = (type, id, checked_type) => {
+            var type_str = type ? 'on' : 'off';
+            return `<label><input type=radio name=o${id} value=${type} ${checked_type == type ? 'checked' : ''}/>${type_str.toUpperCase()}</label>`;
+        },
+        get_form_data = () => {
+            const form_data = new FormData(form);
+            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
+                const name = 'o' + i,
+                    result = form_data.get(name) << 7;
+                form_data.delete(name);
+                return result;
+            })));
+            return form_data;
+        },
+        reload_page = () => location.href = '/60',
+        submit_form = (event) => {
+        	event.preventDefault();
+
+          const request = new XMLHttpRequest(),
+              string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
+          request.open('POST', '/', false);
+          request.send(string_data + '&z00=0');
+          reload_page();
+        };
+        
+
+    convert_from_hex(data.h00).forEach((cfg, i) => {
+    		var name = data['j'+(i+'').padStart(2, '0')];
+        if ((cfg & 3) == 3) { //output
+            outputs.push(`<tr><td>${name}</td><td class='s${cfg >> 7} t3'></td><td class=c>${make_radio_input(1, i, cfg >> 7)}${make_radio_input(0, i, cfg >> 7)}</td></tr>`);
+        } else if ((cfg & 3) == 1) { // input
+            inputs.push(`<tr><td>${name}</td><td class='s${cfg >> 7} t3'></td><td/></tr>`);
+        }
+    });
+
+    document_write(inputs.join(''));
+    document_write(`<tr><th></th><th></th>${outputs.length > 0 ? '<th class=c>SET</th>' : ''}</tr>`);
+    document_write(outputs.join(''));
+    
+    return {s: submit_form, l:reload_page}
+})({
+  h00: '%h00',
+  j00: '%j00',
+  j01: '%j01',
+  j02: '%j02',
+  j03: '%j03',
+  j04: '%j04',
+  j05: '%j05',
+  j06: '%j06',
+  j07: '%j07',
+  j08: '%j08',
+  j09: '%j09',
+  j10: '%j10',
+  j11: '%j11',
+  j12: '%j12',
+  j13: '%j13',
+  j14: '%j14',
+  j15: '%j15',
+});
+
+*/
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+// Configuration webpage Template
+//
+// PARSE_BYTES calculation:
+// The form contained in this webpage will generate several data update
+// replies. These replies need to be parsed to extract the data from them. We
+// need to stop parsing the reply POST data after all update bytes are parsed.
+// The formula for determining the stop value is as follows:
+//   Each POST has a "wrapper" consisting of
+//     1 byte ParseCmd
+//     2 byte ParseNum
+//     1 byte egual sign
+//     1 byte Delimiter
+//     So, add 5 bytes to each POST as defined here:
+//
+//     For 1 of the replies (device name):
+//     example: a00=xxxxxxxxxxxxxxxxxxx& where xxxxxxxxxxxxxxxxxxx is 1 to 19 bytes
+//     POST consists of 19 bytes data plus 5 byte wrapper (24 bytes)
+//   PLUS
+//     For 3 of the replies (HTML IP, Gateway, and Netmask fields):
+//     example: b00=xxxxxxxx& where xxxxxxxx is 8 bytes
+//     POST consists of 8 bytes data plus 5 byte wrapper (13 bytes)
+//   PLUS
+//     For 1 of the replies (HTML Port number):
+//     example: c00=xxxx& where xxxx is 4 bytes
+//     POST consists of 4 bytes data plus 5 byte wrapper (9 bytes)
+//   PLUS
+//     For 1 of the replies (MAC):
+//     example: d00=xxxxxxxxxxxx& where xxxxxxxxxxxx is 12 bytes
+//     POST consists of 12 bytes data plus 5 byte wrapper (17 bytes)
+//   PLUS
+//     For 1 of the replies (Config):
+//     example: g00=xx& where xx is 2 bytes
+//     POST consists of 2 bytes data plus 5 byte wrapper (7 bytes)
+//   PLUS
+//     For 1 of the replies (Pin Control):
+//     example: h00=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx&
+//     where xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx is 32 bytes
+//     POST consists of 32 bytes data plus 5 byte wrapper (37 bytes)
+//   PLUS
+//     For 16 of the replies (IO Name):
+//     example: j00=xxxxxxxxxxxxxxx& where xxxxxxxxxxxxxxx is 15 bytes
+//     POST consists of 15 bytes data plus 5 byte wrapper (20 bytes)
+//   PLUS
+//     For 16 of the replies (IO Timer):
+//     example: i00=xxxx& where xxxx is 4 bytes
+//     POST consists of 4 bytes data plus 5 byte wrapper (9 bytes)
+//   PLUS
+//     For 1 of the replies (hidden):
+//     example: z00=x where x is 1 byte (note no &)
+//     POST consists of 1 byte data plus 4 byte wrapper (5 bytes)
+// The formula in this case is
+//     PARSEBYTES = (1 x 24)
+//                + (3 x 13)
+//                + (1 x 9)
+//                + (1 x 17)
+//                + (1 x 7)
+//                + (1 x 37)
+//                + (16 x 20)
+//                + (16 x 9)
+//                + (1 x 5)
+//     PARSEBYTES = 24
+//                + 39
+//                + 9
+//                + 17
+//                + 7
+//                + 37
+//                + 320
+//                + 144
+//                + 5 = 602
+//
+#define PARSEBYTES_CONFIGURATION	602
+// Next line is dummy define used only by the strings pre-processor.
+#define BROWSER_ONLY_WEBPAGE_CONFIGURATION_BEGIN	93
+#if OB_EEPROM_SUPPORT == 0
+static const char g_HtmlPageConfiguration[] =
+"%y04%y05"
+      "<title>%a00: Configuration</title>"
+   "</head>"
+   "<body>"
+      "<h1>Configuration</h1>"
+      "<form onsubmit='return m.s(event);return false'>"
+         "<table>"
+            "<tr>"
+               "<td>Name</td>"
+               "<td><input name='a00' value='%a00' pattern='[0-9a-zA-Z-_*.]{1,19}' required title='1 to 19 letters, numbers, and -_*. no spaces' maxlength='19'/></td>"
+            "</tr>"
+            "<tr class='hs'/>"
+            "<tr>"
+               "<td>IP Address</td>"
+               "<td>"
+                 "<input name='b00' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Gateway</td>"
+               "<td>"
+                 "<input name='b04' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Netmask</td>"
+               "<td>"
+                 "<input name='b08' class='ip'/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Port</td>"
+               "<td><input name='c00' class='t8 port'></td>"
+            "</tr>"
+            "<tr>"
+               "<td>MAC Address</td>"
+               "<td>"
+                 "<input name='d00' required pattern='([0-9a-fA-F]{2}[:-]?){5}([0-9a-fA-F]{2})' title='aa:bb:cc:dd:ee:ff format' maxlength=17/>"
+               "</td>"
+            "</tr>"
+            "<tr>"
+               "<td>Features</td>"
+               "<td class='f'></td>"
+            "</tr>"
+            "<tr class='hs'/>"
+         "</table>"
+         "<table>"
+            "<tr>"
+              "<th>IO</th>"
+              "<th>Type</th>"
+              "<th>Name</th>"
+              "<th>Invert</th>"
+              "<th>Boot state</th>"
+              "<th>Timer</th>"
+            "</tr>"
+         "<script>"
+"const m=(e=>{const t=['b00','b04','b08'],i=['c00'],n={disabled:0,input:1,output:3},r={r"
+"etain:8,on:16,off:0},a={'0.1s':0,'1s':16384,'1m':32768,'1h':49152},o=document,s=locatio"
+"n,c=o.querySelector.bind(o),j=c('form'),d=Object.entries,p=parseInt,l=(e,t)=>p(e).toStr"
+"ing(16).padStart(t,'0'),m=e=>e.map(e=>l(e,2)).join(''),u=e=>e.match(/.{2}/g).map(e=>p(e"
+",16)),$=e=>encodeURIComponent(e),b=(e,t)=>(e=>c(`input[name=${e}]`))(e).value=t,f=(e,t)"
+"=>{for(const i of o.querySelectorAll(e))t(i)},h=(e,t)=>{for(const[i,n]of d(t))e.setAttr"
+"ibute(i,n)},g=(e,t)=>d(e).map(e=>`<option value=${e[1]} ${e[1]==t?'selected':''}>${e[0]"
+"}</option>`).join(''),x=(e,t,i,n='')=>`<input type='checkbox' name='${e}' value=${t} ${"
+"(i&t)==t?'checked':''}>${n}`,y=(e,t,i)=>{const n=new XMLHttpRequest;n.open(e,t,!1),n.se"
+"nd(i)},S=()=>s.href='/61',v=()=>{o.body.innerText='Wait 5s...',setTimeout(S,5e3)},A=u(e"
+".g00)[0],E={required:!0};return f('.ip',e=>{h(e,{...E,title:'x.x.x.x format',pattern:'("
+"(25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$)|$)){4}'})}),f('.port',e=>{h(e,{...E,type"
+":'number',min:10,max:65535})}),t.forEach(t=>b(t,u(e[t]).join('.'))),i.forEach(t=>b(t,p("
+"e[t],16))),b('d00',e.d00.replace(/[0-9a-z]{2}(?!$)/g,'$&:')),u(e.h00).forEach((t,i)=>{c"
+"onst c=1&t?x('p'+i,4,t):'',j=(e,i)=>3==(3&t)?e:i,d=(''+i).padStart(2,'0'),p=j(u(e['i'+d"
+"]).reduce((e,t)=>(e<<8)+t),0),l=j(`<select name='p${i}'>${g(r,24&t)}</select>`,''),m='#"
+"d'==s.hash?`<td>${t}</td>`:'',$=j(`<input type=number class=t8 name='i${d}' value='${16"
+"383&p}' min=0 max=16383><select name='i${d}'>${g(a,49152&p)}</select>`,'');(e=>o.write("
+"e))(`<tr><td>#${i+1}</td><td><select name='p${i}'>${g(n,3&t)}</select></td><td><input n"
+"ame='j${d}' value='${e['j'+d]}' pattern='[0-9a-zA-Z_*.-]{1,15}' required title='1 to 15"
+" letters, numbers, and -*_. no spaces' maxlength=15/></td><td>${c}</td><td>${l}</td><td"
+">${$}</td>${m}</tr>`)}),c('.f').innerHTML=Array.from(d({'Full Duplex':1,DS18B20:8}),([e"
+",t])=>x('g00',t,A,e)).join('</br>'),{r:()=>{y('GET','/91'),v()},s:n=>{n.preventDefault("
+");const r=Array.from((()=>{const n=new FormData(j),r=e=>n.getAll(e).map(e=>p(e)).reduce"
+"((e,t)=>e|t,0);t.forEach(e=>n.set(e,m(n.get(e).split('.')))),i.forEach(e=>n.set(e,l(n.g"
+"et(e),4))),n.set('d00',n.get('d00').toLowerCase().replace(/[:-]/g,'')),n.set('h00',m(u("
+"e.h00).map((e,t)=>{const i='p'+t,a=r(i);return n.delete(i),a})));for(let e=0;e<16;e++){"
+"let t=(''+e).padStart(2,'0');n.set('i'+t,l(65535&r('i'+t),4))}return n.set('g00',m([r('"
+"g00')])),n})().entries(),([e,t])=>`${$(e)}=${$(t)}`).join('&');y('POST','/',r+'&z00=0')"
+",v()},l:S}})({b00:'%b00',b04:'%b04',b08:'%b08',c00:'%c00',d00:'%d00',h00:'%h00',g00:'%g"
+"00',j00:'%j00',j01:'%j01',j02:'%j02',j03:'%j03',j04:'%j04',j05:'%j05',j06:'%j06',j07:'%"
+"j07',j08:'%j08',j09:'%j09',j10:'%j10',j11:'%j11',j12:'%j12',j13:'%j13',j14:'%j14',j15:'"
+"%j15',i00:'%i00',i01:'%i01',i02:'%i02',i03:'%i03',i04:'%i04',i05:'%i05',i06:'%i06',i07:"
+"'%i07',i08:'%i08',i09:'%i09',i10:'%i10',i11:'%i11',i12:'%i12',i13:'%i13',i14:'%i14',i15"
+":'%i15'});"
+            "%y01"
+      "<p>Code Revision %w00<br/>"
+        "<a href='https://github.com/nielsonm236/NetMod-ServerApp/wiki'>Help Wiki</a>"
+      "</p>"
+      "<button title='Save first!' onclick='m.r()'>Reboot</button>"
+      "<br><br>"
+      "%y02`/61`'>Refresh</button> "
+      "%y02`/60`'>IO Control</button>"
+   "</body>"
+"</html>";
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if OB_EEPROM_SUPPORT == 1
+// Declared short static const here so that common code can be used for Flash
+// and Off-Board webpage sources.
+static const char g_HtmlPageConfiguration[] = " ";
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+/*
+// Credit to Jevgeni Kiski for the javascript work and html improvements.
+// Below is the raw script used above before minify.
+// 1) Copy raw script to minify website, for example https://javascript-minifier.com/
+// 2) Copy the resulting minified script to an editor and replace all double quotes with
+//    single quotes. THIS STEP IS VERY IMPORTANT.
+// 3) Copy the result to the above between the <script> and </script> lines.
+// 4) Add double quotes at the start and end of the minfied script to make it part of the
+//    constant string.
+// 5) It is OK to break up the minified script into lines enclosed by double quotes (just
+//    to make it all visible in the code editors). But make sure no spaces are inadvertantly
+//    removed from the minified script.
+
+const m = (data => {
+    const ip_input_names = ['b00', 'b04', 'b08'],
+        port_input_names = ['c00'],
+        features = { 'Full Duplex': 1, 'DS18B20': 8 },
+        pin_types = { 'disabled': 0, 'input': 1, 'output': 3 },
+        boot_state = { 'retain': 8, 'on': 16, 'off': 0 },
+        timer_unit = { '0.1s': 0, '1s': 0x4000, '1m': 0x8000, '1h': 0xc000 },
+        doc=document,
+        loc=location,
+        selector=doc.querySelector.bind(doc),
+        form=selector('form'),
+        get_entries=Object.entries,
+        parse_int = parseInt,
+        document_write = text => doc.write(text),
+        pad_hex = (s, l) => parse_int(s).toString(16).padStart(l, '0'),
+        convert_to_hex = v => v.map(p => pad_hex(p, 2)).join(''),
+        convert_from_hex = v => v.match(/.{2}/g).map(p => parse_int(p, 16)),
+        encode = v => encodeURIComponent(v),
+        query_input_by_name = n => selector(`input[name=${n}]`),
+        set_input_value = (n, v) => query_input_by_name(n).value = v,
+        selector_apply_fn = (query, fn) => { for (const e of doc.querySelectorAll(query)) { fn(e) } },
+        set_attributes = (e, d) => { for (const [k, v] of get_entries(d)) { e.setAttribute(k, v); } },
+        make_options = (o, v) => get_entries(o).map((o) => `<option value=${o[1]} ${o[1] == v ? 'selected' : ''}>${o[0]}</option>`).join(''),
+        make_checkbox = (name, bit, value, title='') => `<input type='checkbox' name='${name}' value=${bit} ${(value & bit) == bit ? 'checked' : ''}>${title}`,
+        get_form_data = () => {
+            const form_data = new FormData(form),
+            	collect_bits = (name) => form_data.getAll(name).map(v => parse_int(v)).reduce((a, b) => a | b, 0);
+              
+            ip_input_names.forEach((n) => form_data.set(n, convert_to_hex(form_data.get(n).split('.'))));
+            port_input_names.forEach((n) => form_data.set(n, pad_hex(form_data.get(n), 4)));
+            
+            form_data.set('d00', form_data.get('d00').toLowerCase().replace(/[:-]/g, ''));
+            form_data.set('h00', convert_to_hex(convert_from_hex(data.h00).map((_, i) => {
+                const name = 'p' + i,
+                    result = collect_bits(name);
+                form_data.delete(name);
+                return result;
+            })));
+            for (let i=0;i<16;i++) {
+              let input_nr = (''+i).padStart(2, '0');
+            	form_data.set('i'+input_nr, pad_hex(collect_bits('i'+input_nr) & 0xffff, 4));
+            }
+            
+            form_data.set('g00', convert_to_hex([collect_bits('g00')]));
+            
+            return form_data;
+        },
+        send_request = (method, url, data) => {
+        	const request = new XMLHttpRequest();
+          request.open(method, url, false);
+          request.send(data);
+        },
+        reload_page = () => loc.href='/61',
+        wait_reboot = () => {
+          doc.body.innerText = 'Wait 5s...';
+          setTimeout(reload_page, 5000);
+        },
+        reboot = () => {
+          send_request('GET', '/91');
+          wait_reboot();
+        },
+        submitForm = (event) => {
+        	event.preventDefault();
+          const string_data = Array.from(get_form_data().entries(), ([k, v]) => `${encode(k)}=${encode(v)}`).join('&');
+          send_request('POST', '/', string_data + '&z00=0');
+          wait_reboot();
+        },
+        features_data = convert_from_hex(data.g00)[0],
+        common_attributes = {required: true};
+
+    selector_apply_fn('.ip', (e) => { set_attributes(e, {...common_attributes, title: 'x.x.x.x format', pattern: '((25[0-5]|(2[0-4]|1[0-9]|[1-9]|)[0-9])([.](?!$)|$)){4}' }); });
+    selector_apply_fn('.port', (e) => { set_attributes(e, {...common_attributes, type: 'number', min: 10, max: 65535 }); });
+
+    ip_input_names.forEach((n) => set_input_value(n, convert_from_hex(data[n]).join('.')));
+    port_input_names.forEach((n) => set_input_value(n, parse_int(data[n], 16)));
+    set_input_value('d00', data.d00.replace(/[0-9a-z]{2}(?!$)/g, '$&:'));
+
+    convert_from_hex(data.h00).forEach((n, i) => {
+        const invert_checkbox = n & 1 ? make_checkbox('p'+i, 4, n) : '',
+            if_output = (a,b) => (n & 3) == 3 ? a: b,
+        		input_nr = (''+i).padStart(2, '0'),
+            timer_int_value = if_output(convert_from_hex(data['i'+input_nr]).reduce((prev, cur)=>(prev<<8)+cur), 0),
+            boot_state_select = if_output(`<select name='p${i}'>${make_options(boot_state, n & 24)}</select>`,''),
+            debug_column = (loc.hash == '#d'?`<td>${n}</td>`:''),
+            timer_column = if_output(`<input type=number class=t8 name='i${input_nr}' value='${timer_int_value & 0x3fff}' min=0 max=16383><select name='i${input_nr}'>${make_options(timer_unit, timer_int_value & 0xc000)}</select>`,'');
+        document_write(`<tr><td>#${i + 1}</td><td><select name='p${i}'>${make_options(pin_types, n & 3)}</select></td><td><input name='j${input_nr}' value='${data['j'+input_nr]}' pattern='[0-9a-zA-Z_*.-]{1,15}' required title='1 to 15 letters, numbers, and -*_. no spaces' maxlength=15/></td><td>${invert_checkbox}</td><td>${boot_state_select}</td><td>${timer_column}</td>${debug_column}</tr>`);
+    });
+    
+    selector('.f').innerHTML = Array.from(
+    	get_entries(features),
+      ([name, bit]) => make_checkbox('g00', bit, features_data, name)).join('</br>'
+    );
+    
+    
+    return {r:reboot, s: submitForm, l:reload_page};
+})({
+    b00: '%b00',
+    b04: '%b04',
+    b08: '%b08',
+    c00: '%c00',
+    d00: '%d00',
+    h00: '%h00',
+    g00: '%g00',
+    j00: '%j00',
+    j01: '%j01',
+    j02: '%j02',
+    j03: '%j03',
+    j04: '%j04',
+    j05: '%j05',
+    j06: '%j06',
+    j07: '%j07',
+    j08: '%j08',
+    j09: '%j09',
+    j10: '%j10',
+    j11: '%j11',
+    j12: '%j12',
+    j13: '%j13',
+    j14: '%j14',
+    j15: '%j15',
+    i00: '%i00',
+    i01: '%i01',
+    i02: '%i02',
+    i03: '%i03',
+    i04: '%i04',
+    i05: '%i05',
+    i06: '%i06',
+    i07: '%i07',
+    i08: '%i08',
+    i09: '%i09',
+    i10: '%i10',
+    i11: '%i11',
+    i12: '%i12',
+    i13: '%i13',
+    i14: '%i14',
+    i15: '%i15',
+});
+
+*/
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+// Statistics page Template
+static const char g_HtmlPageStats1[] =
+"%y04%y05"
+  "<title>%a00: Network Statistics</title>"
+  "</head>"
+  "<body>"
+  "<h1>Network Statistics</h1>"
+  "<p>Values shown are since last power on or reset</p>"
+  "<table>"
+  "<tr><td class='t1'>%e00</td><td class='t2'>Dropped packets at the IP layer</td></tr>"
+  "<tr><td class='t1'>%e01</td><td class='t2'>Received packets at the IP layer</td></tr>"
+  "<tr><td class='t1'>%e02</td><td class='t2'>Sent packets at the IP layer</td></tr>"
+  "<tr><td class='t1'>%e03</td><td class='t2'>Packets dropped due to wrong IP version or header length</td></tr>"
+  "<tr><td class='t1'>%e04</td><td class='t2'>Packets dropped due to wrong IP length, high byte</td></tr>"
+  "<tr><td class='t1'>%e05</td><td class='t2'>Packets dropped due to wrong IP length, low byte</td></tr>"
+  "<tr><td class='t1'>%e06</td><td class='t2'>Packets dropped since they were IP fragments</td></tr>"
+  "<tr><td class='t1'>%e07</td><td class='t2'>Packets dropped due to IP checksum errors</td></tr>"
+  "<tr><td class='t1'>%e08</td><td class='t2'>Packets dropped since they were not ICMP or TCP</td></tr>"
+  "<tr><td class='t1'>%e09</td><td class='t2'>Dropped ICMP packets</td></tr>"
+  "<tr><td class='t1'>%e10</td><td class='t2'>Received ICMP packets</td></tr>"
+  "<tr><td class='t1'>%e11</td><td class='t2'>Sent ICMP packets</td></tr>"
+  "<tr><td class='t1'>%e12</td><td class='t2'>ICMP packets with a wrong type</td></tr>"
+  "<tr><td class='t1'>%e13</td><td class='t2'>Dropped TCP segments</td></tr>"
+  "<tr><td class='t1'>%e14</td><td class='t2'>Received TCP segments</td></tr>"
+  "<tr><td class='t1'>%e15</td><td class='t2'>Sent TCP segments</td></tr>"
+  "<tr><td class='t1'>%e16</td><td class='t2'>TCP segments with a bad checksum</td></tr>"
+  "<tr><td class='t1'>%e17</td><td class='t2'>TCP segments with a bad ACK number</td></tr>"
+  "<tr><td class='t1'>%e18</td><td class='t2'>Received TCP RST (reset) segments</td></tr>"
+  "<tr><td class='t1'>%e19</td><td class='t2'>Retransmitted TCP segments</td></tr>"
+  "<tr><td class='t1'>%e20</td><td class='t2'>Dropped SYNs due to too few connections avaliable</td></tr>"
+  "<tr><td class='t1'>%e21</td><td class='t2'>SYNs for closed ports, triggering a RST</td></tr>"
+  "</table>"
+  "<br>"
+  "<button onclick='location=`/61`'>Configuration</button>"
+  "<button onclick='location=`/68`'>Refresh</button>"
+  "<button onclick='location=`/69`'>Clear</button>"
+  "</body>"
+  "</html>";
+#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+
+#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
+// Link Error Statistics page Template
+static const char g_HtmlPageStats2[] =
+  "%y04%y05"
+  "<title>%a00: Link Error Statistics</title>"
+  "</head>"
+  "<body>"
+  "<h1>Link Error Statistics</h1>"
+  "<table>"
+  "<tr><td>31 %e31</td></tr>"
+  "<tr><td>32 %e32</td></tr>"
+  "<tr><td>33 %e33</td></tr>"
+  "<tr><td>35 %e35</td></tr>"
+#if FAIR_SCHEDULER_SUPPORT == 1
+  "<tr><td>36 %e36</td></tr>"
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  "</table>"
+  "<br>"
+  "<button onclick='location=`/61`'>Configuration</button>"
+  "<button onclick='location=`/66`'>Refresh</button>"
+  "<button onclick='location=`/67`'>Clear</button>"
+  "</body>"
+  "</html>";
+#endif // DEBUG_SUPPORT
+
+
+
+#if DEBUG_SENSOR_SERIAL == 1
+// Temperature Sensor Serial Number page Template
+static const char g_HtmlPageTmpSerialNum[] =
+  "%y04%y05"
+  "<title>%a00: Temperature Sensor Serial Numbers</title>"
+  "</head>"
+  "<body>"
+  "<h1>Temperature Sensor Serial Numbers</h1>"
+  "<table>"
+  "<tr><td>%e40</td></tr>"
+  "<tr><td>%e41</td></tr>"
+  "<tr><td>%e42</td></tr>"
+  "<tr><td>%e43</td></tr>"
+  "<tr><td>%e44</td></tr>"
+  "</table>"
+  "<br>"
+  "<button onclick='location=`/61`'>Configuration</button>"
+  "</body>"
+  "</html>";
+#endif // DEBUG_SENSOR_SERIAL
+
+
+
+// Very Short IO state page Template
+// Only responds with a TCP payload that contains the 16 alphanumeric
+// characters representing the IO pins states. The response is not
+// browser compatible.
+// 4 bytes; size of reports 5
+static const char g_HtmlPageSstate[] =
+  "%f00";
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+// Code Uploader Support page Template
+// This is the main web page shown by the Code Uploader.
+static const char g_HtmlPageUploader[] =
+  "%y04%y05"
+  "<title>Code Uploader</title>"
+  "</head>"
+  "<body>"
+  "<h1>Code Uploader</h1>"
+  "<form action='' method='post' enctype='multipart/form-data'>"
+  
+  "<script>"
+    "function startTimer(){"
+      "var timeleft = 20;"
+      "var downloadTimer = setInterval(function(){"
+        "if(timeleft <= 0){"
+          "clearInterval(downloadTimer);"
+        "}"
+        "document.getElementById('progressBar').value = 20 - timeleft;"
+        "timeleft -= 1;"
+      "}, 1000);"
+    "}"
+    "function start(){"
+      "document.getElementById('progressBar');"
+      "startTimer();"
+    "};"
+  "</script>"
+
+  "<p>"
+  "Use CHOOSE FILE to select a .sx or .nmb file then click SUBMIT. The 30 second<br>"
+  "Upload and Flash programming process will start.<br>"
+  "</p>"
+  
+  "<p><input input type='file' name='file1' accept='.sx,.nmb' required /></p>"
+  "<p><button type='submit' onclick='start()'>Submit</button></p>"
+
+  "<p>"
+  "Once you click Submit do not access via your browser until Flash programming<br>"
+  "completes.<br>"
+  "</p>"
+  
+  "<p>"
+  "<progress id='progressBar' value='0' max='20'></progress>"
+  "<br><br><br>"
+
+  "</form>"
+  
+  "<p>"
+  "RESTORE: If you arrived here unintentionally DO NOT CLICK SUBMIT. Instead<br>"
+  "use the Restore button to reinstall your previous firmware version.<br>"
+  "</p>"
+  "<button onclick='location=`/73`'>Restore</button>"
+  "<p>"
+  "<br>"
+  "</p>"
+  "</body>"
+  "</html>";
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if OB_EEPROM_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+// Load Uploader page Template
+// This web page is shown when the user requests the Code Uploader with the
+// /72 command.
+static const char g_HtmlPageLoadUploader[] =
+  "%y04%y05"
+  "<title>Loading Code Uploader</title>"
+  "</head>"
+  "<body>"
+  "<h1>Loading Code Uploader</h1>"
+  "<p>"
+  "DO NOT ACCESS BROWSER FOR 15 SECONDS.<br><br>"
+  "Wait until the progress bar completes, then click Continue.<br><br>"
+  
+  "<progress value='0' max='15' id='progressBar'></progress>"
+  "<script>"
+  "var timeleft = 15;"
+  "var downloadTimer = setInterval(function(){"
+    "if(timeleft <= 0){"
+      "clearInterval(downloadTimer);"
+    "}"
+    "document.getElementById('progressBar').value = 15 - timeleft;"
+    "timeleft -= 1;"
+  "}, 1000);"
+  "</script>"
+  
+  "<br>"
+  "<br>"
+  
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+// Existing Image page Template
+// This web page is shown when the user requests that the existing firmware
+// image be reinstalled
+static const char g_HtmlPageExistingImage[] =
+  "%y04%y05"
+  "<title>Restoring Existing Image</title>"
+  "</head>"
+  "<body>"
+  "<h1>Restoring Existing Image</h1>"
+  "<p>"
+  "It takes about 15 SECONDS to restore the existing firmware image.<br><br>"
+  "DO NOT ATTEMPT BROWSER ACCESS DURING THIS 15 SECOND PERIOD.<br><br>"
+  "Wait until the progress bar completes, then click Continue.<br><br>"
+  
+  "<progress value='0' max='15' id='progressBar'></progress>"
+  "<script>"
+  "var timeleft = 15;"
+  "var downloadTimer = setInterval(function(){"
+    "if(timeleft <= 0){"
+      "clearInterval(downloadTimer);"
+    "}"
+    "document.getElementById('progressBar').value = 15 - timeleft;"
+    "timeleft -= 1;"
+  "}, 1000);"
+  "</script>"
+  "<br>"
+  "<br>"
+  
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+// Timer page Template
+// This web page is shown when uploaded code is being written to the Flash.
+// The page displays a wait timer to help prevent the user from taking
+// actions while the Flash is finishing.
+static const char g_HtmlPageTimer[] =
+  "%y04%y05"
+  "<title>Writing Flash</title>"
+  "</head>"
+  "<body>"
+  "<h1>Writing and Verifying Flash</h1>"
+  "<p>"
+  "Wait until the progress bar completes, then click Continue.<br><br>"
+  
+  "<progress value='0' max='15' id='progressBar'></progress>"
+  "<script>"
+  "var timeleft = 15;"
+  "var downloadTimer = setInterval(function(){"
+    "if(timeleft <= 0){"
+      "clearInterval(downloadTimer);"
+    "}"
+    "document.getElementById('progressBar').value = 15 - timeleft;"
+    "timeleft -= 1;"
+  "}, 1000);"
+  "</script>"
+  "<br>"
+  "<br>"
+  
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+// Upload Complete page Template
+// This web page is shown when the uploaded strings file completes success-
+// fully.
+static const char g_HtmlPageUploadComplete[] =
+  "%y04%y05"
+  "<title>Upload Complete</title>"
+  "</head>"
+  "<body>"
+  "<h1>Upload Complete</h1>"
+  "<p>"
+  "Click Continue.<br><br>"
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+// Parse Fail page Template
+// This web page is shown when uploaded code had a parsing failure. It is
+// also shown when a /73 reinstall is refused (during a /74 erase, or if the
+// EEPROM0 image fails its CRC32 check).
+static const char g_HtmlPageParseFail[] =
+  "%y04%y05"
+  "<title>Upload Parse Fail</title>"
+  "</head>"
+  "<body>"
+  "<h1>Upload Parse Fail</h1>"
+  "<p>"
+  "Parsing of the uploaded file failed.<br>"
+  "Retry the upload. Make sure you selected the correct file.<br>"
+  "Fault reason code:<br>"
+  "%s02"
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+// Erase EEPROM page Template
+// This web page is shown by the /74 command. The erase runs in the
+// background (see eeprom_erase_service()) and the page polls the /76
+// Erase Status response to show progress.
+static const char g_HtmlPageErase[] =
+  "%y04%y05"
+  "<title>Erasing EEPROM</title>"
+  "</head>"
+  "<body>"
+  "<h1>Erasing Off-Board EEPROM</h1>"
+  "<p>"
+  "<progress value='0' max='1024' id='bar'></progress><br><br>"
+  "<span id='msg'>Erasing</span><br><br>"
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "<script>"
+  "function poll(){"
+    "fetch('/76').then(r=>r.text()).then(t=>{"
+      "if(t=='FAIL'){document.getElementById('msg').innerText='Erase failed';return;}"
+      "if(t=='BUSY'){document.getElementById('msg').innerText='Not erased, an upload is in progress';return;}"
+      "document.getElementById('bar').value=t;"
+      "if(t<1024)setTimeout(poll,500);"
+      "else document.getElementById('msg').innerText='Erase complete';"
+    "}).catch(()=>setTimeout(poll,1000));"
+  "}"
+  "poll();"
+  "</script>"
+  "</body>"
+  "</html>";
+
+
+// Erase Status Template
+// Only responds with a TCP payload that contains the 4 character erase
+// status: the number of 128 byte blocks erased so far (0000 to 1024), FAIL
+// if the EEPROM stopped responding, or BUSY if the erase was refused
+// because a firmware upload was in progress. The response is not browser
+// compatible.
+static const char g_HtmlPageEraseStatus[] =
+  "%s03";
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if OB_EEPROM_SUPPORT == 1
+// EEPROM Missing webpage
+// This web page is shown when the EEPROM has gone missing unexpectedly.
+// This should never happen, but may occur is there is a faulty connection.
+static const char g_HtmlPageEEPROMMissing[] =
+  "%y04%y05"
+  "<title>EEPROM Missing</title>"
+  "</head>"
+  "<body>"
+  "<h1>EEPROM Missing</h1>"
+  "<p>"
+  "EEPROM device may be defective or wiring may be loose.<br>"
+  "</p>"
+  "<button onclick='location=`/`'>Continue</button>"
+  "</body>"
+  "</html>";
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+// Event Stream
+// There is no template for the Event Stream. The /80 command sends a
+// "text/event-stream" header with no Content-Length, then the connection is
+// held open and short records are generated directly into the uip_buf each
+// time the connection is polled and something has changed. Everything a
+// record contains is captured when it is first sent so that a retransmit
+// can re-create it exactly:
+//   "data:" + 16 pin state characters (same format as the /98 command,
+//   Pin 16 first and Pin 1 last)
+//   If DS18B20 is enabled: " " + 5 x 4 hex characters containing the raw
+//   DS18B20 readings (1/16 degree C units, twos complement)
+//   "\n\n"
+// A heartbeat record ":\n\n" (an SSE comment, ignored by the Browser) is
+// sent if no record has been sent for EVENT_STREAM_HEARTBEAT seconds.
+#define EVENT_STREAM_COALESCE	2   // Minimum 100ms ticks between records.
+                                    // Changes within this window are merged
+				    // into one record.
+#define EVENT_STREAM_HEARTBEAT	15  // Seconds between heartbeat records
+
+static uint16_t CopyEventHeader(uint8_t* pBuffer);
+static void event_capture(struct tHttpD* pSocket, uint16_t pin_states);
+static uint16_t CopyEventRecord(uint8_t* pBuffer, struct tHttpD* pSocket);
+static void event_stream_poll(struct tHttpD* pSocket);
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+
+
+//---------------------------------------------------------------------------//
+// The following creates an array of strings that are commonly used strings
+// in the HTML pages. To reduce the size of the HTML pages these common
+// strings are replaced with placeholders of the form "%yxx", then when the
+// HTML page is copied to the trasnmit buffer the placeholders are replaced
+// with one of the strings in this array. The length of each string is
+// manually counted and put in the associated _len value. When the _len value 
+// is needed it often has 4 subtracted (as the strings are replacing the 4
+// character placeholder), so that subtraction is done once here.
+
+// The following creates an array of 6 strings of variable length
+
+// String for %y00 replacement in web page templates
+#define s0 "" \
+  "placeholder"
+
+// String for %y01 replacement in web page templates
+#define s1 "" \
+  "</script>" \
+  "</table>" \
+  "<p/>" \
+  "<button type=submit>Save</button> <button type=reset onclick='m.l()'>Undo All</button>" \
+  "</form>"
+
+// String for %y02 replacement in web page templates
+#define s2 "" \
+  "<button title='Save first!' onclick='location="
+
+// String for %y03 replacement in web page templates
+#define s3 "" \
+"placeholder"
+
+// String for %y04 replacement in web page templates
+#define s4  "" \
+  "<html>"\
+  "<head>" \
+  "<link rel='icon' href='data:,'>" \
+  "<meta name='viewport' content='width=device-width'>" \
+  "<style>" \
+  ".s0{background:red;}" \
+  ".s1{background:green;}"
+
+// String for %y05 replacement in web page templates
+#define s5 "" \
+  "table{border-spacing:8px2px}" \
+  ".t1{width:100px;}" \
+  ".t2{width:450px;}" \
+  ".t3{width:30px;}" \
+  ".t8{width:60px;}" \
+  ".c{text-align:center;}" \
+  ".ip input{width:27px;}" \
+  ".mac input{width:14px;}" \
+  ".s div{width:13px;height:13px;display:inline-block;}" \
+  ".hs{height:9px;}" \
+  "</style>"
+
+// The following creates an array of string lengths corresponding to
+// the strings in the #define statements above
+// AND
+// Creates an array of string lengths (less 4) corresponding to the
+// strings above
+struct page_string {
+    const char * str;
+    uint8_t size;
+    uint8_t size_less4;
+};
+
+const struct page_string ps[6] = {
+    { s0, sizeof(s0)-1, sizeof(s0)-5 },
+    { s1, sizeof(s1)-1, sizeof(s1)-5 },
+    { s2, sizeof(s2)-1, sizeof(s2)-5 },
+    { s3, sizeof(s3)-1, sizeof(s3)-5 },
+    { s4, sizeof(s4)-1, sizeof(s4)-5 },
+    { s5, sizeof(s5)-1, sizeof(s5)-5 }
+};
+
+// Access the above strings, string length, and (string length - 4) as
+// follows:
+// ps[i].str
+// ps[i].size
+// ps[i].size_less4
+
+
+//---------------------------------------------------------------------------//
+// The following compile time pre-processor statements test the string
+// lengths to make sure they are within valid limits. All string lengths
+// must be less than 256.
+#if (sizeof(s0) > 255)
+  #error "string s0 is too big"
+#endif
+
+#if (sizeof(s1) > 255)
+  #error "string s1 is too big"
+#endif
+
+#if (sizeof(s2) > 255)
+  #error "string s2 is too big"
+#endif
+
+#if (sizeof(s3) > 255)
+  #error "string s3 is too big"
+#endif
+
+#if (sizeof(s4) > 255)
+  #error "string s4 is too big"
+#endif
+
+#if (sizeof(s5) > 255)
+  #error "string s5 is too big"
+#endif
+
+
+#if OB_EEPROM_SUPPORT == 1
+static void read_string_directory(uint16_t byte_address, uint16_t *value)
+{
+  // Read two adjacent big endian uint16_t values of the String File
+  // directory at byte_address into value[0] and value[1].
+  uint8_t temp[4];
+  
+  I2C_read_block(I2C_EEPROM2_WRITE, byte_address, temp, 4);
+  value[0] = (uint16_t)((temp[0] << 8) | temp[1]);
+  value[1] = (uint16_t)((temp[2] << 8) | temp[3]);
+}
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+void HttpDStringInit() {
+  // Initialize HttpD string sizes
+#if OB_EEPROM_SUPPORT == 1
+  uint16_t value[2];
+#endif // OB_EEPROM_SUPPORT == 1
+  
+#if OB_EEPROM_SUPPORT == 0
+  HtmlPageIOControl_size = (uint16_t)(sizeof(g_HtmlPageIOControl) - 1);
+  HtmlPageConfiguration_size = (uint16_t)(sizeof(g_HtmlPageConfiguration) - 1);
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if OB_EEPROM_SUPPORT == 1
+  // The String File directory (the template addresses and sizes) is read
+  // from the Off-Board EEPROM once, here at boot, and kept in RAM. Page
+  // requests then only read the template content itself. The directory
+  // cannot change while the runtime firmware is running: a String File can
+  // only be uploaded with the Code Uploader, which reboots into the runtime
+  // firmware when done, and that reboot reloads the directory.
+  //
+  // The two template addresses are adjacent in the EEPROM, as are the two
+  // template sizes, so each pair is read with one block read.
+#if BUILD_SUPPORT == MQTT_BUILD
+  read_string_directory(MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION, value);
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  read_string_directory(BROWSER_ONLY_WEBPAGE_IOCONTROL_ADDRESS_LOCATION, value);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+  // The String File is built with SREC addresses starting at 0x8000 (see
+  // init_off_board_string_pointers()).
+  HtmlPageIOControl_index = (uint16_t)(value[0] - 0x8000);
+  HtmlPageConfiguration_index = (uint16_t)(value[1] - 0x8000);
+
+#if BUILD_SUPPORT == MQTT_BUILD
+  read_string_directory(MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION, value);
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  read_string_directory(BROWSER_ONLY_WEBPAGE_IOCONTROL_SIZE_LOCATION, value);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+  HtmlPageIOControl_size = value[0];
+  HtmlPageConfiguration_size = value[1];
+#endif // OB_EEPROM_SUPPORT == 1
+}
+
+
+void init_off_board_string_pointers(struct tHttpD* pSocket) {
+  // Initialize the index into the Off-Board EEPROM Strings region.
+  //
+  // In order to allow a String File to be read using the same code used for
+  // reading Program Files the code expects the Strings file to have SREC
+  // addresses starting at 0x8000, however in the EEPROM itself the base
+  // address for Strings is 0x0000. This initialization will compensate for
+  // that disparity.
+
+#if OB_EEPROM_SUPPORT == 1
+  // The template addresses were read from the Off-Board EEPROM (with the
+  // above compensation applied) by HttpDStringInit().
+  if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
+    off_board_eeprom_index = HtmlPageIOControl_index;
+  }
+      
+  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    off_board_eeprom_index = HtmlPageConfiguration_index;
+  }
+#endif // OB_EEPROM_SUPPORT == 1
+}
+
+
+void httpd_diagnostic(void) {
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+#if OB_EEPROM_SUPPORT == 1
+  // Read and display the 8 bytes with address info for the web pages
+  {
+    int i;
+    uint8_t temp[8];
+    I2C_read_block(I2C_EEPROM2_WRITE, MQTT_WEBPAGE_IOCONTROL_ADDRESS_LOCATION, temp, 8);
+    UARTPrintf("Webpage Address Bytes: ");
+    for (i = 0; i < 8; i++) {
+      emb_itoa(temp[i], OctetArray, 16, 2);
+      UARTPrintf(OctetArray);
+      UARTPrintf(" ");
+    }
+  UARTPrintf("\r\n");
+  }
+  
+  // Read and display the 8 bytes with size info for the web pages
+  {
+    int i;
+    uint8_t temp[8];
+    I2C_read_block(I2C_EEPROM2_WRITE, MQTT_WEBPAGE_IOCONTROL_SIZE_LOCATION, temp, 8);
+    UARTPrintf("Webpage Size Bytes: ");
+    for (i = 0; i < 8; i++) {
+      emb_itoa(temp[i], OctetArray, 16, 2);
+      UARTPrintf(OctetArray);
+      UARTPrintf(" ");
+    }
+  UARTPrintf("\r\n");
+  }
+
+  UARTPrintf("IOControl Page Size: ");
+  emb_itoa(HtmlPageIOControl_size, OctetArray, 16, 4);
+  UARTPrintf(OctetArray);
+  UARTPrintf("\r\n");
+
+
+  UARTPrintf("Configuration Page Size: ");
+  emb_itoa(HtmlPageConfiguration_size, OctetArray, 16, 4);
+  UARTPrintf(OctetArray);
+  UARTPrintf("\r\n");
+#endif // OB_EEPROM_SUPPORT == 1
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+}
+
+
+uint16_t adjust_template_size(struct tHttpD* pSocket)
+{
+  uint16_t size;
+  // declare and pre-calculate repeatedly used values
+  int strlen_devicename_adjusted = (strlen(stored_devicename) - 4);
+  
+  // This function calculates the size of the HTML page that will be
+  // transmitted based on the size of the web page template plus adjustments
+  // needed to account for text strings that replace markers in the web page
+  // template.
+  // 
+  // Note to self: This code is crap from the perspective of readability and
+  // being error prone. Walking through the web page templates to verify that
+  // this code properly adjusts the reported web page size is tedious,
+  // particularly when it comes to the #if inclusions/exclusions. Need to
+  // work on a better methodology.
+  //
+  // Most of the size calculations end up being constants, so a lot of this
+  // function is comments explaining where the constants come from, then
+  // simply adding the result to the template size.
+  
+  size = 0;
+
+
+  //-------------------------------------------------------------------------//
+  // A no-function check for current_webpage that allows the various options
+  // to compile as "else if" statements.
+  //-------------------------------------------------------------------------//
+  if (pSocket->current_webpage == WEBPAGE_NULL) { }
+
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_IOCONTROL template
+  //-------------------------------------------------------------------------//
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  else if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
+    size = HtmlPageIOControl_size;
+
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+
+    // Account for Device Name field %a00 in <title> and in body
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+    size = size + (2 * strlen_devicename_adjusted);
+
+    // Account for pin control field %h00
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances x (32 - 4));
+    // size = size + (1 x 28);
+    size = size + 28;
+ 
+    // Account for Temperature Sensor insertion %t00 to %t04
+    // Each of these insertions can have a different length due to the
+    // text around them. If DS18B20 is NOT enabled we only need to
+    // subtract the size of the 5 placeholders.
+    //
+    if (stored_config_settings & 0x08) {
+      //  %t00 "<p>Temperature Sensors<br> xxxxxxxxxxxx "
+      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
+      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
+      //    40 bytes of text plus 27 bytes of data = 59
+      //    size = size + 67 - 4
+      size = size + 63;
+      //
+      //  %t01 "<br> xxxxxxxxxxxx " 
+      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
+      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
+      //    18 bytes of text plus 27 bytes of data = 37
+      //    size = size + 45 - 4
+      size = size + 41;
+      //
+      //  %t02 "<br> xxxxxxxxxxxx "
+      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
+      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
+      //    18 bytes of text plus 27 bytes of data = 37
+      //    size = size + 45 - 4
+      size = size + 41;
+      //
+      //  %t03 "<br> xxxxxxxxxxxx "
+      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
+      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
+      //    18 bytes of text plus 27 bytes of data = 37
+      //    size = size + 45 - 4
+      size = size + 41;
+      //
+      //  %t04 "<br> xxxxxxxxxxxx "
+      //      plus 13 bytes of data and degC characters (-000.0&#8451;)
+      //      plus 14 bytes of data and degF characters ( -000.0&#8457;)
+      //      plus "<br></p>"
+      //    18 bytes of text plus 27 bytes of data = 45
+      //    plus 8 bytes of text = 53
+      //    size = size + 53 - 4
+      size = size + 49;
+    }
+    else {
+      // Subtract the size of the placeholders as they won't be used
+      // size = size - (5 x 4)
+      size = size - 20;
+    }
+    
+    // Account for Text Replacement insertion
+    // Some strings appear frequently in the templates - things like the
+    // button titles which appear when hovering over a button. These strings
+    // are inserted on the fly when the web page is sent to the browser, so
+    // they have to be accounted for in the size of the web page.
+    
+    // String for %y01 in web page template
+    // There 1 instance (Save and Undo All buttons)
+    // size = size + (#instances) x (ps[1].size - marker_field_size);
+    // size = size + ps[1].size_less4;
+    size = size + ps[1].size_less4;
+
+    // String for %y02 in web page template
+    // There 2 instances (Refresh and Configuration buttons)
+    // size = size + (#instances) x (ps[2].size - marker_field_size);
+    // size = size + (2 x ps[2].size_less4);
+    size = size + (2 * ps[2].size_less4);
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    // Account for IO Name fields %j00 to %j15
+    // Each can be variable in size during run time so we have to calculate
+    // them  each time we display the web page.
+    {
+      int i;
+      for (i=0; i<16; i++) {
+        size = size + (strlen(IO_NAME[i]) - 4);
+      }
+    }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_CONFIGURATION template
+  //-------------------------------------------------------------------------//
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  else if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    size = HtmlPageConfiguration_size;
+
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+
+    // Account for Device Name field %a00 in <title> and in body
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the /web page.
+    size = size + (2 * strlen_devicename_adjusted);
+
+    // Account for HTML IP Address, Gateway Address, and
+    // Netmask fields %b00, %b04, %b08
+    // There are 3 instances of these fields
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (3 x (8 - 4));
+    // size = size + (3 x (4));
+    size = size + 12;
+
+    // Account for HTML Port field %c00
+    // There is 1 instance
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (1 x (5 - 4));
+    // size = size + (1 x (1));
+    // size = size + 1;
+    size = size + 1;
+
+    // Account for MAC field %d00
+    // There is 1 instance of this field
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (1 x (12 - 4));
+    // size = size + (1 x (8));
+    size = size + 8;
+
+    // Account for Config string %g00
+    // There is 1 instance
+    // value_size is 2 (2 characters)
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances x (2 - 4));
+    // size = size + (1 x (-2));
+    size = size - 2;
+
+    // Account for Code Revision + Code Type insertion %w00
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances x (26 - 4));
+    // size = size + (1 x 22);
+    size = size + 22;
+
+    // Account for pin control field %h00
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances x (32 - 4));
+    // size = size + (1 x 28);
+    size = size + 28;
+
+    // Account for Text Replacement insertion
+    // Some strings appear frequently in the templates - things like the
+    // button titles which appear when hovering over a button. These strings
+    // are inserted on the fly when the web page is sent to the browser, so
+    // they have to be accounted for in the size of the web page.
+    
+    // String for %y01 in web page template
+    // There 1 instance (Save and Undo All buttons)
+    // size = size + (#instances) x (ps[1].size - marker_field_size);
+    // size = size + ps[1].size_less4;
+    size = size + ps[1].size_less4;
+
+    // String for %y02 in web page templates
+    // There are 2 instances (Refresh and IO Control buttons)
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances) x (ps[2].size - 4);
+    // size = size + (2) x ps[2].size_less4;
+    size = size + (2 * ps[2].size_less4);
+    
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    // Account for IO Name fields %j00 to %j15
+    // Each can be variable in size during run time so we have to calculate
+    // them  each time we display the web page.
+    {
+      int i;
+      for (i=0; i<16; i++) {
+        size = size + (strlen(IO_NAME[i]) - 4);
+      }
+    }
+
+    // Account for IO Timer field %i00 to %i15
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances x (4 - 4));
+    // size = size + (16 x 0);
+    // size = size + 0;
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+ 
+#if BUILD_SUPPORT == MQTT_BUILD
+    // Account for MQTT IP Address field %b12
+    // There is 1 instance
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (1 x (8 - 4));
+    // size = size + (1 x (4));
+    size = size + 4;
+    
+    // Account for MQTT Port field %c01
+    // There is 1 instance
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (1 x (5 - 4));
+    // size = size + (1 x (1));
+    // size = size + 1;
+    size = size + 1;
+
+    // Account for Username field %l00
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+    size = size + (strlen(stored_mqtt_username) - 4);
+
+    // Account for Password field %m00
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+    size = size + (strlen(stored_mqtt_password) - 4);
+    
+    // Account for red/green State Progress boxes %n00, %n01, %n02, %n03, %n04 
+    // There are always 5 boxes, one for each State progress indicator
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (#instances x (1 - 4));
+    // size = size + (5 x (-3));
+    size = size - 15;
+#endif // BUILD_SUPPORT == MQTT_BUILD
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_STATS1 template
+  //-------------------------------------------------------------------------//
+#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  else if (pSocket->current_webpage == WEBPAGE_STATS1) {
+    size = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
+
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+
+    // Account for Device Name field %a00 in <title>
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+    size = size + strlen_devicename_adjusted;
+    
+    // Account for Statistics fields %e00 to %e21
+    // There are 22 instances of these fields
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (22 x (10 - 4));
+    // size = size + (22 x (6));
+    size = size + 132;
+  }
+#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_STATS2 template
+  //-------------------------------------------------------------------------//
+#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
+  else if (pSocket->current_webpage == WEBPAGE_STATS2) {
+    size = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
+
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+
+    // Account for Device Name field %a00 in <title>
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+    size = size + strlen_devicename_adjusted;
+
+    // Account for Statistics fields %e31, %e32, %e33, %e35
+    // There are 4 instances of these fields
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (4 x (10 - 4));
+    // size = size + (4 x (6));
+    size = size + 24;
+
+#if FAIR_SCHEDULER_SUPPORT == 1
+    // Account for the scheduler statistics field %e36
+    // There is 1 instance with 10 characters per connection
+    // size = size + (#instances x (value_size - marker_field_size));
+    // size = size + (1 x ((UIP_CONNS x 10) - 4));
+    size = size + (UIP_CONNS * 10) - 4;
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  }
+#endif // DEBUG_SUPPORT
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the DEBUG_SENSOR_SERIAL template
+  //-------------------------------------------------------------------------//
+#if DEBUG_SENSOR_SERIAL == 1
+  else if (pSocket->current_webpage == WEBPAGE_SENSOR_SERIAL) {
+    size = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
+
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+
+    // Account for Device Name field %a00 in <title>
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+    size = size + strlen_devicename_adjusted;
+  }
+#endif // DEBUG_SENSOR_SERIAL
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_SSTATE template
+  //-------------------------------------------------------------------------//
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  else if (pSocket->current_webpage == WEBPAGE_SSTATE) {
+    size = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+//    size = size + ps[4].size_less4
+//                + ps[5].size_less4;
+
+    // Account for Device Name field %a00 in <title>
+    // This can be variable in size during run time so we have to calculate it
+    // each time we display the web page.
+//    size = size + strlen_devicename_adjusted;
+
+    // Account for Short Form IO Settings field (%f00)
+    // size = size + (value size - marker_field_size)
+    // size = size + (16 - 4);
+    size = size + 12;
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+
+#if OB_EEPROM_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_LOADUPLOADER template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_LOADUPLOADER) {
+    size = (uint16_t)(sizeof(g_HtmlPageLoadUploader) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+  }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_UPLOADER template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_UPLOADER) {
+    size = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
+
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+  }
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_EXISTING_IMAGE template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_EXISTING_IMAGE) {
+    size = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+  }
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_TIMER template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_TIMER) {
+    size = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+  }
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_UPLOAD_COMPLETE template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_UPLOAD_COMPLETE) {
+    size = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+  }
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_PARSEFAIL template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_PARSEFAIL) {
+    size = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+    
+    // Account for EEPROM status string %s02
+    // size = size + (value size - marker_field_size)
+    // size = size + (40 - 4);
+    size = size + 36;
+  }
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_ERASE template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_ERASE) {
+    size = (uint16_t)(sizeof(g_HtmlPageErase) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;
+  }
+
+
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_ERASE_STATUS template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_ERASE_STATUS) {
+    // The %s03 erase status is 4 characters, the same size as the marker
+    size = (uint16_t)(sizeof(g_HtmlPageEraseStatus) - 1);
+  }
+
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if OB_EEPROM_SUPPORT == 1
+  //-------------------------------------------------------------------------//
+  // Adjust the size reported by the WEBPAGE_EEPROM_MISSING template
+  //-------------------------------------------------------------------------//
+  else if (pSocket->current_webpage == WEBPAGE_EEPROM_MISSING) {
+    size = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
+    
+    // Account for header replacement strings %y04 %y05
+    size = size + ps[4].size_less4
+                + ps[5].size_less4;    
+  }
+#endif // OB_EEPROM_SUPPORT == 1
+  return size;
+}
+
+
+// Tables used by emb_itoa() and int2nibble() for division free conversion
+static const char hex_digit[] = "0123456789abcdef";
+static const uint8_t pow10_8[3] = { 1, 10, 100 };
+static const uint16_t pow10_16[5] = { 1, 10, 100, 1000, 10000 };
+static const uint32_t pow10_32[10] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+
+void emb_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad)
+{
+  // Implementation of itoa() specific to this application
+  // num  - The value to be converted
+  // str  - Pointer to the storage location for the converted value
+  // base - The base to be used in the output string
+  // pad  - size of the string result, pre-pad with zeroes if needed
+  //
+  // The resulting string in str will be NULL terminated on completion.
+  // No checking is done so make sure str has enough room for the
+  // converted value and the terminator. A value wider than "pad" digits
+  // keeps only its low "pad" digits, in every base.
+  //
+  // Positive numbers ONLY,
+  //   Up to 10 digits (32 bits),
+  //   Includes leading 0 pad,
+  //   Converts base 2 (binary), 8 (nibbles), 10 (decimal), 16 (hex)
+  //     base 2 example
+  //       emb_itoa(number, OctetArray, 2, 8);
+  //       where number is a uint8_t containing the value 0xac
+  //       output string in OctetArray is 10101100
+  //     base 8 example
+  //       emb_itoa(number, OctetArray, 2, 4);
+  //       where number is a uint8_t containing the value 0xac
+  //       output string in OctetArray is 0254
+  //     base 10 example
+  //       emb_itoa(number, OctetArray, 2, 5);
+  //       where number is a uint8_t containing the value 0xac
+  //       output string in OctetArray is 00172
+  //     base 16 example
+  //       emb_itoa(number, OctetArray, 2, 8);
+  //       where number is a uint32_t containing the value 0xc0a80004
+  //       output string in OctetArray is c0a80004
+  //
+  // The STM8 has no hardware support for 32 bit division, so the original
+  // "num % base" and "num / base" loop called the compiler's long division
+  // library routine twice per digit. This is significant as emb_itoa() is
+  // called for nearly every dynamic insertion in the web pages (the 22
+  // uip_stat counters at 10 digits each, for instance) and for MQTT topics.
+  // The conversion is now division free:
+  // - Bases 2, 8, and 16 are powers of two, so each digit is a mask and a
+  //   shift, using a nibble table for the digit character.
+  // - Base 10 digits are found by counting how many times each power of ten
+  //   can be subtracted from the value, starting with the most significant
+  //   digit. At most 9 subtractions are needed per digit. Values that fit
+  //   in 8 or 16 bits (the common case: IP octets, pin numbers, ports,
+  //   temperatures) use 8 or 16 bit arithmetic, which the STM8 does natively.
+  // Output is identical to the original implementation for values that fit
+  // in "pad" digits. For wider values the original wrote past the end of
+  // str.
+
+  int i;
+  uint8_t digit;
+  uint8_t pos;
+
+  str[pad] = '\0';
+
+  if (base != 10) {
+    // Base 2, 8, or 16. Fill from the least significant digit.
+    uint8_t shift;
+    uint8_t mask;
+    shift = 4;
+    if (base == 8) shift = 3;
+    if (base == 2) shift = 1;
+    mask = (uint8_t)(base - 1);
+    for (i = pad - 1; i >= 0; i--) {
+      str[i] = hex_digit[(uint8_t)num & mask];
+      num >>= shift;
+    }
+    return;
+  }
+
+  // Base 10. Drop any digits above "pad" by subtracting the higher powers
+  // of ten, so that no digit below counts past 9.
+  if (pad < 10 && num >= pow10_32[pad]) {
+    pos = 10;
+    while (pos > pad) {
+      pos--;
+      while (num >= pow10_32[pos]) num -= pow10_32[pos];
+    }
+  }
+
+  // Fill from the most significant digit. "pos" is the power of ten for the
+  // digit being filled. Positions beyond the range of the value being
+  // converted are always '0'.
+  pos = pad;
+  i = 0;
+  if (num < 0x100) {
+    uint8_t num8;
+    num8 = (uint8_t)num;
+    while (pos--) {
+      digit = '0';
+      if (pos < 3) {
+        while (num8 >= pow10_8[pos]) {
+          num8 -= pow10_8[pos];
+          digit++;
+        }
+      }
+      str[i++] = digit;
+    }
+  }
+  else if (num < 0x10000) {
+    uint16_t num16;
+    num16 = (uint16_t)num;
+    while (pos--) {
+      digit = '0';
+      if (pos < 5) {
+        while (num16 >= pow10_16[pos]) {
+          num16 -= pow10_16[pos];
+          digit++;
+        }
+      }
+      str[i++] = digit;
+    }
+  }
+  else {
+    while (pos--) {
+      digit = '0';
+      if (pos < 10) {
+        while (num >= pow10_32[pos]) {
+          num -= pow10_32[pos];
+          digit++;
+        }
+      }
+      str[i++] = digit;
+    }
+  }
+}
+
+
+int hex2int(char ch)
+{
+  // Convert a single hex character to an integer (a nibble)
+  // If the character is not hex -1 is returned
+  if (ch >= '0' && ch <= '9') return ch - '0';
+  if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+  return -1;
+}
+
+
+uint8_t two_hex2int(char chmsb, char chlsb)
+{
+  uint8_t temp;
+  // Convert two hex characters to an integer (an unsigned byte)
+  temp = (uint8_t)hex2int(chmsb);
+  temp = (uint8_t)(temp<<4);
+  temp = (uint8_t)(temp | hex2int(chlsb));
+  return temp;
+}
+
+
+void int2hex(uint8_t i)
+{
+  uint8_t j;
+  // Convert a single integer into two hex characters (two nibbles).
+  // Put the result in global variable OctetArray.
+  j = (uint8_t)(i>>4);
+  OctetArray[0] = int2nibble(j);
+  
+  j = (uint8_t)(i & 0x0f);
+  OctetArray[1] = int2nibble(j);
+  
+  OctetArray[2] = '\0';
+}
+
+
+uint8_t int2nibble(uint8_t j)
+{
+  // Convert a 4 bit integer to a character (a single nibble).
+  return (uint8_t)hex_digit[j & 0x0f];
+}
+
+
+#if OB_EEPROM_SUPPORT == 1
+// CRC32 lookup table for one nibble. A full 256 entry table would cost 1KB
+// of Flash, while processing bit by bit costs 8 long shifts per byte. The
+// nibble table is a 64 byte compromise that runs about 3x faster than the
+// bitwise loop, which matters because the boot image check may CRC the
+// entire 32KB Flash image.
+static const uint32_t crc32_nibble[16] = {
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+  0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+  0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C };
+
+uint32_t crc32_update(uint32_t crc, uint8_t data)
+{
+  // Add one byte to a CRC32 (the IEEE 802.3 / zip CRC, reflected polynomial
+  // 0xEDB88320). Start with crc = 0xffffffff and invert the result after the
+  // last byte.
+  crc ^= data;
+  crc = (crc >> 4) ^ crc32_nibble[(uint8_t)crc & 0x0f];
+  crc = (crc >> 4) ^ crc32_nibble[(uint8_t)crc & 0x0f];
+  return crc;
+}
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen)
+{
+  uint16_t nBytes;
+  int i;
+  
+  static const char http_string1[] = 
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length:";
+  static const char http_string2[] = 
+    "\r\n"
+    "Cache-Control: no-cache, no-store\r\n"
+    "Content-Type: text/html; charset=utf-8\r\n"
+    "Connection:close\r\n\r\n";
+
+  nBytes = 0;
+
+  pBuffer = stpcpy(pBuffer, http_string1);
+  nBytes += strlen(http_string1);
+
+  // This creates the "xxxxx" part of a 5 character "Content-Length:xxxxx" field in the pBuffer.
+  emb_itoa(nDataLen, OctetArray, 10, 5);
+  pBuffer = stpcpy(pBuffer, OctetArray);
+  nBytes += 5;
+
+  pBuffer = stpcpy(pBuffer, http_string2);
+  nBytes += strlen(http_string2);
+  
+  return nBytes;
+}
+
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+static uint16_t CopyEventHeader(uint8_t* pBuffer)
+{
+  // Header for the Event Stream. There is no Content-Length as the stream
+  // continues until the Browser closes the connection.
+  static const char http_string[] = 
+    "HTTP/1.1 200 OK\r\n"
+    "Cache-Control: no-cache, no-store\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Connection:keep-alive\r\n\r\n";
+
+  stpcpy(pBuffer, http_string);
+  return (uint16_t)(sizeof(http_string) - 1);
+}
+
+
+uint16_t event_pin_states(void)
+{
+  // Collect the pin states in the same form displayed by the /98 command.
+  // Output pins report the pin_control ON/OFF bit. Input pins report the
+  // pin_control ON/OFF bit inverted if the Invert bit is set.
+  // Bit 15 is Pin 16, bit 0 is Pin 1.
+  uint16_t pin_states;
+  int i;
+  
+  pin_states = 0;
+  for (i=15; i>=0; i--) {
+    pin_states <<= 1;
+    if (pin_control[i] & 0x80) pin_states |= 1;
+    if ((pin_control[i] & 0x06) == 0x04) pin_states ^= 1; // Inverted input
+  }
+  return pin_states;
+}
+
+
+static void event_capture(struct tHttpD* pSocket, uint16_t pin_states)
+{
+  // Capture everything a new Event Stream data record depends on: the pin
+  // states, whether DS18B20 is enabled, and the raw readings for all 5
+  // temperature sensors. CopyEventRecord() builds the record only from the
+  // captured values so that a retransmit re-creates the same bytes even if
+  // the readings have been updated since.
+  uint8_t *temps;
+  int i;
+  
+  pSocket->nParseLeft = pin_states;
+  pSocket->nNewlines = (uint8_t)(stored_config_settings & 0x08);
+  temps = event_temps[pSocket->structID];
+  for (i=0; i<5; i++) {
+    *temps++ = DS18B20_scratch[i][1];
+    *temps++ = DS18B20_scratch[i][0];
+  }
+}
+
+
+static uint16_t CopyEventRecord(uint8_t* pBuffer, struct tHttpD* pSocket)
+{
+  // Create an Event Stream data record in the pBuffer from the values
+  // captured by event_capture(). The record contains the pin states and, if
+  // DS18B20 is enabled, the raw readings for all 5 temperature sensors.
+  uint8_t* pBuffer_start;
+  uint8_t *temps;
+  uint16_t mask;
+  int i;
+  
+  pBuffer_start = pBuffer;
+  pBuffer = stpcpy(pBuffer, "data:");
+  for (mask = 0x8000; mask != 0; mask >>= 1) {
+    if (pSocket->nParseLeft & mask) *pBuffer++ = '1';
+    else *pBuffer++ = '0';
+  }
+  
+  if (pSocket->nNewlines) {
+    *pBuffer++ = ' ';
+    temps = event_temps[pSocket->structID];
+    for (i=0; i<10; i++) {
+      *pBuffer++ = int2nibble((uint8_t)(*temps >> 4));
+      *pBuffer++ = int2nibble((uint8_t)(*temps & 0x0f));
+      temps++;
+    }
+  }
+  *pBuffer++ = '\n';
+  *pBuffer++ = '\n';
+  
+  return (uint16_t)(pBuffer - pBuffer_start);
+}
+
+
+static void event_stream_poll(struct tHttpD* pSocket)
+{
+  // Called when an open Event Stream connection is polled (and has no
+  // unacknowledged data). While the stream is open the tHttpD fields that
+  // are not otherwise used are repurposed as follows:
+  //   nParseLeft - pin states reported in the last data record
+  //   nNewlines  - DS18B20 enabled flag for the last data record
+  //   ParseNum   - event_temperature_seq reported in the last data record
+  //   ParseCmd   - t100ms_ctr1 (low byte) when the last data record was sent
+  //   nDataLeft  - second_counter (low 16 bits) when the last record of any
+  //                kind was sent
+  //   nPrevBytes - type of the last record sent (for retransmit)
+  //                0xFFFF = header, 0 = heartbeat, 1 = data
+  uint16_t pin_states;
+  
+  pin_states = event_pin_states();
+  
+  if ((pin_states != pSocket->nParseLeft || event_temperature_seq != pSocket->ParseNum)
+   && (uint8_t)((uint8_t)t100ms_ctr1 - pSocket->ParseCmd) >= EVENT_STREAM_COALESCE) {
+    // Something changed and the coalescing window has passed. Any other
+    // changes that occurred within the window are reported in this same
+    // record as it always contains the present state of all pins.
+    event_capture(pSocket, pin_states);
+    pSocket->ParseNum = event_temperature_seq;
+    pSocket->ParseCmd = (uint8_t)t100ms_ctr1;
+    pSocket->nDataLeft = (uint16_t)second_counter;
+    pSocket->nPrevBytes = 1;
+    uip_send(uip_appdata, CopyEventRecord(uip_appdata, pSocket));
+  }
+  else if ((uint16_t)((uint16_t)second_counter - pSocket->nDataLeft) >= EVENT_STREAM_HEARTBEAT) {
+    // Nothing has been sent for a while. Send a heartbeat. If the Browser
+    // went away without closing the connection the heartbeat will not be
+    // acknowledged and uip will eventually time out the connection.
+    pSocket->nDataLeft = (uint16_t)second_counter;
+    pSocket->nPrevBytes = 0;
+    uip_send(uip_appdata, stpcpy(uip_appdata, ":\n\n") - (char *)uip_appdata);
+  }
+}
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+static uint16_t render_cache_start(struct tHttpD* pSocket)
+{
+  // Called when an IOControl page is about to be sent. Returns the page
+  // size for the HTTP header.
+  // If the cache holds the page rendered with the current
+  // render_cache_version the connection is switched to STATE_SENDCACHE and
+  // the page is sent from the ENC28J60 buffer memory. The page size is kept
+  // in nParseLeft, so a retransmitted header reports the size that was
+  // first sent even if the cache has been refilled since.
+  // Otherwise the page is rendered from the template as usual and this
+  // connection becomes the cache filler. The last connection to start
+  // rendering always takes over the fill, so a connection that is closed or
+  // aborted mid-page can never block the cache.
+  uint16_t size;
+
+  if (render_cache_valid && render_cache_tag == render_cache_version) {
+    pSocket->nDataLeft = render_cache_size;
+    pSocket->nParseLeft = render_cache_size;
+    pSocket->ParseNum = render_cache_epoch;
+    pSocket->nState = STATE_SENDCACHE;
+    return render_cache_size;
+  }
+
+  size = adjust_template_size(pSocket);
+  if (size <= RENDER_CACHE_MAX) {
+    // Invalidate the old contents. Any connection still reading the old
+    // contents will see the epoch change and abort.
+    render_cache_valid = 0;
+    render_cache_epoch++;
+    render_cache_filler = pSocket;
+    render_cache_fill_ofs = 0;
+    render_cache_fill_tag = render_cache_version;
+  }
+  pSocket->nState = STATE_SENDDATA;
+  return size;
+}
+
+
+static void render_cache_fill(struct tHttpD* pSocket, uint16_t nBytes)
+{
+  // Copy a packet of rendered IOControl page data from uip_appdata to the
+  // cache. When the last packet is copied the cache is marked valid, but
+  // only if nothing changed while the page was being rendered.
+  if (render_cache_fill_ofs + nBytes > RENDER_CACHE_MAX) {
+    render_cache_filler = NULL;
+    return;
+  }
+  Enc28j60WriteBuffer((uint16_t)(ENC28J60_CACHESTART + render_cache_fill_ofs),
+                      (uint8_t *)uip_appdata,
+		      nBytes);
+  render_cache_fill_ofs += nBytes;
+  if (pSocket->nDataLeft == 0) {
+    if (render_cache_fill_tag == render_cache_version) {
+      render_cache_tag = render_cache_fill_tag;
+      render_cache_size = render_cache_fill_ofs;
+      render_cache_valid = 1;
+    }
+    render_cache_filler = NULL;
+  }
+}
+
+
+static void render_cache_send(struct tHttpD* pSocket)
+{
+  // Send the next packet of the IOControl page from the cache.
+  //   nDataLeft  - cached bytes not yet sent
+  //   nParseLeft - size of the cached page when the transfer started
+  //   nPrevBytes - bytes sent in the last packet (for retransmit)
+  //   ParseNum   - render_cache_epoch when the transfer started
+  uint16_t nBytes;
+
+  nBytes = pSocket->nDataLeft;
+  if (nBytes == 0) {
+    uip_close();
+    return;
+  }
+  if (pSocket->ParseNum != render_cache_epoch) {
+    // The cache was refilled while this page was being sent. The rest of
+    // the page no longer matches what was already sent.
+    uip_abort();
+    return;
+  }
+  if (nBytes > uip_mss()) nBytes = uip_mss();
+  Enc28j60ReadBuffer((uint16_t)(ENC28J60_CACHESTART + pSocket->nParseLeft - pSocket->nDataLeft),
+                     (uint8_t *)uip_appdata,
+		     nBytes);
+  pSocket->nDataLeft -= nBytes;
+  pSocket->nPrevBytes = nBytes;
+  uip_send(uip_appdata, nBytes);
+}
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+
+
+#if OB_EEPROM_SUPPORT == 1
+//---------------------------------------------------------------------------//
+// Webpage template streamer
+//
+// The IOControl and Configuration templates are read from the Off-Board
+// EEPROM through a small read ahead ring (tpl_buf). The ring is filled two
+// ways:
+// - CopyHttpData() reads bytes with tpl_stream_get(). If the ring is empty
+//   it is refilled right away (an "inline" read, which the connection has
+//   to wait for).
+// - On main.c loop passes where no packet is received tpl_stream_prefetch()
+//   reads ahead TPL_PREFETCH_CHUNK bytes at a time. This happens while the
+//   connection waits for the Browser to ACK the last packet, so most of the
+//   next packet's template is already in the ring when it is needed.
+// The EEPROM is left in sequential read mode between refills (see
+// I2C_read_close() in I2C.c), so a refill only needs to clock in the data.
+// The Control Bytes and byte address are only sent again if some other
+// read used the bus in between, or if the template position changed.
+//
+// Previously each call to CopyHttpData() re-addressed the EEPROM and read
+// a 230 byte buffer on the stack, then re-addressed and read it again when
+// it ran low, re-reading any bytes that had not been consumed. All of those
+// reads happened while the connection waited.
+//---------------------------------------------------------------------------//
+static void tpl_stream_fill(uint8_t count)
+{
+  // Append up to count bytes to tpl_buf from the Off-Board EEPROM.
+  uint8_t tail;
+  
+  if (count > (uint8_t)(TPL_BUF_SIZE - tpl_count)) count = (uint8_t)(TPL_BUF_SIZE - tpl_count);
+  if (count == 0) return;
+  
+  if (I2C_read_open == 0) {
+    // The sequential read was ended (or never started). Address the EEPROM
+    // at the byte following the last byte in the ring.
+    prep_read(I2C_EEPROM2_WRITE, I2C_EEPROM2_READ, (uint16_t)(tpl_addr + tpl_count));
+    I2C_read_open = 1;
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+    tpl_stat_address++;
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+  }
+  
+  tail = (uint8_t)((tpl_head + tpl_count) & (TPL_BUF_SIZE - 1));
+  tpl_count = (uint8_t)(tpl_count + count);
+  while (count--) {
+    // Read with an ACK so the EEPROM stays in sequential read mode
+    tpl_buf[tail] = I2C_read_byte(0);
+    tail = (uint8_t)((tail + 1) & (TPL_BUF_SIZE - 1));
+  }
+}
+
+
+void tpl_stream_seek(uint16_t address)
+{
+  // Position the streamer at an Off-Board EEPROM address. Called at the
+  // start of each CopyHttpData() call with off_board_eeprom_index. If the
+  // address is where the last call stopped the ring content is kept,
+  // otherwise (a new page, another connection's page, or a retransmit) the
+  // ring is emptied.
+  tpl_active = 1;
+  if (address == tpl_addr) return;
+  I2C_read_close();
+  tpl_addr = address;
+  tpl_head = 0;
+  tpl_count = 0;
+}
+
+
+uint8_t tpl_stream_get(void)
+{
+  // Return the next template byte
+  uint8_t data;
+  
+  if (tpl_count == 0) {
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+    uint16_t start;
+    start = boot_timer_read();
+    tpl_stream_fill(TPL_BUF_SIZE);
+    tpl_stat_inline_ms += (uint16_t)(boot_timer_read() - start);
+    tpl_stat_inline += TPL_BUF_SIZE;
+#else // DEBUG_SUPPORT
+    tpl_stream_fill(TPL_BUF_SIZE);
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+  }
+  data = tpl_buf[tpl_head];
+  tpl_head = (uint8_t)((tpl_head + 1) & (TPL_BUF_SIZE - 1));
+  tpl_count--;
+  tpl_addr++;
+  return data;
+}
+
+
+void tpl_stream_prefetch(void)
+{
+  // Called from the main.c loop when no packet was received. Reads ahead
+  // one chunk if a template is being sent and the ring has room.
+  if (tpl_active && tpl_count < TPL_BUF_SIZE) {
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+    tpl_stat_prefetch += (uint8_t)(TPL_BUF_SIZE - tpl_count) < TPL_PREFETCH_CHUNK ?
+                         (uint8_t)(TPL_BUF_SIZE - tpl_count) : TPL_PREFETCH_CHUNK;
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+    tpl_stream_fill(TPL_PREFETCH_CHUNK);
+  }
+}
+
+
+void tpl_stream_stop(void)
+{
+  // Called when the last of a template has been copied. Stops read ahead
+  // and releases the bus. The ring content stays valid in case the last
+  // packet needs to be retransmitted.
+  I2C_read_close();
+  tpl_active = 0;
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+  // Report how the template was read. "inline" bytes were read while the
+  // connection waited, "prefetch" bytes were read during idle time.
+  UARTPrintf("Template EEPROM reads: inline ");
+  emb_itoa(tpl_stat_inline, OctetArray, 10, 5);
+  UARTPrintf(OctetArray);
+  UARTPrintf(" bytes ");
+  emb_itoa(tpl_stat_inline_ms, OctetArray, 10, 5);
+  UARTPrintf(OctetArray);
+  UARTPrintf(" ms  prefetch ");
+  emb_itoa(tpl_stat_prefetch, OctetArray, 10, 5);
+  UARTPrintf(OctetArray);
+  UARTPrintf(" bytes  addressing ");
+  emb_itoa(tpl_stat_address, OctetArray, 10, 3);
+  UARTPrintf(OctetArray);
+  UARTPrintf("\r\n");
+  tpl_stat_inline = 0;
+  tpl_stat_prefetch = 0;
+  tpl_stat_inline_ms = 0;
+  tpl_stat_address = 0;
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+}
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+static uint16_t CopyHttpData(uint8_t* pBuffer,
+                             const char** ppData,
+			     uint16_t* pDataLeft,
+			     uint16_t nMaxBytes,
+			     struct tHttpD* pSocket)
+{
+  // This function copies the selected webpage from flash storage to the
+  // output buffer.
+  // pBuffer - the output buffer
+  // ppData - the Flash storage for the Webpage template
+  // pDataLeft - remaining size of the template to be processed
+  // nMaxBytes - size of the output buffer
+  // While performing the copy the stream of characters in the webpage
+  // template is searched for special markers that indicate where template
+  // text should be replaced with variable length text.
+    
+  uint8_t nByte;
+  uint8_t nParsedNum;
+  uint8_t nParsedMode;
+  uint8_t temp;
+  int i;
+  int no_err;
+  unsigned char temp_octet[3];
+  uint8_t* pBuffer_start;
+  
+  nParsedNum = 0;
+  nParsedMode = 0;
+  pBuffer_start =  pBuffer;
+
+  // The input value "nMaxBytes" provided by the calling routine is based on
+  // the MSS (Maximum Segment Size) defined in UIP_TCP_MSS.
+  //
+  // In this "transmit" routine MSS indicates the maximum number of TCP
+  // datagram bytes that the remote host will accept in a TCP segment (the
+  // TCP datagram part of an IP frame). The MSS value is defined in the
+  // uipopt.h file. Later the MSS should be updated with a value obtained from
+  // the browser that is accessing the web server during setup of a connection.
+  // However, I don't think this actually happens, and for simplification I
+  // think UIP is using a single MSS value for transmit and receive. Receive
+  // is the critical direction because we have limited memory to store
+  // incoming packets ... and it is OK if we transmit less than the MSS that a
+  // remote host tells us it can receive. The problem that this causes is that
+  // as we reduce the value of MSS for receive, it also reduces the size of
+  // MSS for transmit, and that causes our web page transmission to take a
+  // very long time (I'm seeing 2 seconds for a simple web page). May have to
+  // work on this some more.
+  //
+  // In the original UIP code there was a "uip_split" function that would
+  // reduce the size of transmitted packets. I think that code was interacting
+  // with the code below creating instability, perhaps because a lot of
+  // short packets were generated. Making the nMaxBytes limit smaller than the
+  // uip_split threshold effectively prevented the uip_split from operating,
+  // and the overall code became stable. I subsequently decided to remove
+  // uip_split from this application.
+  //
+  //-------------------------------------------------------------------------//
+  // See the uipopt.h file: UIP_TCP_MSS must be smaller than the UIP_BUF
+  // (which is the same size as MAXFRAME) by the size of the headers (54
+  // bytes). So, if MAXFRAME is 500 bytes UIP_TCP_MSS can be up to 446 bytes.
+  // In this application UIP_TCP_MSS is set to 440.
+  // 
+  // We really only need to make sure that the loop below stays within the
+  // MSS boundary and within the UIP_BUF buffer size, whichever is smaller.
+  //-------------------------------------------------------------------------//
+  //
+  // #define ENC28J60_MAXFRAME	900 (in enc28j60.h)
+  //   Note: When using MQTT, ENC28J60_MAXFRAME could only be a max of 500
+  //   bytes to allow room for the MQTT variables and buffer.
+  //
+  // nMaxbytes must be 32 bytes smaller than UIP_TCP_MSS due to the need to
+  // allow for the largest string insertion that is NOT a %yxx replacement.
+  //
+  // nMaxBytes should not cause a TCP datagram formation larger than 536
+  // bytes.
+  //
+  // Note: Complete transmission of the typical webpage in this application is
+  // about 4000 bytes.
+
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+  // This over-rides the nMaxBytes value passed to the function to account
+  // for extra bytes that might be sent in a single pass of the loop below.
+  nMaxBytes = UIP_TCP_MSS - 40;
+  // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+
+
+  //-------------------------------------------------------------------------//
+#if OB_EEPROM_SUPPORT == 1
+  if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    // This code is applicable only when the Off-Board EERPOM is used to store
+    // the IOControl and Configuration webpage templates. Reading templates
+    // from the Off-Board EEPROM is very slow relative to reading the
+    // templates from STM8 Flash, so the template streamer is used to read
+    // ahead. See tpl_stream_fill().
+    tpl_stream_seek(off_board_eeprom_index);
+  }
+#endif // OB_EEPROM_SUPPORT == 1
+  //-------------------------------------------------------------------------//
+
+
+  while ((uint16_t)(pBuffer - pBuffer_start) < nMaxBytes) {
+    // This is the main loop for processing the page templates stored in
+    // flash and inserting variable data as the webpage is copied to the
+    // transmission buffer.
+    //
+    // The variable *pDataLeft counts down the amount of data not yet
+    // "consumed" from the source web page template.
+    //
+    // There are a large number of "markers" in the template (example: %a01)
+    // that get replaced by other text when the template is read and copied
+    // to the transmit buffer. Thus, the amount of data actually sent for a
+    // given page can greatly exceed the original size of the template.
+    //
+    // There are two ways this loop terminates:
+    // 1) If (pBuffer - pBuffer_start) exceeds nMaxBytes.
+    // 2) If *pDataLeft reaches a count of zero.
+    // If the loop terminates and there is still data left to transmit (as
+    // indicated by pDataLeft > 0) the calling routine will call the function
+    // again.
+    
+    if (*pDataLeft > 0) {
+      // If pDataLeft > 0 then we are (or are still) processing a page
+      // template.
+    
+      if (pSocket->insertion_index != 0) {
+        // If we previously interrupted an insertion string transfer to the
+	// transmit buffer then we don't want to read a character from the
+	// template, and instead we want to continue with the insertion string
+	// process. In this case use the retained nParsedMode and nParsedNum
+	// values so that we return to the %yxx part of the function. Note
+	// that if we are in the process of copying an insertion string to the
+	// transmit buffer the insertion_index will be non-zero.
+        // insertion_index = %yxx insertion byte index (1 byte)
+        // nParsedMode ('y' in this case)
+        // nParsedNum  (0, 1, 2, etc)
+	// Note: Since pSocket->ParseCmd and pSocket->ParseNum are not being
+	// used while this code is running I repurposed them as temporary
+	// storage for the nParsedMode and nParsedNum values until the next
+	// packet generation is started.
+        nParsedMode = pSocket->ParseCmd;
+        nParsedNum = pSocket->ParseNum;
+	nByte = '0'; // Need to set nByte to something other than '%' so we
+	             // can use the regular processing routine.
+      }
+      else {
+        // Else we're not continuing a string insertion and instead we should
+	// process the next character in the page template.
+	//
+        // Collect a byte from the source webpage. It will either be written
+	// to the transmission buffer as-is, or it (and perhaps characters
+	// that follow it) will be processed for replacement in the
+	// transmission buffer. pDataLeft is decremented once for each
+	// character read from the web page template.
+        
+#if OB_EEPROM_SUPPORT == 0
+	nByte = **ppData;
+#endif // OB_EEPROM_SUPPORT == 0
+
+#if OB_EEPROM_SUPPORT == 1
+        if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+          // This code is applicable only when the Off-Board EERPOM is used
+	  // to store the IOControl and Configuration webpage templates.
+          // Read 1 byte from the template streamer
+	  nByte = tpl_stream_get();
+	  off_board_eeprom_index++;
+	}
+	else nByte = **ppData;
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+        // Search for '%' symbol in the data stream. The symbol indicates the
+	// start of one of these special fields:
+        // %a - A user entered text field with a device name. Used for GUI
+	//      display so the user can easily tell what device they are
+	//      connected to. Also used as part of the MQTT Topic name. Also
+	//      displayed in the tab "title" field of a browser. Input and
+	//      output. Max 19 chars.
+        // %b - Address values - in the GUI the user will change these values
+	//      if they want to change the IP Address, Gateway Address,
+	//      Netmask or MQTT Server IP Address. Input and output.
+        // %c - HTTP Port Number or MQTT Server Port Number - in the GUI the
+	//      user will change this value if they want to change the Port
+	//      number. Input and output.
+        // %d - MAC values - in the GUI the user will change these values if
+	//      they want to change the MAC address. Input and output.
+        // %e - Statistics display information. Output only.
+        // %f - IO states displayed in simplified form. Output only.
+        // %g - "Config" string to control MQTT Enable, Full/Half Duplex, and
+	//      Home Assistant Auto Discovery functions. Input and Output.
+	// %h - Pin Control string - The pin control string is defined as 32
+	//      characters representing 16 hex bytes of information in text
+	//      format. Each byte is the pin_control character for each IO
+	//      pin. Input and Output.
+	// %i - IO Timer values
+	// %j - IO Names
+        // %l - MQTT Username - This is a user entered text field with a
+	//      Username. Used in MQTT communication. Input and output.
+        // %m - MQTT Password - This is a user entered text field with a
+	//      Password. Used in MQTT communication. Input and output.
+        // %n - MQTT Status - Displays red or green boxes to indicate startup
+	//      status for MQTT (Connection Available, ARP OK, TCP OK, Connect
+	//      OK, MQTT_OK). Output only.
+	// %s - EEPROM presence status. Output only.
+	// %t - Temperature Sensor data. Output only.
+	// %w - Code Revision. Output only.
+        // %y - Indicates the need to insert one of several commonly occuring
+	//      HTML strings. This is to aid in compressing the web page
+	//      templates stored in flash memory.
+        // %z - A bogus variable inserted at the end of the form data to make
+	//      sure that all real data is followed by an & character. This
+	//      helps to find the end of variable length values in the POST
+	//      form. The z value itself is never used.
+      
+        if (nByte == '%') {
+          (*ppData)++;
+          (*pDataLeft)--;
+          
+          // Collect the "nParsedMode" value (the i, o, a, b, c, etc part of
+	  // the field). This, along with the "nParsedNum" digits that follow,
+	  // will determine what data is put in the output stream.
+#if OB_EEPROM_SUPPORT == 0
+	  nParsedMode = **ppData;
+#endif // OB_EEPROM_SUPPORT == 0
+#if OB_EEPROM_SUPPORT == 1
+          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+	    // Read 1 byte from the template streamer
+	    nParsedMode = tpl_stream_get();
+	    off_board_eeprom_index++;
+	  }
+	  else nParsedMode = **ppData;
+#endif // OB_EEPROM_SUPPORT == 1
+          (*ppData)++;
+          (*pDataLeft)--;
+          
+          // Collect the first digit of the "nParsedNum" which follows the
+	  // "nParsedMode". This is the "tens" digit of the two character
+	  // nParsedNum.
+#if OB_EEPROM_SUPPORT == 0
+	  temp = **ppData;
+#endif // OB_EEPROM_SUPPORT == 0
+#if OB_EEPROM_SUPPORT == 1
+          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+	    // Read 1 byte from the template streamer
+	    temp = tpl_stream_get();
+	    off_board_eeprom_index++;
+	  }
+  	  else temp = **ppData;
+#endif // OB_EEPROM_SUPPORT == 1
+          nParsedNum = (uint8_t)((temp - '0') * 10);
+          (*ppData)++;
+          (*pDataLeft)--;
+
+          // Collect the second digit of the "nParsedNum". This is the "ones"
+	  // digit. Add it to the "tens" digit to complete the number in
+	  // integer form.
+#if OB_EEPROM_SUPPORT == 0
+	  temp = **ppData;
+#endif // OB_EEPROM_SUPPORT == 0
+#if OB_EEPROM_SUPPORT == 1
+          if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+	    // Read 1 byte from the template streamer
+	    temp = tpl_stream_get();
+	    off_board_eeprom_index++;
+	  }
+	  else temp = **ppData;
+#endif // OB_EEPROM_SUPPORT == 1
+          nParsedNum = (uint8_t)(nParsedNum + temp - '0');
+          (*ppData)++;
+          (*pDataLeft)--;
+	}
+      }
+
+      if ((nByte == '%') || (pSocket->insertion_index != 0)) {
+        // NOW insert information in the transmit stream based on the nParsedMode
+	// and nParsedNum just collected. Anything inserted in the transmit stream
+	// is in ascii / UTF-8 form.
+
+        if (nParsedMode == 'a') {
+	  // This displays the device name (up to 19 characters)
+          pBuffer = stpcpy(pBuffer, stored_devicename);
+	}
+
+	
+        else if (nParsedMode == 'b') {
+	  // This displays the IP Address, Gateway Address, and Netmask information.
+	  // We need to get the 32 bit values for IP Address, Gateway Address, and
+	  // Netmask and send them as text strings of hex characters (8 characters
+	  // for a 32 bit number, for example "c0a80004").
+	  {
+	    uint32_t temp32;
+	    uip_ipaddr_t * uip_ptr = NULL;
+	    
+            switch (nParsedNum)
+	    {
+	      // Depending on nParsedNum, point the correspondent variable
+	      case 0:
+	        uip_ptr = &uip_hostaddr;
+	        break;
+	      case 4:
+	        uip_ptr = &uip_draddr;
+	        break;
+	      case 8:
+	        uip_ptr = &uip_netmask;
+	        break;
+	      case 12:
+	        uip_ptr = &uip_mqttserveraddr;
+	        break;
+	      default: break;
+            }
+	  
+	    // Convert the value to an 8 digit hex string
+	    if (uip_ptr != NULL) {
+	        temp32 = (*uip_ptr)[0];
+		temp32 <<= 16;
+		temp32 |= (*uip_ptr)[1];
+	        emb_itoa(temp32, OctetArray, 16, 8);
+	    }
+	  
+ 	    // Copy OctetArray characters to output. Advance pointers.
+            pBuffer = stpcpy(pBuffer, OctetArray);
+	  }
+	}
+	
+        else if (nParsedMode == 'c') {
+	  // If nParsedNum == 0 this is the HTML Port number (5 characters)
+	  // If nParsedNum == 1 this is the MQTT Port number (5 characters)
+	  // In both cases we need to get a single 16 bit integer from storage
+	  // but put it in the transmission buffer as 5 alpha characters in
+	  // hex format.
+
+	  // Write the 5 digit Port value in hex
+	  if (nParsedNum == 0) emb_itoa(stored_port, OctetArray, 16, 5);
+	  else emb_itoa(stored_mqttport, OctetArray, 16, 5);
+	    
+	  // Copy OctetArray characters to output. Advance pointers.
+          pBuffer = stpcpy(pBuffer, OctetArray);
+        }
+	
+        else if (nParsedMode == 'd') {
+	  // This displays the MAC adddress information (2 characters per
+	  // octet). We send the 12 characters in the mac_string (rather
+	  // than from the uip_ethaddr bytes) as the mac_string is already
+	  // in alphanumeric format.
+          pBuffer = stpcpy(pBuffer, mac_string);
+	}
+	
+
+#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+        else if ((nParsedMode == 'e') && (nParsedNum < 22)) {
+	  // This displays the statistics information (10 characters per
+	  // data item). We need to get a single uint32_t from storage but
+	  // put it in the output stream as a character representation of
+	  // the data.
+	  // uip_stat.ip.drop       Number of dropped packets at the IP layer.
+	  // uip_stat.ip.recv       Number of received packets at the IP layer.
+	  // uip_stat.ip.sent       Number of sent packets at the IP layer.
+	  // uip_stat.ip.vhlerr     Number of packets dropped due to wrong IP version or header length.
+	  // uip_stat.ip.hblenerr   Number of packets dropped due to wrong IP length, high byte.
+	  // uip_stat.ip.lblenerr   Number of packets dropped due to wrong IP length, low byte.
+	  // uip_stat.ip.fragerr    Number of packets dropped since they were IP fragments.
+	  // uip_stat.ip.chkerr     Number of packets dropped due to IP checksum errors.
+	  // uip_stat.ip.protoerr   Number of packets dropped since they were neither ICMP, UDP nor TCP.
+	  // uip_stat.icmp.drop     Number of dropped ICMP packets.
+	  // uip_stat.icmp.recv     Number of received ICMP packets.
+	  // uip_stat.icmp.sent     Number of sent ICMP packets.
+	  // uip_stat.icmp.typeerr  Number of ICMP packets with a wrong type.
+	  // uip_stat.tcp.drop      Number of dropped TCP segments.
+	  // uip_stat.tcp.recv      Number of received TCP segments.
+	  // uip_stat.tcp.sent      Number of sent TCP segments.
+	  // uip_stat.tcp.chkerr    Number of TCP segments with a bad checksum.
+	  // uip_stat.tcp.ackerr    Number of TCP segments with a bad ACK number.
+	  // uip_stat.tcp.rst       Number of received TCP RST (reset) segments.
+	  // uip_stat.tcp.rexmit    Number of retransmitted TCP segments.
+	  // uip_stat.tcp.syndrop   Number of dropped SYNs due to too few connections avaliable.
+	  // uip_stat.tcp.synrst    Number of SYNs for closed ports, triggering a RST.
+	  
+          switch (nParsedNum)
+	  {
+	    // Output the statistics. First convert to 10 digit Decimal.
+	    case 0:  emb_itoa(uip_stat.ip.drop,      OctetArray, 10, 10); break;
+	    case 1:  emb_itoa(uip_stat.ip.recv,      OctetArray, 10, 10); break;
+	    case 2:  emb_itoa(uip_stat.ip.sent,      OctetArray, 10, 10); break;
+	    case 3:  emb_itoa(uip_stat.ip.vhlerr,    OctetArray, 10, 10); break;
+	    case 4:  emb_itoa(uip_stat.ip.hblenerr,  OctetArray, 10, 10); break;
+	    case 5:  emb_itoa(uip_stat.ip.lblenerr,  OctetArray, 10, 10); break;
+	    case 6:  emb_itoa(uip_stat.ip.fragerr,   OctetArray, 10, 10); break;
+	    case 7:  emb_itoa(uip_stat.ip.chkerr,    OctetArray, 10, 10); break;
+	    case 8:  emb_itoa(uip_stat.ip.protoerr,  OctetArray, 10, 10); break;
+	    case 9:  emb_itoa(uip_stat.icmp.drop,    OctetArray, 10, 10); break;
+	    case 10: emb_itoa(uip_stat.icmp.recv,    OctetArray, 10, 10); break;
+	    case 11: emb_itoa(uip_stat.icmp.sent,    OctetArray, 10, 10); break;
+	    case 12: emb_itoa(uip_stat.icmp.typeerr, OctetArray, 10, 10); break;
+	    case 13: emb_itoa(uip_stat.tcp.drop,     OctetArray, 10, 10); break;
+	    case 14: emb_itoa(uip_stat.tcp.recv,     OctetArray, 10, 10); break;
+	    case 15: emb_itoa(uip_stat.tcp.sent,     OctetArray, 10, 10); break;
+	    case 16: emb_itoa(uip_stat.tcp.chkerr,   OctetArray, 10, 10); break;
+	    case 17: emb_itoa(uip_stat.tcp.ackerr,   OctetArray, 10, 10); break;
+	    case 18: emb_itoa(uip_stat.tcp.rst,      OctetArray, 10, 10); break;
+	    case 19: emb_itoa(uip_stat.tcp.rexmit,   OctetArray, 10, 10); break;
+	    case 20: emb_itoa(uip_stat.tcp.syndrop,  OctetArray, 10, 10); break;
+	    case 21: emb_itoa(uip_stat.tcp.synrst,   OctetArray, 10, 10); break;
+	  }
+        pBuffer = stpcpy(pBuffer, OctetArray);
+	}
+#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
+        else if ((nParsedMode == 'e') && (nParsedNum >= 30) && (nParsedNum < 40)) {
+          if (nParsedNum == 31) {
+	    emb_itoa(second_counter, OctetArray, 10, 10);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+	  }
+          else if (nParsedNum == 32) {
+	    emb_itoa(TRANSMIT_counter, OctetArray, 10, 10);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+	  }
+          else if (nParsedNum == 33) {
+	    for (i=0; i<5; i++) {
+              int2hex(stored_debug[i]);
+              pBuffer = stpcpy(pBuffer, OctetArray);
+	    }
+	  }
+          else if (nParsedNum == 35) {
+            *pBuffer++ = '0';
+            *pBuffer++ = '0';
+            *pBuffer++ = '0';
+            *pBuffer++ = '0';
+            int2hex(MQTT_resp_tout_counter);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+            int2hex(MQTT_not_OK_counter);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+            int2hex(MQTT_broker_dis_counter);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+	  }
+#if FAIR_SCHEDULER_SUPPORT == 1
+          else if (nParsedNum == 36) {
+	    // Scheduler statistics for each connection slot: 8 hex characters
+	    // with the bytes sent and 2 hex characters with the longest wait
+	    // (in 20ms periodic ticks) of a deferred packet.
+	    for (i=0; i<UIP_CONNS; i++) {
+              emb_itoa(hub_stats[i].bytes, OctetArray, 16, 8);
+              pBuffer = stpcpy(pBuffer, OctetArray);
+              int2hex(hub_stats[i].wait_max);
+              pBuffer = stpcpy(pBuffer, OctetArray);
+	    }
+	  }
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+	}
+#endif // DEBUG_SUPPORT
+
+
+#if DEBUG_SENSOR_SERIAL == 1
+        else if ((nParsedMode == 'e') && (nParsedNum >= 40)) {
+	  // This is for diagnostic use only and is NOT normally enabled
+	  // in the compile options. This displays the Temperature Sensor
+	  // Serial Numbers and was made necessary due to some suppliers
+	  // providing DS18B20 devices with identical serial numbers.
+          if ((nParsedNum - 40) <= numROMs) {
+	    {
+              int n;
+              for (n=6; n>0; n--) {
+                int2hex(FoundROM[nParsedNum - 40][n]);
+	        pBuffer = stpcpy(pBuffer, OctetArray);
+              }
+	    }
+          }
+	  // If the sensor does not exist ...
+	  else {
+	    pBuffer = stpcpy(pBuffer, "------------");
+	  }
+	}
+#endif // DEBUG_SENSOR_SERIAL
+
+
+        else if (nParsedMode == 'f') {
+	  // Display the pin state information in the format used by the "98" and
+	  // "99" command. "99" is the command used in the original Network Module.
+	  // For output pins display the state in the pin_control byte.
+	  // For input pins if the Invert bit is set the ON_OFF state needs to be
+	  // inverted before displaying.
+	  // Bits are output for Pin 16 first and Pin 1 last
+	  i = 15;
+	  while( 1 ) {
+	    if (pin_control[i] & 0x02) {
+	      // This is an output
+	      if (pin_control[i] & 0x80) {
+	        // Output is ON
+		*pBuffer++ = '1';
+	      }
+	      else {
+		// Output is OFF
+		*pBuffer++ = '0';
+	      }
+            }
+            else {
+	      // This is an input
+	      if (pin_control[i] & 0x80) {
+	        // Input is ON, invert if needed
+	        if (pin_control[i] & 0x04) *pBuffer = '0';
+	        else *pBuffer = '1';
+                pBuffer++;
+	      }
+	      else {
+		// Input is OFF, invert if needed
+		if (pin_control[i] & 0x04) *pBuffer = '1';
+		else *pBuffer = '0';
+                pBuffer++;
+	      }
+	    }
+	    if (i == 0) break;
+	    i--;
+          }
+	}
+	
+
+        else if (nParsedMode == 'g') {
+	  // This displays the Config string, currently defined as follows:
+	  // Communicated to and from the web pages as 2 characters making
+	  // a hex encoded byte. Stored in memory as a single byte.
+	  // Bit 8: Undefined, 0 only
+	  // Bit 7: Undefined, 0 only
+	  // Bit 6: Undefined, 0 only
+	  // Bit 5: Undefined, 0 only
+	  // Bit 4: DS18B20 1 = Enable, 0 = Disable
+	  // Bit 3: MQTT 1 = Enable, 0 = Disable
+	  // Bit 2: Home Assistant Auto Discovery 1 = Enable, 0 = Disable
+	  // Bit 1: Duplex 1 = Full, 0 = Half
+	  // There is only 1 'g' ID so we don't need to check the nParsedNum.
+	  
+	  // Convert Config settngs byte into two hex characters
+          int2hex(stored_config_settings);
+	  pBuffer = stpcpy(pBuffer, OctetArray);
+	}
+	
+	
+        else if (nParsedMode == 'h') {
+	  // This sends the Pin Control String, defined as follows:
+	  // 32 characters
+	  // The 32 characters represent 16 hex bytes of information in text
+	  // format. Each byte is the pin_control character for each IO pin
+	  // starting with pin 01 on the left.
+	  // Note: Input pins needed to have the ON/OFF bit inverted if the
+	  //   Invert bit is set.
+	  	  
+	  // Insert pin_control bytes
+	  {
+	    int i;
+	    uint8_t j;
+	    for (i = 0; i <16; i++) {
+	      j = pin_control[i];
+	      if ((j & 0x02) == 0x00) {
+	        // This is an input pin - check the invert bit
+	        if (j & 0x04) { // Invert is set - flip the ON/OFF bit
+		  if (j & 0x80) j &= 0x7f;
+		  else j |= 0x80;
+		}
+	      }
+	      int2hex(j);
+	      pBuffer = stpcpy(pBuffer, OctetArray);
+            }
+	  }
+	}
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+        else if (nParsedMode == 'i') {
+	  // This sends the IO Timer units and IO Timer values to the Browser
+	  // defined as follows:
+	  // 2 bytes represented as hex encoded strings (4 nibbles)
+	  // Upper 2 bits are units
+	  // Lower 14 bits are value
+	  {
+	    uint8_t j;
+	    j = (uint8_t)((IO_TIMER[nParsedNum] & 0xff00) >> 8);
+	    int2hex(j);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+	    j = (uint8_t)(IO_TIMER[nParsedNum] & 0x00ff);
+	    int2hex(j);
+            pBuffer = stpcpy(pBuffer, OctetArray);
+          }
+	}
+	
+	
+        else if (nParsedMode == 'j') {
+	  // This displays IO Names in user friendly format (1 to 15 characters)
+          pBuffer = stpcpy(pBuffer, IO_NAME[nParsedNum]);
+	}
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+        else if (nParsedMode == 'l') {
+	  // This displays MQTT Username information (0 to 10 characters)
+          pBuffer = stpcpy(pBuffer, stored_mqtt_username);
+	}
+
+
+        else if (nParsedMode == 'm') {
+	  // This displays MQTT Password information (0 to 10 characters)
+          pBuffer = stpcpy(pBuffer, stored_mqtt_password);
+	}
+
+
+        else if (nParsedMode == 'n') {
+	  // This displays the MQTT Start Status information as five
+	  // red/green boxes showing Connections available, ARP status,
+	  // TCP status, MQTT Connect status, and MQTT Error status.
+	  no_err = 0;
+
+          switch (nParsedNum)
+	  {
+	    case 0:
+              // Connection request status
+	      if (mqtt_start_status & MQTT_START_CONNECTIONS_GOOD) no_err = 1;
+	      break;
+	    case 1:
+	      // ARP request status
+	      if (mqtt_start_status & MQTT_START_ARP_REQUEST_GOOD) no_err = 1;
+	      break;
+	    case 2:
+	      // TCP connection status
+	      if (mqtt_start_status & MQTT_START_TCP_CONNECT_GOOD) no_err = 1;
+	      break;
+	    case 3:
+	      // MQTT Connection status 1
+	      if (mqtt_start_status & MQTT_START_MQTT_CONNECT_GOOD) no_err = 1;
+              break;
+	    case 4:
+	      // MQTT start complete with no errors
+	      if ((MQTT_error_status == 1) && ((mqtt_start_status & 0xf0) == 0xf0) ) no_err = 1;
+              break;
+	    default:
+	      break;
+	  }
+	  
+	  if (no_err == 1) *pBuffer++ = '1'; // Paint a green square
+	  else *pBuffer++ = '0'; // Paint a red square
+	}
+
+
+#if OB_EEPROM_SUPPORT == 1
+        else if (nParsedMode == 's') {
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+	  if (nParsedNum == 2) {
+	    // This sends the Parse Fail reason code. %s02
+	    // Note: String copied to the pBuffer must be 40 characters
+	    if (upgrade_failcode == UPGRADE_FAIL_FILE_READ_CHECKSUM)
+	      pBuffer = stpcpy(pBuffer, "Checksum error receiving file...........");
+	    else if (upgrade_failcode == UPGRADE_FAIL_EEPROM_MISCOMPARE)
+	      pBuffer = stpcpy(pBuffer, "EEPROM content miscompare...............");
+	    else if (upgrade_failcode == STRING_EEPROM_MISCOMPARE)
+	      pBuffer = stpcpy(pBuffer, "EEPROM content miscompare...............");
+	    else if (upgrade_failcode == UPGRADE_FAIL_NOT_SREC)
+	      pBuffer = stpcpy(pBuffer, "SREC file format incorrect..............");
+	    else if (upgrade_failcode == UPGRADE_FAIL_IMAGE_HEADER)
+	      pBuffer = stpcpy(pBuffer, "Binary image header incorrect...........");
+	    else if (upgrade_failcode == UPGRADE_FAIL_IMAGE_CRC)
+	      pBuffer = stpcpy(pBuffer, "Binary image CRC error..................");
+	    else if (upgrade_failcode == UPGRADE_FAIL_ERASE_ACTIVE)
+	      pBuffer = stpcpy(pBuffer, "EEPROM erase in progress, retry later...");
+	    else
+	      pBuffer = stpcpy(pBuffer, "Unknown Error...........................");
+	  }
+	  if (nParsedNum == 3) {
+	    // This sends the Off-Board EEPROM erase status. %s03
+	    // Note: String copied to the pBuffer must be 4 characters
+	    if (eeprom_erase_state == EEPROM_ERASE_FAIL) {
+	      pBuffer = stpcpy(pBuffer, "FAIL");
+	    }
+	    else if (eeprom_erase_state == EEPROM_ERASE_REFUSED) {
+	      pBuffer = stpcpy(pBuffer, "BUSY");
+	    }
+	    else {
+	      emb_itoa(eeprom_erase_block, OctetArray, 10, 4);
+	      pBuffer = stpcpy(pBuffer, OctetArray);
+	    }
+	  }
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+	}
+#endif // OB_EEPROM_SUPPORT == 1
+
+
+        else if ((nParsedMode == 't') && (stored_config_settings & 0x08)) {
+	  // This displays temperature sensor data for 5 sensors and the
+	  // text fields around that data IF DS18B20 mode is enabled.
+	  
+	  if (nParsedNum == 0) {
+	    #define TEMPTEXT "<p>Temperature Sensors<br>"
+	    pBuffer = stpcpy(pBuffer, TEMPTEXT);
+	    #undef TEMPTEXT
+	  }
+	  
+	  // Output the sensor ID numbers
+	  // For display we output the MSByte first followed by remaining
+	  // bytes. A total of 6 bytes are displayed in hex encoded format.
+	  if (nParsedNum <= numROMs) {
+	    *pBuffer++ = ' ';
+	    {
+	      int i;
+	      for (i=6; i>0; i--) {
+	        int2hex(FoundROM[nParsedNum][i]);
+	        pBuffer = stpcpy(pBuffer, OctetArray);
+	      }
+              pBuffer = stpcpy(pBuffer, " ");
+	    }
+	  }
+	  // If the sensor does not exist ...
+	  else {
+	    pBuffer = stpcpy(pBuffer, " ------------ ");
+	  }
+	  
+	  // Output temperature data
+          pBuffer = show_temperature_string(pBuffer, nParsedNum);
+	  if (nParsedNum == 4) {
+	    #define TEMPTEXT "</p>"
+	    pBuffer = stpcpy(pBuffer, TEMPTEXT);
+	    #undef TEMPTEXT
+	  }
+	}
+
+
+        else if (nParsedMode == 'w') {
+	  // This displays Code Revision information (13 characters) plus Code
+	  // Type (13 characters, '.' characters are added to make sure the
+	  // length is always 13)
+          pBuffer = stpcpy(pBuffer, code_revision);
+	  
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD	&& I2C_SUPPORT == 0 && OB_EEPROM_SUPPORT == 0
+          pBuffer = stpcpy(pBuffer, " Browser Only");
+#endif
+
+#if BUILD_SUPPORT == MQTT_BUILD	&& I2C_SUPPORT == 0 && OB_EEPROM_SUPPORT == 0
+          pBuffer = stpcpy(pBuffer, " MQTT .......");
+#endif
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD	&& I2C_SUPPORT == 1 && OB_EEPROM_SUPPORT == 1
+          pBuffer = stpcpy(pBuffer, " Browser UPG ");
+#endif
+
+#if BUILD_SUPPORT == MQTT_BUILD	&& I2C_SUPPORT == 1 && OB_EEPROM_SUPPORT == 1
+          pBuffer = stpcpy(pBuffer, " MQTT UPG ...");
+#endif
+	}
+
+
+        else if (nParsedMode == 'y') {
+          // Indicates the need to insert one of several commonly occuring HTML
+          // strings. These strings were created to aid in compressing the web
+	  // page templates stored in flash memory by storing the strings once,
+	  // then inserting them in the web page template as that template is
+	  // sent to the browser for display.
+	  //
+	  // Processing of a long string insertion is a special case and may
+	  // bridge over more than one call to the CopyHttpData() function. This
+	  // is to better utilize the transmit buffer. Without the "bridging" the
+	  // function would have to always make sure there is enough buffer space
+	  // to hold the longest string, whether a string is being sent or not.
+	  // This would waste buffer space and require many more packets to send
+	  // an HTML page.
+	  //
+	  // Bridging of calls to the CopyHttpData() function is acomplished as
+	  // follows:
+	  // a) If a %yxx placeholder is detected in the template as much of the
+	  //    replacement string is inserted in the send buffer as possible.
+	  // b) An "insertion_index" is filled to contain the index into the
+	  //    string being inserted into the transmit buffer. If this index
+	  //    is non-zero we know we are in the process of inserting a %yxx
+	  //    string. If the index is zero we are NOT in the process of
+	  //    inserting a %yxx string.
+	  // c) If the CopyHttpData() function hits the maximum character
+	  //    insertion limit for the packet it does a normal return to the
+	  //    calling function, and the insertion_index is retained in the
+	  //    socket struct. nParsedMode and nParsedNum are also retained
+	  //    in the socket struct in the pSocket->ParseCmd and
+	  //    pSocket->ParseNum variables. This stores the information
+	  //    needed to continue the string insertion on the next call to
+	  //    CopyHttpData().
+	  // d) If the entire string is inserted successfully the
+	  //    insertion_index is cleared to 0.
+	  // d) When CopyHttpData() is called again it will check the
+	  //    insertion_index to determine if a string insertion was prev-
+	  //    iously underway. If so the function will jump to this point
+	  //    in the routine and will continue the string insertion.
+          
+	  // insertion_index will be 0 if we are just starting insertion of a
+	  //   string.
+	  // insertion_index will be non-0 if a string insertion was started
+	  //   and is not yet complete. In this case insertion_index is an
+	  //   index to the next character in the source string that is to be
+	  //   inserted into the transmit buffer.
+
+          // pSocket->ParseCmd and pSocket->ParseNum are used to temporarily
+          // store the nParsedMode and nParsedNum values until the start of
+	  // the next transmit packet generation. These struct are repurposed
+	  // for this storage because they are not being used while this code
+	  // is running.
+
+	  i = pSocket->insertion_index;
+	  pSocket->ParseCmd = nParsedMode;
+	  pSocket->ParseNum = nParsedNum;
+	  
+	  // The insertion strings are stored as an array of strings. nParsedNum
+	  // is used as an index to select the needed string, and i is used as
+	  // an index to single characters in each string. Also, the string
+	  // length for each string in the "array of strngs" is stored in an
+	  // "array of string lengths" with nParsedNum again used as an index
+	  // to select the correct value.
+          // Access the strings and string lengths as follows:
+          // ps[i].str
+          // ps[i].size
+          *pBuffer = (uint8_t)ps[nParsedNum].str[i];
+	  pSocket->insertion_index++;
+	  if (pSocket->insertion_index == ps[nParsedNum].size) pSocket->insertion_index = 0;
+          pBuffer++;
+	}
+      }
+
+
+      else {
+        // If the above code did not process a "%" nParsedMode code and we were
+	// not continuing a string insertion then whatever character we read from
+	// the page template is copied as-is to the uip_buf for transmission.
+        *pBuffer = nByte;
+        *ppData = *ppData + 1;
+        *pDataLeft = *pDataLeft - 1;
+        pBuffer++;
+      }
+    }
+    else break;
+  }
+
+#if OB_EEPROM_SUPPORT == 1
+  if (pSocket->current_webpage == WEBPAGE_IOCONTROL || pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+    // The whole template has been read. Stop reading ahead.
+    if (*pDataLeft == 0) tpl_stream_stop();
+  }
+#endif // OB_EEPROM_SUPPORT == 1
+
+  return (pBuffer - pBuffer_start);
+}
+
+
+char *show_temperature_string(char *pBuffer, uint8_t nParsedNum)
+{
+  // Display temperature strings in degrees C and degrees F
+  // Note: &#8451; inserts a degree symbol followed by C.
+  // Note: &#8457; inserts a degree symbol followed by F.
+  convert_temperature(nParsedNum, 0);      // Convert to degrees C in OctetArray
+  pBuffer = stpcpy(pBuffer, OctetArray);     // Display sensor value
+  #define TEMPTEXT "&#8451; "              // Display degress C symbol
+  pBuffer = stpcpy(pBuffer, TEMPTEXT);
+  #undef TEMPTEXT
+  
+  convert_temperature(nParsedNum, 1);      // Convert to degrees F in OctetArray
+  pBuffer = stpcpy(pBuffer, OctetArray);     // Display sensor value
+  #define TEMPTEXT "&#8457;<br>"           // Display degress F symbol
+  pBuffer = stpcpy(pBuffer, TEMPTEXT);
+  #undef TEMPTEXT
+  
+  return pBuffer;
+}
+
+
+void HttpDInit(void)
+{
+  // Initialize the structures that manage each connection in the form of a
+  // protosocket
+  int i;
+  register struct uip_conn *uip_connr = uip_conn;
+  
+  // Initialize the struct tHttpD values
+  for (i = 0; i < UIP_CONNS; i++) {
+    uip_connr = &uip_conns[i];
+//    init_tHttpD_struct(&uip_connr->appstate.HttpDSocket);
+    init_tHttpD_struct(&uip_connr->appstate.HttpDSocket, i);
+  }
+
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+  // The ENC28J60 was just initialized. Start with an empty render cache.
+  render_cache_valid = 0;
+  render_cache_filler = NULL;
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+
+#if OB_EEPROM_SUPPORT == 1
+  // No template is being streamed. The open read (if any) must be ended
+  // before the ring is emptied so the next refill re-addresses the EEPROM.
+  I2C_read_close();
+  tpl_active = 0;
+  tpl_count = 0;
+#endif // OB_EEPROM_SUPPORT == 1
+
+  // Start listening on our port
+  uip_listen(htons(Port_Httpd));
+}
+
+
+// void init_tHttpD_struct(struct tHttpD* pSocket) {
+void init_tHttpD_struct(struct tHttpD* pSocket, int i) {
+  // Initialize the contents of the struct tHttpD
+  // This function is called UIP_CONNS times by the HttpDinit function. It is
+  // called once for each possible connection. The function sets the initial
+  // values within the pSocket structure to give a new connection a "starting
+  // place", such as which page to initially display when a connection is made.
+  
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  pSocket->current_webpage = WEBPAGE_IOCONTROL;
+  pSocket->structID = i; // TEMPORARY DEBUG MARKER
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+  
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+  pSocket->current_webpage = WEBPAGE_UPLOADER;
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+// UARTPrintf("init_tHttpd_struct\r\n");
+
+  pSocket->insertion_index = 0;
+  init_off_board_string_pointers(pSocket);
+}
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+static uint8_t upload_active(void)
+{
+  // Returns 1 if a firmware or String file upload is being received on any
+  // connection, or if pages of an upload are still waiting in the
+  // upload_ring to be written to the Off-Board EEPROM. The /74 erase must
+  // not be started while this is true as it would zero the pages the
+  // upload is writing.
+  uint8_t i;
+  
+  for (i=0; i<UIP_CONNS; i++) {
+    if (uip_conns[i].tcpstateflags != UIP_CLOSED
+     && uip_conns[i].appstate.HttpDSocket.nState == STATE_PARSEFILE) return 1;
+  }
+#if UPLOAD_PIPELINE_SUPPORT == 1
+  if (upload_ring_count != 0) return 1;
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+  return 0;
+}
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+void HttpDCall(uint8_t* pBuffer, uint16_t nBytes, struct tHttpD* pSocket)
+{
+  uint16_t nBufSize;
+  int i;
+  uint8_t j;
+  char compare_buf[32];
+  uint8_t GET_response_type = 200;
+
+  // HttpDCall() is used to:
+  // a) Receive a request or data from the Browser:
+  //    In the form of a GET if the Browser is requesting a web page or other
+  //    other action.
+  //    In the form of a POST if the Broswer is sending data to the
+  //    application.
+  //    "if (uip_newdata()" part of the code below.
+  // b) Send a requsted web page to the Browser:
+  //    This uses the "if (uip_connected())" part of the code below to start a
+  //    new page transmission and the "if (uip_acked())" part of the code
+  //    below if continuing a page transmission.
+
+  i = 0;
+  j = 0;
+
+// UARTPrintf("HttpDCall: current_webpage = ");
+// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("   structID = ");
+// emb_itoa(pSocket->structID, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+  if (uip_connected()) {
+    //Initialize this connection
+    
+// UARTPrintf("HttpDCall: uip_connected  current_webpage = ");
+// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("   structID = ");
+// emb_itoa(pSocket->structID, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    // If this connection slot was last used for an Event Stream revert to
+    // the default page. The Event Stream is only entered via a /80 command.
+    // nNewlines held the captured DS18B20 enable flag and is cleared for
+    // the POST header search.
+    if (pSocket->current_webpage == WEBPAGE_EVENTS) {
+      pSocket->current_webpage = WEBPAGE_IOCONTROL;
+      pSocket->nNewlines = 0;
+    }
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+    // If the last connection in this slot was filling the render cache it
+    // did not complete.
+    if (render_cache_filler == pSocket) render_cache_filler = NULL;
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+    if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
+      pSocket->pData = g_HtmlPageIOControl;
+      pSocket->nDataLeft = HtmlPageIOControl_size;
+      // nDataLeft above is used when we get around to calling CopyHttpData
+      // in state STATE_SENDDATA
+    }
+    
+    if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) {
+      pSocket->pData = g_HtmlPageConfiguration;
+      pSocket->nDataLeft = HtmlPageConfiguration_size;
+    }
+    
+    if (pSocket->current_webpage == WEBPAGE_SSTATE) {
+      pSocket->pData = g_HtmlPageSstate;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
+    }
+
+#if OB_EEPROM_SUPPORT == 1
+    if (pSocket->current_webpage == WEBPAGE_LOADUPLOADER) {
+      pSocket->pData = g_HtmlPageLoadUploader;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageLoadUploader) - 1);
+    }
+#endif // OB_EEPROM_SUPPORT == 1
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    if (pSocket->current_webpage == WEBPAGE_STATS1) {
+      pSocket->pData = g_HtmlPageStats1;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
+    }
+#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
+    if (pSocket->current_webpage == WEBPAGE_STATS2) {
+      pSocket->pData = g_HtmlPageStats2;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
+    }
+#endif // DEBUG_SUPPORT
+
+#if DEBUG_SENSOR_SERIAL == 1
+    if (pSocket->current_webpage == WEBPAGE_SENSOR_SERIAL) {
+      pSocket->pData = g_HtmlPageTmpSerialNum;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
+    }
+#endif // DEBUG_SENSOR_SERIAL
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+    if (pSocket->current_webpage == WEBPAGE_UPLOADER) {
+      pSocket->pData = g_HtmlPageUploader;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
+    }
+
+    if (pSocket->current_webpage == WEBPAGE_EXISTING_IMAGE) {
+      pSocket->pData = g_HtmlPageExistingImage;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
+    }
+
+    if (pSocket->current_webpage == WEBPAGE_TIMER) {
+      pSocket->pData = g_HtmlPageTimer;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
+    }
+
+    if (pSocket->current_webpage == WEBPAGE_UPLOAD_COMPLETE) {
+      pSocket->pData = g_HtmlPageUploadComplete;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
+    }
+
+    if (pSocket->current_webpage == WEBPAGE_PARSEFAIL) {
+      pSocket->pData = g_HtmlPageParseFail;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
+    }
+
+    if (pSocket->current_webpage == WEBPAGE_ERASE) {
+      pSocket->pData = g_HtmlPageErase;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageErase) - 1);
+    }
+
+    if (pSocket->current_webpage == WEBPAGE_ERASE_STATUS) {
+      pSocket->pData = g_HtmlPageEraseStatus;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageEraseStatus) - 1);
+    }
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+#if OB_EEPROM_SUPPORT == 1
+    if (pSocket->current_webpage == WEBPAGE_EEPROM_MISSING) {
+      pSocket->pData = g_HtmlPageEEPROMMissing;
+      pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
+    }
+#endif // OB_EEPROM_SUPPORT == 1
+
+    pSocket->nState = STATE_CONNECTED;
+    pSocket->nPrevBytes = 0xFFFF;
+
+    // Note on TCP Fragment reassembly: The uip_connected() steps ABOVE are
+    // run for every TCP packet and fragment. That being the case we need to
+    // be sure that TCP Fragment reassembly values are not changed in these
+    // steps.
+  }
+
+  else if (uip_acked()) {
+
+// UARTPrintf("HttpDCall: uip_acked  current_webpage = ");
+// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("   structID = ");
+// emb_itoa(pSocket->structID, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+    // if uip_acked() is true we will be in the STATE_SENDDATA state and
+    // only need to run the "senddata" part of this routine. This typically
+    // happens when there are multiple packets to send to the Broswer in
+    // response to a POST or GET, so we may repeat this loop in
+    // STATE_SENDDATA several times.
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    if (pSocket->nState == STATE_EVENTSTREAM) {
+      // The previous Event Stream record was acknowledged. Check right away
+      // for anything new rather than waiting for the next poll.
+      event_stream_poll(pSocket);
+      return;
+    }
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    goto senddata;
+  }
+  
+  else if (uip_newdata()) {
+
+// UARTPrintf("HttpDCall: uip_newdata  current_webpage = ");
+// emb_itoa(pSocket->current_webpage, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("   structID = ");
+// emb_itoa(pSocket->structID, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+    // This is the start of a new Browser session, or it is additional packets
+    // sent to complete a transmission from the Browser.
+    //
+    // In this limited application the only "new data" packets a browser can
+    // send to the web server are "POST" or "GET" packets, as the browser can
+    // only reply to the pages the web server sent to it. We're going to parse
+    // the data portion of the packet.
+    //
+    // This code will re-assemble POST/GET datagrams that arrive in
+    // "fragmented" packets. Note that we are not really receiving "fragments"
+    // in the traditional sense of an original packet being broken up by
+    // router points in the network. In that case we could have used the MF
+    // flag ("More Fragments") in the IP Header as each packet arrived to
+    // determine if the final packet was received. But in this case we have
+    // given the remote host a packet size limitation (via MSS settings), and
+    // the remote host has broken up the TCP datagram into small packets. There
+    // is nothing in the IP or TCP headers that shows a clear connection
+    // between the packets except for the sequence and ack numbers. That being
+    // the case this code relies on the nParseLeft value to determine when a
+    // sequence of packets with the TCP datagram in it completes.
+    //
+    // While possibly a misnomer, I will call these "TCP Fragments" in the
+    // comments in this code.
+    //
+    // The TCP Fragments are tracked and reassembled by saving the parse state
+    // and values at each step in the parsing so that incomplete parse steps
+    // can be continued when the next packet in a TCP Fragment series arrives.
+    // Note that it is possible for one of the following to happen:
+    //   1) POST/GET data can arrive complete in the first packet (no TCP
+    //      Fragments).
+    //   2) TCP Fragment packets can be anywhere from 2 to "many" packets, and
+    //      the fragment break can be at any character in datagram - it can
+    //      even occur at the last character of the POST/GET data where there
+    //      is nothing useful left to parse, but there might still be a tiny
+    //      fragment coming in to complete the TCP Fragment series. Note this
+    //      should never happen if we parse the end of POST data.
+    //   3) The first POST/GET packet will always start with "POST" or "GET "
+    //      as the first four characters in the datagram. This comes right
+    //      after the LLH, IP, and TCP Headers, so it will start at byte 55 of
+    //      the uip_buf. We won't count on that exact byte number, but it is
+    //      reasonable to assume that the buffer is always 400 bytes or more,
+    //      and that the "POST" or "GET " phrase will be completely contained
+    //      within the first packet, thus the phrase itself will never be
+    //      fragmented.
+    //   3a) Once the "POST" phrase is found it can be followed in the
+    //      datagram by a very long HTML preamble (the overhead stuff sent by
+    //      browsers that precedes the POST data content ... hundreds of
+    //      bytes). So it is very likely that TCP Fragments will occur within
+    //      this preamble area before we find the actual POST data, or that
+    //      the preamble will cause the POST data to get pushed onto a
+    //      fragmentation boundary.
+    //   3b) Likewise the GET request can be followed by a very long HTML
+    //      preamble (I guess I should call it a post-amble in this case). The
+    //      post-amble can also be hundreds of bytes. It is less problematic
+    //      in the GET case because everything we want to parse from the GET
+    //      message will occur prior to the post-amble and has zero chance of
+    //      being fragmented. So the code is not written to handle any
+    //      fragmentation of GET requests.
+    //   3c) With the addition of Off-Board EEPROMs and the ability to upload
+    //      replacement code via Ethernet the POST pre-amble is parsed for the
+    //      "Content-Type" phrase. The phrase is used to determine if the POST
+    //      data contains a new firmware file, or if the POST data contains
+    //      user entered responses to GUI fields.
+    //   3d) Otherwise this code by-passes all the preamble/post-amble stuff
+    //      but saves the parsing state so it knows we are either looking for
+    //      data or disposing of extraneous fragments.
+    //
+      
+    // In the code below we are parsing for the "POST" or "GET " phrase. We do
+    // not need to worry about TCP fragmentation because the phrase will appear
+    // very early in the first packet (easily within the first 100 bytes).
+    // However, once we receive "POST" we go into a loop looking for the
+    // "\r\n\r\n" sequence, and we need to be able to handle TCP fragmentation
+    // during that search.
+    //
+    // If we are parsing a TCP fragment then pSocket->nState may have been
+    // restored to STATE_PARSEPOST or STATE_PARSEGET. If so the parse code
+    // will run but won't do anything.
+    
+    // If we are in STATE_CONNECTED (meaning we are reading the first and
+    // perhaps only packet in a series) check the first five characters of the
+    // uip_buf to see if this is a POST or GET request.
+    if (pSocket->nState == STATE_CONNECTED) {
+      if (memcmp("POST", &pBuffer[0], 4) == 0) pSocket->nState = STATE_GOTPOST;
+      if (memcmp("GET", &pBuffer[0], 3) == 0)  pSocket->nState = STATE_GOTGET;
+      pBuffer += 4;
+      nBytes -= 4;
+      // We are collecting the first packet. Clear parse_tail so it will be
+      // ready if there is a TCP Fragment.
+      parse_tail[0] = '\0';
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+      // Initialize the find_content_info state. It is used to manage the
+      // search for the Content-Type and Content-Length phrases.
+      find_content_info = SEEK_CONTENT_INFO;
+
+// UARTPrintf("\r\n");
+// UARTPrintf("find_content_info = SEEK_CONTENT_INFO initialize");
+// UARTPrintf("\r\n");
+
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+    }
+    
+
+    if (pSocket->nState == STATE_GOTPOST) {
+      // If this is a BROWSER_ONLY_BUILD or a MQTT_BUILD then the only kind of
+      // POST we can receive is a "normal" POST consisting of values the user
+      // entered in the GUI. If that is the case the data we want follows the
+      // first \r\n\r\n sequence in the html body.
+      // If this is a CODE_UPLOADER_BUILD then the only kind of POST we can
+      // receive is a "file" POST wherein the POST consists of a new firmware
+      // file. If that is the case the data we want follows the second
+      // \r\n\r\n sequence in the html body. Note that we need to search the
+      // html pre-amble for the "Content-Length" when running a Code Uploader
+      // build.
+
+// UARTPrintf("\r\n");
+// UARTPrintf("pSocket->nState == STATE_GOTPOST Search for rnrn");
+// UARTPrintf("\r\n");
+
+      if (nBytes == 0) {
+        // If we enter the search at end of fragment we exit and will come
+	// back to this point with the next fragment.
+        return;
+      }
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+      while (nBytes != 0) {
+	// The following searches for the \r\n\r\n sequence
+	if (pSocket->nNewlines == 2) {
+	  // This handles the case where a TCP Fragmentation occured in the
+	  // previous packet just as we collected the second \n. In that case
+	  // the search does not continue.
+	}
+	else {
+          // We're processing packets but haven't found the \r\n\r\n sequence
+          // yet. The sequence detector really just looks for two \n in a row,
+          // ignoring the first \r. If any character other than \r appears
+	  // between the \n and \n the Newlines counter is zero'd.
+          if (*pBuffer == '\n') pSocket->nNewlines++;
+          else if (*pBuffer == '\r') { }
+          else pSocket->nNewlines = 0;
+          pBuffer++;
+          nBytes--;
+          if (nBytes == 0) {
+            // If we hit end of fragment we exit and will come back to the loop
+            // with the next fragment.
+            return;
+          }
+        }
+
+        if (pSocket->nNewlines == 2) {
+          // Beginning of non-file POST found.
+	  
+	  // Clear nNewlines for future POSTs
+	  pSocket->nNewlines = 0;
+	  
+          // Set current_webpage to NULL. This will be used later to aid in
+	  // determining if the POST is coming from an IOControl POST or from
+	  // a Configuration POST.
+	  pSocket->current_webpage = WEBPAGE_NULL;
+	  
+	  // Initialize parse_tail for first pass of parsing
+	  parse_tail[0] = '\0';
+	  
+          // Start parsing
+          pSocket->ParseState = PARSE_CMD;
+          pSocket->nParseLeft = 0;
+          pSocket->nState = STATE_PARSEPOST;
+	  if (nBytes == 0) {
+	    // If we are at end of fragment here we exit and will return in
+	    // STATE_PARSEPOST
+	    return;
+	  }
+          break;
+        }
+      }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+	
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+      while (nBytes != 0) {
+	// Search for the "Content-Length: " phrase. We're processing the first
+	// packet but haven't found the phrase yet.
+        if ((*pBuffer == 'C') && (find_content_info == SEEK_CONTENT_INFO)) {
+          // Might have first character of the phrase. Copy 16 characters from
+	  // pBuffer into a temporary buffer and check for a match to the
+	  // phrase.
+          {
+            int i;
+            
+	    for (i=0; i<16; i++) {
+              compare_buf[i] = *pBuffer;
+              pBuffer++;
+              nBytes--;
+            }
+            // At this point we have captured enough characters to check for
+            // the "Content-Length: " phrase.
+            if (strncmp(compare_buf, "Content-Length: ", 16) == 0) {
+              // Found "Content-Length: "
+	      i = 0;
+	      while (1) {
+                // Extract the content length value. The value starts with the
+	        // first character following the phrase, and continues until a
+	        // ';' or '\r' or '\n' is found.
+	        if (*pBuffer == ';' || *pBuffer == '\r' || *pBuffer == '\n') {
+		  OctetArray[i] = '\0';
+		  break;
+		}
+		else {
+		  OctetArray[i++] = *pBuffer;
+		  pBuffer++;
+                  nBytes--;
+		}
+	      }
+	      // Convert OctetArray to an integer. This needs to be a 32 bit
+	      // integer as the file content could exceed 65536 characters but
+	      // will not exceed 99999
+	      //
+	      // See this URL for an explanation of the use of (uint16_t) and
+	      // "U" in the equations below:
+	      // https://www.microchip.com/forums/m1126560.aspx
+	      // Note: Simple addition and subtraction doesn't see to have this
+	      // problem ... appears to be division and multiplication only.
+	      // Note: Can't use atoi() ... it seems to have the same problem.
+
+	      file_length =  ((uint16_t)(OctetArray[0] - '0') * 10000U);
+	      file_length += ((uint16_t)(OctetArray[1] - '0') * 1000U);
+	      file_length += ((uint16_t)(OctetArray[2] - '0') * 100U);
+	      file_length += ((uint16_t)(OctetArray[3] - '0') * 10U);
+	      file_length += ((uint16_t)(OctetArray[4] - '0') * 1U);
+              find_content_info = SEEK_FIRST_RNRN;
+
+// UARTPrintf("\r\n");
+// UARTPrintf("Found Content-Length: ");
+// UARTPrintf(OctetArray);
+// UARTPrintf("  file_length: ");
+// emb_itoa(file_length, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+	    }
+	  }
+        }	
+
+	// The following searches for the \r\n\r\n sequence
+	if (pSocket->nNewlines == 2) {
+	  // This handles the case where a TCP Fragmentation occured in the
+	  // previous packet just as we collected the second \n. In that case
+	  // the search does not continue.
+	}
+	else {
+          // We're processing packets but haven't found the \r\n\r\n sequence
+          // yet. The sequence detector really just looks for two \n in a row,
+          // ignoring the first \r. If any character other than \r appears
+	  // between the \n and \n the Newlines counter is zero'd.
+          if (*pBuffer == '\n') pSocket->nNewlines++;
+          else if (*pBuffer == '\r') { }
+          else pSocket->nNewlines = 0;
+          pBuffer++;
+          nBytes--;
+          if (nBytes == 0) {
+            // If we hit end of fragment we exit and will come back to the loop
+            // with the next fragment.
+            return;
+          }
+        }
+
+        if ((pSocket->nNewlines == 2) && (find_content_info == SEEK_FIRST_RNRN)) {
+	  // Need to search for next \r\n\r\n
+          pSocket->nNewlines = 0;
+	  find_content_info = SEEK_SECOND_RNRN;
+
+// UARTPrintf("\r\n");
+// UARTPrintf("find_content_info = SEEK_SECOND_RNRN");
+// UARTPrintf("\r\n");
+
+	}
+        else if ((pSocket->nNewlines == 2) && (find_content_info == SEEK_SECOND_RNRN)) {
+	  // Found second set of \r\n\r\n
+	  // Clear nNewlines for future searches
+	  pSocket->nNewlines = 0;
+	  
+	  // We are parsing a data file
+	  // The next character in the POST should be the first character of
+	  // the payload (in this case, the new program file).
+          find_content_info = FOUND_CONTENT_INFO;
+
+// UARTPrintf("\r\n");
+// UARTPrintf("find_content_info = FOUND_CONTENT_TYPE FINAL");
+// UARTPrintf("\r\n");
+
+	  // Beginning of a data file found.
+	  // Initialize parsing variables.
+          byte_index = 0;
+          parse_index = 0;
+          eeprom_address_index = I2C_EEPROM0_BASE;
+          parse_tail[0] = '\0';
+          byte_tail[0] = '\0';
+          byte_tail[1] = '\0';
+          line_count = 0;
+          checksum = 0;
+#if UPLOAD_PIPELINE_SUPPORT == 1
+          // Finish any pages left from a prior upload before starting.
+          upload_ring_flush();
+	  upload_ring_fail = 0;
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+          upgrade_failcode = UPGRADE_OK;
+	  non_sequential_detect = 0;
+	  SREC_start = 1;
+          search_limit = 0;
+	  for (i=0; i<30; i++) {
+	    // Initialize the search compare buffer
+	    compare_buf[i] = 'z';
+	  }
+          // Start parsing
+          pSocket->nState = STATE_PARSEFILE;
+	  pSocket->ParseState = PARSE_FILE_SEEK_START;
+	  if (eeprom_erase_state == EEPROM_ERASE_WRITE
+	   || eeprom_erase_state == EEPROM_ERASE_BUSY) {
+	    // A /74 erase is running and would zero the pages this upload
+	    // writes. Refuse the upload: the file is read and discarded and
+	    // the Parse Fail page is shown.
+	    upgrade_failcode = UPGRADE_FAIL_ERASE_ACTIVE;
+	    pSocket->ParseState = PARSE_FILE_FAIL;
+	  }
+          
+          // nParseLeft is normally set to the size of the POST data when
+	  // parsing user entered values from a Browser GUI. In this case the
+	  // data file is much larger than the nParseLeft variable can contain
+	  // so nParseLeft is just set to 1 and used as a flag to indicate
+	  // receipt of all file data (at which time it is set to 0). This
+	  // allows the normal POST processing termination processes to
+	  // complete as they do with user POST entries.
+	  pSocket->nParseLeft = 1;
+
+// UARTPrintf("\r\n");
+// UARTPrintf("Starting STATE_PARSEFILE");
+// UARTPrintf("\r\n");
+
+	  if (nBytes == 0) {
+	    // If we are at end of fragment here we exit and will return in
+	    // STATE_PARSEFILE
+	    return;
+	  }
+          break;
+	}
+      }
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+    }
+
+
+    if (pSocket->nState == STATE_GOTGET) {
+
+// UARTPrintf("\r\n");
+// UARTPrintf("pSocket->nState == STATE_GOTGET Going to PARSEGET");
+// UARTPrintf("\r\n");
+
+      // Don't search for \r\n\r\n ... instead parse what we've got
+      // Initialize Parsing variables
+      // nParseLeft is used as a flag in GET parsing. nParseLeft == 1 will
+      // cause parsing to continue. nParseLeft == 0 will cause parsing to
+      // end.
+      pSocket->nParseLeft = 1;
+      pSocket->ParseState = PARSE_SLASH1;
+      // Start parsing
+      pSocket->nState = STATE_PARSEGET;
+    }
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+    if (pSocket->nState == STATE_PARSEPOST) {
+      // This code parses data the user entered in the GUI.
+      parsepost(pSocket, pBuffer, nBytes);
+    }
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+    
+
+    if (pSocket->nState == STATE_PARSEGET) {
+
+// UARTPrintf("\r\n");
+// UARTPrintf("pSocket->nState == STATE_PARSEGET Parsing");
+// UARTPrintf("\r\n");
+
+      // This section will parse a GET request sent by the user. Normally in a
+      // general purpose web server a GET request would be used to obtain
+      // files or other items from the server. In that general case the data
+      // that follows "GET " is a "/path/filename" (path optional). In this
+      // application we'll use "filename" to command the web server to perform
+      // internal operations. For instance, performing a GET for filename "42"
+      // (with a "/42") might turn an output on, or might command transmission
+      // of a specific web page, rather than retrieve a file.
+      //
+      // At this point the "GET " (GET plus space) part of the request has
+      // been parsed. The "GET " should be followed by "/filename". So we look
+      // for the "/" and collect the next two characters as the fake
+      // "filename".
+      //
+      // Fragmentation note: We don't need to collect any state information in
+      // this parse process as anything we are collecting will easily fit in
+      // the first 100 bytes of the first packet ... so no fragmentation will
+      // occur.
+      //
+      // Browser note: Looks like some browsers get creative and do things
+      // like requesting "favicon.ico" from the server. This causes the code
+      // below to execute - and in the original code it caused confusion as I
+      // would send the IOControl web page if I didn't understand the inquiry.
+      // Now I will just throw the request away if it doesn't exactly match an
+      // expected request. The only exception will be if I get a "/" or "/ "
+      // then I will send the default web page.
+
+      while (nBytes != 0) {
+        if (pSocket->ParseState == PARSE_SLASH1) {
+	  // When we entered the loop *pBuffer should already be pointing at
+	  // the "/". If there isn't one we should display the IOControl page.
+          pSocket->ParseCmd = *pBuffer;
+          pBuffer++;
+	  if (pSocket->ParseCmd == (uint8_t)0x2f) { // Compare to '/'
+	    pSocket->ParseState = PARSE_NUM10;
+	  }
+          else {
+            // Didn't find '/' - send default page
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+// UARTPrintf("Get slash search1\r\n");
+
+	    pSocket->current_webpage = WEBPAGE_IOCONTROL;
+            pSocket->pData = g_HtmlPageIOControl;
+            pSocket->nDataLeft = HtmlPageIOControl_size;
+            init_off_board_string_pointers(pSocket);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+	    pSocket->current_webpage = WEBPAGE_UPLOADER;
+            pSocket->pData = g_HtmlPageUploader;
+            pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
+	                             // SENDHEADER
+	  }
+        }
+
+        else if (pSocket->ParseState == PARSE_NUM10) {
+	  // It's possible we got here because the user did not request a
+	  // filename (ie, the user entered "192.168.1.4:8080/". In this case
+	  // there will be a space here instead of a digit, and we should just
+	  // exit the while() loop and send the default page.
+	  if (*pBuffer == ' ') {
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+// UARTPrintf("Get slash search2\r\n");
+
+	    pSocket->current_webpage = WEBPAGE_IOCONTROL;
+            pSocket->pData = g_HtmlPageIOControl;
+            pSocket->nDataLeft = HtmlPageIOControl_size;
+            init_off_board_string_pointers(pSocket);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+	    pSocket->current_webpage = WEBPAGE_UPLOADER;
+            pSocket->pData = g_HtmlPageUploader;
+            pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
+	                             // SENDHEADER
+	  }
+	  // Parse first ParseNum digit. Looks like the user did input a
+	  // filename digit, so collect it here.
+	  else if (isdigit(*pBuffer)) { // Check for user entry error
+            // Still good - parse number
+            pSocket->ParseNum = (uint8_t)((*pBuffer - '0') * 10);
+	    pSocket->ParseState = PARSE_NUM1;
+            pSocket->nParseLeft = 1; // Set to 1 so PARSE_NUM1 will be called
+            pBuffer++;
+	  }
+	  else {
+	    // Something out of sync or invalid filename - exit while() loop
+	    // but do not change the current_webpage
+            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
+	                             // SENDHEADER
+            pSocket->ParseState = PARSE_FAIL;
+	  }
+        }
+	
+	// Parse second ParseNum digit
+        else if (pSocket->ParseState == PARSE_NUM1) {
+	  if (isdigit(*pBuffer)) { // Check for user entry error
+            // Still good - parse number
+            pSocket->ParseNum += (uint8_t)(*pBuffer - '0');
+            pSocket->ParseState = PARSE_VAL;
+            pSocket->nParseLeft = 1; // Set to 1 so PARSE_VAL will be called
+            pBuffer++;
+	  }
+	  else {
+	    // Something out of sync or invalid filename - exit while() loop
+	    // but do not change the current_webpage
+            pSocket->nParseLeft = 0; // Set to 0 so we will go on to STATE_
+	                             // SENDHEADER
+            pSocket->ParseState = PARSE_FAIL;
+	  }
+	}
+	
+        else if (pSocket->ParseState == PARSE_VAL) {
+	  // ParseNum should now contain a two digit "filename". The filename
+	  // is used to command specific action by the webserver. Following
+	  // are the commands for the Network Module.
+	  //
+	  // From a fragment perspective we already received all the useful
+	  // information, so we can clear the saved states and process what
+	  // we've got. If another fragment still follows it won't have
+	  // anything useful in it and processing of the fragment won't cause
+	  // anything to happen.
+	  //
+	  // Note: Only those Output ON/OFF commands that correspond to a pin
+	  // configured as an Output will work.
+	  //
+	  // For 00-31, 55, and 56 you wont see any screen refresh.
+	  // http://IP/00  Output-01OFF
+	  // http://IP/01  Output-01ON
+	  // http://IP/02  Output-02OFF
+	  // http://IP/03  Output-02ON
+	  // http://IP/04  Output-03OFF
+	  // http://IP/05  Output-03ON
+	  // http://IP/06  Output-04OFF
+	  // http://IP/07  Output-04ON
+	  // http://IP/08  Output-05OFF
+	  // http://IP/09  Output-05ON
+	  // http://IP/10  Output-06OFF
+	  // http://IP/11  Output-06ON
+	  // http://IP/12  Output-07OFF
+	  // http://IP/13  Output-07ON
+	  // http://IP/14  Output-08OFF
+	  // http://IP/15  Output-08ON
+	  // http://IP/16  Output-09OFF
+	  // http://IP/17  Output-09ON
+	  // http://IP/18  Output-10OFF
+	  // http://IP/19  Output-10ON
+	  // http://IP/20  Output-11OFF
+	  // http://IP/21  Output-11ON
+	  // http://IP/22  Output-12OFF
+	  // http://IP/23  Output-12ON
+	  // http://IP/24  Output-13OFF
+	  // http://IP/25  Output-13ON
+	  // http://IP/26  Output-14OFF
+	  // http://IP/27  Output-14ON
+	  // http://IP/28  Output-15OFF
+	  // http://IP/29  Output-15ON
+	  // http://IP/30  Output-16OFF
+	  // http://IP/31  Output-16ON
+	  // http://IP/55  All Outputs ON
+	  // http://IP/56  All Outputs OFF
+	  //
+	  // http://IP/60  Show IO Control page
+	  // http://IP/61  Show Configuration page
+	  // http://IP/63  Show Help page (deprecated)
+	  // http://IP/64  Show Help2 page (deprecated)
+	  // http://IP/65  Flash LED 3 times (no screen refresh)
+	  // http://IP/66  Show Link Error Statistics page
+	  // http://IP/67  Clear Link Error Statistics and refresh page
+	  // http://IP/68  Show Network Statistics page
+	  // http://IP/69  Clear Network Statistics and refresh page
+          // http://IP/70  Clear the "Reset Status Register" counters
+          // http://IP/71  Display the Temperature Sensor Serial Numbers
+          // http://IP/72  Load the Code Uploader (works only in runtime
+	  //               builds)
+          // http://IP/73  Restore (works only in the Code Uploader build)
+          // http://IP/74  Erase EEPROM (works only in the Code Uploader
+	  //               build)
+          // http://IP/75  Show Code Uploader Timer (works only in the Code
+	  //               Uploader build)
+          // http://IP/76  Show Off-Board EEPROM Erase status (works only in
+	  //               the Code Uploader build)
+	  // http://IP/80  Open Event Stream (works only in Browser Only
+	  //               builds with EVENT_STREAM_SUPPORT)
+	  // http://IP/91  Reboot
+	  // http://IP/98  Show Very Short Form IO States page
+	  // http://IP/99  Show Short Form IO States page
+	  //
+          GET_response_type = 200; // Default response type
+          switch(pSocket->ParseNum)
+	  {
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+	    case 55:
+	      // Turn all outputs ON. Verify that each pin is an output
+	      // and that it is enabled.
+	      for (i=0; i<16; i++) {
+ 		Pending_pin_control[i] = pin_control[i];
+                if ((pin_control[i] & 0x03) == 0x03) {
+                  // The above: If an Enabled Output, then turn on the pin
+                  Pending_pin_control[i] |= 0x80;
+	        }
+              }
+	      parse_complete = 1;
+	      GET_response_type = 204; // No return webpage
+	      break;
+	      
+	    case 56:
+	      // Turn all outputs OFF. Verify that each pin is an output
+	      // and that it is enabled.
+	      for (i=0; i<16; i++) {
+		Pending_pin_control[i] = pin_control[i];
+                if ((pin_control[i] & 0x03) == 0x03) {
+                  // The above: If an Enabled Output, then turn off the pin
+                  Pending_pin_control[i] &= 0x7f;
+	        }
+              }
+	      parse_complete = 1; 
+	      GET_response_type = 204; // No return webpage
+	      break;
+
+	    case 60: // Show IO Control page
+
+// UARTPrintf("case 60\r\n");
+
+	      pSocket->current_webpage = WEBPAGE_IOCONTROL;
+              pSocket->pData = g_HtmlPageIOControl;
+              pSocket->nDataLeft = HtmlPageIOControl_size;
+              init_off_board_string_pointers(pSocket);
+	      break;
+	      
+	    case 61: // Show Configuration page
+
+// UARTPrintf("case 61\r\n");
+
+	      pSocket->current_webpage = WEBPAGE_CONFIGURATION;
+              pSocket->pData = g_HtmlPageConfiguration;
+              pSocket->nDataLeft = HtmlPageConfiguration_size;
+              init_off_board_string_pointers(pSocket);
+	      break;
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+	    case 65: // Flash LED for diagnostics
+	      debugflash();
+	      debugflash();
+	      debugflash();
+	      GET_response_type = 204; // No return webpage
+	      break;
+
+#if DEBUG_SUPPORT == 11 || DEBUG_SUPPORT == 15
+            case 66: // Show Link Error Statistics page
+	      pSocket->current_webpage = WEBPAGE_STATS2;
+              pSocket->pData = g_HtmlPageStats2;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
+	      break;
+	      
+            case 67: // Clear Link Error Statistics
+	      // Clear the the Link Error Statistics bytes.
+	      // Important: 
+	      // The debug[] byte indexes used may change if the
+	      // number of debug bytes changes.
+	      debug[3] = 0; // Clear TXERIF counter
+	      debug[4] = 0; // Clear RXERIF counter
+	      update_debug_storage1();
+	      TRANSMIT_counter = 0;
+	      MQTT_resp_tout_counter = 0;
+	      MQTT_not_OK_counter = 0;
+	      MQTT_broker_dis_counter = 0;
+#if FAIR_SCHEDULER_SUPPORT == 1
+	      memset(hub_stats, 0, sizeof(hub_stats));
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+	      
+	      pSocket->current_webpage = WEBPAGE_STATS2;
+              pSocket->pData = g_HtmlPageStats2;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats2) - 1);
+	      break;
+#endif // DEBUG_SUPPORT
+
+#if UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+            case 68: // Show Network Statistics page
+	      pSocket->current_webpage = WEBPAGE_STATS1;
+              pSocket->pData = g_HtmlPageStats1;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
+	      break;
+	      
+            case 69: // Clear Network Statistics and refresh page
+	      uip_init_stats();
+	      pSocket->current_webpage = WEBPAGE_STATS1;
+              pSocket->pData = g_HtmlPageStats1;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageStats1) - 1);
+	      break;
+#endif // UIP_STATISTICS == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+            case 70: // Clear the "Reset Status Register" counters
+	      // Clear the counts for EMCF, SWIMF, ILLOPF, IWDGF, WWDGF
+	      // These only display via the UART
+	      for (i = 5; i < 10; i++) debug[i] = 0;
+	      update_debug_storage1();
+	      break;
+
+#if DEBUG_SENSOR_SERIAL == 1
+            case 71: // Display the Temperature Sensor Serial Numbers
+	      pSocket->current_webpage = WEBPAGE_SENSOR_SERIAL;
+              pSocket->pData = g_HtmlPageTmpSerialNum;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTmpSerialNum) - 1);
+	      break;
+#endif // DEBUG_SENSOR_SERIAL
+
+#if OB_EEPROM_SUPPORT == 1
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+            case 72: // Load Code Uploader
+	      // Re-Check that the EEPROM exists, and if it does then load the
+	      // Code Uploader from Off-Board EEPROM1, display the Loading
+	      // Code Uploader webpage, then reboot.
+	      // If the EEPROM does not exist dieplay an error webpage.
+	      // Verify that Off-Board EEPROM(s) exist.
+              eeprom_detect = off_board_EEPROM_detect();
+	      if (eeprom_detect == 0) {
+	        pSocket->current_webpage = WEBPAGE_EEPROM_MISSING;
+                pSocket->pData = g_HtmlPageEEPROMMissing;
+                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageEEPROMMissing) - 1);
+	      }
+	      else {
+	        pSocket->current_webpage = WEBPAGE_LOADUPLOADER;
+                pSocket->pData = g_HtmlPageLoadUploader;
+                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageLoadUploader) - 1);
+                eeprom_copy_to_flash_request = I2C_COPY_EEPROM1_REQUEST;
+	      }
+	      break;
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+	      
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+            case 73: // Reload firmware existing image
+	      // Load the existing firmware image from Off-Board EEPROM0,
+	      // display the Loading Existing Image webpage, then reboot.
+	      if (eeprom_erase_state == EEPROM_ERASE_WRITE
+	       || eeprom_erase_state == EEPROM_ERASE_BUSY) {
+	        // A /74 erase is running and EEPROM0 is partly zeroed. Refuse
+		// the copy and show the Parse Fail page with the reason.
+	        upgrade_failcode = UPGRADE_FAIL_ERASE_ACTIVE;
+	        pSocket->current_webpage = WEBPAGE_PARSEFAIL;
+                pSocket->pData = g_HtmlPageParseFail;
+                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
+		break;
+	      }
+	      if (eeprom_detect == 1 && check_upload_image()) {
+	        // The image in EEPROM0 does not match the CRC32 of the last
+		// binary Program image uploaded. Refuse the copy and show the
+		// Parse Fail page with the reason.
+	        upgrade_failcode = UPGRADE_FAIL_IMAGE_CRC;
+	        pSocket->current_webpage = WEBPAGE_PARSEFAIL;
+                pSocket->pData = g_HtmlPageParseFail;
+                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
+		break;
+	      }
+	      pSocket->current_webpage = WEBPAGE_EXISTING_IMAGE;
+              pSocket->pData = g_HtmlPageExistingImage;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageExistingImage) - 1);
+              eeprom_copy_to_flash_request = I2C_COPY_EEPROM0_REQUEST;
+	      upgrade_failcode = UPGRADE_OK;
+	      break;
+	      
+            case 74: // Erase entire Off-Board EEPROM
+              // Erase EEPROM regions 0, 1, 2, and 3 to provide a clean slate.
+	      // Useful mostly during development for code debug.
+	      // The erase is performed in the background by
+	      // eeprom_erase_service(), one 128 byte block per pass of the
+	      // main.c loop, so the device keeps servicing the network. The
+	      // Erase page polls /76 for progress.
+	      // The erase is refused while a file upload is active (the /76
+	      // status reports BUSY), and a running erase is left to finish.
+	      if (eeprom_erase_state != EEPROM_ERASE_WRITE
+	       && eeprom_erase_state != EEPROM_ERASE_BUSY) {
+	        if (upload_active()) {
+	          eeprom_erase_state = EEPROM_ERASE_REFUSED;
+		}
+		else {
+	          eeprom_erase_block = 0;
+	          eeprom_erase_state = EEPROM_ERASE_WRITE;
+		}
+	      }
+	      pSocket->current_webpage = WEBPAGE_ERASE;
+              pSocket->pData = g_HtmlPageErase;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageErase) - 1);
+              break;
+
+            case 76: // Show Erase Status
+	      pSocket->current_webpage = WEBPAGE_ERASE_STATUS;
+              pSocket->pData = g_HtmlPageEraseStatus;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageEraseStatus) - 1);
+              break;
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#endif // OB_EEPROM_SUPPORT == 1
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+	    case 80: // Open Event Stream
+	      pSocket->current_webpage = WEBPAGE_EVENTS;
+	      break;
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+	    case 91: // Reboot
+	      user_reboot_request = 1;
+	      break;
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+            case 98: // Show Very Short Form IO state page
+            case 99: // Show Short Form IO state page
+	      // Normally when a page is transmitted the "current_webpage" is
+	      // updated to reflect the page just transmitted. This is not
+	      // done for this case as the page is very short (only requires
+	      // one packet to send) and not changing the current_webpage
+	      // pointer prevents "page interference" between normal browser
+	      // activity and the automated functions that normally use this
+	      // page.
+	      pSocket->current_webpage = WEBPAGE_SSTATE;
+              pSocket->pData = g_HtmlPageSstate;
+              pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
+	      break;
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+	    default:
+	      if (pSocket->ParseNum < 32) {
+                // Output-01..16 OFF/ON
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+                update_ON_OFF((uint8_t)(pSocket->ParseNum/2), (uint8_t)(pSocket->ParseNum%2));
+//                // Show Short Form IO state page
+//	        pSocket->current_webpage = WEBPAGE_SSTATE;
+//                pSocket->pData = g_HtmlPageSstate;
+//                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageSstate) - 1);
+	        GET_response_type = 204; // No return webpage
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+              }
+              else {
+	        // Show default page
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+// UARTPrintf("Default GET case\r\n");
+
+	        pSocket->current_webpage = WEBPAGE_IOCONTROL;
+                pSocket->pData = g_HtmlPageIOControl;
+                pSocket->nDataLeft = HtmlPageIOControl_size;
+                init_off_board_string_pointers(pSocket);
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+	        pSocket->current_webpage = WEBPAGE_UPLOADER;
+                pSocket->pData = g_HtmlPageUploader;
+                pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploader) - 1);
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+              }
+              break;
+
+	  } // end switch
+          pSocket->nParseLeft = 0;
+        }
+
+        if (pSocket->ParseState == PARSE_FAIL) {
+          // Parsing failed above. By going to STATE_SENDHEADER200 
+	  // javascript should repaint the page already sent. While
+	  // inefficient this will satisfy the browser's need for a
+	  // reply when it requests favicon.ico or whatever else it
+	  // requests that we don't have.
+          pSocket->nPrevBytes = 0xFFFF;
+          pSocket->nState = STATE_SENDHEADER200;
+	  break;
+	}
+
+        if (pSocket->nParseLeft == 0) {
+          // Finished parsing ... even if nBytes is not zero
+	  // Send the response
+          pSocket->nPrevBytes = 0xFFFF;
+          if (GET_response_type == 200) {
+	    // Update GUI with appropriate webpage
+            pSocket->nState = STATE_SENDHEADER200;
+	  }
+          if (GET_response_type == 204) {
+	    // No return webpage - send header with Content-Length: 0
+            pSocket->nState = STATE_SENDHEADER204;
+	  }
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+          if (pSocket->current_webpage == WEBPAGE_EVENTS) {
+	    // Open the Event Stream
+            pSocket->nState = STATE_SENDEVENTHEADER;
+	  }
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+          break;
+        }
+      } // end of while loop
+    }
+
+
+
+    
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+    if (pSocket->nState == STATE_PARSEFILE) {
+
+// UARTPrintf("\r\n");
+// UARTPrintf("pSocket->nState == STATE_PARSEFILE Parsing");
+// UARTPrintf("\r\n");
+
+      // This step is entered if a POST containing a firmware file was
+      // detected. The file contents will be copied to the Off-Board EEPROM,
+      // then the Off-B0ard EEPROM will be copied to the internal Flash, then
+      // the device will reboot.
+      //
+      // Some notes:
+      // - This application normally parses POST files providing user data
+      //   entries in a Browser session. As such, the size of the data is
+      //   easily less than 65536 characters, thus the nParseLeft variable
+      //   used in normal parsing is a uint16_t type.
+      // - When a SREC file is attached to a POST the datagram can be 1024
+      //   lines x 78 bytes = 79872 characters PLUS some other overhead like
+      //   S0 and S7 records, and some miscellaneous records (partial data,
+      //   0x4000 addresses, etc).
+      //   So nParseLeft cannot be used in receiving the SREC
+      //   file other than as a flag to indicate that parsing is complete.
+      //   Instead the SREC file parser searches for a SREC S7 record to find
+      //   the end of the data then sets nParseLeft to signal that the end of
+      //   data was reached.
+      // - If an invalid file is supplied (ie, not an SREC file) it is detect-
+      //   ed by not finding an "S0" as the first two characters of the file.
+      //   In that case a loop is entered to allow the entire file to be sent
+      //   by the browser, but an upgrade_failcode is set to notify the user
+      //   of the error.
+      // - If an invalid SREC file is provided ... well, can't help the user
+      //   with every possible fart. The invalid SREC file will likely be
+      //   loaded into Flash and reprogramming via the SWIM interface may be
+      //   necessary.
+
+// UARTPrintf("\r\n");
+// UARTPrintf("Parsing data file\r\n");
+
+// UARTPrintf(" byte_index = ");
+// emb_itoa(byte_index, OctetArray, 10, 3);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+// UARTPrintf(" parse_index = ");
+// emb_itoa(parse_index, OctetArray, 10, 3);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+// UARTPrintf(" eeprom_address_index = ");
+// emb_itoa(eeprom_address_index, OctetArray, 16, 4);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+// UARTPrintf(" ParseState = ");
+// emb_itoa(pSocket->ParseState, OctetArray, 10, 3);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+// UARTPrintf("***NEWPACKET***");
+
+
+      // nBytes is tracked in this function using the global file_nBytes to
+      // enable shared use of the nBytes value in this function and the
+      // read_two_characters function.
+      file_nBytes = nBytes;
+
+#if UPLOAD_PIPELINE_SUPPORT == 1
+      // If the upload_ring writer found a page that did not verify while the
+      // previous packet was being written the upload is abandoned. The
+      // upgrade_failcode was set by the writer.
+      if (upload_ring_fail
+       && (pSocket->ParseState == PARSE_FILE_SEEK_SX
+        || pSocket->ParseState == PARSE_FILE_SEQUENTIAL
+        || pSocket->ParseState == PARSE_FILE_NONSEQ
+        || pSocket->ParseState == PARSE_FILE_BIN_HEADER
+        || pSocket->ParseState == PARSE_FILE_BIN_DATA)) {
+        pSocket->ParseState = PARSE_FILE_FAIL;
+      }
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+
+      // This function uses a step by step state machine to read the data file
+
+      // When first starting the data file read keep in mind that even though
+      // the data part of the packet is just starting, a packet boundary can
+      // occur anywhere. However, we know that there will be at least one byte
+      // left in the current packet when we start.
+
+
+      if (pSocket->ParseState == PARSE_FILE_SEEK_START) {
+
+        // The first thing we need to do is find the start of the actual SREC
+        // file. In order to do this we need to find the end of the "multi-
+	// part boundary".
+        // Since only one SREC file is included in an update file the multi-
+	// part boundary immediately follows the second \r\n\r\n sequence.
+	// This is an example of the boundary text that will precede the first
+	// characters of the SREC data:
+        //
+        // -----------------------------168888385127375703662499690451
+        // Content-Disposition: form-data; name="file1"; filename="NetworkModule.sx"
+        // Content-Type: application/octet-stream
+        //
+        // So, we need to find the start of the SREC data by finding the end
+	// of the phrase "Type: application/octet-stream".
+        // Since a user might provide an invalid file we should also determine
+        // a reasonable point to give up looking for the phrase. Counting up
+	// the above and adding a little buffer for file name differences, we
+	// should find the end of the phrase within 200 characters of starting
+	// the search. If we don't it can be assumed this is not an SREC file.
+
+        while (1) {
+	  // Search for the "Type: application/octet-stream" phrase.
+	  // Since we can hit a packet boundary at any time we must check for
+	  // file_nBytes == 0 and break away to allow the next packet to be
+	  // read.
+	  // This search works by reading one character at a time from the
+	  // pBuffer and placing it in a left shift register. The register
+	  // shifts left one character each time a new character would exceed
+	  // the length of the register. The register is then compared with
+	  // the search phrase.
+	  
+	  for (i=0; i<29; i++) {
+	    // Shift the register contents left
+	    compare_buf[i] = compare_buf[i+1];
+	  }
+// UARTPrintf("compare_buf: ");
+// UARTPrintf(compare_buf);
+// UARTPrintf("\r\n");
+	  // Add a new character to the end of the register
+	  compare_buf[29] = *pBuffer;
+	  pBuffer++;
+	  file_nBytes--;
+	  file_length--;
+	  search_limit++;
+	  
+          if (strncmp(compare_buf, "Type: application/octet-stream", 30) == 0) {
+            // Found "Type: application/octet-stream"
+	    // The next character starts the SREC content
+            pSocket->ParseState = PARSE_FILE_SEEK_SX;
+// UARTPrintf("Found octet-stream\r\n");
+
+
+// Diagnostic - Print the characters that follow "octet-stream"
+// UARTPrintf("Characters following octet-stream: ");
+// for (i=0; i<30; i++) {
+// compare_buf[0] = *pBuffer;
+// pBuffer++;
+// compare_buf[1] = '\0';
+// UARTPrintf(compare_buf);
+// }
+// UARTPrintf("\r\n");
+
+
+	    break; // Break out of the local while loop
+	  }
+	      
+          if (search_limit >= 200) {
+            // Should have found the phrase by now. Assume this is not a valid
+	    // SREC file. Break out of the loop and go to PARSE_FILE_FAIL
+	    // The next character starts the SREC content
+// UARTPrintf("Exceeded search limit\r\n");
+            pSocket->ParseState = PARSE_FILE_FAIL;
+	    break; // Break out of the local while loop
+	  }
+	  
+          if (file_nBytes == 0) {
+            // We just read the last character in this packet. Break out
+            // of the local while loop so the next packet will be read.
+            break; // Break out of the local while loop
+          }
+        } // End of local while loop
+      }
+
+      if (pSocket->ParseState != PARSE_FILE_SEEK_START) {
+        while (1) {
+          // This while() loop is a state machine with three main
+	  // "pSocket->ParseState" states:
+	  // PARSE_FILE_SEEK_SX
+	  //   Parses the leading characters of each SREC looking for the SREC
+	  //   type.
+	  //     If the SREC type is S0 we are starting receipt of an SREC file
+	  //     so the 32K EEPROM0 space is erased to make it available to
+	  //     store the parsed SREC content. This SREC must be read to deter-
+	  //     mine the "file_type", ie, is it a PROGRAM file or a STRING
+	  //     file.
+	  //     If the SREC type is S3 we are starting receipt of an SREC data
+	  //     line. The "address" contained within the data line is parsed
+	  //     then the state machine goes to state PARSE_FILE_SEQUENTIAL or
+	  //     state PARSE_FILE_NONSEQ as needed.
+	  //     If the SREC type is S7 we are at the last record in the SREC
+	  //     file.
+	  // PARSE_FILE_SEQUENTIAL
+	  //   Parses "sequential" SREC date, ie, the first data record and any
+	  //   subsequent data record that has an address that is sequential
+	  //   with the previous data record.
+	  // PARSE_FILE_NONSEQ
+	  //   Parses "non-sequential" SREC data, ie, any data record that has
+	  //   an address that is not seqeuntial relative to the previous data
+	  //   record.
+	  // Exit at end of packet (file_nBytes == 0). This can occur at any
+	  // point while reading data. The exit allows the uip functions to
+	  // receive the next ethernet packet, then the STATE_PARSEFILE code
+	  // will be re-entered to continue this state machine where we left
+	  // off. Re-entry is made possible because "pSocket->nState" and
+	  // "pSocket->ParseState" are both saved so that we know where we
+	  // were when a packet ended (a TCP Fragmentation).
+          
+          if (pSocket->ParseState == PARSE_FILE_SEEK_SX) {
+
+// UARTPrintf(" ParseState = PARSE_FILE_SEEK_SX\r\n");
+
+	    // This parse looks for the start of record and will parse the
+	    // address value for the record.
+	    while (1) {
+              // Try to read two characters from the SREC
+              pBuffer = read_two_characters(pBuffer);
+              if (byte_tail[0] == '\0') {
+	        // No characters were found. This can occur when an end of
+	        // packet occurs during a CRLF sequence. The read attempt will
+	        // have set file_nBytes to zero. Break out of the local while
+	        // loop so that the next packet will be read.
+	        break;
+	      }
+              if (byte_tail[1] == '\0') {
+                // We only found 1 character so we just read the last character
+	        // in this packet. The read_two_characters() function will have
+	        // set file_nBytes to zero. Break out of the local while loop so
+	        // the next packet will be read.
+                break;
+              }
+
+// {
+// uint8_t temp[3];
+// temp[0] = byte_tail[0];
+// temp[1] = byte_tail[1];
+// temp[2] = '\0';
+// UARTPrintf(temp);
+// }
+            
+	      // If we didn't break out then we successfully read two charac-
+	      // ters.
+	      
+	      // If this is the start of the SREC parsing the file MUST begin
+	      // with "S0" ... otherwise we must assume this is not an SREC file
+	      // and we will abort the parsing.
+	      if (SREC_start == 1) {
+	        if (strncmp(byte_tail, "NM", 2) == 0) {
+		  // This is a Network Module binary image (see the description
+		  // at PARSE_FILE_BIN_HEADER below). The "NM" just read are the
+		  // first two bytes of the image header. Everything after them
+		  // is raw binary and must not be read with
+		  // read_two_characters().
+		  SREC_start = 0;
+		  parse_tail[0] = 'N';
+		  parse_tail[1] = 'M';
+		  parse_index = 2;
+                  byte_tail[0] = '\0';
+                  byte_tail[1] = '\0';
+                  pSocket->ParseState = PARSE_FILE_BIN_HEADER;
+		  break;
+		}
+	        if (strncmp(byte_tail, "S0", 2) != 0) {
+	          // This does not appear to be an SREC file. Abort.
+                  upgrade_failcode = UPGRADE_FAIL_NOT_SREC;
+	      
+// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_NOT_SREC\r\n");
+
+                  pSocket->ParseState = PARSE_FILE_FAIL;
+		  break;
+	        }
+	        else SREC_start = 0;
+	      }
+	      
+	      // "byte_index" is used to track progress in dissecting the
+	      // incoming SREC.
+	      
+	      if (byte_index == 0) {
+	        if (strncmp(byte_tail, "S0", 2) == 0) {
+                  // Check if the two characters are "S0", indicating the start
+		  // of a SREC file.
+
+// UARTPrintf("Found S0\r\n");
+
+                  // Erase EEPROM0 to provide a clean space to store the incom-
+		  // ing SREC data.
+		  upload_erase_eeprom0();
+		  image_length = 0;
+		  // Now go on to determining what kind of file was sent
+		  file_type = FILETYPE_SEARCH;
+	          byte_index = 2;
+                  // Clear byte_tail for subsequent reads
+                  byte_tail[0] = '\0';
+                  byte_tail[1] = '\0';
+	          // Continue to read the address value in this SREC
+	          continue;
+	        }
+	        else if (strncmp(byte_tail, "S3", 2) == 0) {
+                  // Check if the two characters are "S3", indicating the start
+		  // of a new SREC data line.
+
+// UARTPrintf("Found S3\r\n");
+
+	          byte_index = 2;
+                  // Clear byte_tail for subsequent reads
+                  byte_tail[0] = '\0';
+                  byte_tail[1] = '\0';
+	          // Continue to read the address value in this SREC
+	          continue;
+	        }
+	        else if (strncmp(byte_tail, "S7", 2) == 0) {
+// UARTPrintf("Found S7\r\n");
+                  // Check if the two characters are "S7", indicating the end of
+		  // data.
+		 
+		  if (parse_index != 0) {
+		    // If any data remains in parse_tail write it to the EEPROM.
+                    upload_write_page(pSocket, UPGRADE_FAIL_EEPROM_MISCOMPARE);
+		  }
+		  
+		  // At this point all data is processed. Go on to the
+		  // PARSE_FILE_COMPLETE code.
+ 
+	          pSocket->ParseState = PARSE_FILE_COMPLETE;
+		  
+		  continue; // Continue reading characters until end of file
+	        }
+	        else {
+	          // Throw away characters and continue search
+                  // Clear byte_tail for subsequent reads
+                  byte_tail[0] = '\0';
+                  byte_tail[1] = '\0';
+		  continue;
+                } 
+	      }
+	    
+	      if (byte_index == 2) {
+	        // Read the data count value
+
+// UARTPrintf("byte_index == 2  ");
+
+                data_count = two_hex2int(byte_tail[0], byte_tail[1]);
+	        // Start checksum
+	        checksum = data_count;
+	        byte_index = 4;
+                // Clear byte_tail for subsequent reads
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
+	        continue;
+	      }
+	    
+	      if (byte_index == 4) {
+	        // Ignore first byte of address value
+
+// UARTPrintf("byte_index == 4  ");
+
+	        data_count--;
+	        // Add to checksum. Value is always 00
+	        checksum += 0;
+	        byte_index = 6;
+                // Clear byte_tail for subsequent reads
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
+	        continue;
+	      }
+	    
+	      if (byte_index == 6) {
+	        // Ignore the second byte of address value
+
+// UARTPrintf("byte_index == 6  ");
+
+	        data_count--;
+	        // Add to checksum. Value is always 00
+	        checksum += 0;
+	        byte_index = 8;
+                // Clear byte_tail for subsequent reads
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
+	        continue;
+	      }
+	    
+	      if (byte_index == 8 && file_type != FILETYPE_SEARCH) {
+	        // Capture the high order byte of the address value
+
+// UARTPrintf("byte_index == 8  ");
+
+                temp_address = two_hex2int(byte_tail[0], byte_tail[1]);
+	        data_count--;
+	        checksum += (uint8_t)temp_address;
+	        temp_address = temp_address << 8;
+	        byte_index = 10;
+                // Clear byte_tail for subsequent reads
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
+	        continue;
+	      }
+	    
+	      if (byte_index == 8 && file_type == FILETYPE_SEARCH) {
+	        // Determine file_type
+
+// UARTPrintf("byte_index == 8\r\n");
+
+	        data_count--;
+	        // Capture the first byte of the file type
+	        // 'N' (0x4E) is a NetworkModule program file
+	        // 'S' (0x53) is a String File
+                if (two_hex2int(byte_tail[0], byte_tail[1]) == 0x4E) {
+	          file_type = FILETYPE_PROGRAM;
+
+// UARTPrintf("file_type = FILETYPE_PROGRAM\r\n");
+	      
+	        }
+	        else {
+	          file_type = FILETYPE_STRING;
+
+// UARTPrintf("file_type = FILETYPE_STRING\r\n");
+	      
+                }
+	        // Reset byte_index and byte_tail
+	        byte_index = 0;
+                byte_tail[0] = '\0';
+                byte_tail[1] = '\0';
+	        // Break out of while loop so that next SREC will be read
+                break;
+	      }
+	    
+	      if (byte_index == 10) {
+	        // Capture the low order byte of the address value
+
+// UARTPrintf("byte_index == 10\r\n");
+
+                temp_address_low = two_hex2int(byte_tail[0], byte_tail[1]);
+	        data_count--;
+	        checksum += (uint8_t)temp_address_low;
+	        temp_address |= temp_address_low;
+	      
+	        if ((temp_address < 0x8000) || (temp_address > (FLASH_START_USER_RESERVE - 1))) {
+// UARTPrintf("\r\nDiscard ");
+// UARTPrintf("temp_address = ");
+// emb_itoa(temp_address, OctetArray, 16, 4);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+	          // If the address is not in the range 0x8000 to
+	          // FLASH_START_USER_DATA_RESERVE we ignore the SREC and
+		  // stay in ParseState PARSE_FILE_SEEK_SX to search for the
+ 		  // next SREC.
+	          byte_index = 0;
+                  // Clear byte_tail for subsequent reads
+                  byte_tail[0] = '\0';
+                  byte_tail[1] = '\0';
+	          break;
+	        }
+	        else {
+	          // Else we start processing the SREC
+                  new_address = temp_address;
+// UARTPrintf("\r\nnew_address = ");
+// emb_itoa(new_address, OctetArray, 16, 4);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+	        }
+	      
+	        if (new_address == 0x8000) {
+	          // If this is the start of the firmware image set address and
+	          // parse the first SREC in the image
+	          address = 0x8000;
+                  pSocket->ParseState = PARSE_FILE_SEQUENTIAL;
+                  // Clear byte_tail for subsequent reads
+                  byte_tail[0] = '\0';
+                  byte_tail[1] = '\0';
+                  break;
+	        }
+	      
+	        if (new_address > 0x8000) {
+	          // Handle valid addresses beyond the starting address
+	          if (new_address == address) {
+	            // While reading the SREC "address" should have incremented
+		    // up to equal the "new_address". If so then continue read-
+		    // ing data
+                    pSocket->ParseState = PARSE_FILE_SEQUENTIAL;
+                    // Clear byte_tail for subsequent reads
+                    byte_tail[0] = '\0';
+                    byte_tail[1] = '\0';
+	            break;
+	          }
+		  
+		  else {
+		    // This is a case where the "new_address" is not sequential
+		    // with the prevous data read.
+		    // In this case we need to finish writing data we were col-
+		    // lecting, then we need to use the PARSE_FILE_NONSEQ code
+		    // to begin collection of data at the new_address.
+		    //   If the new_address is in space already written to the
+		    //   EEPROM an over-write of the EEPROM content will occur.
+		    //   If the new_address is in space futher out in the EEPROM
+		    //   the EEPROM writes will begin at that new_address.
+		    // 
+
+
+// UARTPrintf("\r\nFound data line with non-sequential address: parse_index = ");
+// emb_itoa(parse_index, OctetArray, 16, 2);
+// UARTPrintf(OctetArray);
+
+		    if (parse_index != 0) {
+		      // If we were in the middle of writing a 64 byte block to
+		      // EEPROM we need to finish that. Write the 64 bytes of
+		      // data that are in the parse_tail array into the Off-
+		      // Board EEPROM.
+		      // At this point the eeprom_address_index will be pointing
+		      // at the start of the 64 byte EEPROM block that was being
+		      // processed when the out-of-sequence address was
+		      // encountereed.
+                      upload_write_page(pSocket, UPGRADE_FAIL_EEPROM_MISCOMPARE);
+		    }
+		  
+		    // Go to the non-sequential data processing
+                    pSocket->ParseState = PARSE_FILE_NONSEQ;
+                    // Clear byte_tail for subsequent reads
+                    byte_tail[0] = '\0';
+                    byte_tail[1] = '\0';
+		    
+		    // Set "address" to be equal to "new_address"
+		    address = new_address;
+		    
+		    // Indicate initial detection of the non-sequential data.
+		    // This is used to allow the processing to be re-entrant
+		    // should TCP Fragmentation occur.
+		    non_sequential_detect = 1;
+		    
+	            break;
+		  }
+	        }
+	      }
+	    
+              if (file_nBytes == 0) {
+                // We just read the last character in this packet. Break out
+                // of the local while loop so the next packet will be read.
+                break;
+              }
+	    } // End of local while() loop
+	  }
+
+
+          if (pSocket->ParseState == PARSE_FILE_SEQUENTIAL) {
+// UARTPrintf(" ParseState = PARSE_FILE_SEQUENTIAL\r\n");
+	    // This parse is entered knowing that the next two characters are a
+	    // data byte.
+	    while (1) {
+              // Read two characters from the SREC
+              pBuffer = read_two_characters(pBuffer);
+              if (byte_tail[0] == '\0') {
+	        // No characters were found. This can occur when an end of
+	        // packet occurs during a CRLF sequence. The read attempt will
+	        // have set file_nBytes to zero. Break out of the local while
+	        // loop so that the next packet will be read.
+	        break;
+	      }
+              if (byte_tail[1] == '\0') {
+                // We only found 1 character so we just read the last character
+	        // in this packet. The read_two_characters() function will have
+	        // set file_nBytes to zero. Break out of the local while loop so
+	        // the next packet will be read.
+                break;
+              }
+
+// {
+// uint8_t temp[3];
+// temp[0] = byte_tail[0];
+// temp[1] = byte_tail[1];
+// temp[2] = '\0';
+// UARTPrintf(temp);
+// }
+	    
+	      // If we didn't break out then we successfully read two characters
+              data_value = two_hex2int(byte_tail[0], byte_tail[1]);
+              checksum += data_value;
+              data_count--;
+              // Clear byte_tail for subsequent reads
+              byte_tail[0] = '\0';
+              byte_tail[1] = '\0';
+	      
+	      if (data_count > 0) {
+	        // Copy data to parse_tail
+	        parse_tail[parse_index++] = data_value;
+	        address++; // Increment the incoming address counter
+	      }
+	      
+	      if (data_count == 0) {
+// UARTPrintf("data_count 0\r\n");
+	        // We just read the last byte in this SREC. The byte just read
+	        // was the checksum. Check for validity.
+	        if (checksum != 0xff) {
+	          // Handle Checksum Error
+                  upgrade_failcode = UPGRADE_FAIL_FILE_READ_CHECKSUM;
+
+// UARTPrintf("checksum = ");
+// emb_itoa(checksum, OctetArray, 16, 4);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+	      
+// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_FILE_READ_CHECKSUM\r\n");
+                  pSocket->ParseState = PARSE_FILE_FAIL;
+		  break;
+	        }
+	      }
+	    
+	      if (parse_index == 64 && file_type == FILETYPE_PROGRAM) {
+// UARTPrintf("parse_index 64\r\n");
+	        // Copy parse_tail to Off-Board EEPROM0
+                upload_write_page(pSocket, UPGRADE_FAIL_EEPROM_MISCOMPARE);
+                eeprom_address_index += 64;
+              }
+	    
+	      if (parse_index == 64 && file_type == FILETYPE_STRING) {
+	        // Copy parse_tail to Off-Board EEPROM2
+                upload_write_page(pSocket, STRING_EEPROM_MISCOMPARE);
+                eeprom_address_index += 64;
+	      }
+
+	      if (parse_index == 64) {
+// UARTPrintf("parse_index64 clear for next data\r\n");
+	        // This is just a cleanup routine to make debug easier. This
+	        // will zero out the parse_tail array so that subsequent writes
+	        // to parse tail that end before filling it will be followed by
+	        // zeroes.
+	        for (i=0; i<64; i++) parse_tail[i] = 0;
+	        parse_index = 0; // Clear for next data
+	      }
+	      
+	      if (data_count == 0) {
+                // Go on to read next SREC
+                byte_index = 0;
+                pSocket->ParseState = PARSE_FILE_SEEK_SX;
+                break;
+	      }
+	    
+              if (file_nBytes == 0) {
+                // We just read the last character in this packet. Break out
+                // of the local while loop so the next packet will be read.
+                break;
+              }
+	    } // End of local while() loop
+	  }
+
+
+          if (pSocket->ParseState == PARSE_FILE_NONSEQ) {
+// UARTPrintf(" ParseState = PARSE_FILE_NONSEQ\r\n");
+            // This is a case where the new_address is not sequential with the
+	    // previous adddress.
+	    //
+	    // If this occurs then only the data in the SREC is copied to the
+	    // EEPROM, but it requires reading the existing data from the EEPROM
+	    // then inserting the new SREC data into the existing EEPROM data.
+	    //
+            // The "address" and "eeprom_address_index" values will be updated
+	    // according to the addressing values needed by this special case,
+	    // causing all new SREC addresses to be treated as non-sequential
+	    // until they start becoming sequential again.
+	    //
+	    // WHAT IF THE NON-SEQUENTIAL DATA OCCUPIES MORE THAN ONE SREC?
+	    // If the additional SRECs are sequential relative to the first non-
+	    // sequential address encountered they will be handled by the seq-
+	    // uential data processing routine. If the next SREC is non-sequen-
+	    // tial this routine will run again.
+	    //
+	    // WHAT IF THE NON-SEQUENTIAL SREC STARTS AT A POINT OTHER THAN 0
+	    // RELATIVE TO THE 64 BYTE WRITES TO EEPROM?
+	    // This is actually the typical case, so the code needs to read the
+	    // existing data from the EEPROM to preserve previously written
+	    // data, then an offset is calculated to determine the point that
+	    // new SREC data needs to start within the existing EEPROM data.
+	    // a) The data to read from the EEPROM is the 64 bytes starting at
+	    //    ((new_address - 0x8000) & 0xFFC0).
+	    // b) The offset into this data for writing the new data is
+	    //    (new_address & 0x003F).
+	    // NOTE: (a) and (b) are performed only once at the initial detect-
+	    // ion of a non-sequential SREC case. The "non_sequential_detect"
+	    // flag is used to manage this. This is necessary as TCP Fragmenta-
+	    // tion may cause the process to be re-entered.
+	    // c) Read the incoming SREC and write the contents to parse_tail.
+	    //    If the end of parse_tail is reached or the end of the SREC is
+	    //    reached write the parse_tail to the EEPROM.
+	    // d) If the end of the parse_tail is reached but there is still
+	    //    data in the incoming SREC then read the next 64 bytes from the
+	    //    EEPROM into parse_tail, and continue writing the incoming SREC
+	    //    data into the parse_tail starting at byte [0].
+	    //    When the end of the SREC is reached write the parse_tail to
+	    //    the EEPROM.
+	    // e) Exit comments: "address" and "eeprom_address_index" never get
+	    //    changed in this process so when this parsing completes we will
+	    //    go on to reading the next SREC. If that next SREC has a
+	    //    new_address lower than the current address the non-sequential
+	    //    process repeats. Otherwise the regular read SREC process runs.
+	    
+            // Why not use the above technique for every SREC?
+	    // Because it would result in twice as many writes to the EEPROM
+	    // taking a lot longer to do the programming. Twice as many writes
+	    // will occur because it is typical for the incoming data to be
+	    // skewed relative to the 64 byte writes to the EEPROM, and the
+	    // incoming SREC data is in 32 byte blocks as opposed to the 64 byte
+	    // blocks being written to the EEPROM.
+	  
+	    if (non_sequential_detect == 1) {
+// UARTPrintf("\r\nnon_sequential_detect == 1 ");
+	      // Calculate the starting index of the EEPROM block
+	      eeprom_address_index = (new_address - 0x8000) & 0xFFC0;
+	      
+#if UPLOAD_PIPELINE_SUPPORT == 1
+	      // The block may still be waiting in the upload_ring. Write out
+	      // everything queued so the read below sees the latest data.
+	      upload_ring_flush();
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+	      
+	      // Read the existing EEPROM data into parse_tail
+	      if (file_type == FILETYPE_PROGRAM) {
+                I2C_read_block(I2C_EEPROM0_WRITE, eeprom_address_index, parse_tail, 64);
+              }
+	      if (file_type == FILETYPE_STRING) {
+                I2C_read_block(I2C_EEPROM2_WRITE, eeprom_address_index, parse_tail, 64);
+              }
+	      
+	      // Set the offset into parse_tail for the new data.
+              parse_index = (uint8_t)(new_address & 0x003F);
+	      
+	      // Clear initial detect flag so this "if" section will be bypassed
+	      // if the code is re-entered due to handle TCP Fragmentation.
+	      non_sequential_detect = 0;
+// UARTPrintf("\r\nnon_sequential_detect EEPROM read completed");
+	    }
+	    
+	    // This parse is entered knowing that the next two characters are a
+	    // data byte, and that all the data of interest is contained in a
+	    // single incoming SREC.
+	    
+	    while (1) {
+              // Read two characters from the data line
+              pBuffer = read_two_characters(pBuffer);
+              if (byte_tail[0] == '\0') {
+	        // No characters were found. This can occur when an end of
+	        // packet occurs during a CRLF sequence. The read attempt will
+	        // have set file_nBytes to zero. Break out of the local while
+	        // loop so that the next packet will be read.
+	        break;
+	      }
+              if (byte_tail[1] == '\0') {
+                // We only found 1 character so we just read the last character
+	        // in this packet. The read_two_characters() function will have
+	        // set file_nBytes to zero. Break out of the local while loop so
+	        // the next packet will be read.
+                break;
+              }
+
+// {
+// uint8_t temp[3];
+// temp[0] = byte_tail[0];
+// temp[1] = byte_tail[1];
+// temp[2] = '\0';
+// UARTPrintf(temp);
+// }
+	    
+	      // If we didn't break out then we successfully read two characters
+              data_value = two_hex2int(byte_tail[0], byte_tail[1]);
+              checksum += data_value;
+	      data_count--;
+              // Clear byte_tail for subsequent reads
+              byte_tail[0] = '\0';
+              byte_tail[1] = '\0';
+	      
+	      if (data_count > 0) {
+	        // Copy data to parse_tail
+	        parse_tail[parse_index++] = data_value;
+	        address++; // Increment the incoming address counter
+	      }
+	      
+	      if (data_count == 0) {
+	        // We just read the last byte in this SREC. The byte just read
+	        // was the checksum. Check for validity.
+	        if (checksum != 0xff) {
+	          // Handle Checksum Error
+                  upgrade_failcode = UPGRADE_FAIL_FILE_READ_CHECKSUM;
+
+// UARTPrintf("checksum = ");
+// emb_itoa(checksum, OctetArray, 16, 4);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+	      
+// UARTPrintf("UPGRADE_FAILCODE = UPGRADE_FAIL_FILE_READ_CHECKSUM\r\n");
+                  pSocket->ParseState = PARSE_FILE_FAIL;
+		  break;
+	        }
+	        else {
+// UARTPrintf("\r\nnon_sequential_detect checksum completed");
+	        }
+	      }
+	      
+	      if (data_count == 0 || parse_index == 64) {
+                // Write the data in the parse_tail array into the Off-Board
+	        // EEPROM.
+                upload_write_page(pSocket, UPGRADE_FAIL_EEPROM_MISCOMPARE);
+	      }
+	      
+	      if (parse_index == 64 && data_count != 0) {
+	        // Hit end of parse_tail but still have data to read from this
+	        // SREC. Read the next 64 bytes from the EEPROM into parse_tail,
+	        // and continue writing the incoming SREC data into the
+	        // parse_tail starting at byte [0]. When the end of the SREC
+	        // data is reached write the parse_tail to the EEPROM.
+	        
+	        // Point to next block in EEPROM
+	        eeprom_address_index += 64;
+		
+#if UPLOAD_PIPELINE_SUPPORT == 1
+	        upload_ring_flush();
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+		
+                // Read the next existing EEPROM data into parse_tail
+	        if (file_type == FILETYPE_PROGRAM) {
+                  I2C_read_block(I2C_EEPROM0_WRITE, eeprom_address_index, parse_tail, 64);
+		}
+	        if (file_type == FILETYPE_STRING) {
+                  I2C_read_block(I2C_EEPROM2_WRITE, eeprom_address_index, parse_tail, 64);
+		}
+	    
+	        // The local while loop continues to finish reading the incoming
+	        // SREC.
+	      }
+	      
+	      if (parse_index == 64) {
+	        parse_index = 0; // Clear for next data
+	      }
+	      
+	      if (data_count == 0) {
+                // Go on to read next SREC
+                byte_index = 0;
+                pSocket->ParseState = PARSE_FILE_SEEK_SX;
+                break;
+	      }
+	      
+              if (file_nBytes == 0) {
+// UARTPrintf("\r\nnon_sequential_detect file_nBytes == 0");
+                // We just read the last character in this packet. Break out
+                // of the local while loop so the next packet will be read.
+                break;
+              }
+	    } // End of local while loop
+	  }
+	
+
+          if (pSocket->ParseState == PARSE_FILE_BIN_HEADER
+	   || pSocket->ParseState == PARSE_FILE_BIN_DATA) {
+	    // This parse handles a Network Module binary image instead of an
+	    // SREC file. The image is produced from the build's SREC output by
+	    // the tools/nm_pack.py script and carries the same content with
+	    // no hex encoding or record overhead, so less than half as many
+	    // bytes are uploaded.
+	    //
+	    // The image is a 16 byte header followed by the data:
+	    //   0-2   "NMB"
+	    //   3     Format version (BIN_IMAGE_VERSION)
+	    //   4     File type: 'N' Program file, 'S' String file (the same
+	    //         convention as the first data byte of the SREC S0 record)
+	    //   5     Reserved (0)
+	    //   6-7   Data length (big endian). A multiple of 128 bytes.
+	    //   8-11  CRC32 of the data (big endian)
+	    //   12-15 Build ID (big endian). Identifies the image for the
+	    //         user only. It is not checked here because the module
+	    //         cannot tell which build ID a compatible image should
+	    //         carry.
+	    // The data is the image from address 0x8000 upward in 128 byte
+	    // blocks, so data byte n goes to Off-Board EEPROM address n. The
+	    // data is written 64 bytes at a time with upload_write_page(), the
+	    // same as the SREC data.
+	    //
+	    // The header is collected in parse_tail. Bytes are read directly
+	    // from pBuffer as any byte value (including CR and LF) is valid.
+	    while (file_nBytes != 0) {
+	      if (pSocket->ParseState == PARSE_FILE_FAIL) break;
+	      
+	      data_value = *pBuffer;
+	      pBuffer++;
+	      file_nBytes--;
+	      file_length--;
+	      
+	      if (pSocket->ParseState == PARSE_FILE_BIN_HEADER) {
+	        parse_tail[parse_index++] = data_value;
+		if (parse_index == BIN_HEADER_SIZE) {
+		  bin_remaining = (uint16_t)(((uint16_t)parse_tail[6] << 8) | parse_tail[7]);
+		  bin_header_crc = ((uint32_t)parse_tail[8] << 24)
+		            | ((uint32_t)parse_tail[9] << 16)
+		            | ((uint32_t)parse_tail[10] << 8)
+		            | (uint32_t)parse_tail[11];
+		  if (parse_tail[4] == 'N') file_type = FILETYPE_PROGRAM;
+		  else file_type = FILETYPE_STRING;
+		  
+		  // Validate the header. The length must be a whole number of
+		  // 128 byte blocks and must fit the region being written: a
+		  // Program image must not reach the user reserved Flash, and a
+		  // String image must not run past EEPROM2 into EEPROM3.
+		  if (parse_tail[2] != 'B'
+		   || parse_tail[3] != BIN_IMAGE_VERSION
+		   || (parse_tail[4] != 'N' && parse_tail[4] != 'S')
+		   || bin_remaining == 0
+		   || (bin_remaining & 0x7f) != 0
+		   || (file_type == FILETYPE_PROGRAM
+		    && bin_remaining > OFFSET_TO_FLASH_START_USER_RESERVE)
+		   || (file_type == FILETYPE_STRING
+		    && bin_remaining > (I2C_EEPROM3_BASE - I2C_EEPROM2_BASE))) {
+                    upgrade_failcode = UPGRADE_FAIL_IMAGE_HEADER;
+                    pSocket->ParseState = PARSE_FILE_FAIL;
+		    break;
+		  }
+		  
+		  // Erase EEPROM0 for a Program file, as is done on receipt of
+		  // the SREC S0 record, so that any space not covered by the
+		  // image reads as zero. The length and CRC32 are kept for
+		  // check_upload_image() only for a Program file. A String
+		  // file is not written to EEPROM0, so it leaves them as they
+		  // were.
+		  if (file_type == FILETYPE_PROGRAM) {
+		    upload_erase_eeprom0();
+		    image_crc = bin_header_crc;
+		    image_length = bin_remaining;
+		  }
+		  
+		  for (i=0; i<64; i++) parse_tail[i] = 0;
+		  parse_index = 0;
+		  eeprom_address_index = 0;
+		  bin_crc = 0xffffffff;
+                  pSocket->ParseState = PARSE_FILE_BIN_DATA;
+		}
+	      }
+	      
+	      else if (pSocket->ParseState == PARSE_FILE_BIN_DATA) {
+	        bin_crc = crc32_update(bin_crc, data_value);
+	        parse_tail[parse_index++] = data_value;
+		if (parse_index == 64) {
+		  upload_write_page(pSocket, (uint8_t)(file_type == FILETYPE_PROGRAM ?
+		                    UPGRADE_FAIL_EEPROM_MISCOMPARE : STRING_EEPROM_MISCOMPARE));
+		  eeprom_address_index += 64;
+		  parse_index = 0;
+		}
+		bin_remaining--;
+		if (bin_remaining == 0) {
+		  if (~bin_crc != bin_header_crc) {
+                    upgrade_failcode = UPGRADE_FAIL_IMAGE_CRC;
+                    pSocket->ParseState = PARSE_FILE_FAIL;
+		    break;
+		  }
+		  if (pSocket->ParseState == PARSE_FILE_BIN_DATA) {
+		    pSocket->ParseState = PARSE_FILE_COMPLETE;
+		  }
+		}
+	      }
+	      
+	      // Else PARSE_FILE_COMPLETE. The remaining characters are the end
+	      // of the multipart boundary and are discarded.
+	    } // End of local while() loop
+	  }
+
+
+          if (pSocket->ParseState == PARSE_FILE_FAIL) {
+            // Abort parsing.
+	    // Enter a loop that will allow the Browser to finish sending
+	    // whatever it was sending.
+	    while (file_length > 0) {
+	      // Use the read_two_characters() function to deplete the incoming
+	      // packets. Once file_length reaches zero we've received all
+	      // packets.
+	      // Note that if we "break" it allows the program to fetch another
+	      // packet and then we return to this routine to read and deplete
+	      // that packet.
+	      // Also note that when file_length reaches zero file_nBytes should
+	      // also be zero if all is working correctly.
+	      
+              // Read two characters from the data line
+              pBuffer = read_two_characters(pBuffer);
+              IWDG_KR = 0xaa; // Prevent the IWDG from firing.
+	      if (file_length == 0) {
+	        // All packets read. Go on to the PARSE_FILE_FAIL_EXIT routine.
+	        pSocket->ParseState = PARSE_FILE_FAIL_EXIT;
+// UARTPrintf("\r\nSet ParseState to PARSE_FILE_FAIL_EXIT, break local loop\r\n");
+		break;
+              }
+              if (file_nBytes == 0) {
+                // The read_two_characters() function will set file_nBytes to
+	        // zero if an end of packet occurred. If so break out of the
+	        // local while loop so the next packet will be read.
+	        break;
+	      }
+	    } // End of local while loop
+	  }
+
+	  if (file_length == 0) {
+	    // All packets read.
+// UARTPrintf("\r\nAll packets read, break main loop\r\n");
+	    break; // Break out of mail while loop
+          }
+	  
+          if (file_nBytes == 0) {
+            // We just read the last character in this packet. Break out
+            // of the main while loop so the next packet will be read.
+
+// Diagnostic only
+// UARTPrintf("\r\nfile_length: ");
+// emb_itoa(file_length, OctetArray, 10, 5);
+// UARTPrintf(OctetArray);
+// UARTPrintf("  file_nBytes: ");
+// emb_itoa(file_nBytes, OctetArray, 10, 3);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+// UARTPrintf("XXXXXX-EOP-XXXXXX");
+            break; // Break out of main while loop
+          }
+        } // End of main while loop
+      }
+
+// UARTPrintf("\r\nExcuting code after main loop\r\n");
+// if (pSocket->ParseState == PARSE_FILE_FAIL_EXIT) {
+// UARTPrintf("\r\nParseState == PARSE_FILE_FAIL_EXIT\r\n");
+// }
+
+#if UPLOAD_PIPELINE_SUPPORT == 1
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE) {
+        // The last pages may still be in the upload_ring. They must all be
+	// written and verified before the response is sent (and before the
+	// main.c loop is asked to copy EEPROM0 to Flash). At most
+	// UPLOAD_RING_PAGES pages remain so this takes only a few ms.
+        upload_ring_flush();
+	if (upload_ring_fail) pSocket->ParseState = PARSE_FILE_FAIL_EXIT;
+      }
+      else if (pSocket->ParseState != PARSE_FILE_FAIL
+            && pSocket->ParseState != PARSE_FILE_FAIL_EXIT
+            && upload_ring_count > (UPLOAD_RING_PAGES - UPLOAD_RING_RESERVE)) {
+        // The next packet might decode to more pages than the upload_ring
+	// has room for. Close the receive window (uip_stop() makes uip
+	// advertise a zero window in the ACK for this packet). The window is
+	// re-opened from the uip_poll() code in HttpDCall() once the writer
+	// in the main.c loop has made room.
+        uip_stop();
+      }
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+    
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_PROGRAM) {
+        // Check the image CRC32 in EEPROM0 before the response page is
+	// chosen, so a failure is reported on the Parse Fail page instead of
+	// the Timer page. This takes about 1.5 seconds.
+        if (check_upload_image()) {
+          upgrade_failcode = UPGRADE_FAIL_IMAGE_CRC;
+          pSocket->ParseState = PARSE_FILE_FAIL_EXIT;
+	}
+      }
+
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_PROGRAM) {
+
+// UARTPrintf("\r\n");
+// UARTPrintf("File Upload Complete - entering 500ms pause");
+// UARTPrintf("\r\n");
+
+        // All data is now in Off-Board EEPROM0. Signal the main.c loop to
+	// copy the data to Flash and display a Timer window to have the
+	// user wait until Flash programming completes and the module reboots.
+	eeprom_copy_to_flash_request = I2C_COPY_EEPROM0_REQUEST;
+        pSocket->nParseLeft = 0;
+	
+	pSocket->current_webpage = WEBPAGE_TIMER;
+        pSocket->pData = g_HtmlPageTimer;
+        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageTimer) - 1);
+	
+	// Send the response
+        pSocket->nPrevBytes = 0xFFFF;
+        pSocket->nState = STATE_SENDHEADER200;
+      }
+
+
+      if (pSocket->ParseState == PARSE_FILE_COMPLETE && file_type == FILETYPE_STRING) {
+
+// UARTPrintf("\r\n");
+// UARTPrintf("File Upload Complete - entering 500ms pause");
+// UARTPrintf("\r\n");
+
+        // All data is now in Off-Board EEPROM2.
+	// Display the Upload Complete GUI.
+        pSocket->nDataLeft = 0;
+        pSocket->nParseLeft = 0;
+	
+	pSocket->current_webpage = WEBPAGE_UPLOAD_COMPLETE;
+        pSocket->pData = g_HtmlPageUploadComplete;
+        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageUploadComplete) - 1);
+	
+        // Send the response
+        pSocket->nPrevBytes = 0xFFFF;
+        pSocket->nState = STATE_SENDHEADER200;
+      }
+
+
+      if (pSocket->ParseState == PARSE_FILE_FAIL_EXIT) {
+        // Parsing aborted. Display a GUI with the fail reason code.
+
+// UARTPrintf("\r\n");
+// UARTPrintf("Parse FAIL XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
+// UARTPrintf("\r\n");
+
+	// Display the fail reason and tell the user to try again.
+        pSocket->nParseLeft = 0;
+	pSocket->current_webpage = WEBPAGE_PARSEFAIL;
+        pSocket->pData = g_HtmlPageParseFail;
+        pSocket->nDataLeft = (uint16_t)(sizeof(g_HtmlPageParseFail) - 1);
+	// Send the response
+        pSocket->nPrevBytes = 0xFFFF;
+        pSocket->nState = STATE_SENDHEADER200;
+      }
+    }
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+    if (pSocket->nState == STATE_SENDHEADER200) {
+
+// UARTPrintf("HttpDCall: SENDHEADER200\r\n");
+
+      // This step is usually entered after GET processing is complete in
+      // order to send an appropriate web page in response to the GET request.
+      // In the uip_send() call we provide the CopyHttpHeader function with
+      // the length of the web page.
+      // Some GET requests do not send a webpage response (just a header with
+      // 0 data). In those cases STATE_SENDHEADER204 will have been entered
+      // from GET processing.
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+      // The IOControl page may be sent from the render cache. The
+      // render_cache_start() function sets the next state.
+      if (pSocket->current_webpage == WEBPAGE_IOCONTROL) {
+        uip_send(uip_appdata, CopyHttpHeader(uip_appdata, render_cache_start(pSocket)));
+        return;
+      }
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, adjust_template_size(pSocket)));
+      pSocket->nState = STATE_SENDDATA;
+      return;
+    }
+      
+    if (pSocket->nState == STATE_SENDHEADER204) {
+
+// UARTPrintf("HttpDCall: SENDHEADER204\r\n");
+
+      // This step is entered after POST is complete.
+      // This step is also entered after GET processing is complete if no
+      // webpage reply is required.
+      // In both of these cases we only send a header with Content Length: 0
+      // and no data is sent.
+      // Note: After POST of an IOControl or Configuration page no webpage is
+      // automatically sent. The javascript in those pages will generate a GET
+      // request to update the Browser after the POST is sent.
+      // Note: It is not clear if some browsers require a "204 No Content"
+      // header. This appears to work just returning a "200 OK" with Content
+      // Length: 0.
+      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, 0));
+      // Clear nDataLeft and go to STATE_SENDDATA, but only to close
+      // connection.
+      pSocket->nDataLeft = 0;
+      pSocket->nState = STATE_SENDDATA;
+      return;
+    }
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    if (pSocket->nState == STATE_SENDEVENTHEADER) {
+      // Send the Event Stream header, then hold the connection open. The
+      // tracking values are set so that the first poll after the header is
+      // acknowledged sends a record with the present pin states.
+      uip_send(uip_appdata, CopyEventHeader(uip_appdata));
+      pSocket->nParseLeft = (uint16_t)(~event_pin_states());
+      pSocket->ParseNum = event_temperature_seq;
+      pSocket->ParseCmd = (uint8_t)((uint8_t)t100ms_ctr1 - EVENT_STREAM_COALESCE);
+      pSocket->nDataLeft = (uint16_t)second_counter;
+      pSocket->nPrevBytes = 0xFFFF;
+      pSocket->nState = STATE_EVENTSTREAM;
+      return;
+    }
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+    senddata:
+    if (pSocket->nState == STATE_SENDDATA) {
+      // We have sent the HTML Header or HTML Data previously. Now we send
+      // data using the CopyHttpData() function as a pre-processor, and the
+      // uip_send() function to actually copy data from the internal buffer
+      // to the ENC28J60 hardware.
+      // Data is always sent at the end of a "uip_newdata()" as a response to
+      // a Browser request.
+      // When transmitting data to the Browser there may be more data than
+      // will fit in one packet. For instance transmitting one of the Webpage
+      // templates can easily take 10 or more transmit packets. So, additional
+      // data (if any) will be sent on return to this function in response to
+      // "uip_acked()". Whether or not there is additional data to send in a
+      // series of packets is tracked in the nDataLeft variable.
+      // If there is no data to send, or if all data has been sent, we close
+      // the connection.
+
+// UARTPrintf("Send Data, off_board_eeprom_index: ");
+// emb_itoa(off_board_eeprom_index, OctetArray, 16, 4);
+// UARTPrintf(OctetArray);
+// UARTPrintf("\r\n");
+
+      if (pSocket->nDataLeft == 0) {
+        // There is no data to send. Close connection
+        nBufSize = 0;
+      }
+      else {
+        // Copy data to buffer
+        pSocket->nPrevBytes = pSocket->nDataLeft;
+        nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
+        pSocket->nPrevBytes -= pSocket->nDataLeft;
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+        if (pSocket == render_cache_filler) render_cache_fill(pSocket, nBufSize);
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+      }
+
+      if (nBufSize == 0) {
+        //No Data has been copied (or there was none to send). Close connection
+        uip_close();
+      }
+      else {
+        //Else send copied data
+        uip_send(uip_appdata, nBufSize);
+      }
+      
+      return;
+    }
+
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+    if (pSocket->nState == STATE_SENDCACHE) {
+      render_cache_send(pSocket);
+      return;
+    }
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+  }
+  
+  else if (uip_rexmit()) {
+
+// UARTPrintf("HttpDCall: uip_rexmit\r\n");
+
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    if (pSocket->nState == STATE_EVENTSTREAM) {
+      // Re-create the last Event Stream header or record. A data record is
+      // built from the values captured when it was first sent, so the
+      // retransmit matches what uip expects.
+      if (pSocket->nPrevBytes == 0xFFFF) {
+        uip_send(uip_appdata, CopyEventHeader(uip_appdata));
+      }
+      else if (pSocket->nPrevBytes == 0) {
+        uip_send(uip_appdata, stpcpy(uip_appdata, ":\n\n") - (char *)uip_appdata);
+      }
+      else {
+        uip_send(uip_appdata, CopyEventRecord(uip_appdata, pSocket));
+      }
+      return;
+    }
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+    if (pSocket->nState == STATE_SENDCACHE) {
+      // Re-send the header, or back up over the last packet and read it
+      // from the cache again.
+      if (pSocket->nPrevBytes == 0xFFFF) {
+        uip_send(uip_appdata, CopyHttpHeader(uip_appdata, pSocket->nParseLeft));
+      }
+      else {
+        pSocket->nDataLeft += pSocket->nPrevBytes;
+        render_cache_send(pSocket);
+      }
+      return;
+    }
+    // A retransmit while filling the cache would write the same packet
+    // twice. This is rare, so just give up on the fill.
+    if (pSocket == render_cache_filler) render_cache_filler = NULL;
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+
+    if (pSocket->nPrevBytes == 0xFFFF) {
+      // Send header again
+      uip_send(uip_appdata, CopyHttpHeader(uip_appdata, adjust_template_size(pSocket)));
+    }
+    else {
+
+// UARTPrintf("XXXX RETRANSMIT XXXX\r\n");
+
+      // The pData pointer needs to be moved back by the number of bytes
+      // consumed from the webpage template.
+      pSocket->pData -= pSocket->nPrevBytes;
+      
+#if OB_EEPROM_SUPPORT == 1
+      // A similar adjustment is required for off_board_eeprom_index when
+      // the webpage is sourced from Off-Board EEPROM.
+      off_board_eeprom_index -= pSocket->nPrevBytes;
+#endif // OB_EEPROM_SUPPORT == 1
+      
+      pSocket->nDataLeft += pSocket->nPrevBytes;
+      pSocket->nPrevBytes = pSocket->nDataLeft;
+      nBufSize = CopyHttpData(uip_appdata, &pSocket->pData, &pSocket->nDataLeft, uip_mss(), pSocket);
+      pSocket->nPrevBytes -= pSocket->nDataLeft;
+      
+      if (nBufSize == 0) {
+        //No Data has been copied. Close connection
+        uip_close();
+      }
+      else {
+        //Else send copied data
+        uip_send(uip_appdata, nBufSize);
+      }
+    }
+    return;
+  }
+
+#if (EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD) || FAIR_SCHEDULER_SUPPORT == 1 || (UPLOAD_PIPELINE_SUPPORT == 1 && BUILD_SUPPORT == CODE_UPLOADER_BUILD)
+  else if (uip_poll()) {
+    // uip polls every established connection with no outstanding data when
+    // the periodic timer fires. Ordinary page transfers are driven by
+    // uip_acked(), so a poll only needs action for an open Event Stream, for
+    // a page packet that the scheduler in uip_TcpAppHubCall() deferred, or
+    // for a firmware upload that is waiting for room in the upload_ring.
+#if UPLOAD_PIPELINE_SUPPORT == 1 && BUILD_SUPPORT == CODE_UPLOADER_BUILD
+    if (uip_stopped(uip_conn)
+     && upload_ring_count <= (UPLOAD_RING_PAGES - UPLOAD_RING_RESERVE)) {
+      // uip_restart() clears the stopped flag and sets UIP_NEWDATA so that
+      // uip sends a pure ACK advertising the full window. That tells the
+      // Browser to resume sending.
+      uip_restart();
+      return;
+    }
+#endif // UPLOAD_PIPELINE_SUPPORT == 1 && BUILD_SUPPORT == CODE_UPLOADER_BUILD
+#if EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    if (pSocket->nState == STATE_EVENTSTREAM) event_stream_poll(pSocket);
+#endif // EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD
+#if FAIR_SCHEDULER_SUPPORT == 1
+    if (pSocket->nState == STATE_SENDDATA) goto senddata;
+#if IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+    if (pSocket->nState == STATE_SENDCACHE) goto senddata;
+#endif // IOCONTROL_CACHE_SUPPORT == 1 && BUILD_SUPPORT != CODE_UPLOADER_BUILD
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  }
+#endif // (EVENT_STREAM_SUPPORT == 1 && BUILD_SUPPORT == BROWSER_ONLY_BUILD) || FAIR_SCHEDULER_SUPPORT == 1 || (UPLOAD_PIPELINE_SUPPORT == 1 && BUILD_SUPPORT == CODE_UPLOADER_BUILD)
+}
+
+
+
+#if BUILD_SUPPORT == CODE_UPLOADER_BUILD
+static void upload_erase_eeprom0(void)
+{
+  // Erase EEPROM0 to provide a clean space to store an incoming Program
+  // file. 256 blocks of 128 bytes are written with zero.
+  uint16_t i;
+  uint8_t j;
+  
+#if UPLOAD_PIPELINE_SUPPORT == 1
+  upload_ring_flush();
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+  
+  for (i=0; i<256; i++) {
+    I2C_control(I2C_EEPROM0_WRITE); // Send Write Control Byte
+    I2C_byte_address((uint16_t)(i * 128));
+    for (j=0; j<128; j++) {
+      // Write a zero byte
+      I2C_write_byte(0);
+    }
+    I2C_stop(); // Start the EEPROM internal write cycle
+    IWDG_KR = 0xaa; // Prevent the IWDG from firing.
+    // Wait for completion of write using "acknowledge polling" (see the
+    // 24AA1025 EEPROM spec).
+    I2C_write_wait(I2C_EEPROM0_WRITE); // Wait for write cycle to complete
+  }
+}
+
+
+static uint8_t upload_page_differs(uint8_t control, uint16_t address, uint8_t *data)
+{
+  // Read back the 64 byte page at address in the Off-Board EEPROM selected
+  // by control (the Write Control Byte) and compare it to data. Returns 1
+  // if any byte differs.
+  // The page is read with a single addressing sequence and compared as it
+  // is clocked in, so no buffer is needed. The read is left open while the
+  // bytes match. If a byte differs the read stops there and is ended with
+  // I2C_read_close().
+  uint8_t i;
+  
+  prep_read(control, (uint8_t)(control | 0x01), address);
+  I2C_read_open = 1;
+  for (i=0; i<63; i++) {
+    if (I2C_read_byte(0) != data[i]) {
+      I2C_read_close();
+      return 1;
+    }
+  }
+  I2C_read_open = 0;
+  // The last byte is read with NACK and STOP
+  if (I2C_read_byte(1) != data[63]) return 1;
+  return 0;
+}
+
+
+static void upload_write_page(struct tHttpD* pSocket, uint8_t failcode)
+{
+  // Write the 64 bytes of data that are in the parse_tail array into the
+  // Off-Board EEPROM at eeprom_address_index, then validate the data. If the
+  // validation fails "failcode" is placed in upgrade_failcode and the parse
+  // is sent to PARSE_FILE_FAIL.
+  //
+  // With UPLOAD_PIPELINE_SUPPORT the page is only copied into the
+  // upload_ring here and the write and validation are done later by
+  // upload_ring_service() in the main.c loop. That lets the HttpDCall()
+  // return (and uip ACK the packet) without waiting for the EEPROM write
+  // cycle. If the upload_ring is full the oldest page is written now.
+#if UPLOAD_PIPELINE_SUPPORT == 1
+  struct upload_page_t *page;
+  uint8_t i;
+  
+  while (upload_ring_count == UPLOAD_RING_PAGES) {
+    upload_ring_service();
+    IWDG_KR = 0xaa; // Prevent the IWDG from firing.
+  }
+  
+  page = &upload_ring[upload_ring_head];
+  page->address = eeprom_address_index;
+  page->failcode = failcode;
+  for (i=0; i<64; i++) page->data[i] = parse_tail[i];
+  upload_ring_head++;
+  if (upload_ring_head == UPLOAD_RING_PAGES) upload_ring_head = 0;
+  upload_ring_count++;
+  
+  if (upload_ring_fail) pSocket->ParseState = PARSE_FILE_FAIL;
+#else // UPLOAD_PIPELINE_SUPPORT == 0
+  int i;
+  
+  // Send Write Control Byte
+  if (file_type == FILETYPE_PROGRAM) {
+    I2C_control(I2C_EEPROM0_WRITE);
+  }
+  if (file_type == FILETYPE_STRING) {
+    I2C_control(I2C_EEPROM2_WRITE);
+  }
+  I2C_byte_address(eeprom_address_index);
+  for (i=0; i<64; i++) {
+    I2C_write_byte(parse_tail[i]);
+  }
+  I2C_stop();
+  I2C_write_wait((uint8_t)(file_type == FILETYPE_PROGRAM ?
+                           I2C_EEPROM0_WRITE : I2C_EEPROM2_WRITE));
+  IWDG_KR = 0xaa; // Prevent the IWDG from firing.
+  
+  // Validate data in Off-Board EEPROM
+  if (upload_page_differs((uint8_t)(file_type == FILETYPE_PROGRAM ?
+                                    I2C_EEPROM0_WRITE : I2C_EEPROM2_WRITE),
+                          eeprom_address_index, parse_tail)) {
+    upgrade_failcode = failcode;
+// UARTPrintf("UPGRADE_FAILCODE = EEPROM MISCOMPARE\r\n");
+    pSocket->ParseState = PARSE_FILE_FAIL;
+  }
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+}
+
+
+#if UPLOAD_PIPELINE_SUPPORT == 1
+void upload_ring_service(void)
+{
+  // Background writer for the firmware upload pipeline. Called on every
+  // pass of the main.c loop. Each call does one step for the oldest page in
+  // the upload_ring:
+  // UPLOAD_RING_IDLE  Send the page to the Off-Board EEPROM and start the
+  //                   EEPROM internal write cycle.
+  // UPLOAD_RING_BUSY  Check if the write cycle is complete (acknowledge
+  //                   polling). If it is, read the page back to validate it
+  //                   and release the upload_ring entry.
+  // None of the steps wait for the EEPROM, so uip keeps receiving upload
+  // packets while pages are being written.
+  struct upload_page_t *page;
+  uint8_t control;
+  uint8_t i;
+  
+  if (upload_ring_count == 0) return;
+  
+  page = &upload_ring[upload_ring_tail];
+  control = (uint8_t)(file_type == FILETYPE_PROGRAM ? I2C_EEPROM0_WRITE : I2C_EEPROM2_WRITE);
+  
+  if (upload_ring_state == UPLOAD_RING_IDLE) {
+    I2C_control(control); // Send Write Control Byte
+    I2C_byte_address(page->address);
+    for (i=0; i<64; i++) {
+      I2C_write_byte(page->data[i]);
+    }
+    I2C_stop(); // Start the EEPROM internal write cycle
+    upload_ring_polls = 0;
+    upload_ring_state = UPLOAD_RING_BUSY;
+    return;
+  }
+  
+  // UPLOAD_RING_BUSY
+  if (I2C_write_done(control) == 0) {
+    // Still writing. Give up waiting after UPLOAD_RING_POLL_LIMIT polls
+    // (well beyond the 5ms maximum write cycle) and let the validation
+    // report the failure.
+    if (++upload_ring_polls < UPLOAD_RING_POLL_LIMIT) return;
+    I2C_failcode = I2C_FAIL_WRITE_TIMEOUT;
+  }
+  
+  // Validate data in Off-Board EEPROM
+  if (upload_page_differs(control, page->address, page->data)) {
+    upgrade_failcode = page->failcode;
+    upload_ring_fail = 1;
+  }
+  
+  upload_ring_tail++;
+  if (upload_ring_tail == UPLOAD_RING_PAGES) upload_ring_tail = 0;
+  upload_ring_count--;
+  upload_ring_state = UPLOAD_RING_IDLE;
+}
+
+
+void upload_ring_flush(void)
+{
+  // Run the upload_ring writer until all queued pages are written and
+  // validated. Used where the parser is about to read the Off-Board EEPROM
+  // and at the end of the upload.
+  while (upload_ring_count != 0) {
+    upload_ring_service();
+    IWDG_KR = 0xaa; // Prevent the IWDG from firing.
+  }
+}
+#endif // UPLOAD_PIPELINE_SUPPORT == 1
+
+
+void eeprom_erase_service(void)
+{
+  // Background job for the /74 Erase Off-Board EEPROM command. Called on
+  // every pass of the main.c loop. Each call does one step:
+  // EEPROM_ERASE_WRITE  Write a 128 byte block of zeros and start the
+  //                     EEPROM internal write cycle.
+  // EEPROM_ERASE_BUSY   Check if the write cycle is complete (acknowledge
+  //                     polling). If it is, move on to the next block.
+  // Blocks 0 to 1023 cover the four 32KB regions in order:
+  //   0-255    EEPROM0 (I2C_EEPROM0 Control Bytes, base 0x0000)
+  //   256-511  EEPROM1 (I2C_EEPROM1 Control Bytes, base 0x8000)
+  //   512-767  EEPROM2 (I2C_EEPROM2 Control Bytes, base 0x0000)
+  //   768-1023 EEPROM3 (I2C_EEPROM3 Control Bytes, base 0x8000)
+  // so bit 0x0200 of the block number selects the device and bit 0x0100
+  // selects the 32KB half of the device.
+  // eeprom_erase_block doubles as the progress count reported by /76.
+  uint8_t control;
+  uint8_t i;
+  
+  if (eeprom_erase_state != EEPROM_ERASE_WRITE
+   && eeprom_erase_state != EEPROM_ERASE_BUSY) return;
+  
+  control = (uint8_t)((eeprom_erase_block & 0x0200) ? I2C_EEPROM2_WRITE : I2C_EEPROM0_WRITE);
+  
+  if (eeprom_erase_state == EEPROM_ERASE_WRITE) {
+    I2C_control(control); // Send Write Control Byte
+    I2C_byte_address((uint16_t)(((eeprom_erase_block & 0x0100) ? 0x8000 : 0x0000)
+                              | ((eeprom_erase_block & 0x00ff) << 7)));
+    for (i=0; i<128; i++) {
+      // Write a zero byte
+      I2C_write_byte(0);
+    }
+    I2C_stop(); // Start the EEPROM internal write cycle
+    eeprom_erase_polls = 0;
+    eeprom_erase_state = EEPROM_ERASE_BUSY;
+    return;
+  }
+  
+  // EEPROM_ERASE_BUSY
+  if (I2C_write_done(control) == 0) {
+    // Still writing. Give up after EEPROM_ERASE_POLL_LIMIT polls (well
+    // beyond the 5ms maximum write cycle).
+    if (++eeprom_erase_polls < EEPROM_ERASE_POLL_LIMIT) return;
+    I2C_failcode = I2C_FAIL_WRITE_TIMEOUT;
+    eeprom_erase_state = EEPROM_ERASE_FAIL;
+    return;
+  }
+  
+  eeprom_erase_block++;
+  if (eeprom_erase_block == EEPROM_ERASE_BLOCKS) eeprom_erase_state = EEPROM_ERASE_IDLE;
+  else eeprom_erase_state = EEPROM_ERASE_WRITE;
+}
+
+
+char *read_two_characters(char *pBuffer)
+{
+  // This function attempts to read two bytes from the SREC file.
+  // - Normal function is that two bytes are read.
+  // - The function must also handle the case where we only need to read one
+  //   byte because a byte was already read at the tail of a previous packet.
+  // - The function must also handle the case where we can only read one byte
+  //   because it is the last remaining byte in a packet.
+  // - The function discards any CR or LF character
+  //
+  // The function updates and returns the pBuffer pointer as bytes are consum-
+  // ed from the incoming data buffer.
+  //
+  // The function updates the byte_tail string with the bytes read from the
+  // incoming data buffer.
+  //
+  // The function updates the nParseLeft and file_nBytes counters.
+
+  if ((byte_tail[0] != '\0') && (byte_tail[1] == '\0')) {
+    // This is a check for TCP Fragmentation during a prior packet. byte_tail
+    // will have length 0 if no prior fragmentation occurred. If TCP Fragment-
+    // ation DID occur then byte_tail[0] will contain the last byte read from the
+    // SREC file and byte_tail[1] will contain NULL.
+    // Note that the SREC file is read one byte at a time, but a two byte pair
+    // is needed for any processing to occur. So, if only one byte of the two
+    // byte pair is captured when a packet boundary is encountered that byte
+    // must be saved in byte_tail so that the two bye pair can be completed
+    // and processed when the next packet is received.
+    // We have to account for the case where the single byte read in the
+    // previous packet is followed by CR or LF. In that case we discard the
+    // CR and LF and go on to read the next valid character.
+    
+    while (1) {
+      if (*pBuffer != '\r' && *pBuffer != '\n') {
+        byte_tail[1] = *pBuffer;
+        pBuffer++;
+        file_nBytes--;
+	file_length--; // Decrement the file_length for every character read
+	break;
+      }
+      else {
+        // Ignore the CR or LF
+        pBuffer++;
+        file_nBytes--;
+	file_length--; // Decrement the file_length for every character read
+	if (file_nBytes == 0) break;
+      }
+    }
+    byte_tail[2] = '\0';
+    return pBuffer;
+  }
+
+  else {
+    // We are starting with an empty byte_tail. Fill with any remaining bytes
+    // in the packet, but ignore CR and LF.
+    if (file_nBytes != 0) {
+      while (1) {
+        if (*pBuffer != '\r' && *pBuffer != '\n') {
+          byte_tail[0] = *pBuffer;
+          pBuffer++;
+          file_nBytes--;
+          file_length--; // Decrement the file_length for every character read
+          break;
+        }
+        else {
+          // Ignore the CR or LF
+          pBuffer++;
+          file_nBytes--;
+          file_length--; // Decrement the file_length for every character read
+  	  if (file_nBytes == 0) break;
+        }
+      }
+    }
+    
+    if (file_nBytes != 0) {
+      while (1) {
+        if (*pBuffer != '\r' && *pBuffer != '\n') {
+          byte_tail[1] = *pBuffer;
+          pBuffer++;
+          file_nBytes--;
+          file_length--; // Decrement the file_length for every character read
+          break;
+        }
+        else {
+          // Ignore the CR or LF
+          pBuffer++;
+          file_nBytes--;
+          file_length--; // Decrement the file_length for every character read
+  	  if (file_nBytes == 0) break;
+        }
+      }
+    }
+    byte_tail[2] = '\0';
+    return pBuffer;
+  }
+}
+#endif // BUILD_SUPPORT == CODE_UPLOADER_BUILD
+
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+// POST field handlers
+// Each handler is called once a complete POST component value has been
+// collected in parse_tail. The handler converts the value and applies it to
+// the appropriate Pending_ variable(s). The handlers are called through the
+// post_field[] table below indexed by ParseCmd.
+
+static void post_string(struct tHttpD* pSocket)
+{
+  // 'a' = Update the Device Name field
+  // 'l' = Update the MQTT Username field
+  // 'm' = Update the MQTT Password field
+  // 'j' = Update the IO Name field
+  //
+  // POST data for strings can consist of anything from 0 to the maximum
+  // number of characters for the field. parse_tail is zero filled beyond the
+  // collected characters so it can be copied as-is.
+  
+  // Notes on the "current_webpage" logic.
+  // When parsing a POST we need to know if the POST came from a IOControl
+  // page or from a Configuation page. The IOControl page starts with a 'h'
+  // value, while the Configuration page starts with a 'a' value. If we have
+  // not encountered a 'a' value yet the current_webpage will be NULL. Now
+  // that we see a 'a' value we now know we are receiving a POST from a
+  // Configuration page. Setting current_webpage here is important to
+  // subsequent POST processing decisions.
+  pSocket->current_webpage = WEBPAGE_CONFIGURATION;
+
+  switch (pSocket->ParseCmd)
+  {
+    case 'a':
+      memcpy(Pending_devicename, parse_tail, 19);
+      break;
+    case 'l':
+      memcpy(Pending_mqtt_username, parse_tail, 10);
+      break;
+    case 'm':
+      memcpy(Pending_mqtt_password, parse_tail, 10);
+      break;
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+    case 'j':
+      // Ignore IO Names for pins that don't exist
+      if (pSocket->ParseNum > 15) break;
+      unlock_flash();
+      if (strcmp(IO_NAME[pSocket->ParseNum], (char *)parse_tail) != 0) {
+        // The write to Flash will occur 4 bytes at a time to reduce Flash
+	// wear. All 16 bytes reserved in the Flash for a given IO Name will be
+	// written at one time in a sequence of 4 byte "word" writes.
+        int i;
+        i = 0;
+        while(i<16) {
+          FLASH_CR2 = 0x40;
+          FLASH_NCR2 = 0xBF;
+          memcpy(&IO_NAME[pSocket->ParseNum][i], &parse_tail[i], 4);
+          i += 4;
+        }
+      }
+      lock_flash();
+      break;
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  }
+}
+
+
+static void post_ip(struct tHttpD* pSocket)
+{
+  // 'b' = Update the "pending" IP address, Gateway address, Netmask, or MQTT
+  // Host IP address which will then cause the main.c functions to restart
+  // the software.
+  // The value consists of eight hex nibbles ('0' to 'f') representing the 4
+  // octets of the address, most significant octet first.
+  uint8_t* pAddr;
+  int i;
+  
+  switch(pSocket->ParseNum)
+  {
+    case 0:  pAddr = Pending_hostaddr;       break;
+    case 4:  pAddr = Pending_draddr;         break;
+    case 8:  pAddr = Pending_netmask;        break;
+    case 12: pAddr = Pending_mqttserveraddr; break;
+    default: return;
+  }
+  for (i=0; i<4; i++) {
+    pAddr[3 - i] = two_hex2int(parse_tail[i*2], parse_tail[i*2 + 1]);
+  }
+}
+
+
+static void post_port(struct tHttpD* pSocket)
+{
+  // 'c' = Update the "pending" HTTP Port number (ParseNum == 0) or MQTT Port
+  // number (ParseNum == 1) which will then cause the main.c functions to
+  // restart the software.
+  // The value consists of four hex nibbles with the port number.
+  uint16_t temp;
+  
+  temp = (uint16_t)((two_hex2int(parse_tail[0], parse_tail[1]) << 8)
+                   | two_hex2int(parse_tail[2], parse_tail[3]));
+  if (temp > 9) { // Make change only if valid entry
+    if (pSocket->ParseNum == 0) Pending_port = temp;
+    else Pending_mqttport = temp;
+  }
+}
+
+
+static void post_mac(struct tHttpD* pSocket)
+{
+  // 'd' = Update the "pending" MAC address which will then cause the main.c
+  // functions to restart the software.
+  // The value consists of twelve hex nibbles. Note that the byte order is
+  // reversed in Pending_uip_ethaddr_oct.
+  int i;
+  
+  for (i=0; i<6; i++) {
+    Pending_uip_ethaddr_oct[5 - i] = two_hex2int(parse_tail[i*2], parse_tail[i*2 + 1]);
+  }
+}
+
+
+static void post_config(struct tHttpD* pSocket)
+{
+  // 'g' = Update the Config Settings byte which defines the DS18B20, MQTT,
+  // Full/Half Duplex, and Home Assistant Auto Discovery functionality.
+  // The value consists of two hex nibbles.
+  Pending_config_settings = two_hex2int(parse_tail[0], parse_tail[1]);
+}
+
+
+static void post_pin_control(struct tHttpD* pSocket)
+{
+  // 'h' = Update the Pending_pin_control bytes.
+  // The value consists of 32 characters in 16 pairs of hex encoded nibbles,
+  // each pair representing a pin control byte.
+  // The Configuration page updates all bits except the ON/OFF bit.
+  // The IOControl page only updates the ON/OFF bit.
+  int i;
+  uint8_t k;
+  uint8_t keep_mask;
+  
+  // The IOControl page starts with a 'h' value, so if we have not
+  // encountered a 'a' value yet the current_webpage will be NULL and we know
+  // we are receiving a POST from an IOControl page.
+  if (pSocket->current_webpage == WEBPAGE_NULL) {
+    pSocket->current_webpage = WEBPAGE_IOCONTROL;
+  }
+  
+  if (pSocket->current_webpage == WEBPAGE_CONFIGURATION) keep_mask = 0x80;
+  else keep_mask = 0x7f;
+  
+  for (i=0; i<16; i++) {
+    k = two_hex2int(parse_tail[i*2], parse_tail[i*2 + 1]);
+    // Keep the bits the page does not control and "OR" in the changed bits
+    Pending_pin_control[i] = (uint8_t)((pin_control[i] & keep_mask) | (k & (uint8_t)~keep_mask));
+  }
+}
+
+
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+static void post_timer(struct tHttpD* pSocket)
+{
+  // 'i' = Update the IO Timer units and value in Pending_IO_TIMER so that the
+  // main.c functions will write them to Flash.
+  // The value consists of four hex nibbles.
+  // Upper 2 bits are units
+  // Lower 14 bits are value
+  // Timers for pins that don't exist are ignored.
+  if (pSocket->ParseNum > 15) return;
+  Pending_IO_TIMER[pSocket->ParseNum] =
+    (uint16_t)((two_hex2int(parse_tail[0], parse_tail[1]) << 8)
+              | two_hex2int(parse_tail[2], parse_tail[3]));
+}
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+
+
+// POST field dispatch table, indexed by ParseCmd - 'a'. Each entry provides
+// the handler and the maximum number of value characters collected for the
+// field. Entries with a NULL handler are unused commands; their value is
+// skipped.
+struct post_field_t {
+  void (*handler)(struct tHttpD* pSocket);
+  uint8_t max_len;
+};
+
+static const struct post_field_t post_field[] = {
+  { post_string,      19 }, // 'a' Device Name
+  { post_ip,           8 }, // 'b' IP/Gateway/Netmask/MQTT Server
+  { post_port,         4 }, // 'c' HTTP/MQTT Port
+  { post_mac,         12 }, // 'd' MAC
+  { 0,                 0 }, // 'e'
+  { 0,                 0 }, // 'f'
+  { post_config,       2 }, // 'g' Config settings
+  { post_pin_control, 32 }, // 'h' Pin Control string
+#if BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  { post_timer,        4 }, // 'i' IO Timer
+  { post_string,      15 }, // 'j' IO Name
+#else
+  { 0,                 0 }, // 'i'
+  { 0,                 0 }, // 'j'
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD
+  { 0,                 0 }, // 'k'
+  { post_string,      10 }, // 'l' MQTT Username
+  { post_string,      10 }  // 'm' MQTT Password
+};
+
+
+uint16_t parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes) {
+  // This function parses data the user entered in the GUI (usually when they
+  // click on the "submit" button on a webpage). POST data consists of
+  // components of the form:
+  //   One character with a ParseCmd
+  //   Two digits with a ParseNum indicating the item to be changed
+  //   One character with an equal sign
+  //   A variable number of characters with the new value of the item
+  //   One character with a Parse Delimiter (an '&')
+  // The final component is the hidden "z00=0" which marks the end of the
+  // POST.
+  //
+  // The parser is a single pass state machine that consumes the POST data
+  // in place in the uip_buf one character at a time. If a packet ends at any
+  // point (a "TCP Fragment") the parse simply returns and continues with the
+  // next packet. The only state carried between packets is:
+  //   pSocket->ParseState - where we are within a POST component
+  //   pSocket->ParseCmd   - the component command character
+  //   pSocket->ParseNum   - the component number
+  //   pSocket->nParseLeft - the number of value characters collected so far
+  //   parse_tail          - the value characters collected so far
+  // When a component value is complete its handler is called through the
+  // post_field[] table to apply the value to the Pending_ variables.
+  //
+  // Note: Earlier versions copied the POST into a 300 byte stack buffer and
+  // counted the expected PARSEBYTES down in nParseLeft. Neither is needed
+  // now; the end of the POST is found from the "z" component.
+  uint8_t ch;
+  uint8_t index;
+
+  while (nBytes != 0) {
+    ch = (uint8_t)*pBuffer++;
+    nBytes--;
+    
+    switch (pSocket->ParseState)
+    {
+      case PARSE_CMD:
+        pSocket->ParseCmd = ch;
+        pSocket->ParseState = PARSE_NUM10;
+        break;
+	
+      case PARSE_NUM10:
+        pSocket->ParseNum = (uint8_t)((ch - '0') * 10);
+        pSocket->ParseState = PARSE_NUM1;
+        break;
+	
+      case PARSE_NUM1:
+        pSocket->ParseNum += (uint8_t)(ch - '0');
+        pSocket->ParseState = PARSE_EQUAL;
+        break;
+	
+      case PARSE_EQUAL:
+        // Skip the '=' and prepare to collect the value
+        if (pSocket->ParseCmd == 'z') {
+          // The hidden "z" component is always last, so the POST is
+	  // complete. Any data remaining is not needed.
+          pSocket->nParseLeft = 0;
+          parse_complete = 1;
+          pSocket->nState = STATE_SENDHEADER204;
+          return 0;
+        }
+        memset(parse_tail, 0, sizeof(parse_tail));
+        pSocket->nParseLeft = 0;
+        pSocket->ParseState = PARSE_VAL;
+        break;
+	
+      case PARSE_VAL:
+        index = (uint8_t)(pSocket->ParseCmd - 'a');
+        if (ch == '&') {
+          // End of the component value. Apply it.
+          if (index < (sizeof(post_field) / sizeof(post_field[0]))
+	   && post_field[index].handler) {
+            post_field[index].handler(pSocket);
+          }
+          pSocket->ParseState = PARSE_CMD;
+        }
+        else if (index < (sizeof(post_field) / sizeof(post_field[0]))
+	 && pSocket->nParseLeft < post_field[index].max_len) {
+          // Collect a value character. Characters beyond the maximum length
+	  // for the field (and all characters of unused fields) are dropped.
+          parse_tail[pSocket->nParseLeft++] = ch;
+        }
+        break;
+    }
+  }
+  
+  // We hit the end of the packet but have not yet seen the end of the POST.
+  // The remaining POST data should arrive in subsequent packets. The remote
+  // host is not expecting a CLOSE connection until we are done receiving
+  // all POST data. The CLOSE will happen as part of the STATE_SENDHEADER204
+  // process.
+  uip_len = 0;
+  return 0;
+}
+#endif // BUILD_SUPPORT == BROWSER_ONLY_BUILD || BUILD_SUPPORT == MQTT_BUILD
+
+
+void update_ON_OFF(uint8_t i, uint8_t j)
+{
+  // Verify that pin is an output and it is enabled. If so
+  // update the ON/OFF state. Otherwise the command is ignored.
+  if ((pin_control[i] & 0x01) && (pin_control[i] & 0x02)) {
+    Pending_pin_control[i] = pin_control[i];
+    if (j==0) Pending_pin_control[i] &= (uint8_t)(~0x80);
+    else Pending_pin_control[i] |= (uint8_t)0x80;
+    parse_complete = 1;
+  }
+}
+
+
+void encode_16bit_registers()
+{
+  // Function to sort the pin control bytes into the 16 bit registers.
+  int i;
+  uint16_t j;
+  i = 0;
+  j = 0x0001;
+  while( i<16 ) {
+    if (pin_control[i] & 0x04) Invert_word = Invert_word |  j;
+    else                       Invert_word = Invert_word & ~j;
+    if (pin_control[i] & 0x80) ON_OFF_word = ON_OFF_word |  j;
+    else                       ON_OFF_word = ON_OFF_word & ~j;
+    i++;
+    j = j << 1;
+  }
+}
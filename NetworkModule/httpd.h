@@ -1,146 +1,269 @@
-/*
- * Important defines and function prototypes for the HTTP Daemon Implementation
- * 
- * Author: Simon Kueppers
- * Email: simon.kueppers@web.de
- * Homepage: http://klinkerstein.m-faq.de
- * 
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful,
- but WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- GNU General Public License for more details.
-
- You should have received a copy of the GNU General Public License
- along with this program.  If not, see <http://www.gnu.org/licenses/>.
- 
- Copyright 2008 Simon Kueppers
- *
- */
- 
-/* Modifications 2020 Michael Nielson
- * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
- * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
- * Author: Michael Nielson
- * Email: nielsonm.projects@gmail.com
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful, but
- WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- General Public License for more details.
-
- See GNU General Public License at <http://www.gnu.org/licenses/>.
- 
- Copyright 2020 Michael Nielson
-*/
-
-#include <stdint.h>
-
-
-
-#ifndef HTTPD_H_
-#define HTTPD_H_
-
-#define SEEK_CONTENT_INFO	0
-#define SEEK_FIRST_RNRN		1
-#define SEEK_SECOND_RNRN	2
-#define FOUND_CONTENT_INFO	4
-
-#define UPGRADE_OK				0
-#define UPGRADE_FAIL_FILE_READ_CHECKSUM		1
-#define UPGRADE_FAIL_EEPROM_MISCOMPARE		2
-#define STRING_EEPROM_MISCOMPARE		3
-#define UPGRADE_FAIL_NOT_SREC			5
-
-#define FILETYPE_SEARCH		0
-#define FILETYPE_PROGRAM	1
-#define FILETYPE_STRING		2
-
-
-struct tHttpD
-{
-  uint8_t nState;
-  const uint8_t* pData;
-  uint16_t nDataLeft;
-  uint8_t nNewlines;
-  uint16_t nParseLeft;
-  uint8_t ParseCmd;
-  uint8_t ParseNum;
-  uint8_t ParseState;
-  uint16_t nPrevBytes;
-  uint8_t current_webpage;
-  uint8_t insertion_index;
-  int structID;
-  
-// nState		Tracks the parsing state of a POST and subsequent
-//			response to the Browser
-// pData		Pointer to the webpage data to be transmitted
-// nDataLeft		Tracks the data remaining to be transmitted from a
-//			page pointed to by pData
-// nNewlines		Tracks discovery of the \r\n\r\n sequence in a
-//			received POST
-// nParseLeft		Tracks parsing of POST data
-// ParseCmd		Contains the Cmd part of a variable sequence when
-//			parsing a POST, and used to store the Mode part of
-//			a transmit sequence when bridging a packet sequence
-//			when transmitting a webpage.
-// ParseNum		Contains the Num parter of a variable sequence when
-//			parsing a POST, and used to store the Num part of
-//			a transmit sequence when bridging a packet sequence
-//			when transmitting a webpage.
-// ParseState		Tracks the state of a POST parsing process to allow
-//			bridging of TCP Fragmentation.
-// nPrevBytes		Used in the case of uip_rexmit to determine if the
-//			header needs to be retransmitted.
-// current_webpage	Tracks the current webpage being displayed in the GUI.
-// insertion_index	Tracks the position in a "long string" being trans-
-//			mitted in a webpage to allow bridging of TCP Frag-
-//			mentation.
-// structID		This was meant to be a temporary debug value to help
-//                      sort out when connections were being used. It will be
-//                      left in the code for now as it proved to be very
-//                      useful.
-};
-
-
-void httpd_diagnostic(void);
-
-void HttpDStringInit(void);
-void init_off_board_string_pointers(struct tHttpD* pSocket);
-uint16_t adjust_template_size(struct tHttpD* pSocket);
-
-static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen);
-static uint16_t CopyHttpData(uint8_t* pBuffer,
-                             const char** ppData,
-			     uint16_t* pDataLeft,
-			     uint16_t nMaxBytes,
-			     struct tHttpD* pSocket);
-char *show_temperature_string(char * pBuffer, uint8_t nParsedNum);
-
-void emb_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad);
-int hex2int(char ch);
-uint8_t two_hex2int(char chmsb, char chlsb);
-uint8_t int2nibble(uint8_t j);
-void int2hex(uint8_t i);
-
-void HttpDInit(void);
-// void init_tHttpD_struct(struct tHttpD* pSocket);
-void init_tHttpD_struct(struct tHttpD* pSocket, int i);
-void HttpDCall(uint8_t* pBuffer, uint16_t nBytes, struct tHttpD* pSocket);
-// char *read_two_characters(struct tHttpD* pSocket, char *pBuffer);
-char *read_two_characters(char *pBuffer);
-uint16_t parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes);
-void parse_local_buf(struct tHttpD* pSocket, char* local_buf, uint16_t lbi_max);
-void encode_16bit_registers(void);
-void update_pin_control_bytes(void);
-void update_ON_OFF(uint8_t i, uint8_t j);
-
-#endif /*HTTPD_H_*/
+/*
+ * Important defines and function prototypes for the HTTP Daemon Implementation
+ * 
+ * Author: Simon Kueppers
+ * Email: simon.kueppers@web.de
+ * Homepage: http://klinkerstein.m-faq.de
+ * 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2008 Simon Kueppers
+ *
+ */
+ 
+/* Modifications 2020 Michael Nielson
+ * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
+ * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
+ * Author: Michael Nielson
+ * Email: nielsonm.projects@gmail.com
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ See GNU General Public License at <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2020 Michael Nielson
+*/
+
+#include <stdint.h>
+
+
+
+#ifndef HTTPD_H_
+#define HTTPD_H_
+
+#define SEEK_CONTENT_INFO	0
+#define SEEK_FIRST_RNRN		1
+#define SEEK_SECOND_RNRN	2
+#define FOUND_CONTENT_INFO	4
+
+#define UPGRADE_OK				0
+#define UPGRADE_FAIL_FILE_READ_CHECKSUM		1
+#define UPGRADE_FAIL_EEPROM_MISCOMPARE		2
+#define STRING_EEPROM_MISCOMPARE		3
+#define UPGRADE_FAIL_NOT_SREC			5
+#define UPGRADE_FAIL_IMAGE_HEADER		6
+#define UPGRADE_FAIL_IMAGE_CRC			7
+#define UPGRADE_FAIL_ERASE_ACTIVE		8
+
+// Network Module binary image (.nmb) header. See PARSE_FILE_BIN_HEADER in
+// httpd.c and tools/nm_pack.py.
+#define BIN_HEADER_SIZE		16
+#define BIN_IMAGE_VERSION	1
+
+#define FILETYPE_SEARCH		0
+#define FILETYPE_PROGRAM	1
+#define FILETYPE_STRING		2
+
+// HTTP connection states (nState), POST/GET parse states (ParseState) and
+// webpage template numbers (current_webpage). These are only used by
+// httpd.c, but are kept here so that the host tests in tools/hosttest use
+// the same values.
+#define STATE_CONNECTED		0	// Client has just connected
+#define STATE_GOTGET		1	// Client just sent a GET request
+#define STATE_GOTPOST		2	// Client just sent a POST request
+#define STATE_PARSEPOST		10	// We are currently parsing the
+                                        // client's POST-data
+#define STATE_PARSEFILE		11	// We are currently parsing the
+                                        // client's POSTed file data
+#define STATE_SENDHEADER200	12	// Next we send the HTTP 200 header
+#define STATE_SENDHEADER204	13	// Or we send the HTTP 204 header
+#define STATE_SENDDATA		14	// ... followed by data
+#define STATE_PARSEGET		15	// We are currently parsing the
+                                        // client's GET-request
+#define STATE_SENDEVENTHEADER	16	// Next we send the Event Stream header
+#define STATE_EVENTSTREAM	17	// Event Stream is open, records are
+                                        // sent when polled
+#define STATE_SENDCACHE		18	// Sending the IOControl page from the
+                                        // render cache
+#define STATE_NULL		127     // Signals no fragment reassembly info
+                                        // present
+
+#define PARSE_CMD		0       // Parsing the command byte in a POST
+#define PARSE_NUM10		1       // Parsing the most sig digit of POST
+                                        // cmd
+#define PARSE_NUM1		2       // Parsing the least sig digit of a
+                                        // POST cmd
+#define PARSE_EQUAL		3       // Parsing the equal sign of a POST
+                                        // cmd
+#define PARSE_VAL		4       // Parsing the data value of a POST
+                                        // cmd
+#define PARSE_DELIM		5       // Parsing the delimiter of a POST cmd
+#define PARSE_SLASH1		6       // Parsing the slash of a GET cmd
+#define PARSE_FAIL		7       // Indicates parse failure - no action
+                                        // taken
+
+
+#define PARSE_FILE_SEEK_START	30	// Parse a new SREC record
+#define PARSE_FILE_SEEK_SX	31	// Parse a new SREC record
+#define PARSE_FILE_SEQUENTIAL	32	// Read data in the SREC record
+#define PARSE_FILE_NONSEQ	33	// Read non-sequential SREC record
+#define PARSE_FILE_COMPLETE	34	// Termination of good file read
+#define PARSE_FILE_FAIL		35	// Termination of failed file read
+#define PARSE_FILE_FAIL_EXIT	36	// Display of fail code
+#define PARSE_FILE_BIN_HEADER	37	// Read binary image header
+#define PARSE_FILE_BIN_DATA	38	// Read binary image data
+
+#define WEBPAGE_NULL		0	// Default for adjust_template_size()
+#define WEBPAGE_IOCONTROL	1
+#define WEBPAGE_CONFIGURATION	2
+#define WEBPAGE_STATS1		6
+#define WEBPAGE_STATS2		7
+#define WEBPAGE_SENSOR_SERIAL	8
+#define WEBPAGE_SSTATE		9
+#define WEBPAGE_UPLOADER	10
+#define WEBPAGE_LOADUPLOADER	12
+#define WEBPAGE_EXISTING_IMAGE	13
+#define WEBPAGE_TIMER		14
+#define WEBPAGE_UPLOAD_COMPLETE	15
+#define WEBPAGE_PARSEFAIL	16
+#define WEBPAGE_EEPROM_MISSING	17
+#define WEBPAGE_EVENTS		18
+#define WEBPAGE_ERASE		19
+#define WEBPAGE_ERASE_STATUS	20
+
+// Firmware upload pipeline (UPLOAD_PIPELINE_SUPPORT)
+// UPLOAD_RING_PAGES is the number of decoded 64 byte pages that can wait for
+// the Off-Board EEPROM writer. UPLOAD_RING_RESERVE is the number of pages one
+// UIP_TCP_MSS packet of SREC text can complete (440 characters of 32 byte
+// S3 records is about 176 data bytes, which can complete 3 pages). The
+// receive window is closed whenever fewer than UPLOAD_RING_RESERVE entries
+// are free.
+#define UPLOAD_RING_PAGES	4
+#define UPLOAD_RING_RESERVE	3
+#define UPLOAD_RING_POLL_LIMIT	1000
+
+#define UPLOAD_RING_IDLE	0
+#define UPLOAD_RING_BUSY	1
+
+// Off-Board EEPROM erase job (/74 command). EEPROM_ERASE_BLOCKS is the
+// number of 128 byte blocks in the four EEPROM regions.
+#define EEPROM_ERASE_BLOCKS	1024
+#define EEPROM_ERASE_POLL_LIMIT	1000
+
+#define EEPROM_ERASE_IDLE	0
+#define EEPROM_ERASE_WRITE	1
+#define EEPROM_ERASE_BUSY	2
+#define EEPROM_ERASE_FAIL	3
+#define EEPROM_ERASE_REFUSED	4	// Not started, an upload was active
+
+// Webpage template streamer (OB_EEPROM_SUPPORT)
+// TPL_BUF_SIZE is the size of the read ahead ring for templates stored in
+// the Off-Board EEPROM. It must be a power of 2. TPL_PREFETCH_CHUNK is the
+// number of bytes read ahead per idle pass of the main.c loop (about 0.8ms
+// of I2C time at 400kHz).
+#define TPL_BUF_SIZE		128
+#define TPL_PREFETCH_CHUNK	32
+
+struct upload_page_t
+{
+  uint16_t address;   // Off-Board EEPROM address of the page
+  uint8_t failcode;   // upgrade_failcode to report if validation fails
+  uint8_t data[64];   // Page contents
+};
+
+
+struct tHttpD
+{
+  uint8_t nState;
+  const uint8_t* pData;
+  uint16_t nDataLeft;
+  uint8_t nNewlines;
+  uint16_t nParseLeft;
+  uint8_t ParseCmd;
+  uint8_t ParseNum;
+  uint8_t ParseState;
+  uint16_t nPrevBytes;
+  uint8_t current_webpage;
+  uint8_t insertion_index;
+  int structID;
+  
+// nState		Tracks the parsing state of a POST and subsequent
+//			response to the Browser
+// pData		Pointer to the webpage data to be transmitted
+// nDataLeft		Tracks the data remaining to be transmitted from a
+//			page pointed to by pData
+// nNewlines		Tracks discovery of the \r\n\r\n sequence in a
+//			received POST
+// nParseLeft		Tracks parsing of POST data
+// ParseCmd		Contains the Cmd part of a variable sequence when
+//			parsing a POST, and used to store the Mode part of
+//			a transmit sequence when bridging a packet sequence
+//			when transmitting a webpage.
+// ParseNum		Contains the Num parter of a variable sequence when
+//			parsing a POST, and used to store the Num part of
+//			a transmit sequence when bridging a packet sequence
+//			when transmitting a webpage.
+// ParseState		Tracks the state of a POST parsing process to allow
+//			bridging of TCP Fragmentation.
+// nPrevBytes		Used in the case of uip_rexmit to determine if the
+//			header needs to be retransmitted.
+// current_webpage	Tracks the current webpage being displayed in the GUI.
+// insertion_index	Tracks the position in a "long string" being trans-
+//			mitted in a webpage to allow bridging of TCP Frag-
+//			mentation.
+// structID		This was meant to be a temporary debug value to help
+//                      sort out when connections were being used. It will be
+//                      left in the code for now as it proved to be very
+//                      useful.
+};
+
+
+void httpd_diagnostic(void);
+
+void HttpDStringInit(void);
+void init_off_board_string_pointers(struct tHttpD* pSocket);
+uint16_t adjust_template_size(struct tHttpD* pSocket);
+
+static uint16_t CopyHttpHeader(uint8_t* pBuffer, uint16_t nDataLen);
+uint16_t event_pin_states(void);
+static uint16_t CopyHttpData(uint8_t* pBuffer,
+                             const char** ppData,
+			     uint16_t* pDataLeft,
+			     uint16_t nMaxBytes,
+			     struct tHttpD* pSocket);
+char *show_temperature_string(char * pBuffer, uint8_t nParsedNum);
+
+void emb_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad);
+int hex2int(char ch);
+uint8_t two_hex2int(char chmsb, char chlsb);
+uint8_t int2nibble(uint8_t j);
+void int2hex(uint8_t i);
+uint32_t crc32_update(uint32_t crc, uint8_t data);
+
+void HttpDInit(void);
+// void init_tHttpD_struct(struct tHttpD* pSocket);
+void init_tHttpD_struct(struct tHttpD* pSocket, int i);
+void HttpDCall(uint8_t* pBuffer, uint16_t nBytes, struct tHttpD* pSocket);
+// char *read_two_characters(struct tHttpD* pSocket, char *pBuffer);
+char *read_two_characters(char *pBuffer);
+void upload_ring_service(void);
+void upload_ring_flush(void);
+void eeprom_erase_service(void);
+void tpl_stream_seek(uint16_t address);
+uint8_t tpl_stream_get(void);
+void tpl_stream_prefetch(void);
+void tpl_stream_stop(void);
+uint16_t parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes);
+void encode_16bit_registers(void);
+void update_pin_control_bytes(void);
+void update_ON_OFF(uint8_t i, uint8_t j);
+
+#endif /*HTTPD_H_*/
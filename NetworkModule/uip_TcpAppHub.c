@@ -1,99 +1,276 @@
-/*
- * This file implements all necessary Callback functions for
- * the uip Stack to route data properly to the right application.
- * 
- * Author: Simon Kueppers
- * Email: simon.kueppers@web.de
- * Homepage: http://klinkerstein.m-faq.de
- * 
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful,
- but WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- GNU General Public License for more details.
-
- You should have received a copy of the GNU General Public License
- along with this program.  If not, see <http://www.gnu.org/licenses/>.
- 
- Copyright 2008 Simon Kueppers
- *
- */
- 
-/* Modifications 2020 Michael Nielson
- * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
- * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
- * Author: Michael Nielson
- * Email: nielsonm.projects@gmail.com
- *
- * This declaration applies to modifications made by Michael Nielson
- * and in no way changes the Simon Kueppers declaration above.
- 
- This program is free software: you can redistribute it and/or modify
- it under the terms of the GNU General Public License as published by
- the Free Software Foundation, either version 3 of the License, or
- (at your option) any later version.
-
- This program is distributed in the hope that it will be useful, but
- WITHOUT ANY WARRANTY; without even the implied warranty of
- MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
- General Public License for more details.
-
- See GNU General Public License at <http://www.gnu.org/licenses/>.
- 
- Copyright 2020 Michael Nielson
-*/
-
-
-
-#include "uip_TcpAppHub.h"
-#include "uip.h"
-#include "main.h"
-#include "mqtt.h"
-#include "uipopt.h"
-
-extern uint16_t Port_Httpd;
-extern uint16_t Port_Mqttd;
-
-#if BUILD_SUPPORT == MQTT_BUILD
-extern struct mqtt_client mqttclient; // Pointer to MQTT client declared in main.c
-extern uint8_t mqtt_start;
-extern uint8_t mqtt_close_tcp;
-#endif // BUILD_SUPPORT == MQTT_BUILD
-
-void uip_TcpAppHubCall(void)
-// We get here via UIP_APPCALL in the uip.c code
-{
-  if(uip_conn->lport == htons(Port_Httpd)) {
-    // This code is called if incoming traffic is HTTP. HttpDCall will read
-    // the incoming data from the uip_buf, then create any needed output
-    // data and put it in the uip_buf.
-    // This code is also called if the UIP functions are just checking to
-    // see if there is anything pending to send - for instance in the case
-    // where multiple packets must be sent to fulfill a browser request.
-    HttpDCall(uip_appdata, uip_datalen(), &uip_conn->appstate.HttpDSocket);
-  }
-
-#if BUILD_SUPPORT == MQTT_BUILD
-  else if(uip_conn->lport == htons(Port_Mqttd)) {
-    // This code is called if incoming traffic is MQTT. mqtt_sync will read
-    // the incoming data (if any) from the uip_buf, then create any needed
-    // ouptut data and put it in the uip_buf.
-    // This code is also called if the UIP functions are just checking to
-    // see if there is anything pending to send. This can happen frequently
-    // with MQTT.
-    if (mqtt_start > MQTT_START_QUEUE_CONNECT) {
-      // Only call mqtt_sync if we know the client has been initialized
-      mqtt_sync(&mqttclient);
-      // If mqtt_close_tcp == 1 we are forcing a TCP connection close on return
-      // to the UIP code. Note that the uip_TcpAppHubCall() function can only
-      // be called if in the ESTABLISHED state - so a uip_close() is a valid
-      // reply.
-      if (mqtt_close_tcp) uip_close();
-    }
-  }
-#endif // BUILD_SUPPORT == MQTT_BUILD
-}
+/*
+ * This file implements all necessary Callback functions for
+ * the uip Stack to route data properly to the right application.
+ * 
+ * Author: Simon Kueppers
+ * Email: simon.kueppers@web.de
+ * Homepage: http://klinkerstein.m-faq.de
+ * 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2008 Simon Kueppers
+ *
+ */
+ 
+/* Modifications 2020 Michael Nielson
+ * Adapted for STM8S005 processor, ENC28J60 Ethernet Controller,
+ * Web_Relay_Con V2.0 HW-584, and compilation with Cosmic tool set.
+ * Author: Michael Nielson
+ * Email: nielsonm.projects@gmail.com
+ *
+ * This declaration applies to modifications made by Michael Nielson
+ * and in no way changes the Simon Kueppers declaration above.
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ See GNU General Public License at <http://www.gnu.org/licenses/>.
+ 
+ Copyright 2020 Michael Nielson
+*/
+
+
+
+#include "uip_TcpAppHub.h"
+#include "uip.h"
+#include "uip_arp.h"
+#include "Enc28j60.h"
+#include "main.h"
+#include "mqtt.h"
+#include "uipopt.h"
+
+extern uint16_t Port_Httpd;
+extern uint16_t Port_Mqttd;
+extern uint16_t uip_slen;         // Length of data the application sent
+
+#if FAIR_SCHEDULER_SUPPORT == 1
+uint8_t hub_tick;                 // Counts periodic ticks (20ms)
+uint8_t hub_rr_start;             // Connection that is polled first (after
+                                  // MQTT) on the next periodic tick
+uint8_t hub_sent[UIP_CONNS];      // Packets sent per connection in the
+                                  // current periodic tick
+uint8_t hub_recent;               // Bit map of HTTP connections that sent in
+                                  // the current or previous periodic tick
+uint8_t hub_deferred;             // Bit map of HTTP connections with a
+                                  // deferred packet
+uint8_t hub_defer_tick[UIP_CONNS]; // hub_tick when a packet was deferred
+struct hub_stats_t hub_stats[UIP_CONNS]; // Per connection diagnostics
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+
+#if BUILD_SUPPORT == MQTT_BUILD
+extern struct mqtt_client mqttclient; // Pointer to MQTT client declared in main.c
+extern uint8_t mqtt_start;
+extern uint8_t mqtt_close_tcp;
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+#if FAIR_SCHEDULER_SUPPORT == 1
+static uint8_t hub_defer(uint8_t i)
+{
+  // Called when an HTTP connection receives an ACK with no other event.
+  // Normally the next packet of a web page is sent right away in response
+  // to the ACK, so a Browser that ACKs quickly gets most of the transmit
+  // opportunities. If this connection already used its share of the
+  // current periodic tick AND another HTTP connection has work waiting,
+  // the packet is deferred. Another connection has work waiting if it has
+  // a deferred packet itself, or if it is sending and a received frame
+  // (most likely its ACK) is waiting in the ENC28J60.
+  // The scheduler is work conserving: a connection is never deferred just
+  // because it used its share, so a lone connection sends at full speed.
+  // A deferred packet is sent by uip_TcpAppHubIdle() as soon as the
+  // ENC28J60 has no more received frames waiting, or at the latest when
+  // uip polls the connection on the next periodic tick.
+  // Returns 1 if the packet is deferred.
+  uint8_t mask;
+  uint8_t others;
+  
+  mask = (uint8_t)(1 << i);
+  others = (uint8_t)(~mask);
+  if (hub_sent[i] < HUB_PACKETS_PER_TICK) return 0;
+  if ((hub_deferred & others) == 0) {
+    if ((hub_recent & others) == 0) return 0;
+    if (Enc28j60PacketsWaiting() == 0) return 0;
+  }
+  if ((hub_deferred & mask) == 0) {
+    hub_deferred |= mask;
+    hub_defer_tick[i] = hub_tick;
+  }
+  return 1;
+}
+
+
+static void hub_account(uint8_t i)
+{
+  // Update the scheduler and the diagnostics after an application call.
+  uint8_t mask;
+  uint8_t wait;
+  
+  mask = (uint8_t)(1 << i);
+  if (uip_connected()) {
+    // New connection in this slot - restart the diagnostics
+    hub_stats[i].bytes = 0;
+    hub_stats[i].wait_max = 0;
+    hub_deferred &= (uint8_t)(~mask);
+  }
+  if (uip_slen == 0) return;
+  hub_stats[i].bytes += uip_slen;
+  if (hub_sent[i] < 255) hub_sent[i]++;
+  if (uip_conn->lport == htons(Port_Httpd)) hub_recent |= mask;
+  if (hub_deferred & mask) {
+    hub_deferred &= (uint8_t)(~mask);
+    wait = (uint8_t)(hub_tick - hub_defer_tick[i]);
+    if (wait > hub_stats[i].wait_max) hub_stats[i].wait_max = wait;
+  }
+}
+
+
+void uip_TcpAppHubPeriodic(void)
+{
+  // Replaces the simple "for (i = 0; i < UIP_CONNS; i++) uip_periodic(i)"
+  // loop in the main loop. Each connection is still given one periodic call
+  // per tick, but:
+  // - The MQTT connection is always called first so that a PUBLISH queued
+  //   by publish_outbound() is not held up behind web page packets.
+  // - The HTTP connections are called in round robin order, starting with a
+  //   different connection on each tick, so no connection is always last
+  //   in line for the ENC28J60 transmitter.
+  uint8_t i;
+  uint8_t j;
+  uint8_t mqtt_i;
+  
+  hub_tick++;
+  // A connection is considered to be sending if it sent in the previous
+  // tick. Start a new accounting period.
+  hub_recent = 0;
+  for (i = 0; i < UIP_CONNS; i++) {
+    if (hub_sent[i] && uip_conns[i].lport == htons(Port_Httpd)) hub_recent |= (uint8_t)(1 << i);
+    hub_sent[i] = 0;
+  }
+  
+  mqtt_i = UIP_CONNS;
+#if BUILD_SUPPORT == MQTT_BUILD
+  for (i = 0; i < UIP_CONNS; i++) {
+    if (uip_conn_active(i) && uip_conns[i].lport == htons(Port_Mqttd)) {
+      mqtt_i = i;
+      uip_periodic(i);
+      if (uip_len > 0) {
+        uip_arp_out();
+        Enc28j60Send(uip_buf, uip_len);
+      }
+      break;
+    }
+  }
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+  i = hub_rr_start;
+  for (j = 0; j < UIP_CONNS; j++) {
+    if (i != mqtt_i) {
+      uip_periodic(i);
+      if (uip_len > 0) {
+        uip_arp_out();
+        Enc28j60Send(uip_buf, uip_len);
+      }
+    }
+    if (++i == UIP_CONNS) i = 0;
+  }
+  if (++hub_rr_start == UIP_CONNS) hub_rr_start = 0;
+}
+
+
+void uip_TcpAppHubIdle(void)
+{
+  // Called from the main loop when no received frame is waiting. Any
+  // deferred packets are sent now rather than on the next periodic tick,
+  // so the transmitter is not left idle while a connection has data ready.
+  // The connections are polled in the same round robin order as the
+  // periodic tick.
+  uint8_t i;
+  uint8_t j;
+  uint8_t mask;
+  
+  if (hub_deferred == 0) return;
+  i = hub_rr_start;
+  for (j = 0; j < UIP_CONNS; j++) {
+    mask = (uint8_t)(1 << i);
+    if (hub_deferred & mask) {
+      uip_poll_one(i);
+      if (uip_len > 0) {
+        uip_arp_out();
+        Enc28j60Send(uip_buf, uip_len);
+      }
+      // The deferral ends here even if the poll sent nothing (for instance
+      // if the connection has closed).
+      hub_deferred &= (uint8_t)(~mask);
+    }
+    if (++i == UIP_CONNS) i = 0;
+  }
+}
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+
+
+void uip_TcpAppHubCall(void)
+// We get here via UIP_APPCALL in the uip.c code
+{
+#if FAIR_SCHEDULER_SUPPORT == 1
+  uint8_t i;
+  i = (uint8_t)(uip_conn - uip_conns);
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+
+  if(uip_conn->lport == htons(Port_Httpd)) {
+    // This code is called if incoming traffic is HTTP. HttpDCall will read
+    // the incoming data from the uip_buf, then create any needed output
+    // data and put it in the uip_buf.
+    // This code is also called if the UIP functions are just checking to
+    // see if there is anything pending to send - for instance in the case
+    // where multiple packets must be sent to fulfill a browser request.
+#if FAIR_SCHEDULER_SUPPORT == 1
+    // A plain ACK may be deferred to give other connections a turn.
+    if (uip_flags == UIP_ACKDATA && hub_defer(i)) return;
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+    HttpDCall(uip_appdata, uip_datalen(), &uip_conn->appstate.HttpDSocket);
+  }
+
+#if BUILD_SUPPORT == MQTT_BUILD
+  else if(uip_conn->lport == htons(Port_Mqttd)) {
+    // This code is called if incoming traffic is MQTT. mqtt_sync will read
+    // the incoming data (if any) from the uip_buf, then create any needed
+    // ouptut data and put it in the uip_buf.
+    // This code is also called if the UIP functions are just checking to
+    // see if there is anything pending to send. This can happen frequently
+    // with MQTT.
+    if (mqtt_start > MQTT_START_QUEUE_CONNECT) {
+      // Only call mqtt_sync if we know the client has been initialized
+      mqtt_sync(&mqttclient);
+#if DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+      if (uip_slen > 0) mqtt_edge_report();
+#endif // DEBUG_SUPPORT == 7 || DEBUG_SUPPORT == 15
+      // If mqtt_close_tcp == 1 we are forcing a TCP connection close on return
+      // to the UIP code. Note that the uip_TcpAppHubCall() function can only
+      // be called if in the ESTABLISHED state - so a uip_close() is a valid
+      // reply.
+      if (mqtt_close_tcp) uip_close();
+    }
+  }
+#endif // BUILD_SUPPORT == MQTT_BUILD
+
+#if FAIR_SCHEDULER_SUPPORT == 1
+  hub_account(i);
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+}
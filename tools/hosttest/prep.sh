@@ -0,0 +1,65 @@
+#!/bin/sh
+#
+# prep.sh
+#
+# Copies the Network Module sources into a build directory and converts
+# them so that they compile with the host gcc. Used by the Makefile in this
+# directory; each test gets its own copy so that it can set its own
+# uipopt.h options.
+#
+# Usage:
+#   prep.sh DIR "OPTION=VALUE OPTION=VALUE ..."
+#
+# The sources are taken from ../../NetworkModule, or from the directory in
+# NM_SRC if it is set (for instance a git worktree of an older version, to
+# compare the results or timing of two versions).
+#
+# The conversion:
+# - Removes the Cosmic extensions (@eeprom, @near, @tiny, @interrupt,
+#   @svlreg, absolute address placement) and the #pragma section lines.
+# - Sets each OPTION in uipopt.h to VALUE, and sets UIP_BYTE_ORDER to
+#   little endian to match the host.
+# - Removes the stpcpy() prototype in mqtt_pal.h and renames the stpcpy()
+#   in mqtt_pal.c, which conflict with the one in the host string.h.
+# - Declares struct mqtt_response_publish ahead of the publish_callback()
+#   prototype in main.h. Main.c includes main.h before mqtt.h, which the
+#   host gcc does not accept.
+# - Renames main() in Main.c to nm_main() so that Main.c functions can be
+#   linked into a test.
+# - Adds lower case copies of the headers, as Cosmic includes are not case
+#   sensitive.
+#
+# Copyright 2020 Michael Nielson
+# This program is free software: you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option)
+# any later version. See <http://www.gnu.org/licenses/>.
+
+set -e
+src=$(cd "${NM_SRC:-$(dirname "$0")/../../NetworkModule}" && pwd)
+dir=$1
+rm -rf "$dir"
+mkdir -p "$dir"
+cp "$src"/*.c "$src"/*.h "$dir"
+cd "$dir"
+for f in *.c *.h; do
+  sed -i -E 's/\r$//;
+    s/@(eeprom|near|far|tiny|inline|interrupt|svlreg)\b//g;
+    s/[ \t]*@[A-Za-z0-9_]+;/;/;
+    s/^#pragma section.*//;
+    s/^#if \(sizeof.*/#if 0/' "$f"
+done
+for kv in $2; do
+  k=${kv%%=*}
+  v=${kv#*=}
+  sed -i -E "s/^#define $k[ \t].*/#define $k $v/" uipopt.h
+done
+sed -i -E 's/^#define UIP_BYTE_ORDER[ \t].*/#define UIP_BYTE_ORDER UIP_LITTLE_ENDIAN/' uipopt.h
+sed -i -E '/^char \*stpcpy/d' mqtt_pal.h
+sed -i -E 's/^char \*stpcpy\(/char *nm_stpcpy(/' mqtt_pal.c
+sed -i -E 's/^void publish_callback\(/struct mqtt_response_publish;\nvoid publish_callback(/' main.h
+sed -i -E 's/^int main\(void\)/int nm_main(void)/' Main.c
+for f in *.h; do
+  l=$(echo "$f" | tr A-Z a-z)
+  [ "$l" = "$f" ] || [ -e "$l" ] || cp "$f" "$l"
+done
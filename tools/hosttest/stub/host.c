@@ -0,0 +1,32 @@
+/*
+ * host.c
+ *
+ * Host definitions for the STM8 registers and the Cosmic intrinsics used by
+ * the Network Module sources. See iostm8s005.h in this directory.
+ */
+
+#define HOST_DEFINE_REGS
+#include "iostm8s005.h"
+
+void (*host_asm_hook)(void);         // Called for each _asm() (nop()). Set
+                                     // by tests that model the I2C bus.
+uint8_t (*host_pg_idr_hook)(void);   // Returns PG_IDR. The default reads
+                                     // back a released (high) SDA line.
+
+uint8_t host_pg_idr(void)
+{
+  if (host_pg_idr_hook) return host_pg_idr_hook();
+  return 0x01;
+}
+
+void _asm(const char *code, ...)
+{
+  (void)code;
+  if (host_asm_hook) host_asm_hook();
+}
+
+int _fctcpy(char name)
+{
+  (void)name;
+  return 1;
+}
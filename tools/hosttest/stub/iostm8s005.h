@@ -0,0 +1,121 @@
+/*
+ * iostm8s005.h
+ *
+ * Host stand-in for the Cosmic STM8S005 register header, used by the host
+ * tests. Each register is a plain byte. host.c defines them (with
+ * HOST_DEFINE_REGS) and every other file declares them.
+ *
+ * PG_IDR (the I2C SDA input) reads through host_pg_idr() so that a test can
+ * model a device on the I2C bus. nop() (used by the I2C bit-bang delays)
+ * reaches the host through _asm(), see host_asm_hook in host.c.
+ */
+
+#ifndef HOST_IOSTM8S005_H
+#define HOST_IOSTM8S005_H
+
+#include <stdint.h>
+
+#ifdef HOST_DEFINE_REGS
+#define HOST_REG(r) volatile uint8_t r
+#else
+#define HOST_REG(r) extern volatile uint8_t r
+#endif
+
+HOST_REG(ADC_CR1);
+HOST_REG(AWU_CSR);
+HOST_REG(CLK_CCOR);
+HOST_REG(CLK_CKDIVR);
+HOST_REG(CLK_CSSR);
+HOST_REG(CLK_DIVR);
+HOST_REG(CLK_ECKR);
+HOST_REG(CLK_HSITRIMR);
+HOST_REG(CLK_ICKR);
+HOST_REG(CLK_PCKENR);
+HOST_REG(CLK_PCKENR1);
+HOST_REG(CLK_PCKENR2);
+HOST_REG(CLK_SWCR);
+HOST_REG(CLK_SWIMCCR);
+HOST_REG(CLK_SWR);
+HOST_REG(FLASH_CR2);
+HOST_REG(FLASH_DUKR);
+HOST_REG(FLASH_IAPSR);
+HOST_REG(FLASH_NCR2);
+HOST_REG(FLASH_PUKR);
+HOST_REG(I2C_CR1);
+HOST_REG(IWDG_KR);
+HOST_REG(IWDG_PR);
+HOST_REG(IWDG_RLR);
+HOST_REG(PA_CR1);
+HOST_REG(PA_CR2);
+HOST_REG(PA_DDR);
+HOST_REG(PA_IDR);
+HOST_REG(PA_ODR);
+HOST_REG(PB_CR1);
+HOST_REG(PB_CR2);
+HOST_REG(PB_DDR);
+HOST_REG(PB_ODR);
+HOST_REG(PC_CR1);
+HOST_REG(PC_CR2);
+HOST_REG(PC_DDR);
+HOST_REG(PC_IDR);
+HOST_REG(PC_ODR);
+HOST_REG(PD_CR1);
+HOST_REG(PD_CR2);
+HOST_REG(PD_DDR);
+HOST_REG(PD_ODR);
+HOST_REG(PE_CR1);
+HOST_REG(PE_CR2);
+HOST_REG(PE_DDR);
+HOST_REG(PE_IDR);
+HOST_REG(PE_ODR);
+HOST_REG(PG_CR1);
+HOST_REG(PG_CR2);
+HOST_REG(PG_DDR);
+HOST_REG(PG_ODR);
+HOST_REG(RST_SR);
+HOST_REG(SPI_CR1);
+HOST_REG(TIM1_ARRH);
+HOST_REG(TIM1_ARRL);
+HOST_REG(TIM1_CNTRH);
+HOST_REG(TIM1_CNTRL);
+HOST_REG(TIM1_CR1);
+HOST_REG(TIM1_EGR);
+HOST_REG(TIM1_IER);
+HOST_REG(TIM1_PSCRH);
+HOST_REG(TIM1_PSCRL);
+HOST_REG(TIM1_RCR);
+HOST_REG(TIM1_SR1);
+HOST_REG(TIM2_CNTRH);
+HOST_REG(TIM2_CNTRL);
+HOST_REG(TIM2_CR1);
+HOST_REG(TIM2_EGR);
+HOST_REG(TIM2_PSCR);
+HOST_REG(TIM3_CNTRH);
+HOST_REG(TIM3_CNTRL);
+HOST_REG(TIM3_CR1);
+HOST_REG(TIM3_EGR);
+HOST_REG(TIM3_PSCR);
+HOST_REG(UART2_BRR1);
+HOST_REG(UART2_BRR2);
+HOST_REG(UART2_CR1);
+HOST_REG(UART2_CR2);
+HOST_REG(UART2_CR3);
+HOST_REG(UART2_CR4);
+HOST_REG(UART2_CR5);
+HOST_REG(UART2_DR);
+HOST_REG(UART2_SR);
+HOST_REG(UART_BRR1);
+HOST_REG(UART_BRR2);
+HOST_REG(UART_CR1);
+HOST_REG(UART_CR2);
+HOST_REG(UART_CR3);
+HOST_REG(WWDG_CR);
+HOST_REG(WWDG_WR);
+
+uint8_t host_pg_idr(void);
+#define PG_IDR (host_pg_idr())
+
+int _fctcpy(char name);
+void _asm(const char *code, ...);
+
+#endif /* HOST_IOSTM8S005_H */
@@ -0,0 +1,108 @@
+/*
+ * test_emb_itoa.c
+ *
+ * Checks the division free emb_itoa() in httpd.c against the original
+ * "num % base" / "num / base" conversion for every base and for pad
+ * lengths up to 12 characters (more than the 10 digits a 32 bit value can
+ * have), over the edges of the 8, 16 and 32 bit paths and a large set of
+ * pseudo random values.
+ *
+ * Values wider than "pad" digits are included. emb_itoa() keeps their low
+ * "pad" digits in every base, as the reference conversion below does (the
+ * original itself wrote past the end of the string for those).
+ *
+ * Also counts the digit subtractions made by the base 10 path, which is
+ * the work that replaced two long divisions per digit on the STM8.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+void emb_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad);
+
+static int failures;
+
+static void reference_itoa(uint32_t num, char* str, uint8_t base, uint8_t pad)
+{
+  // The emb_itoa() conversion before it was made division free, stopped
+  // after "pad" digits
+  int i;
+  str[pad] = '\0';
+  for (i = pad - 1; i >= 0; i--) {
+    uint8_t digit = (uint8_t)(num % base);
+    str[i] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    num /= base;
+  }
+}
+
+static uint32_t lcg(uint32_t *seed)
+{
+  *seed = *seed * 1103515245u + 12345u;
+  return *seed;
+}
+
+static void check(uint32_t num, uint8_t base, uint8_t pad)
+{
+  // The buffer has guard bytes after the terminator to catch over-runs.
+  char expect[20];
+  char result[20];
+  
+  memset(result, 'G', sizeof(result));
+  reference_itoa(num, expect, base, pad);
+  emb_itoa(num, result, base, pad);
+  if (strcmp(expect, result) != 0 || result[pad + 1] != 'G') {
+    if (failures++ < 10) {
+      printf("FAIL num=%lu base=%u pad=%u expected %s got %s\n",
+             (unsigned long)num, base, pad, expect, result);
+    }
+  }
+}
+
+int main(void)
+{
+  static const uint8_t bases[4] = { 2, 8, 10, 16 };
+  static const uint32_t edges[] = {
+    0, 1, 9, 10, 99, 100, 199, 255, 256, 999, 1000, 9999, 10000, 65535,
+    65536, 99999, 100000, 999999999, 1000000000, 4294967295u };
+  uint32_t seed;
+  uint32_t num;
+  unsigned long checks;
+  unsigned long subtractions;
+  int b;
+  int i;
+  int pad;
+  
+  checks = 0;
+  for (b = 0; b < 4; b++) {
+    for (pad = 1; pad <= 12; pad++) {
+      // Pads 11 and 12 run past the 10 entry power table in base 10
+      for (i = 0; i < (int)(sizeof(edges) / sizeof(edges[0])); i++) {
+        check(edges[i], bases[b], (uint8_t)pad);
+        checks++;
+      }
+      seed = (uint32_t)(b * 100 + pad);
+      for (i = 0; i < 20000; i++) {
+        num = lcg(&seed);
+        // Spread the values over the 8, 16 and 32 bit paths
+        if ((i & 3) == 0) num &= 0xff;
+        else if ((i & 3) == 1) num &= 0xffff;
+        check(num, bases[b], (uint8_t)pad);
+        checks++;
+      }
+    }
+  }
+  
+  // Base 10 work: the sum of the digits is the number of subtractions.
+  // The original made two 32 bit divisions per digit.
+  subtractions = 0;
+  {
+    char digits[11];
+    emb_itoa(3999999999u, digits, 10, 10);
+    for (i = 0; i < 10; i++) subtractions += (unsigned long)(digits[i] - '0');
+  }
+  printf("%lu conversions checked, %d failures\n", checks, failures);
+  printf("base 10, 3999999999 pad 10: %lu subtractions, 0 divisions "
+         "(was 20 long divisions)\n", subtractions);
+  return failures != 0;
+}
@@ -0,0 +1,442 @@
+/*
+ * test_fair_scheduler.c
+ *
+ * Measures how the transmit opportunities are shared between concurrent
+ * connections, with and without the scheduler in uip_TcpAppHub.c
+ * (FAIR_SCHEDULER_SUPPORT). test_fair_scheduler_off.c builds the same
+ * simulation with the scheduler disabled.
+ *
+ * The simulation runs the real uip_TcpAppHubCall(), HttpDCall() and (when
+ * enabled) uip_TcpAppHubPeriodic(). uip_process() is replaced by a model
+ * of the uip behaviour the hub relies on: one unacknowledged segment per
+ * connection, the ACK event calling the application, and the periodic
+ * timer and uip_TcpAppHubIdle() polling connections with no outstanding
+ * data. Around it:
+ * - The MCU is a single server. Each packet it builds and sends costs
+ *   PACKET_COST_US plus BYTE_COST_US per payload byte, and events that
+ *   arrive while it is busy wait their turn.
+ * - Three browsers with different round trip times load the IOControl
+ *   page over and over. A new connection starts one round trip after the
+ *   previous one closes.
+ * - Events that arrived while the MCU was busy are the received frames
+ *   waiting in the ENC28J60 (Enc28j60PacketsWaiting()). When the MCU is
+ *   free before the next event the main loop finds no frame and calls
+ *   uip_TcpAppHubIdle().
+ * - An MQTT connection has a PUBLISH ready every MQTT_INTERVAL_MS, which
+ *   mqtt_sync() (replaced here) sends when the connection is called.
+ *
+ * The results: pages and throughput per browser, Jain's fairness index
+ * over the browsers' throughput, and the PUBLISH latency. The simulation
+ * is then run again with only the fastest browser, which must never be
+ * deferred (the scheduler is work conserving).
+ *
+ * With the scheduler the Link Error Statistics page (/66) is also fetched
+ * to check that it shows hub_stats[] with the right Content-Length.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uip.h"
+#include "uipopt.h"
+#include "uip_TcpAppHub.h"
+#include "main.h"
+#include "mqtt.h"
+
+#define SIM_MS            20000.0  // Simulated time
+#define TICK_MS           20.0     // Periodic timer
+#define PACKET_COST_US    400.0    // MCU time to build and send a packet
+#define BYTE_COST_US      4.0      // plus this per payload byte
+#define MQTT_INTERVAL_MS  97.0     // A PUBLISH is ready this often
+#define MQTT_RTT_MS       2.0
+#define MQTT_PUBLISH_SIZE 60
+
+static const double browser_rtt_ms[3] = { 1.0, 5.0, 40.0 };
+
+extern uint16_t Port_Httpd;
+extern uint16_t Port_Mqttd;
+extern uint8_t mqtt_start;
+extern uint8_t mqtt_close_tcp;
+extern uint16_t uip_slen;
+extern char *uip_sappdata;
+void HttpDStringInit(void);
+#if FAIR_SCHEDULER_SUPPORT == 1
+extern struct hub_stats_t hub_stats[UIP_CONNS];
+extern uint8_t hub_deferred;
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+
+// uip variables (uip.c is not linked)
+struct uip_conn uip_conns[UIP_CONNS];
+struct uip_conn *uip_conn;
+uint8_t uip_buf[UIP_BUFSIZE + 2];
+char *uip_appdata;
+char *uip_sappdata;
+uint16_t uip_len;
+uint16_t uip_slen;
+uint8_t uip_flags;
+uip_ipaddr_t uip_hostaddr;
+uip_ipaddr_t uip_draddr;
+uip_ipaddr_t uip_netmask;
+uip_ipaddr_t uip_mqttserveraddr;
+
+void uip_send(const char *data, int len)
+{
+  if (len > 0) {
+    uip_slen = (uint16_t)len;
+    if (data != uip_sappdata) memcpy(uip_sappdata, data, uip_slen);
+  }
+}
+void uip_listen(uint16_t port) { (void)port; }
+void uip_arp_out(void) { }
+void Enc28j60Send(uint8_t* pBuffer, uint16_t nBytes) { (void)pBuffer; (void)nBytes; }
+
+// Simulation state
+static int browsers;                // Browsers loading pages
+static double now;                  // Current time (ms)
+static double mcu_free;             // Time the MCU finishes its current work
+static double mcu_busy;             // Total MCU busy time
+static int outstanding[UIP_CONNS];  // 1 while a segment is not ACKed
+static double ack_at[UIP_CONNS];    // Time the ACK arrives
+static double connect_at[3];        // Time browser i opens its next page
+static double page_start[3];
+static int pages[3];
+static double page_time_sum[3];
+static double page_time_max[3];
+static double bytes[3];
+static int mqtt_ready;              // PUBLISHes waiting
+static double mqtt_ready_at[64];
+static double mqtt_next;
+static double mqtt_latency_sum;
+static double mqtt_latency_max;
+static int mqtt_sent;
+static int deferrals;               // ACKs that did not send because the
+                                    // connection was deferred
+
+#define MQTT_SLOT 3
+
+uint8_t Enc28j60PacketsWaiting(void)
+{
+  // The events that arrived while the MCU was busy
+  int c;
+  uint8_t n;
+  n = 0;
+  for (c = 0; c < UIP_CONNS; c++) {
+    if (outstanding[c] && ack_at[c] <= now) n++;
+  }
+  for (c = 0; c < browsers; c++) {
+    if (uip_conns[c].tcpstateflags == UIP_CLOSED && connect_at[c] <= now) n++;
+  }
+  return n;
+}
+
+static void transmit(int c)
+{
+  // The application left uip_slen bytes to send on connection c. The MCU
+  // builds and sends the packet, then the ACK comes back one round trip
+  // later.
+  double cost;
+  double rtt;
+  cost = (PACKET_COST_US + BYTE_COST_US * uip_slen) / 1000.0;
+  if (mcu_free < now) mcu_free = now;
+  mcu_free += cost;
+  mcu_busy += cost;
+  rtt = (c == MQTT_SLOT) ? MQTT_RTT_MS : browser_rtt_ms[c];
+  outstanding[c] = 1;
+  ack_at[c] = mcu_free + rtt;
+  if (c != MQTT_SLOT) bytes[c] += uip_slen;
+  uip_len = uip_slen;
+}
+
+static void appcall(int c, uint8_t flags)
+{
+  uip_conn = &uip_conns[c];
+  uip_appdata = (char *)&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
+  uip_sappdata = uip_appdata;
+  uip_flags = flags;
+  uip_slen = 0;
+  uip_len = 0;
+  uip_TcpAppHubCall();
+  if (uip_slen > 0) transmit(c);
+#if FAIR_SCHEDULER_SUPPORT == 1
+  if (flags == UIP_ACKDATA && (hub_deferred & (1 << c))) deferrals++;
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  if (c != MQTT_SLOT && (uip_flags & (UIP_CLOSE | UIP_ABORT))) {
+    // Page complete. The browser opens the next connection after the FIN
+    // and SYN exchange.
+    double t = ((mcu_free > now) ? mcu_free : now) - page_start[c];
+    uip_conns[c].tcpstateflags = UIP_CLOSED;
+    pages[c]++;
+    page_time_sum[c] += t;
+    if (t > page_time_max[c]) page_time_max[c] = t;
+    connect_at[c] = now + browser_rtt_ms[c];
+  }
+}
+
+void uip_process(uint8_t flag)
+{
+  // Only the periodic timer and poll requests are modelled: poll a
+  // connection that has no outstanding data.
+  int c;
+  c = (int)(uip_conn - uip_conns);
+  if (flag != UIP_TIMER && flag != UIP_POLL_REQUEST) return;
+  if (uip_conns[c].tcpstateflags != UIP_ESTABLISHED) return;
+  if (outstanding[c]) return;
+  appcall(c, UIP_POLL);
+}
+
+// The MQTT client is replaced by a PUBLISH source
+int16_t mqtt_sync(struct mqtt_client *client)
+{
+  (void)client;
+  if (mqtt_ready && !outstanding[MQTT_SLOT]) {
+    double lat;
+    memset(uip_appdata, 0x30, MQTT_PUBLISH_SIZE);
+    uip_slen = MQTT_PUBLISH_SIZE;
+    lat = ((mcu_free > now) ? mcu_free : now) - mqtt_ready_at[0];
+    mqtt_latency_sum += lat;
+    if (lat > mqtt_latency_max) mqtt_latency_max = lat;
+    mqtt_sent++;
+    mqtt_ready--;
+    memmove(mqtt_ready_at, mqtt_ready_at + 1, sizeof(double) * mqtt_ready);
+  }
+  return MQTT_OK;
+}
+
+static void connect_browser(int c)
+{
+  struct uip_conn *conn = &uip_conns[c];
+  memset(conn, 0, sizeof(*conn));
+  conn->tcpstateflags = UIP_ESTABLISHED;
+  conn->lport = htons(Port_Httpd);
+  conn->mss = UIP_TCP_MSS;
+  outstanding[c] = 0;
+  page_start[c] = now;
+  appcall(c, UIP_CONNECTED);
+  strcpy((char *)&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN], "GET /60 HTTP/1.1\r\n\r\n");
+  uip_conn = conn;
+  uip_appdata = (char *)&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
+  uip_sappdata = uip_appdata;
+  uip_flags = UIP_NEWDATA;
+  uip_slen = 0;
+  uip_len = (uint16_t)strlen(uip_appdata);
+  uip_TcpAppHubCall();
+  if (uip_slen > 0) transmit(c);
+}
+
+static void periodic(void)
+{
+#if FAIR_SCHEDULER_SUPPORT == 1
+  uip_TcpAppHubPeriodic();
+#else // FAIR_SCHEDULER_SUPPORT == 0
+  int i;
+  for (i = 0; i < UIP_CONNS; i++) uip_periodic(i);
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+}
+
+static void simulate(int n)
+{
+  // Run the simulation with the first n browsers
+  double next_tick;
+  double t;
+  int c;
+  int i;
+  int which;
+
+  browsers = n;
+  now = 0;
+  mcu_free = 0;
+  mcu_busy = 0;
+  memset(outstanding, 0, sizeof(outstanding));
+  memset(pages, 0, sizeof(pages));
+  memset(page_time_sum, 0, sizeof(page_time_sum));
+  memset(page_time_max, 0, sizeof(page_time_max));
+  memset(bytes, 0, sizeof(bytes));
+  mqtt_ready = 0;
+  mqtt_latency_sum = 0;
+  mqtt_latency_max = 0;
+  mqtt_sent = 0;
+  deferrals = 0;
+#if FAIR_SCHEDULER_SUPPORT == 1
+  memset(hub_stats, 0, sizeof(hub_stats));
+  hub_deferred = 0;
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  for (i = 0; i < UIP_CONNS; i++) {
+    init_tHttpD_struct(&uip_conns[i].appstate.HttpDSocket, i);
+  }
+  next_tick = TICK_MS;
+  mqtt_next = MQTT_INTERVAL_MS / 3;
+  for (i = 0; i < 3; i++) {
+    uip_conns[i].tcpstateflags = UIP_CLOSED;
+    connect_at[i] = (i < browsers) ? 0 : SIM_MS;
+  }
+  memset(&uip_conns[MQTT_SLOT], 0, sizeof(uip_conns[MQTT_SLOT]));
+  uip_conns[MQTT_SLOT].tcpstateflags = UIP_ESTABLISHED;
+  uip_conns[MQTT_SLOT].lport = htons(Port_Mqttd);
+  uip_conns[MQTT_SLOT].mss = UIP_TCP_MSS;
+
+  while (1) {
+    // Find the next event. The MCU handles one event at a time, so an
+    // event that arrives while it is busy starts when it is free.
+    which = -1;
+    t = next_tick;
+    for (c = 0; c < UIP_CONNS; c++) {
+      if (outstanding[c] && ack_at[c] < t) { t = ack_at[c]; which = c; }
+    }
+    for (c = 0; c < browsers; c++) {
+      if (uip_conns[c].tcpstateflags == UIP_CLOSED && connect_at[c] < t) {
+        t = connect_at[c];
+        which = 10 + c;
+      }
+    }
+    if (mqtt_next < t) { t = mqtt_next; which = 20; }
+    if (t >= SIM_MS) break;
+#if FAIR_SCHEDULER_SUPPORT == 1
+    if (hub_deferred && mcu_free < t) {
+      // The MCU is free before the next event: the main loop finds no
+      // received frame and sends the deferred packets.
+      now = mcu_free;
+      uip_TcpAppHubIdle();
+      continue;
+    }
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+    now = (mcu_free > t) ? mcu_free : t;
+
+    if (which == -1) {
+      next_tick += TICK_MS;
+      periodic();
+    }
+    else if (which < UIP_CONNS) {
+      outstanding[which] = 0;
+      appcall(which, UIP_ACKDATA);
+    }
+    else if (which < 20) {
+      connect_browser(which - 10);
+    }
+    else {
+      // A PUBLISH is queued. As with publish_outbound() it goes out on the
+      // next call of the MQTT connection.
+      if (mqtt_ready < 64) mqtt_ready_at[mqtt_ready++] = mqtt_next;
+      mqtt_next += MQTT_INTERVAL_MS;
+    }
+  }
+}
+
+static int check_stats_page(void)
+{
+  // Fetch /66 on slot 0 and check its Content-Length against the data
+  int failures = 0;
+#if FAIR_SCHEDULER_SUPPORT == 1
+  static char page[4096];
+  int len;
+  char *p;
+  char *body;
+  struct uip_conn *conn = &uip_conns[0];
+
+  memset(conn, 0, sizeof(*conn));
+  conn->tcpstateflags = UIP_ESTABLISHED;
+  conn->lport = htons(Port_Httpd);
+  conn->mss = UIP_TCP_MSS;
+  uip_conn = conn;
+  uip_appdata = (char *)&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
+  uip_sappdata = uip_appdata;
+  uip_flags = UIP_CONNECTED;
+  uip_len = 0;
+  HttpDCall((uint8_t *)uip_appdata, 0, &conn->appstate.HttpDSocket);
+  strcpy(uip_appdata, "GET /66 HTTP/1.1\r\n\r\n");
+  uip_flags = UIP_NEWDATA;
+  uip_len = (uint16_t)strlen(uip_appdata);
+  uip_slen = 0;
+  HttpDCall((uint8_t *)uip_appdata, uip_len, &conn->appstate.HttpDSocket);
+  len = 0;
+  while (uip_slen > 0 && !(uip_flags & (UIP_CLOSE | UIP_ABORT))) {
+    memcpy(&page[len], uip_appdata, uip_slen);
+    len += uip_slen;
+    uip_flags = UIP_ACKDATA;
+    uip_len = 0;
+    uip_slen = 0;
+    HttpDCall((uint8_t *)uip_appdata, 0, &conn->appstate.HttpDSocket);
+  }
+  page[len] = '\0';
+  p = strstr(page, "Content-Length:");
+  body = strstr(page, "\r\n\r\n");
+  if (!p || !body || strtol(p + 15, 0, 10) != (long)(len - (body + 4 - page))) {
+    printf("FAIL /66 Content-Length does not match the page\n");
+    failures++;
+  }
+  p = strstr(page, "<td>36 ");
+  if (!p) {
+    printf("FAIL /66 has no scheduler statistics\n");
+    failures++;
+  }
+  else {
+    printf("/66 row 36: %.*s\n", UIP_CONNS * 10 + 3, p + 4);
+  }
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  return failures;
+}
+
+static void report(void)
+{
+  double tput[3];
+  double sum;
+  double sum_sq;
+  int i;
+
+  printf("Scheduler %s, %d browser%s, %.0f s, MCU busy %.0f%%, packet cost "
+         "%.1f ms at MSS %d\n", FAIR_SCHEDULER_SUPPORT ? "on" : "off",
+         browsers, browsers == 1 ? "" : "s", SIM_MS / 1000.0,
+         100.0 * mcu_busy / SIM_MS,
+         (PACKET_COST_US + BYTE_COST_US * UIP_TCP_MSS) / 1000.0, UIP_TCP_MSS);
+  sum = 0;
+  sum_sq = 0;
+  for (i = 0; i < browsers; i++) {
+    tput[i] = bytes[i] / SIM_MS;  // kB/s
+    sum += tput[i];
+    sum_sq += tput[i] * tput[i];
+    printf("  browser RTT %4.0f ms: %4d pages, %6.1f kB/s, page time mean "
+           "%6.1f ms max %6.1f ms\n", browser_rtt_ms[i], pages[i], tput[i],
+           pages[i] ? page_time_sum[i] / pages[i] : 0.0, page_time_max[i]);
+  }
+  printf("  fairness (Jain) %.3f, total %.1f kB/s\n",
+         sum * sum / (browsers * sum_sq), sum);
+  printf("  MQTT PUBLISH latency mean %.2f ms max %.2f ms (%d sent)\n",
+         mqtt_sent ? mqtt_latency_sum / mqtt_sent : 0.0, mqtt_latency_max,
+         mqtt_sent);
+#if FAIR_SCHEDULER_SUPPORT == 1
+  for (i = 0; i < browsers; i++) {
+    printf("  hub_stats[%d]: %lu bytes, longest deferral %u ticks\n", i,
+           (unsigned long)hub_stats[i].bytes, hub_stats[i].wait_max);
+  }
+  printf("  %d packets deferred\n", deferrals);
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+}
+
+
+int main(void)
+{
+  int failures;
+
+  Port_Httpd = 80;
+  Port_Mqttd = 1883;
+  mqtt_start = MQTT_START_COMPLETE;
+  mqtt_close_tcp = 0;
+  HttpDStringInit();
+  failures = 0;
+
+  simulate(3);
+  report();
+  simulate(1);
+  report();
+  if (deferrals) {
+    printf("FAIL a lone browser was deferred\n");
+    failures++;
+  }
+  failures += check_stats_page();
+  return failures != 0;
+}
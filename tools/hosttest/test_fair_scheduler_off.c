@@ -0,0 +1,14 @@
+/*
+ * test_fair_scheduler_off.c
+ *
+ * The simulation in test_fair_scheduler.c built with FAIR_SCHEDULER_SUPPORT
+ * disabled, for comparison.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_fair_scheduler.c"
@@ -0,0 +1,366 @@
+/*
+ * test_i2c_read.c
+ *
+ * Checks the I2C bus sequence of I2C_read_block() against a model of a
+ * 24AA1025 EEPROM on the bit-banged bus.
+ *
+ * The model watches the SCL (PE_DDR bit 0x08) and SDA (PG_DDR bit 0x01)
+ * lines on every nop() of the I2C delays (host_asm_hook) and on every read
+ * of PG_IDR (host_pg_idr_hook), which also returns the bus SDA level. A
+ * line is low when its DDR bit is set (driven) and high when it is clear
+ * (pulled up). The model follows START and STOP conditions, receives the
+ * Control and Byte address bytes, ACKs its own Control bytes, and drives
+ * the data bits of a sequential read, which wraps at the end of each 64KB
+ * block as the device does.
+ *
+ * For each read:
+ * - The bytes read match the EEPROM contents, including reads that run
+ *   past the end of a 64KB block and continue in the other block.
+ * - Each part of the read is START, Write Control byte, 2 Byte address
+ *   bytes, repeated START, Read Control byte, the data bytes each followed
+ *   by an ACK from the master except the last which gets a NACK, then
+ *   STOP. Every byte sent by the master is ACKed by the device.
+ * - SDA only changes while SCL is high as part of a START or STOP.
+ * - The bus is released (SCL and SDA high) at the end.
+ * A sequential read left open (I2C_read_open) is ended with a NACK and
+ * STOP before the new read starts.
+ *
+ * The shortest SCL high and low times seen are reported in nop() counts,
+ * and must be at least I2C_WAIT_HIGH and I2C_WAIT_LOW. An SCL low or high
+ * time with no nop() in it at all is not seen by the model, so the clock is
+ * lost and the bit count, ACK and data checks fail.
+ *
+ * The read rate is reported for a 64 byte page read as 4 reads of 16 bytes
+ * and as one read, and for a 128 byte read, in bytes/sec. It is calculated
+ * from the nop() counts at 4 CPU cycles (250ns at 16MHz) per count, so it
+ * only includes the I2C_delay() time and not the code between the delays.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "iostm8s005.h"
+#include "uipopt.h"
+#include "I2C.h"
+
+#if I2C_FAST_MODE == 1
+#define WAIT_HIGH	3
+#define WAIT_LOW	3
+#else // I2C_FAST_MODE == 0
+#define WAIT_HIGH	20
+#define WAIT_LOW	20
+#endif // I2C_FAST_MODE == 1
+
+extern void (*host_asm_hook)(void);
+extern uint8_t (*host_pg_idr_hook)(void);
+extern uint8_t I2C_failcode;
+extern uint8_t I2C_read_open;
+
+static int failures;
+#define FAIL(...) do { if (failures++ < 10) printf(__VA_ARGS__); } while (0)
+
+// The 24AA1025: two 64KB blocks selected by the B0 bit (0x08) of the
+// Control byte. A2 is tied high and A1, A0 are tied low, so the device
+// answers Control bytes 0xa0, 0xa1, 0xa8 and 0xa9.
+static uint8_t mem[2][0x10000];
+
+enum { DEV_IDLE, DEV_RX, DEV_TX };
+enum { RX_CONTROL, RX_ADDR_HI, RX_ADDR_LO, RX_DATA };
+
+static int scl;                 // Bus levels at the last update
+static int sda;
+static int dev_sda;             // 0 while the device drives SDA low
+static int mode;
+static int rx_what;
+static int bits;                // Bits of the current byte clocked so far
+static uint8_t shift;
+static int block;
+static uint16_t address;
+static int to_tx;               // Read Control byte ACKed, send data next
+static int master_ack;
+
+// Bus events of one read, as counted by the device
+static int starts;
+static int stops;
+static int control_writes;
+static int control_reads;
+static int address_bytes;
+static int acks;                // Data bytes ACKed by the master
+static int nacks;               // Data bytes NACKed by the master
+static int bad_sda;             // SDA changes while SCL high outside a
+                                // START or STOP
+
+// SCL timing in nop() counts
+static long nops;               // All nop() calls
+static int level_nops;
+static int min_high = 1000;
+static int min_low = 1000;
+
+static void tx_load(void)
+{
+  shift = mem[block][address];
+  bits = 0;
+  dev_sda = (shift & 0x80) != 0;
+}
+
+static void scl_rise(void)
+{
+  if (mode == DEV_RX && bits < 8) {
+    shift = (uint8_t)((shift << 1) | sda);
+    bits++;
+  }
+  else if (mode == DEV_TX) {
+    if (bits < 8) bits++;
+    else {
+      master_ack = (sda == 0);
+      if (master_ack) acks++;
+      else nacks++;
+      bits = 9;
+    }
+  }
+}
+
+static void scl_fall(void)
+{
+  if (mode == DEV_RX) {
+    if (bits == 8) {
+      // A byte has been received. ACK it on the 9th clock.
+      bits = 9;
+      if (rx_what == RX_CONTROL) {
+        if ((shift & 0xf6) != 0xa0) {
+          mode = DEV_IDLE;
+          return;
+        }
+        block = (shift & 0x08) ? 1 : 0;
+        if (shift & 0x01) {
+          control_reads++;
+          to_tx = 1;
+        }
+        else {
+          control_writes++;
+          rx_what = RX_ADDR_HI;
+        }
+      }
+      else if (rx_what == RX_ADDR_HI) {
+        address = (uint16_t)(shift << 8);
+        address_bytes++;
+        rx_what = RX_ADDR_LO;
+      }
+      else if (rx_what == RX_ADDR_LO) {
+        address |= shift;
+        address_bytes++;
+        rx_what = RX_DATA;
+      }
+      dev_sda = 0;
+    }
+    else if (bits == 9) {
+      // End of the ACK clock
+      dev_sda = 1;
+      bits = 0;
+      shift = 0;
+      if (to_tx) {
+        to_tx = 0;
+        mode = DEV_TX;
+        tx_load();
+      }
+    }
+  }
+  else if (mode == DEV_TX) {
+    if (bits < 8) dev_sda = (shift & (0x80 >> bits)) != 0;
+    else if (bits == 8) dev_sda = 1;  // Release SDA for the master's ACK
+    else if (master_ack) {
+      address++;                      // Wraps within the 64KB block
+      tx_load();
+    }
+    else mode = DEV_IDLE;             // NACK: wait for the STOP
+  }
+}
+
+static void bus_update(void)
+{
+  // Follow the lines. SCL is handled first: when both changed since the
+  // last update SCL went low first (SCL_low() has no delay of its own).
+  int new_scl = (PE_DDR & 0x08) == 0;
+  int new_sda;
+
+  if (new_scl != scl) {
+    if (scl) {
+      if (level_nops < min_high) min_high = level_nops;
+    }
+    else if (level_nops < min_low) min_low = level_nops;
+    level_nops = 0;
+    scl = new_scl;
+    if (scl) scl_rise();
+    else scl_fall();
+  }
+  new_sda = ((PG_DDR & 0x01) == 0) && dev_sda;
+  if (new_sda != sda) {
+    sda = new_sda;
+    if (scl) {
+      if (sda == 0 && (PG_DDR & 0x01)) {
+        // START (or repeated START)
+        starts++;
+        mode = DEV_RX;
+        rx_what = RX_CONTROL;
+        bits = 0;
+        shift = 0;
+        to_tx = 0;
+        dev_sda = 1;
+      }
+      else if (sda == 1) {
+        // STOP
+        stops++;
+        mode = DEV_IDLE;
+        dev_sda = 1;
+      }
+      else bad_sda++;
+    }
+  }
+}
+
+static void on_nop(void)
+{
+  bus_update();
+  nops++;
+  level_nops++;
+}
+
+static uint8_t on_pg_idr(void)
+{
+  bus_update();
+  return (uint8_t)sda;
+}
+
+static void clear_counts(void)
+{
+  starts = 0;
+  stops = 0;
+  control_writes = 0;
+  control_reads = 0;
+  address_bytes = 0;
+  acks = 0;
+  nacks = 0;
+  bad_sda = 0;
+}
+
+static uint8_t buf[0x20000];
+
+static void check_read(uint8_t control, uint16_t addr, uint16_t count, int open)
+{
+  // Read count bytes and check the data and the bus sequence. open is 1 if
+  // a sequential read was left open, which adds a NACK and a STOP.
+  int parts;
+  int b;
+  uint16_t a;
+  int i;
+
+  clear_counts();
+  I2C_failcode = 0;
+  memset(buf, 0x55, count);
+  I2C_read_block(control, addr, buf, count);
+
+  b = (control & 0x08) ? 1 : 0;
+  a = addr;
+  parts = 1;
+  for (i = 0; i < count; i++) {
+    if (buf[i] != mem[b][a]) {
+      FAIL("FAIL read %02x %04x %u: byte %d is %02x, expected %02x\n",
+           control, addr, count, i, buf[i], mem[b][a]);
+      break;
+    }
+    if (++a == 0 && i + 1 < count) {
+      b ^= 1;
+      parts++;
+    }
+  }
+  if (starts != 2 * parts
+   || control_writes != parts || control_reads != parts
+   || address_bytes != 2 * parts
+   || acks != count - parts || nacks != parts + open
+   || stops != parts + open || bad_sda != 0) {
+    FAIL("FAIL read %02x %04x %u: %d starts, %d stops, %d/%d control "
+         "bytes, %d address bytes, %d ACKs, %d NACKs, %d bad SDA changes "
+         "(%d parts)\n", control, addr, count, starts, stops,
+         control_writes, control_reads, address_bytes, acks, nacks, bad_sda,
+         parts);
+  }
+  if (I2C_failcode) FAIL("FAIL read %02x %04x %u: I2C_failcode %u\n",
+                         control, addr, count, I2C_failcode);
+  if ((PE_DDR & 0x08) || (PG_DDR & 0x01) || mode != DEV_IDLE) {
+    FAIL("FAIL read %02x %04x %u: bus not released\n", control, addr, count);
+  }
+}
+
+static void report_rate(const char *what, uint16_t size, uint16_t part)
+{
+  // Read size bytes as reads of part bytes and report the rate
+  uint16_t i;
+  double us;
+
+  nops = 0;
+  for (i = 0; i < size; i += part) I2C_read_block(0xa0, (uint16_t)(0x1000 + i), buf, part);
+  us = nops * 0.25;
+  printf("  %-26s %6ld nop() counts, %5.0f us, %6.0f bytes/sec\n", what, nops,
+         us, size / us * 1e6);
+}
+
+int main(void)
+{
+  int b;
+  long a;
+  int reads;
+
+  for (b = 0; b < 2; b++) {
+    for (a = 0; a < 0x10000; a++) {
+      mem[b][a] = (uint8_t)(a * 7 + (a >> 8) + b * 0x5a);
+    }
+  }
+  scl = 1;
+  sda = 1;
+  dev_sda = 1;
+  mode = DEV_IDLE;
+  host_asm_hook = on_nop;
+  host_pg_idr_hook = on_pg_idr;
+
+  reads = 0;
+  // Reads within one block, as used for the Flash copy and the webpage
+  // templates (EEPROM0/1 in block 0, EEPROM2/3 in block 1)
+  check_read(0xa0, 0x0000, 1, 0); reads++;
+  check_read(0xa0, 0x0000, 128, 0); reads++;
+  check_read(0xa0, 0x1234, 64, 0); reads++;
+  check_read(0xa0, 0x7fc0, 128, 0); reads++;
+  check_read(0xa8, 0x8000, 200, 0); reads++;
+  check_read(0xa0, 0xffff, 1, 0); reads++;
+  check_read(0xa8, 0xff80, 128, 0); reads++;
+  // Reads past the end of a block continue in the other block
+  check_read(0xa0, 0xffe0, 64, 0); reads++;
+  check_read(0xa0, 0xffff, 2, 0); reads++;
+  check_read(0xa8, 0xfff0, 32, 0); reads++;
+  check_read(0xa0, 0xff00, 300, 0); reads++;
+
+  // A sequential read left open by the template streamer is ended first
+  I2C_control(0xa0);
+  I2C_byte_address(0x4000);
+  I2C_control(0xa1);
+  I2C_read_byte(0);
+  I2C_read_open = 1;
+  check_read(0xa0, 0x2000, 16, 1); reads++;
+  if (I2C_read_open) FAIL("FAIL open read: I2C_read_open still set\n");
+
+  printf("%d reads checked, shortest SCL high %d, low %d nop() counts "
+         "(I2C_FAST_MODE %d)\n", reads, min_high, min_low, I2C_FAST_MODE);
+  printf("Read rate from the I2C_delay() time at 250ns per count:\n");
+  report_rate("64 byte page as 4 x 16", 64, 16);
+  report_rate("64 byte page as 1 x 64", 64, 64);
+  report_rate("128 byte block", 128, 128);
+  if (min_high < WAIT_HIGH || min_low < WAIT_LOW) {
+    FAIL("FAIL SCL high or low time shorter than I2C_WAIT_HIGH/I2C_WAIT_LOW\n");
+  }
+  printf("%d failures\n", failures);
+  return failures != 0;
+}
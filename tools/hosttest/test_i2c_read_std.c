@@ -0,0 +1,14 @@
+/*
+ * test_i2c_read_std.c
+ *
+ * The bus checks in test_i2c_read.c built with I2C_FAST_MODE disabled
+ * (Standard Mode timing).
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_i2c_read.c"
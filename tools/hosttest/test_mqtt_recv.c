@@ -0,0 +1,259 @@
+/*
+ * test_mqtt_recv.c
+ *
+ * Checks how __mqtt_recv() splits the TCP segments from the Broker into
+ * MQTT packets. A stand-in for the Broker coalesces a series of packets
+ * into one stream and cuts it into three segments at every pair of split
+ * points (the second in steps of 7 bytes). For each split:
+ * - Every packet that fits the partial buffer is delivered to the publish
+ *   callback once, in order, with its topic and payload intact.
+ * - A packet larger than the partial buffer is delivered when it is whole
+ *   in one segment and discarded when it is split, without disturbing the
+ *   packets around it.
+ * A remaining length of more than 16 bits must be refused with
+ * MQTT_ERROR_INVALID_REMAINING_LENGTH wherever it is split, and not wrap
+ * around to a small packet size. A remaining length field of 5 bytes is
+ * refused the same way.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "uip.h"
+#include "mqtt.h"
+
+// Variables used by mqtt.c (Main.c, uip.c and timer.c are not linked)
+uint16_t uip_len;
+uint16_t uip_slen;
+uint8_t uip_flags;
+char *uip_appdata;
+struct uip_conn *uip_conn;
+uint32_t second_counter;
+uint8_t MQTT_error_status;
+uint8_t mqtt_start;
+
+int16_t mqtt_pal_sendall(const void* buf, uint16_t len)
+{
+  (void)buf;
+  return (int16_t)len;
+}
+
+static int failures;
+#define FAIL(...) do { if (failures++ < 10) printf(__VA_ARGS__); } while (0)
+
+// Packets delivered to the publish callback, as "topic=payload" lines
+static char delivered[4096];
+static int delivered_len;
+
+static void callback(void** state, struct mqtt_response_publish *publish)
+{
+  (void)state;
+  if (delivered_len + publish->topic_name_size + publish->application_message_size + 2
+      > (int)sizeof(delivered)) return;
+  memcpy(&delivered[delivered_len], publish->topic_name, publish->topic_name_size);
+  delivered_len += publish->topic_name_size;
+  delivered[delivered_len++] = '=';
+  memcpy(&delivered[delivered_len], publish->application_message,
+         publish->application_message_size);
+  delivered_len += publish->application_message_size;
+  delivered[delivered_len++] = '\n';
+  delivered[delivered_len] = '\0';
+}
+
+// The Broker stand-in: packets are added to one stream
+static uint8_t stream[2048];
+static int stream_len;
+static int packet_start[16];
+static int packet_end[16];
+static int packet_big[16];
+static char expect_line[16][300];
+static int packets;
+
+static void add_publish(const char *topic, const char *payload)
+{
+  // QoS 0 PUBLISH with a 1 or 2 byte remaining length
+  uint8_t *b = &stream[stream_len];
+  int tl = (int)strlen(topic);
+  int pl = (int)strlen(payload);
+  int rl = 2 + tl + pl;
+  int h;
+  b[0] = MQTT_CONTROL_PUBLISH << 4;
+  if (rl < 128) {
+    b[1] = (uint8_t)rl;
+    h = 2;
+  }
+  else {
+    b[1] = (uint8_t)(0x80 | (rl & 0x7f));
+    b[2] = (uint8_t)(rl >> 7);
+    h = 3;
+  }
+  b[h] = (uint8_t)(tl >> 8);
+  b[h + 1] = (uint8_t)tl;
+  memcpy(&b[h + 2], topic, (size_t)tl);
+  memcpy(&b[h + 2 + tl], payload, (size_t)pl);
+  packet_start[packets] = stream_len;
+  stream_len += h + rl;
+  packet_end[packets] = stream_len;
+  packet_big[packets] = (h + rl > MQTT_RECV_PARTIAL_SIZE);
+  sprintf(expect_line[packets], "%s=%s\n", topic, payload);
+  packets++;
+}
+
+static struct mqtt_client client;
+static uint8_t sendbuf[140];
+static uint8_t segment[2048];
+
+static int16_t feed(const uint8_t *data, int len)
+{
+  // Deliver one TCP segment to the client
+  memcpy(segment, data, (size_t)len);
+  uip_appdata = (char *)segment;
+  uip_len = (uint16_t)len;
+  return __mqtt_recv(&client);
+}
+
+static void start(void)
+{
+  mqtt_init(&client, sendbuf, sizeof(sendbuf), segment, sizeof(segment), callback);
+  delivered_len = 0;
+  delivered[0] = '\0';
+}
+
+static int whole_in_segment(int p, int cut1, int cut2)
+{
+  // 1 if packet p does not cross a segment boundary
+  int s = packet_start[p];
+  int e = packet_end[p];
+  return !((s < cut1 && e > cut1) || (s < cut2 && e > cut2));
+}
+
+static int splits;
+
+static void check_split(int cut1, int cut2)
+{
+  static char expect[4096];
+  int16_t rv;
+  int p;
+
+  start();
+  rv = feed(stream, cut1);
+  if (rv == MQTT_OK) rv = feed(stream + cut1, cut2 - cut1);
+  if (rv == MQTT_OK) rv = feed(stream + cut2, stream_len - cut2);
+  if (rv != MQTT_OK) {
+    FAIL("FAIL split %d %d: error %04x\n", cut1, cut2, (uint16_t)rv);
+    return;
+  }
+  expect[0] = '\0';
+  for (p = 0; p < packets; p++) {
+    if (!packet_big[p] || whole_in_segment(p, cut1, cut2)) strcat(expect, expect_line[p]);
+  }
+  if (strcmp(expect, delivered) != 0) {
+    FAIL("FAIL split %d %d: delivered\n%sexpected\n%s", cut1, cut2, delivered, expect);
+  }
+  splits++;
+}
+
+static void check_invalid(const uint8_t *pkt, int len, const char *what)
+{
+  // The packet follows a valid one in the stream. Every split must deliver
+  // the valid packet and refuse the invalid one.
+  static uint8_t buf[256];
+  int16_t rv;
+  int cut;
+  int n;
+
+  stream_len = 0;
+  packets = 0;
+  add_publish("NetworkModule/dev/output/01/set", "ON");
+  memcpy(buf, stream, (size_t)stream_len);
+  memcpy(&buf[stream_len], pkt, (size_t)len);
+  n = stream_len + len;
+  for (cut = 1; cut <= n; cut++) {
+    start();
+    rv = feed(buf, cut);
+    if (rv == MQTT_OK && cut < n) rv = feed(buf + cut, n - cut);
+    if (rv != MQTT_ERROR_INVALID_REMAINING_LENGTH) {
+      FAIL("FAIL %s split at %d: returned %04x\n", what, cut, (uint16_t)rv);
+    }
+    if (strcmp(delivered, expect_line[0]) != 0) {
+      FAIL("FAIL %s split at %d: valid packet not delivered\n", what, cut);
+    }
+  }
+}
+
+int main(void)
+{
+  static const uint8_t wraps[] = {
+    // Remaining length 65541, which is 5 in 16 bits. Followed by what
+    // would be a complete 5 byte PUBLISH.
+    MQTT_CONTROL_PUBLISH << 4, 0x85, 0x80, 0x04, 0x00, 0x01, 'x', 'O', 'N'
+  };
+  static const uint8_t too_long[] = {
+    // Remaining length field of 5 bytes
+    MQTT_CONTROL_PUBLISH << 4, 0x80, 0x80, 0x80, 0x80, 0x01, 0x00
+  };
+  static const uint8_t largest[] = {
+    // Remaining length 65531, the largest packet size (65535) that fits 16
+    // bits. It is too large to reassemble, so it is skipped.
+    MQTT_CONTROL_PUBLISH << 4, 0xfb, 0xff, 0x03, 0x00, 0x01, 'x'
+  };
+  char big[201];
+  int cut1;
+  int cut2;
+
+  // Commands as a Broker sends them after a SUBSCRIBE: several short
+  // /set messages, a retained message larger than the partial buffer, and
+  // a state request, all coalesced in one stream.
+  memset(big, 'x', 200);
+  big[200] = '\0';
+  add_publish("NetworkModule/dev/output/01/set", "ON");
+  add_publish("NetworkModule/dev/output/03/set", "ON");
+  add_publish("NetworkModule/dev/output/02/set", "OFF");
+  add_publish("NetworkModule/dev/big", big);
+  add_publish("NetworkModule/dev/output/16/set", "OFF");
+  add_publish("NetworkModule/dev/state-req", "");
+  add_publish("NetworkModule/dev/output/05/set", "ON");
+
+  for (cut1 = 0; cut1 <= stream_len; cut1++) {
+    for (cut2 = cut1; cut2 <= stream_len; cut2 += 7) check_split(cut1, cut2);
+  }
+  printf("%d byte stream of %d packets, %d splits checked\n", stream_len, packets, splits);
+
+  check_invalid(wraps, sizeof(wraps), "remaining length over 16 bits");
+  check_invalid(too_long, sizeof(too_long), "5 byte remaining length");
+
+  // The largest valid size is skipped, not refused, and the packet after
+  // it is delivered.
+  {
+    static uint8_t buf[80];
+    static uint8_t zero[440];
+    long left;
+    int16_t rv;
+    stream_len = 0;
+    packets = 0;
+    add_publish("NetworkModule/dev/output/01/set", "ON");
+    memcpy(buf, stream, (size_t)stream_len);
+    memcpy(&buf[stream_len], largest, sizeof(largest));
+    start();
+    rv = feed(buf, stream_len + (int)sizeof(largest));
+    left = 65535 - (long)sizeof(largest);
+    while (rv == MQTT_OK && left > 0) {
+      rv = feed(zero, left > 440 ? 440 : (int)left);
+      left -= 440;
+    }
+    stream_len = 0;
+    add_publish("NetworkModule/dev/output/02/set", "OFF");
+    if (rv == MQTT_OK) rv = feed(stream, stream_len);
+    if (rv != MQTT_OK || strstr(delivered, "output/02/set=OFF") == NULL) {
+      FAIL("FAIL 65535 byte packet: returned %04x, delivered\n%s", (uint16_t)rv, delivered);
+    }
+  }
+
+  printf("%d failures\n", failures);
+  return failures != 0;
+}
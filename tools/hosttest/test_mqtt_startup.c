@@ -0,0 +1,561 @@
+/*
+ * test_mqtt_startup.c
+ *
+ * Runs mqtt_startup() against a stand-in MQTT Broker and measures the
+ * time from MQTT_START_TCP_CONNECT to MQTT_START_COMPLETE (time to
+ * online).
+ *
+ * The real mqtt_startup(), uip_TcpAppHub.c, mqtt.c and mqtt_pal.c code
+ * runs. uip_process() is replaced by a model of the uip behaviour the MQTT
+ * code relies on:
+ * - An ARP reply arrives one round trip after uip_connect() and the TCP
+ *   connection is established one round trip after that.
+ * - One unacknowledged segment at a time. The ACK arrives one round trip
+ *   after the segment is sent, together with any replies from the Broker.
+ * - The periodic timer and uip_poll_conn() call the application when
+ *   there is no outstanding data.
+ * Around it the main loop is modelled: a pass every 0.1ms runs
+ * mqtt_startup(), the 20ms periodic timer, the 50ms MQTT timer that
+ * advances mqtt_start_ctr1, and the 1 second counter.
+ *
+ * The Broker answers CONNECT with CONNACK, SUBSCRIBE with SUBACK and
+ * PINGREQ with PINGRESP, and counts the PUBLISHes it receives. A Broker
+ * fault can be injected:
+ * - Reset: the Broker resets the TCP connection when it receives the
+ *   CONNECT.
+ * - Silent: the Broker stops responding (no ACKs) after the handshake.
+ * - Reset during Auto Discovery: the Broker resets the TCP connection
+ *   after the fifth Auto Discovery config.
+ * Each fault is applied to the first connection only. The startup must
+ * give up on that connection and come online on the next.
+ *
+ * With Auto Discovery on, the time from MQTT_START_QUEUE_PUBLISH_AUTO to
+ * MQTT_START_COMPLETE (discovery completion) is also measured. A run
+ * after a reset during Auto Discovery must send every config again, as
+ * the Broker may not have all of them.
+ *
+ * Once online, the time to report a change of all 16 pins (configured as
+ * Inputs) is measured from the change to the last pin PUBLISH being
+ * queued and to the segment that carries it being sent (on the wire). The
+ * main loop calls mqtt_event_publish() on every pass as in Main.c. Input
+ * debouncing is not modelled: the change is made to ON_OFF_word directly.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "uip.h"
+#include "uipopt.h"
+#include "uip_TcpAppHub.h"
+#include "main.h"
+#include "mqtt.h"
+
+#define PASS_MS     0.1     // Main loop pass
+#define LIMIT_MS    60000.0 // A run that is not online by now has failed
+
+extern uint8_t mqtt_start;
+extern uint8_t mqtt_start_status;
+extern uint8_t mqtt_enabled;
+extern uint8_t mqtt_start_ctr1;
+extern uint8_t mqtt_sanity_ctr;
+extern uint8_t mqtt_restart_step;
+extern uint8_t restart_reboot_step;
+extern uint16_t mqtt_keep_alive;
+extern uint16_t Port_Httpd;
+extern uint16_t Port_Mqttd;
+extern uint32_t second_counter;
+extern uint8_t stored_config_settings;
+extern uint8_t stored_devicename[20];
+extern char mac_string[13];
+extern uint8_t pin_control[16];
+extern uint16_t ON_OFF_word;
+extern uint16_t ON_OFF_word_sent;
+extern struct uip_conn *mqtt_conn;
+extern uip_ipaddr_t uip_mqttserveraddr;
+void HttpDStringInit(void);
+
+// uip variables (uip.c and uip_arp.c are not linked)
+struct uip_conn uip_conns[UIP_CONNS];
+struct uip_conn *uip_conn;
+uint8_t uip_buf[UIP_BUFSIZE + 2];
+char *uip_appdata;
+char *uip_sappdata;
+uint16_t uip_len;
+uint16_t uip_slen;
+uint8_t uip_flags;
+uip_ipaddr_t uip_hostaddr;
+uip_ipaddr_t uip_draddr;
+uip_ipaddr_t uip_netmask;
+uip_ipaddr_t uip_mqttserveraddr;
+
+void uip_send(const char *data, int len)
+{
+  if (len > 0) {
+    uip_slen = (uint16_t)len;
+    if (data != uip_sappdata) memcpy(uip_sappdata, data, uip_slen);
+  }
+}
+void uip_listen(uint16_t port) { (void)port; }
+void uip_arp_out(void) { }
+void Enc28j60Send(uint8_t* pBuffer, uint16_t nBytes) { (void)pBuffer; (void)nBytes; }
+
+static int failures;
+#define FAIL(...) do { if (failures++ < 10) printf(__VA_ARGS__); } while (0)
+
+// Simulation state
+static double now;
+static double rtt;
+static double arp_at;          // ARP reply arrives
+static double est_at;          // SYNACK arrives
+static double ack_at;          // ACK of the outstanding segment arrives
+static double reset_at;        // Broker resets the connection
+static int connections;        // uip_connect() calls in this run
+
+// Broker to client data, delivered with the next ACK (or on its own)
+static uint8_t to_client[512];
+static int to_client_len;
+static double to_client_at;
+
+enum { FAULT_NONE, FAULT_RESET, FAULT_SILENT, FAULT_RESET_DISC };
+static int fault;
+
+// Broker state and counters
+static uint8_t rx[2048];        // Stream from the client
+static int rx_len;
+static int broker_connects;
+static int broker_subscribes;
+static int broker_online;
+static int broker_pins;
+static int broker_disc;
+static long broker_disc_bytes;
+static long broker_bytes;
+static int broker_segments;
+static int report_target;       // broker_pins count that completes a change
+static double report_wire;      // Time that count was reached
+
+static struct uip_conn *mqtt_tcp(void)
+{
+  // The connection the Broker is talking to (the newest MQTT connection)
+  return mqtt_conn;
+}
+
+struct uip_conn *uip_connect(uip_ipaddr_t *ripaddr, uint16_t rport, uint16_t lport)
+{
+  // Take a free connection slot. An earlier connection is left as it is,
+  // as in uip.
+  int i;
+  (void)ripaddr;
+  (void)rport;
+  for (i = 0; i < UIP_CONNS; i++) {
+    if (uip_conns[i].tcpstateflags == UIP_CLOSED) break;
+  }
+  if (i == UIP_CONNS) return NULL;
+  memset(&uip_conns[i], 0, sizeof(uip_conns[i]));
+  uip_conns[i].tcpstateflags = UIP_SYN_SENT;
+  uip_conns[i].lport = htons(lport);
+  uip_conns[i].mss = UIP_TCP_MSS;
+  connections++;
+  broker_disc = 0;
+  broker_disc_bytes = 0;
+  arp_at = now + rtt;
+  est_at = now + 2 * rtt;
+  ack_at = 0;
+  reset_at = 0;
+  to_client_len = 0;
+  rx_len = 0;
+  return &uip_conns[i];
+}
+
+int check_mqtt_server_arp_entry(void)
+{
+  return now >= arp_at;
+}
+
+static void reply(const uint8_t *data, int len)
+{
+  memcpy(&to_client[to_client_len], data, (size_t)len);
+  to_client_len += len;
+  to_client_at = now + rtt;
+}
+
+static void broker_packet(const uint8_t *p, int len, int h)
+{
+  // One complete MQTT packet from the client. h is the fixed header size.
+  static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+  static const uint8_t pingresp[] = { 0xd0, 0x00 };
+  uint8_t suback[16];
+  int topic_len;
+  int n;
+  int i;
+
+  switch (p[0] >> 4) {
+    case MQTT_CONTROL_CONNECT:
+      broker_connects++;
+      if (fault == FAULT_RESET && connections == 1) {
+        reset_at = now + rtt / 2;
+        return;
+      }
+      reply(connack, sizeof(connack));
+      break;
+    case MQTT_CONTROL_SUBSCRIBE:
+      broker_subscribes++;
+      // Count the topic filters
+      n = 0;
+      for (i = h + 2; i < len; i += 2 + ((p[i] << 8) | p[i + 1]) + 1) n++;
+      suback[0] = MQTT_CONTROL_SUBACK << 4;
+      suback[1] = (uint8_t)(2 + n);
+      suback[2] = p[h];
+      suback[3] = p[h + 1];
+      memset(&suback[4], 0, (size_t)n);
+      reply(suback, 4 + n);
+      break;
+    case MQTT_CONTROL_PUBLISH:
+      topic_len = (p[h] << 8) | p[h + 1];
+      if (topic_len > 14 && memcmp(&p[h + 2], "homeassistant/", 14) == 0) {
+        broker_disc++;
+        broker_disc_bytes += len;
+        if (fault == FAULT_RESET_DISC && connections == 1 && broker_disc == 5) {
+          reset_at = now + rtt / 2;
+        }
+      }
+      else if (topic_len > 13 && memcmp(&p[h + 2 + topic_len - 13], "/availability", 13) == 0) {
+        broker_online++;
+      }
+      else if (++broker_pins == report_target) report_wire = now;
+      break;
+    case MQTT_CONTROL_PINGREQ:
+      reply(pingresp, sizeof(pingresp));
+      break;
+  }
+}
+
+static void broker_receive(const uint8_t *data, int len)
+{
+  // A segment from the client. Collect the stream and handle each complete
+  // packet.
+  int size;
+  int h;
+  int i;
+  uint32_t rl;
+
+  broker_segments++;
+  broker_bytes += len;
+  memcpy(&rx[rx_len], data, (size_t)len);
+  rx_len += len;
+  while (rx_len >= 2) {
+    rl = 0;
+    h = 1;
+    i = 0;
+    do {
+      if (h >= rx_len) return;
+      rl |= (uint32_t)(rx[h] & 0x7f) << (7 * i++);
+    } while (rx[h++] & 0x80);
+    size = h + (int)rl;
+    if (size > rx_len) return;
+    broker_packet(rx, size, h);
+    memmove(rx, &rx[size], (size_t)(rx_len - size));
+    rx_len -= size;
+  }
+}
+
+static void appcall(struct uip_conn *c, uint8_t flags)
+{
+  uip_conn = c;
+  uip_appdata = (char *)&uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
+  uip_sappdata = uip_appdata;
+  uip_flags = flags;
+  uip_slen = 0;
+  if (flags & UIP_NEWDATA) {
+    memcpy(uip_appdata, to_client, (size_t)to_client_len);
+    uip_len = (uint16_t)to_client_len;
+    to_client_len = 0;
+  }
+  else uip_len = 0;
+  uip_TcpAppHubCall();
+  if (uip_flags & (UIP_CLOSE | UIP_ABORT)) {
+    c->tcpstateflags = UIP_CLOSED;
+    uip_len = 0;
+    return;
+  }
+  if (uip_slen > 0 && c->tcpstateflags == UIP_ESTABLISHED) {
+    c->len = uip_slen;
+    if (c == mqtt_tcp() && reset_at == 0
+     && !(fault == FAULT_SILENT && connections == 1)) {
+      broker_receive((uint8_t *)uip_appdata, uip_slen);
+      ack_at = now + rtt;
+    }
+  }
+  uip_len = uip_slen;
+}
+
+void uip_process(uint8_t flag)
+{
+  // Only the periodic timer and poll requests reach here: call the
+  // application if the connection has no outstanding data.
+  if (flag != UIP_TIMER && flag != UIP_POLL_REQUEST) return;
+  uip_len = 0;
+  if (uip_conn->tcpstateflags != UIP_ESTABLISHED) return;
+  if (uip_conn->len) return;
+  appcall(uip_conn, UIP_POLL);
+}
+
+static void network(void)
+{
+  // Deliver what the network has for the MQTT connection at this time
+  struct uip_conn *c = mqtt_tcp();
+  uint8_t flags;
+  if (c == NULL) return;
+  if (c->tcpstateflags == UIP_SYN_SENT && now >= est_at) {
+    c->tcpstateflags = UIP_ESTABLISHED;
+    appcall(c, UIP_CONNECTED);
+  }
+  if (c->tcpstateflags != UIP_ESTABLISHED) return;
+  if (reset_at && now >= reset_at) {
+    appcall(c, UIP_ABORT);
+    c->tcpstateflags = UIP_CLOSED;
+    return;
+  }
+  flags = 0;
+  if (c->len && ack_at && now >= ack_at) {
+    c->len = 0;
+    ack_at = 0;
+    flags |= UIP_ACKDATA;
+  }
+  if (to_client_len && now >= to_client_at) flags |= UIP_NEWDATA;
+  if (flags) appcall(c, flags);
+}
+
+static void pass(void)
+{
+  // One pass of the main loop
+  static double next_periodic;
+  static double next_mqtt;
+  static double next_second;
+
+  network();
+#if MQTT_EVENT_PUBLISH_SUPPORT == 1
+  if (mqtt_enabled && mqtt_start == MQTT_START_COMPLETE) mqtt_event_publish();
+#endif // MQTT_EVENT_PUBLISH_SUPPORT == 1
+  if (mqtt_enabled
+   && mqtt_start != MQTT_START_COMPLETE
+   && mqtt_restart_step == MQTT_RESTART_IDLE
+   && restart_reboot_step == RESTART_REBOOT_IDLE) {
+    mqtt_startup();
+  }
+  if (now >= next_periodic) {
+    next_periodic = now + 20.0;
+#if FAIR_SCHEDULER_SUPPORT == 1
+    uip_TcpAppHubPeriodic();
+#else // FAIR_SCHEDULER_SUPPORT == 0
+    {
+      int i;
+      for (i = 0; i < UIP_CONNS; i++) uip_periodic(i);
+    }
+#endif // FAIR_SCHEDULER_SUPPORT == 1
+  }
+  if (now >= next_mqtt) {
+    next_mqtt = now + 50.0;
+    if (mqtt_start == MQTT_START_COMPLETE) publish_outbound(1);
+    mqtt_start_ctr1++;
+    mqtt_sanity_ctr++;
+  }
+  if (now >= next_second) {
+    next_second = now + 1000.0;
+    second_counter++;
+  }
+  now += PASS_MS;
+}
+
+static void reset_broker(void)
+{
+  broker_connects = 0;
+  broker_subscribes = 0;
+  broker_online = 0;
+  broker_pins = 0;
+  broker_disc = 0;
+  broker_disc_bytes = 0;
+  broker_bytes = 0;
+  broker_segments = 0;
+}
+
+static double disc_time;        // Discovery completion time of the last run
+
+static double online(double link_rtt, int broker_fault)
+{
+  // Start over from MQTT_START_TCP_CONNECT as mqtt_sanity_check() does
+  // after a disconnect, and run until MQTT_START_COMPLETE. Returns the time
+  // to online in ms, or -1 if the limit is reached.
+  double start;
+  double disc_start;
+  int i;
+
+  for (i = 0; i < UIP_CONNS; i++) uip_conns[i].tcpstateflags = UIP_CLOSED;
+  mqtt_conn = NULL;
+  rtt = link_rtt;
+  fault = broker_fault;
+  connections = 0;
+  reset_broker();
+  mqtt_start = MQTT_START_TCP_CONNECT;
+  mqtt_start_status = MQTT_START_NOT_STARTED;
+  start = now;
+  disc_start = 0;
+  disc_time = 0;
+  while (mqtt_start != MQTT_START_COMPLETE) {
+    if (now - start > LIMIT_MS) return -1;
+    pass();
+    if (mqtt_start == MQTT_START_QUEUE_PUBLISH_AUTO && disc_start == 0) disc_start = now;
+    if (mqtt_start < MQTT_START_QUEUE_PUBLISH_AUTO) disc_start = 0;
+  }
+  if (disc_start) disc_time = now - disc_start;
+  return now - start;
+}
+
+static double time_to_report(double *queued)
+{
+  // Let the connection settle after coming online (all pin states are
+  // published on connect), then change all 16 pins at once. Returns the
+  // time until the segment carrying the last pin PUBLISH is sent, or -1 if
+  // it is not sent within the limit. *queued is set to the time until the
+  // last pin PUBLISH was queued.
+  double start;
+  double end;
+
+  *queued = 0;
+  end = now + 1000.0;
+  while (now < end || ON_OFF_word != ON_OFF_word_sent || mqtt_conn->len) {
+    if (now - end > LIMIT_MS) return -1;
+    pass();
+  }
+  broker_pins = 0;
+  broker_segments = 0;
+  report_target = 16;
+  report_wire = 0;
+  ON_OFF_word = (uint16_t)~ON_OFF_word;
+  start = now;
+  while (report_wire == 0) {
+    if (now - start > LIMIT_MS) break;
+    pass();
+    if (*queued == 0 && ON_OFF_word == ON_OFF_word_sent) *queued = now - start;
+  }
+  report_target = 0;
+  if (report_wire == 0) return -1;
+  return report_wire - start;
+}
+
+static void report(const char *what, double link_rtt, double t)
+{
+  if (t < 0) {
+    printf("  %-22s RTT %5.1f ms: not online after %.0f s (stuck in state %u)\n",
+           what, link_rtt, LIMIT_MS / 1000.0, mqtt_start);
+    return;
+  }
+  printf("  %-22s RTT %5.1f ms: online in %7.1f ms, %d connection%s, "
+         "%d segments\n", what, link_rtt, t, connections,
+         connections == 1 ? "" : "s", broker_segments);
+}
+
+int main(void)
+{
+  static const double rtts[] = { 1.0, 10.0, 50.0, 200.0 };
+  double t;
+  int disc_all;
+  int i;
+
+  // An MQTT build with four Inputs, four Outputs, the rest Disabled
+  HttpDStringInit();
+  for (i = 0; i < UIP_CONNS; i++) init_tHttpD_struct(&uip_conns[i].appstate.HttpDSocket, i);
+  Port_Httpd = 80;
+  Port_Mqttd = 1883;
+  mqtt_enabled = 1;
+  mqtt_keep_alive = 60;
+  mqtt_restart_step = MQTT_RESTART_IDLE;
+  restart_reboot_step = RESTART_REBOOT_IDLE;
+  uip_ipaddr(uip_mqttserveraddr, 192, 168, 1, 10);
+  strcpy((char *)stored_devicename, "NewDevice");
+  strcpy(mac_string, "c2a3b4c5d6e7");
+  for (i = 0; i < 16; i++) pin_control[i] = 0;
+  for (i = 0; i < 4; i++) pin_control[i] = 0x01;
+  for (i = 4; i < 8; i++) pin_control[i] = 0x03;
+  ON_OFF_word = 0x0055;
+  stored_config_settings = 0; // Auto Discovery disabled
+
+  printf("Time to online (MQTT_START_TCP_CONNECT to MQTT_START_COMPLETE), "
+         "Auto Discovery off\n");
+  for (i = 0; i < 4; i++) {
+    t = online(rtts[i], FAULT_NONE);
+    report("reconnect", rtts[i], t);
+    if (t < 0 || connections != 1 || broker_connects != 1
+     || broker_subscribes != 1 || broker_online != 1) {
+      FAIL("FAIL reconnect at RTT %.0f ms\n", rtts[i]);
+    }
+  }
+
+  // Broker faults on the first connection
+  t = online(10.0, FAULT_RESET);
+  report("reset on CONNECT", 10.0, t);
+  if (t < 0 || connections != 2) FAIL("FAIL no recovery from a reset\n");
+  t = online(10.0, FAULT_SILENT);
+  report("silent Broker", 10.0, t);
+  if (t < 0 || connections != 2) FAIL("FAIL no recovery from a silent Broker\n");
+
+  // Auto Discovery on. The first run sends every config, a reconnect
+  // sends only the configs that changed (none).
+  stored_config_settings = 0x02;
+  printf("Auto Discovery on: time to online and discovery completion "
+         "(MQTT_START_QUEUE_PUBLISH_AUTO to MQTT_START_COMPLETE)\n");
+  disc_all = 0;
+  for (i = 0; i < 4; i++) {
+    discovery_forget();
+    t = online(rtts[i], FAULT_NONE);
+    report("first run", rtts[i], t);
+    printf("  %22s discovery %7.1f ms, %d configs, %ld bytes\n", "",
+           disc_time, broker_disc, broker_disc_bytes);
+    if (i == 0) disc_all = broker_disc;
+    if (t < 0 || broker_disc != disc_all || disc_all == 0) {
+      FAIL("FAIL first discovery run at RTT %.0f ms\n", rtts[i]);
+    }
+    t = online(rtts[i], FAULT_NONE);
+    report("reconnect", rtts[i], t);
+    printf("  %22s discovery %7.1f ms, %d configs\n", "", disc_time, broker_disc);
+    if (t < 0 || broker_disc != 0) FAIL("FAIL discovery reconnect at RTT %.0f ms\n", rtts[i]);
+  }
+
+  // A reset part way through Auto Discovery. The next connection must
+  // send every config again.
+  discovery_forget();
+  t = online(10.0, FAULT_RESET_DISC);
+  report("reset in discovery", 10.0, t);
+  printf("  %22s discovery %7.1f ms, %d configs on the new connection\n", "",
+         disc_time, broker_disc);
+  if (t < 0 || connections != 2) FAIL("FAIL no recovery from a reset in discovery\n");
+  else if (broker_disc != disc_all) {
+    FAIL("FAIL %d of %d configs sent after a reset in discovery\n", broker_disc, disc_all);
+  }
+
+  // Time to report a 16 pin change
+  stored_config_settings = 0;
+  for (i = 0; i < 16; i++) pin_control[i] = 0x01;
+  printf("Time to report a change of all 16 pins (change to the last pin "
+         "PUBLISH queued, and on the wire)\n");
+  for (i = 0; i < 4; i++) {
+    double queued;
+    if (online(rtts[i], FAULT_NONE) < 0) {
+      FAIL("FAIL not online for the report at RTT %.0f ms\n", rtts[i]);
+      continue;
+    }
+    t = time_to_report(&queued);
+    printf("  RTT %5.1f ms: queued in %6.1f ms, on the wire in %6.1f ms, "
+           "%d segments\n", rtts[i], queued, t, broker_segments);
+    if (t < 0 || broker_pins != 16) {
+      FAIL("FAIL %d of 16 pins reported at RTT %.0f ms\n", broker_pins, rtts[i]);
+    }
+  }
+
+  printf("%d failures\n", failures);
+  return failures != 0;
+}
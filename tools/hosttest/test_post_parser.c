@@ -0,0 +1,399 @@
+/*
+ * test_post_parser.c
+ *
+ * Regression, fuzz and throughput checks for the POST parser (parsepost()
+ * in httpd.c).
+ *
+ * - Corpus: Configuration and IOControl page POSTs as the browser sends
+ *   them, with the expected Pending_ values checked field by field.
+ * - Fragmentation: each corpus POST is also fed split at every possible
+ *   point, one byte at a time, and in random sized pieces. The result must
+ *   match the unfragmented parse exactly.
+ * - Fuzz: random POSTs built from the POST grammar (any command, any
+ *   number, values from empty to longer than any field) and random byte
+ *   changes to the corpus. The parse must not write outside the Pending_
+ *   arrays and must give the same result however the data is fragmented.
+ * - Throughput: time to parse a full Configuration POST on the host. Run
+ *   with NM_SRC pointing at another checkout (see prep.sh) to compare
+ *   parser versions.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "httpd.h"
+
+uint16_t parsepost(struct tHttpD* pSocket, char *pBuffer, uint16_t nBytes);
+extern uint8_t parse_tail[];
+
+// The variables and functions parsepost() uses from the rest of the
+// firmware. The arrays are defined larger than the firmware declares them;
+// the extra GUARD entries must never change. A POST component number can
+// be up to 99, so 100 entries covers any array indexed by it.
+#define GUARD 100
+#define GUARD_BYTE 0x5a
+uint8_t Pending_hostaddr[4 + GUARD];
+uint8_t Pending_draddr[4 + GUARD];
+uint8_t Pending_netmask[4 + GUARD];
+uint8_t Pending_devicename[20 + GUARD];
+uint8_t Pending_pin_control[16 + GUARD];
+uint8_t Pending_uip_ethaddr_oct[6 + GUARD];
+uint8_t Pending_mqttserveraddr[4 + GUARD];
+char Pending_mqtt_username[11 + GUARD];
+char Pending_mqtt_password[11 + GUARD];
+uint16_t Pending_IO_TIMER[16 + GUARD];
+char IO_NAME[GUARD][16];
+uint16_t Pending_port;
+uint16_t Pending_mqttport;
+uint8_t Pending_config_settings;
+uint8_t pin_control[16];
+uint8_t parse_complete;
+uint16_t uip_len;
+void unlock_flash(void) { }
+void lock_flash(void) { }
+
+// Everything a parse can change, for comparing two parses
+struct result_t {
+  uint8_t hostaddr[4];
+  uint8_t draddr[4];
+  uint8_t netmask[4];
+  uint8_t devicename[20];
+  uint8_t pin_control[16];
+  uint8_t ethaddr[6];
+  uint8_t mqttserveraddr[4];
+  char mqtt_username[11];
+  char mqtt_password[11];
+  uint16_t io_timer[16];
+  char io_name[16][16];
+  uint16_t port;
+  uint16_t mqttport;
+  uint8_t config_settings;
+  uint8_t webpage;
+  uint8_t complete;
+};
+
+static int failures;
+static unsigned long parses;
+static struct tHttpD socket_state;
+
+#define FAIL(...) do { if (failures++ < 10) printf(__VA_ARGS__); } while (0)
+
+static void reset(void)
+{
+  // Start state: the Pending_ values as the firmware sets them before a
+  // POST, and the parse state as the POST header parse leaves it.
+  int i;
+  memset(Pending_hostaddr, GUARD_BYTE, sizeof(Pending_hostaddr));
+  memset(Pending_draddr, GUARD_BYTE, sizeof(Pending_draddr));
+  memset(Pending_netmask, GUARD_BYTE, sizeof(Pending_netmask));
+  memset(Pending_devicename, GUARD_BYTE, sizeof(Pending_devicename));
+  memset(Pending_pin_control, GUARD_BYTE, sizeof(Pending_pin_control));
+  memset(Pending_uip_ethaddr_oct, GUARD_BYTE, sizeof(Pending_uip_ethaddr_oct));
+  memset(Pending_mqttserveraddr, GUARD_BYTE, sizeof(Pending_mqttserveraddr));
+  memset(Pending_mqtt_username, GUARD_BYTE, sizeof(Pending_mqtt_username));
+  memset(Pending_mqtt_password, GUARD_BYTE, sizeof(Pending_mqtt_password));
+  memset(Pending_IO_TIMER, GUARD_BYTE, sizeof(Pending_IO_TIMER));
+  memset(IO_NAME, GUARD_BYTE, sizeof(IO_NAME));
+  for (i = 0; i < 16; i++) {
+    sprintf(IO_NAME[i], "IO%02d", i + 1);
+    pin_control[i] = (uint8_t)(i * 17);
+  }
+  Pending_port = 0;
+  Pending_mqttport = 0;
+  Pending_config_settings = 0;
+  parse_complete = 0;
+  memset(&socket_state, 0, sizeof(socket_state));
+  socket_state.current_webpage = WEBPAGE_NULL;
+  socket_state.ParseState = PARSE_CMD;
+  socket_state.nParseLeft = 0;
+  socket_state.nState = STATE_PARSEPOST;
+  parse_tail[0] = '\0';
+}
+
+static int guard_ok(const void *base, size_t used, size_t size)
+{
+  const uint8_t *b = (const uint8_t *)base;
+  size_t i;
+  for (i = used; i < size; i++) if (b[i] != GUARD_BYTE) return 0;
+  return 1;
+}
+
+static void capture(struct result_t *r, const char *what)
+{
+  if (!guard_ok(Pending_hostaddr, 4, sizeof(Pending_hostaddr))
+   || !guard_ok(Pending_draddr, 4, sizeof(Pending_draddr))
+   || !guard_ok(Pending_netmask, 4, sizeof(Pending_netmask))
+   || !guard_ok(Pending_devicename, 20, sizeof(Pending_devicename))
+   || !guard_ok(Pending_pin_control, 16, sizeof(Pending_pin_control))
+   || !guard_ok(Pending_uip_ethaddr_oct, 6, sizeof(Pending_uip_ethaddr_oct))
+   || !guard_ok(Pending_mqttserveraddr, 4, sizeof(Pending_mqttserveraddr))
+   || !guard_ok(Pending_mqtt_username, 11, sizeof(Pending_mqtt_username))
+   || !guard_ok(Pending_mqtt_password, 11, sizeof(Pending_mqtt_password))
+   || !guard_ok(Pending_IO_TIMER, 32, sizeof(Pending_IO_TIMER))
+   || !guard_ok(IO_NAME[16], 0, sizeof(IO_NAME[0]) * (GUARD - 16))) {
+    FAIL("FAIL %s: write outside a Pending_ array\n", what);
+  }
+  memset(r, 0, sizeof(*r));
+  memcpy(r->hostaddr, Pending_hostaddr, 4);
+  memcpy(r->draddr, Pending_draddr, 4);
+  memcpy(r->netmask, Pending_netmask, 4);
+  memcpy(r->devicename, Pending_devicename, 20);
+  memcpy(r->pin_control, Pending_pin_control, 16);
+  memcpy(r->ethaddr, Pending_uip_ethaddr_oct, 6);
+  memcpy(r->mqttserveraddr, Pending_mqttserveraddr, 4);
+  memcpy(r->mqtt_username, Pending_mqtt_username, 11);
+  memcpy(r->mqtt_password, Pending_mqtt_password, 11);
+  memcpy(r->io_timer, Pending_IO_TIMER, 32);
+  memcpy(r->io_name, IO_NAME, sizeof(r->io_name));
+  r->port = Pending_port;
+  r->mqttport = Pending_mqttport;
+  r->config_settings = Pending_config_settings;
+  r->webpage = socket_state.current_webpage;
+  r->complete = (uint8_t)(socket_state.nState == STATE_SENDHEADER204);
+}
+
+static void parse(const char *post, size_t len, const size_t *cuts, int ncuts,
+                  struct result_t *r, const char *what)
+{
+  // Parse "post" delivered in ncuts + 1 packets. Each packet is copied to
+  // its own buffer, as each arrives in uip_buf in turn on the target.
+  static char packet[2560];
+  size_t start;
+  size_t end;
+  int i;
+
+  reset();
+  start = 0;
+  for (i = 0; i <= ncuts && socket_state.nState == STATE_PARSEPOST; i++) {
+    end = (i < ncuts) ? cuts[i] : len;
+    if (end > start) {
+      memcpy(packet, post + start, end - start);
+      parsepost(&socket_state, packet, (uint16_t)(end - start));
+    }
+    start = end;
+  }
+  parses++;
+  capture(r, what);
+}
+
+static uint32_t seed = 12345;
+static uint32_t rnd(uint32_t n)
+{
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 8) % n;
+}
+
+static void check_fragments(const char *post, const char *what, int all_cuts)
+{
+  // The parse result must not depend on how the POST is fragmented
+  struct result_t whole;
+  struct result_t frag;
+  size_t cuts[2560];
+  size_t len;
+  size_t i;
+  int n;
+
+  len = strlen(post);
+  parse(post, len, NULL, 0, &whole, what);
+  if (all_cuts) {
+    // Every two packet split, and one byte packets
+    for (i = 1; i < len; i++) {
+      cuts[0] = i;
+      parse(post, len, cuts, 1, &frag, what);
+      if (memcmp(&whole, &frag, sizeof(whole)) != 0) {
+        FAIL("FAIL %s: differs when split at %lu\n", what, (unsigned long)i);
+      }
+    }
+    for (i = 1; i < len; i++) cuts[i - 1] = i;
+    parse(post, len, cuts, (int)len - 1, &frag, what);
+    if (memcmp(&whole, &frag, sizeof(whole)) != 0) {
+      FAIL("FAIL %s: differs with one byte packets\n", what);
+    }
+  }
+  // Random packet sizes
+  for (i = 0; i < 20; i++) {
+    size_t at = 0;
+    n = 0;
+    while (1) {
+      at += 1 + rnd(64);
+      if (at >= len) break;
+      cuts[n++] = at;
+    }
+    parse(post, len, cuts, n, &frag, what);
+    if (memcmp(&whole, &frag, sizeof(whole)) != 0) {
+      FAIL("FAIL %s: differs with random packets\n", what);
+    }
+  }
+}
+
+static void expect_bytes(const char *what, const uint8_t *got,
+                         const uint8_t *want, int n)
+{
+  if (memcmp(got, want, (size_t)n) != 0) FAIL("FAIL corpus: %s\n", what);
+}
+
+static char config_post[1024];
+static char iocontrol_post[128];
+
+static void build_corpus(void)
+{
+  // The Configuration page POST in the order the page sends it, and the
+  // IOControl page POST.
+  char *s;
+  int i;
+
+  s = config_post;
+  s += sprintf(s, "a00=NewDevice-Name_1&b00=c0a80104&b04=c0a80101"
+                  "&b08=ffffff00&c00=1f90&d00=c2fe12345678&g00=a5"
+                  "&h00=");
+  for (i = 0; i < 16; i++) s += sprintf(s, "%02x", 0x83 + i);
+  for (i = 0; i < 16; i++) s += sprintf(s, "&j%02d=Name-%d", i, i * 1000);
+  for (i = 0; i < 16; i++) s += sprintf(s, "&i%02d=%04x", i, 0x4000 + i);
+  strcpy(s, "&z00=0");
+
+  s = iocontrol_post;
+  s += sprintf(s, "h00=");
+  for (i = 0; i < 16; i++) s += sprintf(s, "%02x", (i & 1) ? 0x80 : 0x00);
+  strcpy(s, "&z00=0");
+}
+
+static void check_corpus(void)
+{
+  struct result_t r;
+  uint8_t want[32];
+  char name[16];
+  int i;
+
+  // Configuration page
+  check_fragments(config_post, "Configuration POST", 1);
+  parse(config_post, strlen(config_post), 0, 0, &r, "Configuration POST");
+  if (!r.complete) FAIL("FAIL corpus: Configuration POST not complete\n");
+  if (r.webpage != WEBPAGE_CONFIGURATION) FAIL("FAIL corpus: Configuration page not detected\n");
+  expect_bytes("device name", r.devicename, (const uint8_t *)"NewDevice-Name_1\0\0", 19);
+  want[0] = 0x04; want[1] = 0x01; want[2] = 0xa8; want[3] = 0xc0;
+  expect_bytes("IP address", r.hostaddr, want, 4);
+  want[0] = 0x01;
+  expect_bytes("gateway", r.draddr, want, 4);
+  want[0] = 0x00; want[1] = 0xff; want[2] = 0xff; want[3] = 0xff;
+  expect_bytes("netmask", r.netmask, want, 4);
+  if (r.port != 0x1f90) FAIL("FAIL corpus: port\n");
+  want[0] = 0x78; want[1] = 0x56; want[2] = 0x34; want[3] = 0x12;
+  want[4] = 0xfe; want[5] = 0xc2;
+  expect_bytes("MAC", r.ethaddr, want, 6);
+  if (r.config_settings != 0xa5) FAIL("FAIL corpus: config settings\n");
+  for (i = 0; i < 16; i++) {
+    // The Configuration page keeps the ON/OFF bit
+    want[i] = (uint8_t)((pin_control[i] & 0x80) | ((0x83 + i) & 0x7f));
+  }
+  expect_bytes("pin control (Configuration)", r.pin_control, want, 16);
+  for (i = 0; i < 16; i++) {
+    sprintf(name, "Name-%d", i * 1000);
+    if (strcmp(r.io_name[i], name) != 0) FAIL("FAIL corpus: IO name %d\n", i);
+    if (r.io_timer[i] != 0x4000 + i) FAIL("FAIL corpus: IO timer %d\n", i);
+  }
+
+  // IOControl page
+  check_fragments(iocontrol_post, "IOControl POST", 1);
+  parse(iocontrol_post, strlen(iocontrol_post), 0, 0, &r, "IOControl POST");
+  if (!r.complete) FAIL("FAIL corpus: IOControl POST not complete\n");
+  if (r.webpage != WEBPAGE_IOCONTROL) FAIL("FAIL corpus: IOControl page not detected\n");
+  for (i = 0; i < 16; i++) {
+    // The IOControl page only changes the ON/OFF bit
+    want[i] = (uint8_t)((pin_control[i] & 0x7f) | ((i & 1) ? 0x80 : 0x00));
+  }
+  expect_bytes("pin control (IOControl)", r.pin_control, want, 16);
+
+  // Fields with short, empty and over length values
+  check_fragments("a00=&b00=01&c00=0009&l00=user&m00=0123456789abcdef&z00=0",
+                  "short fields", 1);
+  strcpy(config_post, "a00=&c00=0009&c01=075b&z00=0");
+  parse(config_post, strlen(config_post), 0, 0, &r, "ports");
+  if (r.port != 0) FAIL("FAIL corpus: port 9 was accepted\n");
+  if (r.mqttport != 0x075b) FAIL("FAIL corpus: MQTT port\n");
+  build_corpus();
+}
+
+static void check_fuzz(void)
+{
+  static const char cmds[] = "abcdefghijklmnz&=0%";
+  static const char chars[] = "0123456789abcdefABCDEF-_.*%&=z";
+  char post[2560];
+  char *s;
+  int n;
+  int i;
+  int j;
+  int len;
+
+  // Random POSTs from the grammar
+  for (n = 0; n < 3000; n++) {
+    s = post;
+    for (i = (int)rnd(40); i > 0; i--) {
+      *s++ = cmds[rnd(sizeof(cmds) - 1)];
+      s += sprintf(s, "%02u=", rnd(100));
+      for (len = (int)rnd(45); len > 0; len--) *s++ = chars[rnd(sizeof(chars) - 1)];
+      *s++ = '&';
+    }
+    if (rnd(4)) strcpy(s, "z00=0");
+    else *s = '\0';
+    if (post[0] != '\0') check_fragments(post, "grammar fuzz", n < 200);
+  }
+
+  // Random changes to the corpus
+  for (n = 0; n < 3000; n++) {
+    strcpy(post, (n & 1) ? config_post : iocontrol_post);
+    len = (int)strlen(post);
+    for (j = (int)rnd(8) + 1; j > 0; j--) {
+      post[rnd((uint32_t)len)] = (char)(rnd(255) + 1);
+    }
+    check_fragments(post, "mutation fuzz", 0);
+  }
+}
+
+static void benchmark(void)
+{
+  struct result_t r;
+  struct timespec t0;
+  struct timespec t1;
+  double ns;
+  size_t len;
+  int n;
+  int count;
+
+  len = strlen(config_post);
+  count = 200000;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  reset();
+  for (n = 0; n < count; n++) {
+    // Only the parse state is reset between POSTs
+    socket_state.current_webpage = WEBPAGE_NULL;
+    socket_state.ParseState = PARSE_CMD;
+    socket_state.nParseLeft = 0;
+    socket_state.nState = STATE_PARSEPOST;
+    parse_tail[0] = '\0';
+    parsepost(&socket_state, config_post, (uint16_t)len);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  capture(&r, "benchmark");
+  if (!r.complete) FAIL("FAIL benchmark: POST not complete\n");
+  ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+  printf("Configuration POST (%lu bytes): %.0f ns per POST, %.1f ns per byte "
+         "(host)\n",
+         (unsigned long)len, ns / count, ns / count / (double)len);
+}
+
+int main(void)
+{
+  build_corpus();
+  check_corpus();
+  check_fuzz();
+  printf("%lu parses checked, %d failures\n", parses, failures);
+  benchmark();
+  return failures != 0;
+}
@@ -0,0 +1,336 @@
+/*
+ * test_render_cache.c
+ *
+ * Checks the IOControl page render cache (IOCONTROL_CACHE_SUPPORT) by
+ * running browser connections through HttpDCall() with the ENC28J60 buffer
+ * memory replaced by a RAM array.
+ *
+ * - A page served from the cache is byte for byte the page rendered from
+ *   the template, including across MSS sizes and retransmits.
+ * - A render_cache_version change causes the next request to render again,
+ *   and the new page is the one that gets cached.
+ * - A change while a page is being rendered keeps that page out of the
+ *   cache, as does a retransmit or a new connection during the fill.
+ * - A connection reading the cache aborts if the cache is refilled under
+ *   it, and a header retransmitted after a refill keeps the Content-Length
+ *   that was first sent.
+ * - Timing of a rendered and a cached page on the host.
+ *
+ * Copyright 2020 Michael Nielson
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version. See <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "uip.h"
+#include "httpd.h"
+#include "enc28j60.h"
+
+extern uint16_t uip_slen;
+extern char *uip_sappdata;
+extern uint16_t render_cache_version;
+extern uint8_t render_cache_valid;
+extern uint16_t render_cache_size;
+extern struct tHttpD* render_cache_filler;
+extern uint8_t pin_control[16];
+extern uint16_t ON_OFF_word;
+extern uint8_t stored_devicename[20];
+extern char IO_NAME[16][16];
+void HttpDStringInit(void);
+
+// ENC28J60 buffer memory. Enc28j60.c is not linked; these replace its
+// buffer memory functions.
+static uint8_t enc_mem[0x2000];
+static unsigned long enc_written;
+static unsigned long enc_read;
+
+void Enc28j60WriteBuffer(uint16_t nAddress, uint8_t* pBuffer, uint16_t nBytes)
+{
+  if (nAddress < ENC28J60_CACHESTART || nAddress + nBytes > ENC28J60_CACHEEND + 1) {
+    printf("FAIL write outside the cache area: %04x %u\n", nAddress, nBytes);
+    return;
+  }
+  memcpy(&enc_mem[nAddress], pBuffer, nBytes);
+  enc_written += nBytes;
+}
+
+void Enc28j60ReadBuffer(uint16_t nAddress, uint8_t* pBuffer, uint16_t nBytes)
+{
+  memcpy(pBuffer, &enc_mem[nAddress], nBytes);
+  enc_read += nBytes;
+}
+
+static int failures;
+#define FAIL(...) do { if (failures++ < 10) printf(__VA_ARGS__); } while (0)
+
+// Two connections, each with its own uip_conn and application buffer
+static struct uip_conn conns[2];
+static char appbuf[2][1600];
+#define SOCK(c) (&conns[c].appstate.HttpDSocket)
+
+static void call(int c, uint8_t flags, const char *data)
+{
+  uip_conn = &conns[c];
+  uip_appdata = appbuf[c];
+  uip_sappdata = appbuf[c];
+  uip_flags = flags;
+  uip_slen = 0;
+  uip_len = 0;
+  if (data) {
+    uip_len = (uint16_t)strlen(data);
+    memcpy(appbuf[c], data, uip_len);
+  }
+  HttpDCall((uint8_t *)uip_appdata, uip_len, SOCK(c));
+}
+
+static void open_page(int c, uint16_t mss)
+{
+  // Connect and request the IOControl page (GET /60). Leaves the first
+  // packet (the HTTP header) in appbuf[c].
+  conns[c].mss = mss;
+  call(c, UIP_CONNECTED, 0);
+  call(c, UIP_NEWDATA, "GET /60 HTTP/1.1\r\nHost: x\r\n\r\n");
+}
+
+// Result of a complete page transfer
+static char page[8192];
+static int page_len;
+static int page_packets;
+
+static int next_packet(int c, int rexmit)
+{
+  // Append the packet left by the last call to the page, then ACK it (or
+  // ask for a retransmit first). Returns 0 when the connection closes.
+  if (uip_flags & (UIP_CLOSE | UIP_ABORT)) return 0;
+  if (uip_slen == 0) {
+    FAIL("FAIL connection %d sent nothing\n", c);
+    return 0;
+  }
+  if (rexmit) {
+    // The retransmitted packet must match the original
+    static char prev[1600];
+    uint16_t n = uip_slen;
+    memcpy(prev, appbuf[c], n);
+    call(c, UIP_REXMIT, 0);
+    if (uip_slen != n || memcmp(prev, appbuf[c], n) != 0) {
+      FAIL("FAIL connection %d retransmit differs\n", c);
+    }
+  }
+  memcpy(&page[page_len], appbuf[c], uip_slen);
+  page_len += uip_slen;
+  page_packets++;
+  call(c, UIP_ACKDATA, 0);
+  return 1;
+}
+
+static int check_length(const char *what)
+{
+  // The Content-Length in the header must match the data that follows it
+  char *p;
+  char *body;
+  long len;
+  page[page_len] = '\0';
+  p = strstr(page, "Content-Length:");
+  body = strstr(page, "\r\n\r\n");
+  if (!p || !body) {
+    FAIL("FAIL %s: no HTTP header\n", what);
+    return 0;
+  }
+  len = strtol(p + 15, 0, 10);
+  if (len != (long)(page_len - (body + 4 - page))) {
+    FAIL("FAIL %s: Content-Length %ld but %ld bytes sent\n", what, len,
+         (long)(page_len - (body + 4 - page)));
+    return 0;
+  }
+  return 1;
+}
+
+static int fetch(uint16_t mss, int rexmit_every)
+{
+  // Fetch the IOControl page on connection 0. Returns 1 if the page was
+  // sent from the cache.
+  int cached;
+  page_len = 0;
+  page_packets = 0;
+  open_page(0, mss);
+  cached = (SOCK(0)->nState == STATE_SENDCACHE);
+  while (next_packet(0, rexmit_every && (page_packets % rexmit_every) == 1));
+  if (!(uip_flags & UIP_CLOSE)) FAIL("FAIL page did not end with a close\n");
+  return cached;
+}
+
+static void start_fill(int c, int packets)
+{
+  // Connection c renders the page (filling the cache) and stops after
+  // "packets" packets have been ACKed.
+  open_page(c, 536);
+  if (render_cache_filler != SOCK(c)) FAIL("FAIL connection %d is not filling the cache\n", c);
+  while (packets--) call(c, UIP_ACKDATA, 0);
+}
+
+static double time_fetch(int cached, int count)
+{
+  // Average host time for a complete page, in microseconds
+  struct timespec t0;
+  struct timespec t1;
+  int n;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (n = 0; n < count; n++) {
+    if (!cached) render_cache_version++;
+    fetch(1460, 0);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return ((double)(t1.tv_sec - t0.tv_sec) * 1e9
+         + (double)(t1.tv_nsec - t0.tv_nsec)) / count / 1000.0;
+}
+
+static char reference[8192];
+static int reference_len;
+
+static void save_reference(void)
+{
+  memcpy(reference, page, (size_t)page_len);
+  reference_len = page_len;
+}
+
+static int same_as_reference(void)
+{
+  return page_len == reference_len && memcmp(page, reference, (size_t)page_len) == 0;
+}
+
+int main(void)
+{
+  static const uint16_t mss[] = { 1460, 536, 300, 97 };
+  unsigned long before;
+  double t_render;
+  double t_cache;
+  int i;
+
+  for (i = 0; i < 16; i++) pin_control[i] = (uint8_t)(0x03 | ((i & 1) ? 0x80 : 0));
+  ON_OFF_word = 0xaaaa;
+  strcpy((char *)stored_devicename, "NewDevice");
+  // IO Names of different lengths, including the last one
+  for (i = 0; i < 16; i++) sprintf(IO_NAME[i], "IO%02d", i + 1);
+  strcpy(IO_NAME[2], "Pump 1");
+  strcpy(IO_NAME[15], "Garage Door");
+  HttpDStringInit();
+  HttpDInit();
+
+  // First request renders and fills the cache, the second is served from
+  // the cache and must be identical, for each MSS and with retransmits.
+  for (i = 0; i < 4; i++) {
+    render_cache_version++;
+    if (fetch(mss[i], 0)) FAIL("FAIL mss %u: served from a stale cache\n", mss[i]);
+    check_length("rendered page");
+    if (!render_cache_valid) FAIL("FAIL mss %u: page was not cached\n", mss[i]);
+    save_reference();
+    before = enc_read;
+    if (!fetch(mss[i], 0)) FAIL("FAIL mss %u: not served from the cache\n", mss[i]);
+    if (enc_read - before != render_cache_size) FAIL("FAIL mss %u: cache read size\n", mss[i]);
+    if (!same_as_reference()) FAIL("FAIL mss %u: cached page differs\n", mss[i]);
+    if (!fetch(mss[i], 2) || !same_as_reference()) {
+      FAIL("FAIL mss %u: cached page differs with retransmits\n", mss[i]);
+    }
+    render_cache_version++;
+    if (fetch(mss[i], 2) || !same_as_reference()) {
+      FAIL("FAIL mss %u: rendered page differs with retransmits\n", mss[i]);
+    }
+  }
+  printf("IOControl page: %d bytes with header, cached body %u of %u bytes "
+         "available\n", reference_len, render_cache_size,
+         ENC28J60_CACHEEND - ENC28J60_CACHESTART + 1);
+
+  // A change bumps the version: the next request renders the new page.
+  pin_control[4] ^= 0x80;
+  ON_OFF_word ^= 0x0010;
+  render_cache_version++;
+  if (fetch(536, 0)) FAIL("FAIL change: served from the cache\n");
+  if (same_as_reference()) FAIL("FAIL change: the page did not change\n");
+  save_reference();
+  if (!fetch(536, 0) || !same_as_reference()) FAIL("FAIL change: new page not cached\n");
+
+  // A change while the page is being rendered: that page is sent but not
+  // cached, and the next request renders again.
+  render_cache_version++;
+  start_fill(0, 2);
+  render_cache_version++;
+  while (next_packet(0, 0));
+  if (render_cache_valid) FAIL("FAIL change during fill: page was cached\n");
+  if (fetch(536, 0)) FAIL("FAIL change during fill: served from the cache\n");
+  if (!same_as_reference()) FAIL("FAIL change during fill: page differs\n");
+
+  // A retransmit during the fill abandons the fill
+  render_cache_version++;
+  page_len = 0;
+  start_fill(0, 0);
+  next_packet(0, 0);
+  next_packet(0, 1);
+  if (render_cache_filler) FAIL("FAIL retransmit during fill: fill not abandoned\n");
+  while (next_packet(0, 0));
+  if (!same_as_reference()) FAIL("FAIL retransmit during fill: page differs\n");
+  if (render_cache_valid) FAIL("FAIL retransmit during fill: page was cached\n");
+
+  // A new connection in the slot of a filling connection ends the fill
+  render_cache_version++;
+  start_fill(0, 1);
+  call(0, UIP_CONNECTED, 0);
+  if (render_cache_filler) FAIL("FAIL reconnect during fill: fill not ended\n");
+
+  // A second connection starts rendering while the first is reading the
+  // cache. The first must abort, not mix old and new page data.
+  render_cache_version++;
+  fetch(536, 0);
+  fetch(536, 0);
+  open_page(0, 536);
+  call(0, UIP_ACKDATA, 0);
+  if (SOCK(0)->nState != STATE_SENDCACHE) FAIL("FAIL refill: not reading the cache\n");
+  render_cache_version++;
+  start_fill(1, 1);
+  call(0, UIP_ACKDATA, 0);
+  if (!(uip_flags & UIP_ABORT)) FAIL("FAIL refill: reader did not abort\n");
+  page_len = 0;
+  call(1, UIP_ACKDATA, 0);
+  while (next_packet(1, 0));
+  if (!render_cache_valid) FAIL("FAIL refill: second connection's page not cached\n");
+
+  // The cache is refilled with a page of another size between sending the
+  // header and retransmitting it. The retransmit must match the original.
+  {
+    static char header[1600];
+    uint16_t n;
+    uint16_t old_size;
+    fetch(536, 0);
+    open_page(0, 536);
+    if (SOCK(0)->nState != STATE_SENDCACHE) FAIL("FAIL header rexmit: not reading the cache\n");
+    n = uip_slen;
+    memcpy(header, appbuf[0], n);
+    old_size = render_cache_size;
+    strcpy(IO_NAME[2], "Pump 12");
+    render_cache_version++;
+    page_len = 0;
+    open_page(1, 536);
+    while (next_packet(1, 0));
+    if (!render_cache_valid || render_cache_size == old_size) {
+      FAIL("FAIL header rexmit: cache not refilled with a new size\n");
+    }
+    call(0, UIP_REXMIT, 0);
+    if (uip_slen != n || memcmp(header, appbuf[0], n) != 0) {
+      FAIL("FAIL header rexmit: header changed after a refill\n");
+    }
+  }
+
+  printf("%d failures\n", failures);
+
+  // Timing
+  t_render = time_fetch(0, 20000);
+  t_cache = time_fetch(1, 20000);
+  printf("Rendered from the template: %.2f us per page, from the cache: "
+         "%.2f us per page (host, buffer memory copy only)\n",
+         t_render, t_cache);
+  return failures != 0;
+}
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+#
+# nm_pack.py
+#
+# Converts a Network Module SREC file (the NetworkModule.sx produced by the
+# Cosmic build, or a String File .sx) into a Network Module binary image
+# (.nmb) that can be uploaded with the Code Uploader in place of the SREC
+# file. The binary image carries the same content as the SREC file in less
+# than half the number of bytes.
+#
+# Usage:
+#   python3 nm_pack.py NetworkModule.sx NetworkModule.nmb
+#   python3 nm_pack.py --build-id 0x22020500 Strings.sx Strings.nmb
+#
+# Image format (all multi-byte values are big endian):
+#   0-2   "NMB"
+#   3     Format version (1)
+#   4     File type: 'N' Program file, 'S' String file. This is taken from
+#         the first data byte of the SREC S0 record, which is how the Code
+#         Uploader identifies the file type of an SREC upload.
+#   5     Reserved (0)
+#   6-7   Data length. A multiple of 128 bytes.
+#   8-11  CRC32 (IEEE 802.3 / zip) of the data
+#   12-15 Build ID. Defaults to the time the image was packed (seconds
+#         since 1970). This only identifies the image for the user; the
+#         Code Uploader does not check it.
+#   16-   Data. The image from address 0x8000 upward. Addresses not present
+#         in the SREC file are filled with zero, the same as the erased
+#         Off-Board EEPROM when an SREC file is uploaded.
+#
+# The address range accepted matches the Code Uploader SREC parser: 0x8000
+# up to FLASH_START_USER_RESERVE (main.h). Records outside the range are
+# ignored.
+#
+# Copyright 2020 Michael Nielson
+# This program is free software: you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option)
+# any later version. See <http://www.gnu.org/licenses/>.
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+
+IMAGE_BASE = 0x8000
+FLASH_START_USER_RESERVE = 0xfe80
+BLOCK_SIZE = 128
+FORMAT_VERSION = 1
+
+# Number of address bytes for each SREC data record type
+DATA_RECORDS = {'S1': 2, 'S2': 3, 'S3': 4}
+
+
+def read_srec(path):
+    # Returns (file_type, {address: byte}) from an SREC file.
+    file_type = None
+    data = {}
+    with open(path, 'r') as f:
+        for line_number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line:
+                continue
+            if len(line) < 4 or line[0] != 'S':
+                sys.exit('%s:%d: not an SREC record' % (path, line_number))
+            record = bytes.fromhex(line[2:])
+            if record[0] != len(record) - 1:
+                sys.exit('%s:%d: bad record length' % (path, line_number))
+            if (sum(record) & 0xff) != 0xff:
+                sys.exit('%s:%d: bad checksum' % (path, line_number))
+            kind = line[:2]
+            if kind == 'S0':
+                # First data byte 'N' (0x4E) is a Program file, anything else
+                # is a String file.
+                file_type = 'N' if len(record) > 3 and record[3] == 0x4E else 'S'
+            elif kind in DATA_RECORDS:
+                n = DATA_RECORDS[kind]
+                address = int.from_bytes(record[1:1 + n], 'big')
+                for i, value in enumerate(record[1 + n:-1]):
+                    data[address + i] = value
+    if file_type is None:
+        sys.exit('%s: no S0 record found' % path)
+    return file_type, data
+
+
+def pack(file_type, data, build_id):
+    addresses = [a for a in data if IMAGE_BASE <= a < FLASH_START_USER_RESERVE]
+    if not addresses:
+        sys.exit('no data in the range 0x%04x to 0x%04x'
+                 % (IMAGE_BASE, FLASH_START_USER_RESERVE - 1))
+    length = max(addresses) - IMAGE_BASE + 1
+    length = (length + BLOCK_SIZE - 1) // BLOCK_SIZE * BLOCK_SIZE
+    image = bytearray(length)
+    for a in addresses:
+        image[a - IMAGE_BASE] = data[a]
+    header = struct.pack('>3sBcBHII', b'NMB', FORMAT_VERSION,
+                         file_type.encode('ascii'), 0, length,
+                         zlib.crc32(image) & 0xffffffff, build_id)
+    return header + bytes(image)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert a Network Module SREC file to a binary image')
+    parser.add_argument('srec', help='input SREC (.sx) file')
+    parser.add_argument('image', help='output binary image (.nmb) file')
+    parser.add_argument('--build-id', type=lambda s: int(s, 0),
+                        default=int(time.time()) & 0xffffffff,
+                        help='32 bit build ID stored in the image header')
+    args = parser.parse_args()
+
+    file_type, data = read_srec(args.srec)
+    image = pack(file_type, data, args.build_id)
+    with open(args.image, 'wb') as f:
+        f.write(image)
+    print('%s: %s file, %d data bytes, CRC32 0x%08x, build ID 0x%08x'
+          % (args.image, 'Program' if file_type == 'N' else 'String',
+             len(image) - 16, struct.unpack('>I', image[8:12])[0],
+             args.build_id))
+
+
+if __name__ == '__main__':
+    main()